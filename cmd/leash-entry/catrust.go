@@ -0,0 +1,426 @@
+package main
+
+import (
+	"bytes"
+	"crypto/sha1"
+	"crypto/sha256"
+	"crypto/x509"
+	"encoding/asn1"
+	"encoding/binary"
+	"encoding/hex"
+	"encoding/pem"
+	"errors"
+	"fmt"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"sort"
+	"strings"
+	"unicode/utf16"
+	"unicode/utf8"
+
+	"github.com/strongdm/leash/internal/entrypoint"
+)
+
+const (
+	caBundlePath     = shareRoot + "/" + entrypoint.CABundleFileName
+	caBundleCacheDir = shareRoot + "/" + entrypoint.CABundleCacheDirName
+)
+
+// systemBundles lists where distributions keep the merged PEM bundle that
+// update-ca-certificates and update-ca-trust regenerate.
+var systemBundles = []string{
+	"/etc/ssl/certs/ca-certificates.crt", // Debian, Ubuntu, Alpine
+	"/etc/pki/tls/certs/ca-bundle.crt",   // Fedora, RHEL
+	"/etc/ssl/ca-bundle.pem",             // openSUSE
+	"/etc/ssl/cert.pem",
+}
+
+// caPathDirs are OpenSSL CApath directories, where certificates are found
+// through subject-hash links that update-ca-certificates maintains.
+var caPathDirs = []string{"/etc/ssl/certs"}
+
+// javaKeystores are the Java trust stores that the distributions' full CA
+// update regenerates through its hooks. The fast path cannot update them.
+var javaKeystores = []string{
+	"/etc/ssl/certs/java/cacerts",              // Debian, Ubuntu
+	"/etc/pki/ca-trust/extracted/java/cacerts", // Fedora, RHEL
+	"/etc/ssl/certs/java/cacerts.jks",          // Alpine openjdk
+	"/var/lib/ca-certificates/java-cacerts",    // openSUSE
+}
+
+// trustCA makes the leash CA trusted inside the container and publishes the
+// merged bundle at caBundlePath. The fast path appends the CA to a copy of
+// the system bundle and links it into the CApath directory instead of
+// rebuilding the trust store. The full update-ca-certificates run is the
+// fallback, is used for images with a Java keystore, or is forced with
+// LEASH_CA_FULL_UPDATE=1.
+func trustCA(caCertFile, certBasePath, updateCommand string) error {
+	if strings.TrimSpace(os.Getenv("LEASH_CA_FULL_UPDATE")) != "1" {
+		err := trustCAFast(caCertFile, certBasePath)
+		if err == nil {
+			return nil
+		}
+		os.Stderr.WriteString("leash-entry: fast CA install unavailable (" + err.Error() + "); running full update\n")
+	}
+	if err := trustCAFull(caCertFile, certBasePath, updateCommand); err != nil {
+		return err
+	}
+	// Publish what the full update produced, or the CA alone when the image
+	// keeps no bundle we recognise.
+	src := caCertFile
+	if system, err := findSystemBundle(); err == nil {
+		src = system
+	}
+	data, err := os.ReadFile(src)
+	if err != nil {
+		return fmt.Errorf("read %s: %w", src, err)
+	}
+	return writeFileAtomic(caBundlePath, data, 0o644)
+}
+
+func trustCAFast(caCertFile, certBasePath string) error {
+	if keystore := firstExisting(javaKeystores); keystore != "" {
+		return fmt.Errorf("%s is only updated by the full update", keystore)
+	}
+	system, err := findSystemBundle()
+	if err != nil {
+		return err
+	}
+	ca, err := os.ReadFile(caCertFile)
+	if err != nil {
+		return err
+	}
+	hash, err := subjectHash(ca)
+	if err != nil {
+		return err
+	}
+	merged, err := mergedBundle(system, caBundleCacheDir, os.Getenv("LEASH_IMAGE_ID"), ca)
+	if err != nil {
+		return err
+	}
+
+	os.Stderr.WriteString("leash-entry: installing CA certificate\n")
+	// Keep the CA in the anchors directory so a later full update retains it.
+	anchor := filepath.Join(certBasePath, "leash-ca.crt")
+	if err := runPrivileged("cp", caCertFile, anchor); err != nil {
+		return fmt.Errorf("copy CA certificate: %w", err)
+	}
+	if err := installBundle(merged, system); err != nil {
+		return fmt.Errorf("install bundle: %w", err)
+	}
+	for _, dir := range caPathDirs {
+		if info, err := os.Stat(dir); err != nil || !info.IsDir() {
+			continue
+		}
+		if err := linkCAPath(dir, hash, anchor, ca); err != nil {
+			return fmt.Errorf("link CA into %s: %w", dir, err)
+		}
+	}
+	data, err := os.ReadFile(merged)
+	if err != nil {
+		return err
+	}
+	return writeFileAtomic(caBundlePath, data, 0o644)
+}
+
+func trustCAFull(caCertFile, certBasePath, updateCommand string) error {
+	os.Stderr.WriteString("leash-entry: installing CA certificate\n")
+	if err := runPrivileged("cp", caCertFile, filepath.Join(certBasePath, "leash-ca.crt")); err != nil {
+		os.Stderr.WriteString(err.Error() + "\n")
+		return errors.New("failed to copy CA certificate")
+	}
+	os.Stderr.WriteString("leash-entry: updating CA certificates\n")
+	if err := runPrivileged(updateCommand); err != nil {
+		os.Stderr.WriteString(err.Error() + "\n")
+		return errors.New("failed to update CA certificates")
+	}
+	return nil
+}
+
+// findSystemBundle returns the resolved path of the first system bundle
+// present in the image.
+func findSystemBundle() (string, error) {
+	for _, candidate := range systemBundles {
+		resolved, err := filepath.EvalSymlinks(candidate)
+		if err != nil {
+			continue
+		}
+		if info, err := os.Stat(resolved); err == nil && info.Mode().IsRegular() && info.Size() > 0 {
+			return resolved, nil
+		}
+	}
+	return "", errors.New("no system CA bundle found")
+}
+
+// mergedBundle returns a cached bundle holding system plus ca, building it
+// on a miss. Bundles are keyed by the image ID when the runner supplies one,
+// so every container from an image reuses the same file without reading
+// the system bundle, and otherwise by the system bundle's digest; the CA's
+// digest is part of the key either way.
+func mergedBundle(system, cacheDir, imageID string, ca []byte) (string, error) {
+	if !bytes.Contains(ca, []byte("-----BEGIN CERTIFICATE-----")) {
+		return "", errors.New("CA certificate is not PEM")
+	}
+	var systemData []byte
+	key := sanitizeImageID(imageID)
+	if key == "" {
+		data, err := os.ReadFile(system)
+		if err != nil {
+			return "", err
+		}
+		systemData = data
+		key = digest(data)
+	}
+	path := filepath.Join(cacheDir, key[:min(len(key), 24)]+"-"+digest(ca)[:12]+".pem")
+	// The cache lives in the writable share dir, so a hit is only used when
+	// it still looks like what this function writes.
+	if cached, err := os.ReadFile(path); err == nil && validBundle(cached, systemData, ca) {
+		return path, nil
+	}
+
+	if systemData == nil {
+		data, err := os.ReadFile(system)
+		if err != nil {
+			return "", err
+		}
+		systemData = data
+	}
+	merged := systemData
+	// A restarted container already carries the CA in its bundle.
+	if !bytes.Contains(systemData, bytes.TrimSpace(ca)) {
+		merged = make([]byte, 0, len(systemData)+len(ca)+32)
+		merged = append(merged, systemData...)
+		if len(merged) > 0 && merged[len(merged)-1] != '\n' {
+			merged = append(merged, '\n')
+		}
+		merged = append(merged, "# leash CA\n"...)
+		merged = append(merged, ca...)
+	}
+	if err := os.MkdirAll(cacheDir, 0o755); err != nil {
+		return "", err
+	}
+	if err := writeFileAtomic(path, merged, 0o644); err != nil {
+		return "", err
+	}
+	return path, nil
+}
+
+// validBundle reports whether data is a merged bundle for ca: it ends with
+// the CA and, when the system bundle is known, starts with it.
+func validBundle(data, system, ca []byte) bool {
+	if !bytes.HasSuffix(bytes.TrimSpace(data), bytes.TrimSpace(ca)) {
+		return false
+	}
+	return system == nil || bytes.HasPrefix(data, system)
+}
+
+// installBundle replaces the system bundle with the merged one so tools
+// that ignore SSL_CERT_FILE trust the CA too.
+func installBundle(merged, system string) error {
+	if os.Geteuid() != 0 {
+		return runPrivileged("cp", merged, system)
+	}
+	data, err := os.ReadFile(merged)
+	if err != nil {
+		return err
+	}
+	return writeFileAtomic(system, data, 0o644)
+}
+
+func firstExisting(paths []string) string {
+	for _, path := range paths {
+		if _, err := os.Stat(path); err == nil {
+			return path
+		}
+	}
+	return ""
+}
+
+// linkCAPath links anchor into the CApath directory dir under the subject
+// hash name (<hash>.<n>) that OpenSSL looks certificates up by, as
+// update-ca-certificates does. An existing link to the same certificate is
+// kept.
+func linkCAPath(dir string, hash uint32, anchor string, ca []byte) error {
+	for n := 0; n < 10; n++ {
+		link := filepath.Join(dir, fmt.Sprintf("%08x.%d", hash, n))
+		if _, err := os.Lstat(link); err == nil {
+			if existing, err := os.ReadFile(link); err == nil && bytes.Equal(bytes.TrimSpace(existing), bytes.TrimSpace(ca)) {
+				return nil
+			}
+			continue
+		}
+		err := os.Symlink(anchor, link)
+		if errors.Is(err, os.ErrPermission) && os.Geteuid() != 0 {
+			return runPrivileged("ln", "-s", anchor, link)
+		}
+		return err
+	}
+	return fmt.Errorf("no free link name for subject hash %08x", hash)
+}
+
+// subjectHash returns OpenSSL's X509_NAME_hash of the certificate's subject:
+// the first four bytes, little endian, of the SHA-1 of the canonical name
+// encoding. String values are converted to UTF-8, lowercased, trimmed and
+// have whitespace runs collapsed, and the name's outer SEQUENCE is dropped.
+func subjectHash(certPEM []byte) (uint32, error) {
+	block, _ := pem.Decode(certPEM)
+	if block == nil || block.Type != "CERTIFICATE" {
+		return 0, errors.New("CA certificate is not PEM")
+	}
+	cert, err := x509.ParseCertificate(block.Bytes)
+	if err != nil {
+		return 0, fmt.Errorf("parse CA certificate: %w", err)
+	}
+	var rdns []asn1.RawValue
+	if _, err := asn1.Unmarshal(cert.RawSubject, &rdns); err != nil {
+		return 0, fmt.Errorf("parse CA subject: %w", err)
+	}
+
+	type attribute struct {
+		Type  asn1.ObjectIdentifier
+		Value asn1.RawValue
+	}
+	var canon []byte
+	for _, rdn := range rdns {
+		var attrs []attribute
+		if _, err := asn1.UnmarshalWithParams(rdn.FullBytes, &attrs, "set"); err != nil {
+			return 0, fmt.Errorf("parse CA subject: %w", err)
+		}
+		encoded := make([][]byte, 0, len(attrs))
+		for _, attr := range attrs {
+			if value, ok := canonicalNameValue(attr.Value); ok {
+				attr.Value = asn1.RawValue{Tag: asn1.TagUTF8String, Bytes: value}
+			}
+			der, err := asn1.Marshal(attr)
+			if err != nil {
+				return 0, err
+			}
+			encoded = append(encoded, der)
+		}
+		// DER orders the members of a SET by their encoding.
+		sort.Slice(encoded, func(i, j int) bool { return bytes.Compare(encoded[i], encoded[j]) < 0 })
+		set, err := asn1.Marshal(asn1.RawValue{Tag: asn1.TagSet, IsCompound: true, Bytes: bytes.Join(encoded, nil)})
+		if err != nil {
+			return 0, err
+		}
+		canon = append(canon, set...)
+	}
+	sum := sha1.Sum(canon)
+	return binary.LittleEndian.Uint32(sum[:4]), nil
+}
+
+// canonicalNameValue returns the canonical UTF-8 form of a string-typed name
+// value, or false for types OpenSSL copies unchanged.
+func canonicalNameValue(v asn1.RawValue) ([]byte, bool) {
+	if v.Class != asn1.ClassUniversal {
+		return nil, false
+	}
+	var text []byte
+	switch v.Tag {
+	case asn1.TagUTF8String, asn1.TagNumericString, asn1.TagPrintableString, asn1.TagIA5String:
+		text = v.Bytes
+	case asn1.TagT61String:
+		// Treated as Latin-1.
+		for _, b := range v.Bytes {
+			text = utf8.AppendRune(text, rune(b))
+		}
+	case asn1.TagBMPString:
+		units := make([]uint16, len(v.Bytes)/2)
+		for i := range units {
+			units[i] = binary.BigEndian.Uint16(v.Bytes[2*i:])
+		}
+		for _, r := range utf16.Decode(units) {
+			text = utf8.AppendRune(text, r)
+		}
+	case 28: // UniversalString
+		for i := 0; i+4 <= len(v.Bytes); i += 4 {
+			text = utf8.AppendRune(text, rune(binary.BigEndian.Uint32(v.Bytes[i:])))
+		}
+	default:
+		return nil, false
+	}
+
+	isSpace := func(b byte) bool { return b == ' ' || (b >= '\t' && b <= '\r') }
+	for len(text) > 0 && isSpace(text[0]) {
+		text = text[1:]
+	}
+	for len(text) > 0 && isSpace(text[len(text)-1]) {
+		text = text[:len(text)-1]
+	}
+	out := make([]byte, 0, len(text))
+	for i := 0; i < len(text); {
+		switch b := text[i]; {
+		case b >= 0x80:
+			out = append(out, b)
+			i++
+		case isSpace(b):
+			out = append(out, ' ')
+			for i < len(text) && isSpace(text[i]) {
+				i++
+			}
+		default:
+			if b >= 'A' && b <= 'Z' {
+				b += 'a' - 'A'
+			}
+			out = append(out, b)
+			i++
+		}
+	}
+	return out, true
+}
+
+func sanitizeImageID(id string) string {
+	id = strings.TrimPrefix(strings.TrimSpace(id), "sha256:")
+	if id == "" || strings.Trim(id, "0123456789abcdef") != "" {
+		return ""
+	}
+	return id
+}
+
+func digest(data []byte) string {
+	sum := sha256.Sum256(data)
+	return hex.EncodeToString(sum[:])
+}
+
+// runPrivileged runs a command directly as root, or through sudo otherwise.
+func runPrivileged(name string, args ...string) error {
+	var cmd *exec.Cmd
+	if os.Geteuid() == 0 {
+		cmd = exec.Command(name, args...)
+	} else {
+		cmd = exec.Command("sudo", append([]string{name}, args...)...)
+	}
+	cmd.Stdout = os.Stdout
+	cmd.Stderr = os.Stderr
+	return cmd.Run()
+}
+
+// writeFileAtomic writes data via a temporary file in the same directory and
+// renames it into place.
+func writeFileAtomic(path string, data []byte, mode os.FileMode) error {
+	tmp, err := os.CreateTemp(filepath.Dir(path), filepath.Base(path)+".tmp-*")
+	if err != nil {
+		return err
+	}
+	tmpName := tmp.Name()
+	if _, err := tmp.Write(data); err != nil {
+		tmp.Close()
+		os.Remove(tmpName)
+		return err
+	}
+	if err := tmp.Chmod(mode); err != nil {
+		tmp.Close()
+		os.Remove(tmpName)
+		return err
+	}
+	if err := tmp.Close(); err != nil {
+		os.Remove(tmpName)
+		return err
+	}
+	if err := os.Rename(tmpName, path); err != nil {
+		os.Remove(tmpName)
+		return err
+	}
+	return nil
+}
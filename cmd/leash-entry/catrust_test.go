@@ -0,0 +1,206 @@
+package main
+
+import (
+	"bytes"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"crypto/rand"
+	"crypto/x509"
+	"crypto/x509/pkix"
+	"encoding/pem"
+	"fmt"
+	"math/big"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"time"
+)
+
+const testCA = "-----BEGIN CERTIFICATE-----\nTEST\n-----END CERTIFICATE-----\n"
+
+func writeTestBundle(t *testing.T, contents string) string {
+	t.Helper()
+	path := filepath.Join(t.TempDir(), "ca-certificates.crt")
+	if err := os.WriteFile(path, []byte(contents), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	return path
+}
+
+func TestMergedBundleAppendsCA(t *testing.T) {
+	t.Parallel()
+
+	system := writeTestBundle(t, "-----BEGIN CERTIFICATE-----\nROOT\n-----END CERTIFICATE-----")
+	cache := t.TempDir()
+
+	path, err := mergedBundle(system, cache, "", []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !strings.HasPrefix(string(data), "-----BEGIN CERTIFICATE-----\nROOT\n-----END CERTIFICATE-----\n# leash CA\n") || !strings.HasSuffix(string(data), testCA) {
+		t.Fatalf("unexpected merged bundle:\n%s", data)
+	}
+
+	// Merging again, as after a container restart, must not append twice.
+	if err := os.WriteFile(system, data, 0o644); err != nil {
+		t.Fatal(err)
+	}
+	again, err := mergedBundle(system, t.TempDir(), "", []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	if got, _ := os.ReadFile(again); !bytes.Equal(got, data) {
+		t.Fatalf("expected an unchanged bundle, got:\n%s", got)
+	}
+}
+
+func TestMergedBundleReusesImageCache(t *testing.T) {
+	t.Parallel()
+
+	system := writeTestBundle(t, "ROOTS\n")
+	cache := t.TempDir()
+	const imageID = "sha256:0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+
+	first, err := mergedBundle(system, cache, imageID, []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	// With an image ID the cached bundle is used without reading the system
+	// bundle again.
+	if err := os.Remove(system); err != nil {
+		t.Fatal(err)
+	}
+	second, err := mergedBundle(system, cache, imageID, []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	if first != second {
+		t.Fatalf("expected cache hit: %s vs %s", first, second)
+	}
+
+	// A different CA gets its own bundle.
+	other := strings.Replace(testCA, "TEST", "OTHER", 1)
+	if _, err := mergedBundle(system, cache, imageID, []byte(other)); err == nil {
+		t.Fatal("expected a miss for a new CA to read the (removed) system bundle")
+	}
+}
+
+func TestMergedBundleRejectsNonPEM(t *testing.T) {
+	t.Parallel()
+
+	system := writeTestBundle(t, "ROOTS\n")
+	if _, err := mergedBundle(system, t.TempDir(), "", []byte("not a cert")); err == nil {
+		t.Fatal("expected an error for a non-PEM CA")
+	}
+}
+
+func TestMergedBundleRebuildsTamperedCache(t *testing.T) {
+	t.Parallel()
+
+	system := writeTestBundle(t, "ROOTS\n")
+	cache := t.TempDir()
+	const imageID = "sha256:0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+
+	path, err := mergedBundle(system, cache, imageID, []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	want, _ := os.ReadFile(path)
+
+	// The cache is in the writable share dir: a bundle that no longer ends
+	// with the CA is rebuilt rather than installed.
+	if err := os.WriteFile(path, []byte("ROOTS\nEVIL\n"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	again, err := mergedBundle(system, cache, imageID, []byte(testCA))
+	if err != nil {
+		t.Fatalf("mergedBundle returned error: %v", err)
+	}
+	if got, _ := os.ReadFile(again); !bytes.Equal(got, want) {
+		t.Fatalf("expected the tampered bundle to be rebuilt, got:\n%s", got)
+	}
+}
+
+// testCACert returns a self-signed CA whose subject needs canonicalizing:
+// mixed case, padding and repeated whitespace.
+func testCACert(t *testing.T) []byte {
+	t.Helper()
+	key, err := ecdsa.GenerateKey(elliptic.P256(), rand.Reader)
+	if err != nil {
+		t.Fatal(err)
+	}
+	tmpl := &x509.Certificate{
+		SerialNumber:          big.NewInt(1),
+		Subject:               pkix.Name{CommonName: "  Leash   MITM\tCA ", Organization: []string{"StrongDM"}},
+		NotBefore:             time.Now().Add(-time.Hour),
+		NotAfter:              time.Now().Add(time.Hour),
+		IsCA:                  true,
+		BasicConstraintsValid: true,
+	}
+	der, err := x509.CreateCertificate(rand.Reader, tmpl, tmpl, &key.PublicKey, key)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return pem.EncodeToMemory(&pem.Block{Type: "CERTIFICATE", Bytes: der})
+}
+
+func TestSubjectHashMatchesOpenSSL(t *testing.T) {
+	t.Parallel()
+
+	// openssl x509 -hash -noout prints 80698d2b for this subject.
+	hash, err := subjectHash(testCACert(t))
+	if err != nil {
+		t.Fatalf("subjectHash returned error: %v", err)
+	}
+	if got := fmt.Sprintf("%08x", hash); got != "80698d2b" {
+		t.Fatalf("subjectHash = %s, want 80698d2b", got)
+	}
+}
+
+func TestLinkCAPath(t *testing.T) {
+	t.Parallel()
+
+	ca := testCACert(t)
+	anchor := filepath.Join(t.TempDir(), "leash-ca.crt")
+	if err := os.WriteFile(anchor, ca, 0o644); err != nil {
+		t.Fatal(err)
+	}
+	dir := t.TempDir()
+	// Another certificate already holds the first slot for this hash.
+	if err := os.WriteFile(filepath.Join(dir, "80698d2b.0"), []byte("other\n"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+
+	for i := 0; i < 2; i++ {
+		if err := linkCAPath(dir, 0x80698d2b, anchor, ca); err != nil {
+			t.Fatalf("linkCAPath returned error: %v", err)
+		}
+	}
+	if target, err := os.Readlink(filepath.Join(dir, "80698d2b.1")); err != nil || target != anchor {
+		t.Fatalf("expected 80698d2b.1 to link to the anchor, got %q %v", target, err)
+	}
+	if _, err := os.Lstat(filepath.Join(dir, "80698d2b.2")); err == nil {
+		t.Fatal("expected linking again to reuse the existing link")
+	}
+}
+
+func TestSanitizeImageID(t *testing.T) {
+	t.Parallel()
+
+	cases := map[string]string{
+		"sha256:abc123": "abc123",
+		"abc123":        "abc123",
+		"../../etc":     "",
+		"":              "",
+	}
+	for in, want := range cases {
+		if got := sanitizeImageID(in); got != want {
+			t.Fatalf("sanitizeImageID(%q) = %q, want %q", in, got, want)
+		}
+	}
+}
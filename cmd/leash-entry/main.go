@@ -1,6 +1,7 @@
 package main
 
 import (
+	"context"
 	"encoding/base64"
 	"encoding/json"
 	"fmt"
@@ -12,6 +13,7 @@ import (
 	"time"
 
 	"github.com/strongdm/leash/internal/entrypoint"
+	"github.com/strongdm/leash/internal/telemetry/startup"
 )
 
 const (
@@ -24,14 +26,12 @@ const (
 )
 
 func main() {
+	timeline := startup.New("entry")
 	_ = os.Remove(bootstrapPath)
 
-	for {
-		if _, err := os.Stat(readyFilePath); err == nil {
-			break
-		}
-		time.Sleep(100 * time.Millisecond)
-	}
+	end := timeline.Begin("ready.wait")
+	waitForFile(readyFilePath, 100*time.Millisecond)
+	end(nil)
 
 	// Check for /leash root directory
 	if _, err := os.Stat(shareRoot); os.IsNotExist(err) {
@@ -39,7 +39,10 @@ func main() {
 		os.Exit(1)
 	}
 
-	if err := emitCgroupPath(); err != nil {
+	end = timeline.Begin("cgroup.discover")
+	err := emitCgroupPath()
+	end(err)
+	if err != nil {
 		os.Stderr.WriteString("leash-error: failed to record cgroup path: " + err.Error() + "\n")
 		os.Exit(1)
 	}
@@ -67,51 +70,23 @@ func main() {
 
 	os.Stderr.WriteString("leash-entry: waiting for leash certificate\n")
 
-	// Poll for CA certificate
+	// Wait for CA certificate
 	caCertFile := caCertPath
-	for {
-		if _, err := os.Stat(caCertFile); err == nil {
-			break
-		}
-		time.Sleep(200 * time.Millisecond)
-	}
+	end = timeline.Begin("ca.wait")
+	waitForFile(caCertFile, 200*time.Millisecond)
+	end(nil)
+	end = timeline.Begin("ca.trust")
 
 	// TODO: install cert as call to self with sudo
 	// TODO: support more than alpine
 
-	// Copy CA cert to system certificates directory
-	os.Stderr.WriteString("leash-entry: installing CA certificate\n")
-	var copyCmd *exec.Cmd
-	if os.Geteuid() == 0 {
-		copyCmd = exec.Command("cp", caCertFile, filepath.Join(certBasePath, "leash-ca.crt"))
-	} else {
-		copyCmd = exec.Command("sudo", "cp", caCertFile, filepath.Join(certBasePath, "leash-ca.crt"))
-	}
-	copyCmd.Stdout = os.Stdout
-	copyCmd.Stderr = os.Stderr
-	if err := copyCmd.Run(); err != nil {
-		os.Stderr.WriteString(err.Error() + "\n")
-		os.Stderr.WriteString("leash-error: failed to copy CA certificate\n")
+	if err := trustCA(caCertFile, certBasePath, updateCommand); err != nil {
+		os.Stderr.WriteString("leash-error: " + err.Error() + "\n")
 		os.Exit(1)
 	}
+	end(nil)
 
-	// Run update-ca-certificates
-	os.Stderr.WriteString("leash-entry: updating CA certificates\n")
-	var updateCmd *exec.Cmd
-	if os.Geteuid() == 0 {
-		updateCmd = exec.Command(updateCommand)
-	} else {
-		updateCmd = exec.Command("sudo", updateCommand)
-	}
-	updateCmd.Stdout = os.Stdout
-	updateCmd.Stderr = os.Stderr
-	if err := updateCmd.Run(); err != nil {
-		os.Stderr.WriteString(err.Error() + "\n")
-		os.Stderr.WriteString("leash-error: failed to update CA certificates\n")
-		os.Exit(1)
-	}
-
-	if err := writeBootstrapMarker(); err != nil {
+	if err := writeBootstrapMarker(timeline); err != nil {
 		os.Stderr.WriteString("leash-error: failed to signal bootstrap completion: " + err.Error() + "\n")
 		os.Exit(1)
 	}
@@ -165,12 +140,28 @@ func runIdleLoop() {
 	}
 }
 
-func writeBootstrapMarker() error {
+// waitForFile blocks until path exists. Creation is noticed through inotify
+// on the share directory; poll is the fallback re-check interval.
+func waitForFile(path string, poll time.Duration) {
+	for {
+		if err := entrypoint.WaitForFile(context.Background(), path, poll); err == nil {
+			return
+		}
+		time.Sleep(poll)
+	}
+}
+
+// writeBootstrapMarker signals that bootstrap finished. The marker carries
+// the entry's startup timeline so the runner can fold it into its own.
+func writeBootstrapMarker(timeline *startup.Timeline) error {
 	host, _ := os.Hostname()
+	snapshot := timeline.Snapshot()
 	payload := map[string]any{
-		"pid":       os.Getpid(),
-		"hostname":  host,
-		"timestamp": time.Now().UTC().Format(time.RFC3339Nano),
+		"pid":        os.Getpid(),
+		"hostname":   host,
+		"timestamp":  time.Now().UTC().Format(time.RFC3339Nano),
+		"elapsed_ms": time.Since(snapshot.Start).Milliseconds(),
+		"timeline":   snapshot,
 	}
 	data, err := json.Marshal(payload)
 	if err != nil {
@@ -34,6 +34,14 @@ func main() {
 				log.Fatal(err)
 			}
 			return
+		case "--pool": // Warm pool of standby leash containers.
+			if err := runner.PoolMain(args[2:]); err != nil {
+				if errors.Is(err, flag.ErrHelp) {
+					return
+				}
+				log.Fatal(err)
+			}
+			return
 		case "--darwin": // macOS path.
 			if err := darwind.Main(args[2:]); err != nil {
 				if errors.Is(err, flag.ErrHelp) {
@@ -53,6 +53,7 @@ export default function CedarEditor({ showHeader = true }: Props) {
   const completionDisposableRef = useRef<monacoEditor.IDisposable | null>(null);
   const completionAbortRef = useRef<AbortController | null>(null);
   const isMountedRef = useRef(false);
+  const completionDocumentIdRef = useRef(`cedar-editor-${Math.random().toString(36).slice(2)}`);
 
   const [confirm, setConfirm] = useState<{
     summary: { allowAllConnect: boolean; allowConnect: number; denyConnect: number };
@@ -140,6 +141,9 @@ export default function CedarEditor({ showHeader = true }: Props) {
               {
                 cedar: model.getValue(),
                 cursor: { line: position.lineNumber, column: position.column },
+                // Lets the server keep per-statement parses between keystrokes.
+                documentId: completionDocumentIdRef.current,
+                version: model.getVersionId?.() ?? 0,
               },
               controller.signal,
             );
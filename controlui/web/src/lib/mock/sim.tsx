@@ -12,6 +12,7 @@ import React, {
 import { faker } from "@faker-js/faker";
 import { Action, ActionType, Instance, SimulationState } from "./types";
 import { id, now, pick } from "./random";
+import { fetchPolicies, fetchPolicyLines } from "@/lib/policy/api";
 import type { PoliciesResponse, PolicyLine } from "@/lib/policy/api";
 
 declare global {
@@ -198,6 +199,7 @@ type IngestPayload = {
 type PolicySnapshotPayload = {
   policies: PoliciesResponse;
   lines?: PolicyLine[];
+  version?: number;
 };
 
 export type ActionKind =
@@ -774,6 +776,26 @@ export function SimulationProvider({ children, initialMode = "sim", persist = tr
     let socket: WebSocket | null = null;
     let reconnectTimer: number | null = null;
     let attempts = 0;
+    // Last applied policy snapshot; diff broadcasts are applied on top of it.
+    let policySnapshot: PolicySnapshotPayload | null = null;
+    let resyncing = false;
+
+    const resyncPolicySnapshot = () => {
+      if (resyncing) return;
+      resyncing = true;
+      Promise.all([fetchPolicies(), fetchPolicyLines()])
+        .then(([policies, lines]) => {
+          if (cancelled) return;
+          policySnapshot = { policies, lines, version: policies.version };
+          setLatestPolicySnapshot(policySnapshot);
+        })
+        .catch((err) => {
+          console.warn("[Leash] Failed to resync policy snapshot", err);
+        })
+        .finally(() => {
+          resyncing = false;
+        });
+    };
 
     const scheduleReconnect = () => {
       if (cancelled) return;
@@ -785,6 +807,7 @@ export function SimulationProvider({ children, initialMode = "sim", persist = tr
     const clearLiveState = (ts?: number) => {
       dispatch({ type: "reset", ts: ts ?? now() });
       identityRegistry.reset();
+      policySnapshot = null;
       setLatestPolicySnapshot(null);
     };
 
@@ -815,8 +838,11 @@ export function SimulationProvider({ children, initialMode = "sim", persist = tr
         if (entries.length === 0) return;
         entries.forEach((entry) => {
           if (entry.event === "policy.snapshot") {
-            const snapshot = parsePolicySnapshot(entry.payload);
-            if (snapshot) {
+            const snapshot = parsePolicySnapshot(entry.payload, policySnapshot);
+            if (snapshot === "stale") {
+              resyncPolicySnapshot();
+            } else if (snapshot) {
+              policySnapshot = snapshot;
               setLatestPolicySnapshot(snapshot);
             }
             return;
@@ -946,11 +972,25 @@ function parseWebsocketEntries(raw: string): WebsocketLogEntry[] {
   return entries;
 }
 
-function parsePolicySnapshot(payload: unknown): PolicySnapshotPayload | null {
+// parsePolicySnapshot decodes a policy.snapshot payload. Full payloads carry
+// `policies`; later ones carry a `diff` against `baseVersion`, which is applied
+// to current. "stale" means the diff cannot be applied and a refetch is needed.
+function parsePolicySnapshot(
+  payload: unknown,
+  current: PolicySnapshotPayload | null,
+): PolicySnapshotPayload | "stale" | null {
   if (!payload || typeof payload !== "object") {
     return null;
   }
   const record = payload as Record<string, unknown>;
+  const version = typeof record.version === "number" ? record.version : undefined;
+  const diff = record.diff;
+  if (diff && typeof diff === "object") {
+    if (!current || current.version === undefined || current.version !== record.baseVersion) {
+      return "stale";
+    }
+    return applyPolicySnapshotDiff(current, diff as Record<string, unknown>, version);
+  }
   const policies = record.policies;
   if (!policies || typeof policies !== "object") {
     return null;
@@ -962,9 +1002,35 @@ function parsePolicySnapshot(payload: unknown): PolicySnapshotPayload | null {
   return {
     policies: policies as PoliciesResponse,
     lines,
+    version,
   };
 }
 
+function applyPolicySnapshotDiff(
+  current: PolicySnapshotPayload,
+  diff: Record<string, unknown>,
+  version: number | undefined,
+): PolicySnapshotPayload {
+  let policies = current.policies;
+  if (diff.policies && typeof diff.policies === "object") {
+    policies = { ...policies, ...(diff.policies as Partial<PoliciesResponse>) };
+  }
+
+  let lines = current.lines;
+  const lineDiff = diff.lines as { upserted?: PolicyLine[]; removed?: string[] } | undefined;
+  if (lines && lineDiff) {
+    const removed = new Set(lineDiff.removed ?? []);
+    const byId = new Map<string, PolicyLine>();
+    lines.forEach((line) => {
+      if (!removed.has(line.id)) byId.set(line.id, line);
+    });
+    (lineDiff.upserted ?? []).forEach((line) => byId.set(line.id, line));
+    lines = Array.from(byId.values()).sort((a, b) => (a.sequence ?? 0) - (b.sequence ?? 0));
+  }
+
+  return { policies, lines, version };
+}
+
 function transformLogEntry(entry: WebsocketLogEntry): IngestPayload | null {
   if (!entry.event) {
     logDroppedEvent("missing event", entry);
@@ -32,6 +32,8 @@ export type PoliciesResponse = {
   cedarFile?: string;
   cedarBaseline?: string;
   enforcementMode?: "enforce" | "permit-all";
+  // Snapshot version; bumps whenever any field above changes.
+  version?: number;
 };
 
 export type CedarErrorDetail = {
@@ -173,6 +175,10 @@ export type CompletionRequest = {
     tools?: string[];
     servers?: string[];
   };
+  documentId?: string;
+  version?: number;
+  baseVersion?: number;
+  changes?: { range: CompletionRange; text: string }[];
 };
 
 export async function fetchPolicyBlocks(signal?: AbortSignal): Promise<{
@@ -408,6 +414,20 @@ export type PolicyLine = {
   sequence: number;
 };
 
+export async function fetchPolicies(signal?: AbortSignal): Promise<PoliciesResponse> {
+  const base = resolveApiBase();
+  const res = await fetch(`${base}/api/policies`, {
+    method: "GET",
+    headers: { Accept: "application/json" },
+    cache: "no-store",
+    signal,
+  });
+  if (!res.ok) {
+    return handleErrorResponse(res);
+  }
+  return (await res.json()) as PoliciesResponse;
+}
+
 export async function fetchPolicyLines(signal?: AbortSignal): Promise<PolicyLine[]> {
   const base = resolveApiBase();
   const res = await fetch(`${base}/api/policies/lines`, {
@@ -484,6 +504,30 @@ export async function deletePolicyLine(
   return (await res.json()) as PoliciesResponse;
 }
 
+export type PolicyBatchAdd =
+  | { cedar: string }
+  | { effect: "permit" | "forbid"; action: { type: string; name: string; server?: string; tool?: string } };
+
+export async function applyPolicyBatch(
+  payload: { add?: PolicyBatchAdd[]; delete?: { id?: string; cedar?: string }[] },
+  signal?: AbortSignal
+): Promise<PoliciesResponse> {
+  const base = resolveApiBase();
+  const res = await fetch(`${base}/api/policies/batch`, {
+    method: "POST",
+    headers: {
+      "Content-Type": "application/json",
+      Accept: "application/json",
+    },
+    body: JSON.stringify(payload),
+    signal,
+  });
+  if (!res.ok) {
+    return handleErrorResponse(res);
+  }
+  return (await res.json()) as PoliciesResponse;
+}
+
 export function policiesToBlocks(response: PoliciesResponse): {
   blocksActive: PolicyBlock[];
   blocksRuntime: PolicyBlock[];
@@ -7,6 +7,9 @@ MITM_PORT=${1:-18000}
 LEASH_PORT=${2:-}
 TARGET_CGROUP=${3:-}
 PROXY_MARK=${PROXY_MARK:-0x2000}
+# TENANT_CHAIN is set by a multi-tenant leashd. The chain holds the
+# per-tenant rules of apply-tenant-iptables.sh.
+TENANT_CHAIN=${TENANT_CHAIN:-}
 
 RULE_ERRORS=0
 
@@ -42,6 +45,31 @@ if ! ensure_rule -t nat -C OUTPUT -m mark --mark "$PROXY_MARK" -j RETURN; then
     apply_rule "nat OUTPUT return for proxy mark" iptables_cmd -t nat -I OUTPUT 2 -m mark --mark "$PROXY_MARK" -j RETURN
 fi
 
+# Tenant chain: jumped to after the early returns and before the catch-all
+# redirects below, so a tenant's HTTP(S) reaches its own listener.
+# SECURITY: In multi-tenant mode this is a REQUIRED isolation control -
+# failure is fatal.
+if [ -n "$TENANT_CHAIN" ]; then
+    for table in nat filter; do
+        ensure_rule -t "$table" -L "$TENANT_CHAIN" -n >/dev/null ||
+            ensure_rule -t "$table" -N "$TENANT_CHAIN" ||
+            { echo "leash: FATAL: could not create $table $TENANT_CHAIN chain (iptables)" >&2; exit 1; }
+    done
+    if ! ensure_rule -t nat -C OUTPUT -j "$TENANT_CHAIN"; then
+        # Rule numbers are 1-based; the first line of -S is the policy.
+        redirect=$(iptables_cmd -t nat -S OUTPUT 2>/dev/null | awk 'NR > 1 && / -j REDIRECT/ { print NR - 1; exit }')
+        if [ -n "$redirect" ]; then
+            iptables_cmd -t nat -I OUTPUT "$redirect" -j "$TENANT_CHAIN"
+        else
+            iptables_cmd -t nat -A OUTPUT -j "$TENANT_CHAIN"
+        fi || { echo "leash: FATAL: could not jump to nat $TENANT_CHAIN (iptables)" >&2; exit 1; }
+    fi
+    if ! ensure_rule -t filter -C OUTPUT -j "$TENANT_CHAIN"; then
+        iptables_cmd -t filter -I OUTPUT 1 -j "$TENANT_CHAIN" ||
+            { echo "leash: FATAL: could not jump to filter $TENANT_CHAIN (iptables)" >&2; exit 1; }
+    fi
+fi
+
 # Redirect HTTP to MITM proxy
 if ! ensure_rule -t nat -C OUTPUT -p tcp --dport 80 -j REDIRECT --to-ports "$MITM_PORT"; then
     apply_rule "nat OUTPUT redirect HTTP" iptables_cmd -t nat -A OUTPUT -p tcp --dport 80 -j REDIRECT --to-ports "$MITM_PORT"
@@ -0,0 +1,76 @@
+#!/bin/sh
+# Per-tenant interception rules for a multi-tenant leashd, for both IPv4 and
+# IPv6. The base rules (apply-iptables.sh and apply-ip6tables.sh, run with
+# TENANT_CHAIN set) create the tenant chain in the nat and filter tables and
+# jump to it ahead of their own redirects. Tenant rules only ever go in that
+# chain, so they do not depend on the order of the base rules.
+#
+# Usage: apply-tenant-iptables.sh add|del TENANT_PORT PROXY_PORTS LEASH_PORT TENANT_CGROUP
+#   TENANT_PORT  proxy listener that enforces this tenant's policy
+#   PROXY_PORTS  first:last port range used by all proxy listeners
+#   LEASH_PORT   leashd control plane port (may be empty)
+
+ACTION=${1:-add}
+TENANT_PORT=${2:-}
+PROXY_PORTS=${3:-}
+LEASH_PORT=${4:-}
+TENANT_CGROUP=${5:-}
+TENANT_CHAIN=${TENANT_CHAIN:-LEASH_TENANTS}
+
+if [ -z "$TENANT_PORT" ] || [ -z "$PROXY_PORTS" ] || [ -z "$TENANT_CGROUP" ]; then
+    echo "leash: FATAL: tenant port, proxy ports and cgroup are required" >&2
+    exit 1
+fi
+
+if [ "$ACTION" = "del" ]; then
+    # Best-effort: a rule that is already gone is not an error.
+    for ipt in iptables ip6tables; do
+        $ipt -w -t nat -D "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports 80,443 -j REDIRECT --to-ports "$TENANT_PORT" 2>/dev/null
+        $ipt -w -t filter -D "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$TENANT_PORT" -j ACCEPT 2>/dev/null
+        $ipt -w -t filter -D "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports "$PROXY_PORTS" -j REJECT --reject-with tcp-reset 2>/dev/null
+        if [ -n "$LEASH_PORT" ]; then
+            $ipt -w -t filter -D "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$LEASH_PORT" -j REJECT --reject-with tcp-reset 2>/dev/null
+        fi
+    done
+    echo "leash: removed interception rules for tenant cgroup $TENANT_CGROUP"
+    exit 0
+fi
+
+# Every rule below is a REQUIRED isolation control in both families - failure
+# is fatal.
+fail() {
+    echo "leash: FATAL: could not apply tenant rule: $1" >&2
+    exit 1
+}
+
+for ipt in iptables ip6tables; do
+    # Redirect the tenant's HTTP(S) to its own listener.
+    if ! $ipt -w -t nat -C "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports 80,443 -j REDIRECT --to-ports "$TENANT_PORT" 2>/dev/null; then
+        $ipt -w -t nat -A "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports 80,443 -j REDIRECT --to-ports "$TENANT_PORT" ||
+            fail "$ipt nat redirect to tenant port"
+    fi
+
+    # The listener a connection arrives on decides its policy, so a tenant
+    # may only reach its own. nat runs before filter, so redirected traffic
+    # already carries the tenant port here. Each rule is inserted at the top,
+    # so the ACCEPT ends up ahead of the REJECT.
+    if ! $ipt -w -t filter -C "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports "$PROXY_PORTS" -j REJECT --reject-with tcp-reset 2>/dev/null; then
+        $ipt -w -t filter -I "$TENANT_CHAIN" 1 -m cgroup --path "$TENANT_CGROUP" -p tcp -m multiport --dports "$PROXY_PORTS" -j REJECT --reject-with tcp-reset ||
+            fail "$ipt filter block other proxy listeners"
+    fi
+    if ! $ipt -w -t filter -C "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$TENANT_PORT" -j ACCEPT 2>/dev/null; then
+        $ipt -w -t filter -I "$TENANT_CHAIN" 1 -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$TENANT_PORT" -j ACCEPT ||
+            fail "$ipt filter allow tenant port"
+    fi
+
+    # Block the tenant from reaching the leashd control plane.
+    if [ -n "$LEASH_PORT" ]; then
+        if ! $ipt -w -t filter -C "$TENANT_CHAIN" -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$LEASH_PORT" -j REJECT --reject-with tcp-reset 2>/dev/null; then
+            $ipt -w -t filter -I "$TENANT_CHAIN" 1 -m cgroup --path "$TENANT_CGROUP" -p tcp --dport "$LEASH_PORT" -j REJECT --reject-with tcp-reset ||
+                fail "$ipt filter block control plane"
+        fi
+    fi
+done
+
+echo "leash: tenant cgroup $TENANT_CGROUP intercepted on port $TENANT_PORT"
+exit 0
@@ -8,6 +8,9 @@ var ApplyIptablesScript string
 //go:embed apply-ip6tables.sh
 var ApplyIp6tablesScript string
 
+//go:embed apply-tenant-iptables.sh
+var ApplyTenantIptablesScript string
+
 //go:embed apply-nftables.sh
 var ApplyNftablesScript string
 
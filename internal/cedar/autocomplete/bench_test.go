@@ -0,0 +1,35 @@
+package autocomplete
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+)
+
+func BenchmarkComplete(b *testing.B) {
+	for _, n := range []int{10, 100, 1000} {
+		var sb strings.Builder
+		hints := Hints{}
+		for i := 0; i < n; i++ {
+			fmt.Fprintf(&sb, "permit (principal, action == Action::\"NetworkConnect\", resource)\n    when { resource in [ Host::\"host%d.example.com:443\" ] };\n", i)
+			hints.Hosts = append(hints.Hosts, fmt.Sprintf("host%d.example.com:443", i))
+			hints.Files = append(hints.Files, fmt.Sprintf("/workspace/src/file%d.go", i))
+		}
+		prefix := sb.String()
+		cases := map[string]string{
+			"action":   prefix + `permit (principal, action == <caret>, resource);`,
+			"resource": prefix + "permit (principal, action == Action::\"FileOpen\", resource)\n    when { resource in [ <caret> ] };",
+		}
+		for _, kind := range []string{"action", "resource"} {
+			code, line, col := extractCaret(b, cases[kind])
+			b.Run(fmt.Sprintf("policies=%d/%s", n, kind), func(b *testing.B) {
+				b.ReportAllocs()
+				for i := 0; i < b.N; i++ {
+					if _, _, err := Complete(code, line, col, 0, hints); err != nil {
+						b.Fatal(err)
+					}
+				}
+			})
+		}
+	}
+}
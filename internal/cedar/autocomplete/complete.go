@@ -72,13 +72,8 @@ func Complete(input string, line, column, maxItems int, hints Hints) ([]Item, Re
 	}
 
 	prefix := string(runes[start:offset])
-	normalizedPrefix, segmentPrefix := normalizePrefix(prefix)
-
-	context := detectContexts(input, runes, offset, byteOffset)
-
-	candidates := gatherCandidates(context, hints)
-
-	items := selectAndRank(candidates, normalizedPrefix, segmentPrefix, maxItems)
+	context := detectContexts(input, byteOffset, statelessAnalyzer{})
+	items := completionItems(context, prefix, maxItems, hints)
 
 	replaceRange := ReplaceRange{
 		Start: offsetToPosition(runes, start),
@@ -88,6 +83,14 @@ func Complete(input string, line, column, maxItems int, hints Hints) ([]Item, Re
 	return items, replaceRange, nil
 }
 
+// completionItems ranks the candidates for a detected context against the
+// partial token under the cursor.
+func completionItems(ctx detectedContext, prefix string, maxItems int, hints Hints) []Item {
+	normalizedPrefix, segmentPrefix := normalizePrefix(prefix)
+	candidates := gatherCandidates(ctx, hints)
+	return selectAndRank(candidates, normalizedPrefix, segmentPrefix, maxItems)
+}
+
 type candidate struct {
 	item      Item
 	priority  int
@@ -264,7 +267,25 @@ type detectedContext struct {
 	permitArgsEmpty   bool
 }
 
-func detectContexts(input string, runes []rune, runeOffset, byteOffset int) detectedContext {
+// contextAnalyzer supplies the parse-backed parts of context detection. The
+// stateless analyzer parses on every call; Document answers from its
+// per-segment cache.
+type contextAnalyzer interface {
+	analyzeAST(input string, byteOffset int) (astAnalysis, string, bool)
+	analyzeLint(snippet string) lintAnalysis
+}
+
+type statelessAnalyzer struct{}
+
+func (statelessAnalyzer) analyzeAST(input string, byteOffset int) (astAnalysis, string, bool) {
+	return analyzeContextWithAST(input, byteOffset)
+}
+
+func (statelessAnalyzer) analyzeLint(snippet string) lintAnalysis {
+	return analyzeContextWithLint(snippet)
+}
+
+func detectContexts(input string, byteOffset int, analyzer contextAnalyzer) detectedContext {
 	before := input[:byteOffset]
 	beforeLower := strings.ToLower(before)
 
@@ -291,7 +312,7 @@ func detectContexts(input string, runes []rune, runeOffset, byteOffset int) dete
 	ctx.permitArgsEmpty = permitEmpty
 
 	var snippet string
-	if astInfo, snip, ok := analyzeContextWithAST(input, byteOffset); ok {
+	if astInfo, snip, ok := analyzer.analyzeAST(input, byteOffset); ok {
 		snippet = snip
 		ctx.mcpPolicy = astInfo.hasMCP
 		ctx.httpRewritePolicy = astInfo.hasHttpRewrite
@@ -302,7 +323,7 @@ func detectContexts(input string, runes []rune, runeOffset, byteOffset int) dete
 			snippet = snip
 		}
 		if snippet != "" {
-			if lintInfo := analyzeContextWithLint(snippet); lintInfo.valid {
+			if lintInfo := analyzer.analyzeLint(snippet); lintInfo.valid {
 				ctx.needsAction = ctx.needsAction || lintInfo.missingAction
 				ctx.needsResource = ctx.needsResource || lintInfo.missingResource
 				ctx.mcpPolicy = ctx.mcpPolicy || lintInfo.hasMCP
@@ -517,12 +538,7 @@ func analyzeContextWithAST(input string, byteOffset int) (astAnalysis, string, b
 		if byteOffset < seg.start || byteOffset > seg.end {
 			continue
 		}
-		analysis := astAnalysis{
-			hasMCP:          policyHasAction(seg.policy, "McpCall"),
-			hasHttpRewrite:  policyHasAction(seg.policy, "HttpRewrite"),
-			missingAction:   policyMissingAction(seg.policy),
-			missingResource: policyMissingResource(seg.policy),
-		}
+		analysis := analyzePolicy(seg.policy)
 		start := seg.start
 		end := seg.end
 		if start < 0 {
@@ -537,6 +553,15 @@ func analyzeContextWithAST(input string, byteOffset int) (astAnalysis, string, b
 	return astAnalysis{}, "", false
 }
 
+func analyzePolicy(policy transpiler.CedarPolicy) astAnalysis {
+	return astAnalysis{
+		hasMCP:          policyHasAction(policy, "McpCall"),
+		hasHttpRewrite:  policyHasAction(policy, "HttpRewrite"),
+		missingAction:   policyMissingAction(policy),
+		missingResource: policyMissingResource(policy),
+	}
+}
+
 func buildPolicySegments(input string, policies []transpiler.CedarPolicy) []policySegment {
 	segments := make([]policySegment, 0, len(policies))
 	for _, pol := range policies {
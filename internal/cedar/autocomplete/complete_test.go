@@ -222,7 +222,7 @@ func TestCompletePermitSuggestsActionNotEquals(t *testing.T) {
 	}
 }
 
-func extractCaret(t *testing.T, src string) (string, int, int) {
+func extractCaret(t testing.TB, src string) (string, int, int) {
 	t.Helper()
 	const marker = "<caret>"
 	idx := strings.Index(src, marker)
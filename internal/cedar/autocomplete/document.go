@@ -0,0 +1,431 @@
+package autocomplete
+
+import (
+	"container/list"
+	"errors"
+	"sort"
+	"strings"
+	"sync"
+	"unicode"
+	"unicode/utf8"
+
+	"github.com/strongdm/leash/internal/transpiler"
+)
+
+// ErrVersionMismatch is returned by ApplyEdits when the edits were made against
+// a different version than the one the document holds. Callers should resend
+// the full buffer.
+var ErrVersionMismatch = errors.New("autocomplete: document version mismatch")
+
+const (
+	defaultDocumentCacheSize = 32
+	maxLintCacheEntries      = 64
+)
+
+// Edit replaces Range in the document with Text. Positions are 1-based with the
+// same line/column semantics as Complete; End is exclusive.
+type Edit struct {
+	Range ReplaceRange `json:"range"`
+	Text  string       `json:"text"`
+}
+
+// Document is an editor buffer kept across completion requests. It tracks
+// policy statement boundaries lexically and caches the Cedar parse of each
+// statement by its text, so an edit only re-parses the statement it touches
+// and only when a completion lands inside it.
+//
+// Unlike Complete, which parses the whole buffer and falls back to heuristics
+// when any statement is invalid, a Document parses statements independently:
+// a half-typed policy elsewhere in the file does not disable AST-backed
+// context for the statement under the cursor.
+type Document struct {
+	mu      sync.Mutex
+	version int
+	text    string
+
+	// lineStarts holds the byte offset of each line in text.
+	lineStarts []int
+	// spans are the statement boundaries in text, in order.
+	spans []segmentSpan
+
+	parsed map[string]segmentAnalysis
+	linted map[string]lintAnalysis
+}
+
+type segmentSpan struct {
+	start int
+	end   int
+}
+
+type segmentAnalysis struct {
+	analysis astAnalysis
+	ok       bool
+}
+
+// NewDocument returns a document holding text at version.
+func NewDocument(version int, text string) *Document {
+	d := &Document{}
+	d.Update(version, text)
+	return d
+}
+
+// Version reports the version of the text the document currently holds.
+func (d *Document) Version() int {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	return d.version
+}
+
+// Text returns the current buffer.
+func (d *Document) Text() string {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	return d.text
+}
+
+// Update replaces the whole buffer. Statement boundaries before the first
+// changed byte and parses of statements whose text is unchanged are kept, so
+// clients that resend the full buffer still get incremental re-parsing.
+func (d *Document) Update(version int, text string) {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	d.version = version
+	d.reindex(text, commonPrefixLen(d.text, text))
+}
+
+// ApplyEdits applies edits in order to the buffer at baseVersion and moves the
+// document to version. Each edit's range refers to the text produced by the
+// edits before it.
+func (d *Document) ApplyEdits(baseVersion, version int, edits []Edit) error {
+	d.mu.Lock()
+	defer d.mu.Unlock()
+	if baseVersion != d.version {
+		return ErrVersionMismatch
+	}
+
+	text := d.text
+	lineStarts := d.lineStarts
+	dirty := len(text)
+	for i, edit := range edits {
+		start := byteOffsetAt(text, lineStarts, edit.Range.Start.Line, edit.Range.Start.Column)
+		end := byteOffsetAt(text, lineStarts, edit.Range.End.Line, edit.Range.End.Column)
+		if end < start {
+			start, end = end, start
+		}
+		text = text[:start] + edit.Text + text[end:]
+		if i+1 < len(edits) {
+			lineStarts = indexLines(text)
+		}
+		dirty = min(dirty, start)
+	}
+
+	d.version = version
+	d.reindex(text, dirty)
+	return nil
+}
+
+// Complete is the cached equivalent of the package-level Complete.
+func (d *Document) Complete(line, column, maxItems int, hints Hints) ([]Item, ReplaceRange, error) {
+	if maxItems <= 0 {
+		maxItems = defaultMaxItems
+	}
+	if line < 1 {
+		line = 1
+	}
+	if column < 1 {
+		column = 1
+	}
+
+	d.mu.Lock()
+	defer d.mu.Unlock()
+
+	input := d.text
+	byteOffset := byteOffsetAt(input, d.lineStarts, line, column)
+
+	if inComment(input, byteOffset) {
+		empty := ReplaceRange{
+			Start: Position{Line: line, Column: column},
+			End:   Position{Line: line, Column: column},
+		}
+		return nil, empty, nil
+	}
+
+	start, end := tokenBoundsBytes(input, byteOffset)
+	context := detectContexts(input, byteOffset, d)
+	items := completionItems(context, input[start:byteOffset], maxItems, hints)
+
+	replaceRange := ReplaceRange{
+		Start: positionAt(input, d.lineStarts, start),
+		End:   positionAt(input, d.lineStarts, end),
+	}
+	return items, replaceRange, nil
+}
+
+// reindex installs text, keeping statement spans that end before dirty and
+// rescanning the rest. Cached parses are pruned to statements still present.
+func (d *Document) reindex(text string, dirty int) {
+	d.text = text
+	d.lineStarts = indexLines(text)
+
+	keep := 0
+	for keep < len(d.spans) && d.spans[keep].end < dirty && d.spans[keep].end <= len(text) && text[d.spans[keep].end-1] == ';' {
+		keep++
+	}
+	from := 0
+	if keep > 0 {
+		from = d.spans[keep-1].end
+	}
+	d.spans = append(d.spans[:keep], scanSegments(text, from)...)
+
+	if len(d.parsed) > 0 {
+		live := make(map[string]segmentAnalysis, len(d.spans))
+		for _, span := range d.spans {
+			key := text[span.start:span.end]
+			if cached, ok := d.parsed[key]; ok {
+				live[key] = cached
+			}
+		}
+		d.parsed = live
+	}
+}
+
+// analyzeAST implements contextAnalyzer using the statement under the cursor.
+func (d *Document) analyzeAST(input string, byteOffset int) (astAnalysis, string, bool) {
+	idx := sort.Search(len(d.spans), func(i int) bool {
+		return d.spans[i].end >= byteOffset
+	})
+	if idx == len(d.spans) || d.spans[idx].start > byteOffset {
+		return astAnalysis{}, "", false
+	}
+	snippet := input[d.spans[idx].start:d.spans[idx].end]
+
+	cached, ok := d.parsed[snippet]
+	if !ok {
+		cached = parseSegment(snippet)
+		if d.parsed == nil {
+			d.parsed = make(map[string]segmentAnalysis)
+		}
+		d.parsed[snippet] = cached
+	}
+	if !cached.ok {
+		return astAnalysis{}, "", false
+	}
+	return cached.analysis, snippet, true
+}
+
+// analyzeLint implements contextAnalyzer with a small memo, since the
+// heuristic snippet for an unparseable statement repeats across keystrokes
+// that do not touch it.
+func (d *Document) analyzeLint(snippet string) lintAnalysis {
+	if cached, ok := d.linted[snippet]; ok {
+		return cached
+	}
+	info := analyzeContextWithLint(snippet)
+	if d.linted == nil || len(d.linted) >= maxLintCacheEntries {
+		d.linted = make(map[string]lintAnalysis)
+	}
+	d.linted[snippet] = info
+	return info
+}
+
+func parseSegment(snippet string) segmentAnalysis {
+	parser := transpiler.NewCedarParser()
+	if parser == nil {
+		return segmentAnalysis{}
+	}
+	policySet, err := parser.ParseFromNamedString("completion.cedar", snippet)
+	if err != nil || policySet == nil || len(policySet.Policies) != 1 {
+		return segmentAnalysis{}
+	}
+	return segmentAnalysis{analysis: analyzePolicy(policySet.Policies[0]), ok: true}
+}
+
+// scanSegments splits text[from:] into statements without parsing: each starts
+// at the first token after whitespace and comments and ends after its
+// top-level semicolon (or at end of input).
+func scanSegments(text string, from int) []segmentSpan {
+	var spans []segmentSpan
+	for {
+		start := skipTrivia(text, from)
+		if start >= len(text) {
+			return spans
+		}
+		end := findPolicyEndBytes(text, start)
+		if end <= start {
+			return spans
+		}
+		spans = append(spans, segmentSpan{start: start, end: end})
+		from = end
+	}
+}
+
+func skipTrivia(text string, i int) int {
+	for i < len(text) {
+		switch {
+		case strings.HasPrefix(text[i:], "//"):
+			nl := strings.IndexByte(text[i:], '\n')
+			if nl == -1 {
+				return len(text)
+			}
+			i += nl + 1
+		case strings.HasPrefix(text[i:], "/*"):
+			closing := strings.Index(text[i+2:], "*/")
+			if closing == -1 {
+				return len(text)
+			}
+			i += 2 + closing + 2
+		default:
+			r, size := utf8.DecodeRuneInString(text[i:])
+			if !unicode.IsSpace(r) {
+				return i
+			}
+			i += size
+		}
+	}
+	return i
+}
+
+func commonPrefixLen(a, b string) int {
+	n := min(len(a), len(b))
+	for i := 0; i < n; i++ {
+		if a[i] != b[i] {
+			return i
+		}
+	}
+	return n
+}
+
+func indexLines(text string) []int {
+	starts := make([]int, 1, strings.Count(text, "\n")+1)
+	for i := 0; i < len(text); {
+		nl := strings.IndexByte(text[i:], '\n')
+		if nl == -1 {
+			break
+		}
+		i += nl + 1
+		starts = append(starts, i)
+	}
+	return starts
+}
+
+// byteOffsetAt mirrors positionToOffset over a line index: columns count runes,
+// a column past the end of its line lands at the start of the next line, and a
+// line past the end lands at the end of the input.
+func byteOffsetAt(text string, lineStarts []int, line, column int) int {
+	if line < 1 {
+		line = 1
+	}
+	if column < 1 {
+		column = 1
+	}
+	if len(text) == 0 {
+		return 0
+	}
+	if line > len(lineStarts) {
+		return len(text)
+	}
+	off := lineStarts[line-1]
+	for col := 1; col < column && off < len(text); col++ {
+		r, size := utf8.DecodeRuneInString(text[off:])
+		if r == '\n' {
+			return off + 1
+		}
+		off += size
+	}
+	return off
+}
+
+// positionAt mirrors offsetToPosition for a byte offset.
+func positionAt(text string, lineStarts []int, offset int) Position {
+	if offset < 0 {
+		offset = 0
+	}
+	if offset > len(text) {
+		offset = len(text)
+	}
+	idx := sort.Search(len(lineStarts), func(i int) bool {
+		return lineStarts[i] > offset
+	}) - 1
+	if idx < 0 {
+		idx = 0
+	}
+	return Position{
+		Line:   idx + 1,
+		Column: utf8.RuneCountInString(text[lineStarts[idx]:offset]) + 1,
+	}
+}
+
+// tokenBoundsBytes mirrors tokenBounds for a byte offset.
+func tokenBoundsBytes(text string, offset int) (int, int) {
+	start := offset
+	for start > 0 {
+		r, size := utf8.DecodeLastRuneInString(text[:start])
+		if !isTokenRune(r) {
+			break
+		}
+		start -= size
+	}
+	end := offset
+	for end < len(text) {
+		r, size := utf8.DecodeRuneInString(text[end:])
+		if !isTokenRune(r) {
+			break
+		}
+		end += size
+	}
+	return start, end
+}
+
+// DocumentCache holds the most recently used documents by client-chosen ID.
+type DocumentCache struct {
+	mu    sync.Mutex
+	max   int
+	order *list.List
+	docs  map[string]*list.Element
+}
+
+type cachedDocument struct {
+	id  string
+	doc *Document
+}
+
+// NewDocumentCache returns a cache holding up to size documents (a default
+// when size is not positive).
+func NewDocumentCache(size int) *DocumentCache {
+	if size <= 0 {
+		size = defaultDocumentCacheSize
+	}
+	return &DocumentCache{
+		max:   size,
+		order: list.New(),
+		docs:  make(map[string]*list.Element),
+	}
+}
+
+// Get returns the document for id, or nil when it is not cached.
+func (c *DocumentCache) Get(id string) *Document {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if el, ok := c.docs[id]; ok {
+		c.order.MoveToFront(el)
+		return el.Value.(*cachedDocument).doc
+	}
+	return nil
+}
+
+// Put stores doc under id, evicting the least recently used entry when full.
+func (c *DocumentCache) Put(id string, doc *Document) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if el, ok := c.docs[id]; ok {
+		el.Value.(*cachedDocument).doc = doc
+		c.order.MoveToFront(el)
+		return
+	}
+	c.docs[id] = c.order.PushFront(&cachedDocument{id: id, doc: doc})
+	for c.order.Len() > c.max {
+		oldest := c.order.Back()
+		c.order.Remove(oldest)
+		delete(c.docs, oldest.Value.(*cachedDocument).id)
+	}
+}
@@ -0,0 +1,154 @@
+package autocomplete
+
+import (
+	"errors"
+	"fmt"
+	"reflect"
+	"strings"
+	"testing"
+)
+
+const documentFixture = `permit (principal, action == Action::"FileOpen", resource)
+    when { resource in [ Dir::"/tmp/" ] };
+
+forbid (principal, action == Action::"NetworkConnect", resource == Host::"example.com");
+
+permit (principal, action, resource)
+    when { resource in [ Dir::"/var/lib/" ] };`
+
+func TestDocumentCompleteMatchesStateless(t *testing.T) {
+	t.Parallel()
+
+	doc := NewDocument(1, documentFixture)
+	lines := strings.Split(documentFixture, "\n")
+	for lineIdx, text := range lines {
+		for col := 1; col <= len(text)+1; col++ {
+			wantItems, wantRange, err := Complete(documentFixture, lineIdx+1, col, 0, Hints{})
+			if err != nil {
+				t.Fatalf("Complete returned error: %v", err)
+			}
+			gotItems, gotRange, err := doc.Complete(lineIdx+1, col, 0, Hints{})
+			if err != nil {
+				t.Fatalf("Document.Complete returned error: %v", err)
+			}
+			if gotRange != wantRange {
+				t.Fatalf("%d:%d: range %+v, want %+v", lineIdx+1, col, gotRange, wantRange)
+			}
+			if !reflect.DeepEqual(labels(gotItems), labels(wantItems)) {
+				t.Fatalf("%d:%d: items %v, want %v", lineIdx+1, col, labels(gotItems), labels(wantItems))
+			}
+		}
+	}
+}
+
+func TestDocumentApplyEditsReparsesTouchedStatement(t *testing.T) {
+	t.Parallel()
+
+	doc := NewDocument(1, documentFixture)
+	for line := 1; line <= 7; line++ {
+		if _, _, err := doc.Complete(line, 10, 0, Hints{}); err != nil {
+			t.Fatalf("Complete returned error: %v", err)
+		}
+	}
+	first := documentFixture[:strings.Index(documentFixture, ";")+1]
+	if _, ok := doc.parsed[first]; !ok {
+		t.Fatalf("expected first statement to be cached after completion")
+	}
+
+	// Fill in the missing action of the last statement.
+	edit := Edit{
+		Range: ReplaceRange{Start: Position{Line: 6, Column: 26}, End: Position{Line: 6, Column: 26}},
+		Text:  ` == Action::"FileOpen"`,
+	}
+	if err := doc.ApplyEdits(1, 2, []Edit{edit}); err != nil {
+		t.Fatalf("ApplyEdits returned error: %v", err)
+	}
+	want := strings.Replace(documentFixture, "permit (principal, action, resource)", `permit (principal, action == Action::"FileOpen", resource)`, 1)
+	if doc.Text() != want {
+		t.Fatalf("unexpected text after edit:\n%s", doc.Text())
+	}
+	if doc.Version() != 2 {
+		t.Fatalf("expected version 2, got %d", doc.Version())
+	}
+	if _, ok := doc.parsed[first]; !ok {
+		t.Fatalf("expected untouched statement to keep its cached parse")
+	}
+
+	items, _, err := doc.Complete(7, 27, 0, Hints{})
+	if err != nil {
+		t.Fatalf("Complete returned error: %v", err)
+	}
+	wantItems, _, _ := Complete(want, 7, 27, 0, Hints{})
+	if !reflect.DeepEqual(labels(items), labels(wantItems)) {
+		t.Fatalf("items %v, want %v", labels(items), labels(wantItems))
+	}
+}
+
+func TestDocumentApplyEditsRejectsStaleVersion(t *testing.T) {
+	t.Parallel()
+
+	doc := NewDocument(3, "permit (principal, action, resource);")
+	err := doc.ApplyEdits(2, 4, []Edit{{Text: "x"}})
+	if !errors.Is(err, ErrVersionMismatch) {
+		t.Fatalf("expected ErrVersionMismatch, got %v", err)
+	}
+	if doc.Version() != 3 || doc.Text() != "permit (principal, action, resource);" {
+		t.Fatalf("document changed despite rejected edit")
+	}
+}
+
+func TestDocumentCacheEvictsLeastRecentlyUsed(t *testing.T) {
+	t.Parallel()
+
+	cache := NewDocumentCache(2)
+	a, b, c := NewDocument(1, "a"), NewDocument(1, "b"), NewDocument(1, "c")
+	cache.Put("a", a)
+	cache.Put("b", b)
+	if cache.Get("a") != a {
+		t.Fatalf("expected a to be cached")
+	}
+	cache.Put("c", c)
+	if cache.Get("b") != nil {
+		t.Fatalf("expected b to be evicted")
+	}
+	if cache.Get("a") != a || cache.Get("c") != c {
+		t.Fatalf("expected a and c to remain cached")
+	}
+}
+
+func BenchmarkDocumentCompleteLargeFile(b *testing.B) {
+	var sb strings.Builder
+	for i := 0; i < 2000; i++ {
+		fmt.Fprintf(&sb, "permit (principal, action == Action::\"NetworkConnect\", resource == Host::\"host%d.example.com\");\n", i)
+	}
+	sb.WriteString("permit (principal, action == Action::\"FileOpen\", resource)\n    when { resource in [  ] };")
+	text := sb.String()
+	lastLine := strings.Count(text, "\n") + 1
+
+	b.Run("stateless", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, _, err := Complete(text, lastLine, 25, 0, Hints{}); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("document", func(b *testing.B) {
+		doc := NewDocument(0, text)
+		insert := ReplaceRange{Start: Position{Line: lastLine, Column: 25}, End: Position{Line: lastLine, Column: 25}}
+		remove := ReplaceRange{Start: Position{Line: lastLine, Column: 25}, End: Position{Line: lastLine, Column: 26}}
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			// Type and delete a character, as an editor would send per keystroke.
+			if err := doc.ApplyEdits(2*i, 2*i+1, []Edit{{Range: insert, Text: "D"}}); err != nil {
+				b.Fatal(err)
+			}
+			if err := doc.ApplyEdits(2*i+1, 2*i+2, []Edit{{Range: remove}}); err != nil {
+				b.Fatal(err)
+			}
+			if _, _, err := doc.Complete(lastLine, 25, 0, Hints{}); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
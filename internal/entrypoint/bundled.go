@@ -2,12 +2,15 @@ package entrypoint
 
 import (
 	"bytes"
+	"crypto/sha256"
+	"encoding/hex"
 	"fmt"
 	"io"
 	"os"
 	"os/exec"
 	"path/filepath"
 	"runtime"
+	"strconv"
 	"strings"
 	"sync"
 
@@ -23,6 +26,12 @@ import (
 const (
 	ReadyFileName          = "leash-entry.ready"
 	BootstrapReadyFileName = "bootstrap.ready"
+	// CABundleFileName is the merged trust bundle (system roots plus the leash
+	// CA) that leash-entry publishes in the share dir for SSL_CERT_FILE and
+	// friends; CABundleCacheDirName holds the per-image bundles it is copied
+	// from.
+	CABundleFileName     = "ca-bundle.pem"
+	CABundleCacheDirName = "ca-bundles"
 )
 
 var (
@@ -32,7 +41,9 @@ var (
 
 // InflateBinaries expands the bundled leash-entry binaries into dir and writes a
 // ready marker once complete. The operation is idempotent and safe to call
-// concurrently.
+// concurrently. A binary already in dir whose content hashes to the bundled
+// binary's digest is left alone, and one extracted by an earlier session is
+// copied from the extraction cache instead of being decompressed again.
 func InflateBinaries(dir string) error {
 	if dir == "" {
 		return fmt.Errorf("directory required")
@@ -79,7 +90,7 @@ func InflateBinaries(dir string) error {
 	}
 
 	marker := filepath.Join(dir, ReadyFileName)
-	if err := os.WriteFile(marker, []byte("1"), 0o644); err != nil {
+	if err := writeFileAtomic(marker, []byte("1"), 0o644); err != nil {
 		return fmt.Errorf("failed to write ready marker: %w", err)
 	}
 	return nil
@@ -95,27 +106,304 @@ func extractBinary(dir, name string, blob []byte) error {
 		return fmt.Errorf("embedded binary %s missing", name)
 	}
 
+	// dir is shared read-write with the target container, so nothing in it
+	// is trusted: an existing binary is kept only if it hashes to the digest
+	// recorded in the extraction cache, or to the bundled binary's own.
 	target := filepath.Join(dir, name)
-	tmp, err := os.CreateTemp(dir, name+".tmp-*")
+	source := blobDigest(blob)
+	cacheDir := entryCacheDir(source)
+	want, cached := cachedStamp(cacheDir, name, source)
+	if _, err := os.Lstat(target); err == nil {
+		if !cached {
+			var err error
+			if want, err = contentStamp(blob); err != nil {
+				return err
+			}
+		}
+		if want.matchesContent(target) {
+			return nil
+		}
+	}
+
+	if cached {
+		if err := copyVerified(filepath.Join(cacheDir, name), target, want, 0o755); err == nil {
+			return nil
+		}
+	}
+
+	st, err := decompressTo(dir, name, blob, target)
 	if err != nil {
 		return err
 	}
+	st.source = source
+	rememberContent(blob, st)
+	if cacheDir != "" {
+		populateCache(cacheDir, name, target, st)
+	}
+	return nil
+}
+
+// decompressTo inflates blob into target via a temporary file in dir and
+// returns the digest of what it wrote.
+func decompressTo(dir, name string, blob []byte, target string) (stamp, error) {
+	tmp, err := os.CreateTemp(dir, name+".tmp-*")
+	if err != nil {
+		return stamp{}, err
+	}
 	tmpPath := tmp.Name()
 
 	zr, err := zstd.NewReader(bytes.NewReader(blob))
 	if err != nil {
 		tmp.Close()
 		os.Remove(tmpPath)
-		return fmt.Errorf("create zstd reader: %w", err)
+		return stamp{}, fmt.Errorf("create zstd reader: %w", err)
 	}
 	defer zr.Close()
 
-	if _, err := io.Copy(tmp, zr); err != nil {
+	h := sha256.New()
+	n, err := io.Copy(io.MultiWriter(tmp, h), zr)
+	if err != nil {
 		tmp.Close()
 		os.Remove(tmpPath)
-		return fmt.Errorf("decompress binary: %w", err)
+		return stamp{}, fmt.Errorf("decompress binary: %w", err)
 	}
 	if err := tmp.Chmod(0o755); err != nil {
+		tmp.Close()
+		os.Remove(tmpPath)
+		return stamp{}, err
+	}
+	if err := tmp.Close(); err != nil {
+		os.Remove(tmpPath)
+		return stamp{}, err
+	}
+	if err := os.Rename(tmpPath, target); err != nil {
+		os.Remove(tmpPath)
+		return stamp{}, err
+	}
+	return stamp{content: hex.EncodeToString(h.Sum(nil)), size: n}, nil
+}
+
+// stamp is the digest sidecar kept next to a cached binary: the SHA-256 of
+// the compressed blob it came from, and the SHA-256 and size of the binary
+// itself.
+type stamp struct {
+	source  string
+	content string
+	size    int64
+}
+
+func stampPath(target string) string { return target + ".sha256" }
+
+func readStamp(target string) (stamp, bool) {
+	data, err := os.ReadFile(stampPath(target))
+	if err != nil {
+		return stamp{}, false
+	}
+	fields := strings.Fields(string(data))
+	if len(fields) != 3 {
+		return stamp{}, false
+	}
+	size, err := strconv.ParseInt(fields[2], 10, 64)
+	if err != nil {
+		return stamp{}, false
+	}
+	return stamp{source: fields[0], content: fields[1], size: size}, true
+}
+
+func writeStamp(target string, st stamp) error {
+	line := fmt.Sprintf("%s %s %d\n", st.source, st.content, st.size)
+	return writeFileAtomic(stampPath(target), []byte(line), 0o444)
+}
+
+// matchesContent reports whether target is an executable regular file, not
+// a symlink, whose SHA-256 is the recorded digest.
+func (st stamp) matchesContent(target string) bool {
+	info, err := os.Lstat(target)
+	if err != nil || !info.Mode().IsRegular() || info.Mode().Perm()&0o111 == 0 || info.Size() != st.size {
+		return false
+	}
+	f, err := os.Open(target)
+	if err != nil {
+		return false
+	}
+	defer f.Close()
+	h := sha256.New()
+	if _, err := io.Copy(h, f); err != nil {
+		return false
+	}
+	return hex.EncodeToString(h.Sum(nil)) == st.content
+}
+
+var (
+	blobDigestsMu sync.Mutex
+	blobDigests   = map[*byte]string{}
+)
+
+// blobDigest returns the SHA-256 of an embedded blob, computed once per
+// process.
+func blobDigest(blob []byte) string {
+	blobDigestsMu.Lock()
+	defer blobDigestsMu.Unlock()
+	if d, ok := blobDigests[&blob[0]]; ok {
+		return d
+	}
+	sum := sha256.Sum256(blob)
+	d := hex.EncodeToString(sum[:])
+	blobDigests[&blob[0]] = d
+	return d
+}
+
+var (
+	contentStampsMu sync.Mutex
+	contentStamps   = map[*byte]stamp{}
+)
+
+// contentStamp returns the digest and size of the binary an embedded blob
+// inflates to, decompressing it without writing it out at most once per
+// process.
+func contentStamp(blob []byte) (stamp, error) {
+	contentStampsMu.Lock()
+	st, ok := contentStamps[&blob[0]]
+	contentStampsMu.Unlock()
+	if ok {
+		return st, nil
+	}
+	zr, err := zstd.NewReader(bytes.NewReader(blob))
+	if err != nil {
+		return stamp{}, fmt.Errorf("create zstd reader: %w", err)
+	}
+	defer zr.Close()
+	h := sha256.New()
+	n, err := io.Copy(h, zr)
+	if err != nil {
+		return stamp{}, fmt.Errorf("decompress binary: %w", err)
+	}
+	st = stamp{source: blobDigest(blob), content: hex.EncodeToString(h.Sum(nil)), size: n}
+	rememberContent(blob, st)
+	return st, nil
+}
+
+func rememberContent(blob []byte, st stamp) {
+	contentStampsMu.Lock()
+	contentStamps[&blob[0]] = st
+	contentStampsMu.Unlock()
+}
+
+// entryCacheDir returns the extraction cache directory for one bundled blob,
+// or "" when there is no cache. LEASH_ENTRY_CACHE_DIR overrides the default
+// under the user cache directory; setting it to "off" disables the cache.
+func entryCacheDir(source string) string {
+	root := strings.TrimSpace(os.Getenv("LEASH_ENTRY_CACHE_DIR"))
+	if root == "off" {
+		return ""
+	}
+	if root == "" {
+		base, err := os.UserCacheDir()
+		if err != nil {
+			return ""
+		}
+		root = filepath.Join(base, "leash", "leash-entry")
+	}
+	return filepath.Join(root, source[:32])
+}
+
+// cachedStamp returns the stamp of the cached copy of name when the cache
+// entry can be trusted: the directory, binary and stamp belong to this user
+// and are not writable by anyone else, and the stamp is for source.
+func cachedStamp(cacheDir, name, source string) (stamp, bool) {
+	if cacheDir == "" {
+		return stamp{}, false
+	}
+	cached := filepath.Join(cacheDir, name)
+	for _, path := range []string{cacheDir, cached, stampPath(cached)} {
+		info, err := os.Lstat(path)
+		if err != nil || info.Mode()&os.ModeSymlink != 0 || info.Mode().Perm()&0o022 != 0 || !ownedByEffectiveUser(info) {
+			return stamp{}, false
+		}
+	}
+	st, ok := readStamp(cached)
+	if !ok || st.source != source {
+		return stamp{}, false
+	}
+	return st, true
+}
+
+// populateCache records a freshly extracted binary in the cache. The binary
+// is copied, never linked, because target sits in the writable share dir;
+// the copy is hashed as it lands so a binary modified since extraction is
+// not cached. Entries and their directory are left read-only (0555).
+func populateCache(cacheDir, name, target string, st stamp) {
+	if err := os.MkdirAll(cacheDir, 0o755); err != nil {
+		return
+	}
+	if err := os.Chmod(cacheDir, 0o755); err != nil {
+		return
+	}
+	defer os.Chmod(cacheDir, 0o555)
+	cached := filepath.Join(cacheDir, name)
+	if err := copyVerified(target, cached, st, 0o555); err != nil {
+		return
+	}
+	_ = writeStamp(cached, st)
+}
+
+// copyVerified copies src to dst, by reflink where the filesystem supports
+// it, and installs the copy with mode only if it matches want.
+func copyVerified(src, dst string, want stamp, mode os.FileMode) error {
+	tmpPath := fmt.Sprintf("%s.tmp-%d", dst, os.Getpid())
+	os.Remove(tmpPath)
+	if err := cloneFile(src, tmpPath); err != nil {
+		if err := copyContents(src, tmpPath); err != nil {
+			os.Remove(tmpPath)
+			return err
+		}
+	}
+	if err := os.Chmod(tmpPath, mode); err != nil {
+		os.Remove(tmpPath)
+		return err
+	}
+	if !want.matchesContent(tmpPath) {
+		os.Remove(tmpPath)
+		return fmt.Errorf("copy of %s does not match its digest", src)
+	}
+	if err := os.Rename(tmpPath, dst); err != nil {
+		os.Remove(tmpPath)
+		return err
+	}
+	return nil
+}
+
+func copyContents(src, dst string) error {
+	in, err := os.Open(src)
+	if err != nil {
+		return err
+	}
+	defer in.Close()
+	out, err := os.OpenFile(dst, os.O_WRONLY|os.O_CREATE|os.O_EXCL, 0o600)
+	if err != nil {
+		return err
+	}
+	if _, err := io.Copy(out, in); err != nil {
+		out.Close()
+		return err
+	}
+	return out.Close()
+}
+
+// writeFileAtomic writes data to path via a temporary file and rename, so
+// readers never see a partial file.
+func writeFileAtomic(path string, data []byte, mode os.FileMode) error {
+	tmp, err := os.CreateTemp(filepath.Dir(path), filepath.Base(path)+".tmp-*")
+	if err != nil {
+		return err
+	}
+	tmpPath := tmp.Name()
+	if _, err := tmp.Write(data); err != nil {
+		tmp.Close()
+		os.Remove(tmpPath)
+		return err
+	}
+	if err := tmp.Chmod(mode); err != nil {
 		tmp.Close()
 		os.Remove(tmpPath)
 		return err
@@ -124,7 +412,7 @@ func extractBinary(dir, name string, blob []byte) error {
 		os.Remove(tmpPath)
 		return err
 	}
-	if err := os.Rename(tmpPath, target); err != nil {
+	if err := os.Rename(tmpPath, path); err != nil {
 		os.Remove(tmpPath)
 		return err
 	}
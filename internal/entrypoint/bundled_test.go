@@ -0,0 +1,145 @@
+package entrypoint
+
+import (
+	"bytes"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/klauspost/compress/zstd"
+)
+
+func testBlob(t *testing.T, payload []byte) []byte {
+	t.Helper()
+	enc, err := zstd.NewWriter(nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer enc.Close()
+	return enc.EncodeAll(payload, nil)
+}
+
+func sameFile(t *testing.T, a, b string) bool {
+	t.Helper()
+	ai, err := os.Stat(a)
+	if err != nil {
+		t.Fatal(err)
+	}
+	bi, err := os.Stat(b)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return os.SameFile(ai, bi)
+}
+
+func TestExtractBinarySkipsMatchingDigest(t *testing.T) {
+	t.Setenv("LEASH_ENTRY_CACHE_DIR", "off")
+
+	payload := bytes.Repeat([]byte("leash-entry"), 1000)
+	blob := testBlob(t, payload)
+	dir := t.TempDir()
+	target := filepath.Join(dir, "leash-entry-linux-amd64")
+
+	if err := extractBinary(dir, "leash-entry-linux-amd64", blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	first, err := os.Stat(target)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := extractBinary(dir, "leash-entry-linux-amd64", blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	second, err := os.Stat(target)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !os.SameFile(first, second) {
+		t.Fatal("expected the second extraction to keep the existing file")
+	}
+
+	// A binary rewritten in place, even at the same size, no longer matches
+	// the bundled digest and is replaced.
+	if err := os.WriteFile(target, bytes.Repeat([]byte("XXXXXXXXXXX"), 1000), 0o755); err != nil {
+		t.Fatal(err)
+	}
+	if err := extractBinary(dir, "leash-entry-linux-amd64", blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	if got, _ := os.ReadFile(target); !bytes.Equal(got, payload) {
+		t.Fatal("expected the rewritten binary to be re-extracted")
+	}
+}
+
+func TestExtractBinaryCopiesFromCache(t *testing.T) {
+	cache := t.TempDir()
+	t.Setenv("LEASH_ENTRY_CACHE_DIR", cache)
+
+	payload := bytes.Repeat([]byte("cached"), 1000)
+	blob := testBlob(t, payload)
+	name := "leash-entry-linux-arm64"
+	cacheDir := entryCacheDir(blobDigest(blob))
+	cached := filepath.Join(cacheDir, name)
+	// The cache directory is left read-only; reopen it so TempDir can clean up.
+	t.Cleanup(func() { os.Chmod(cacheDir, 0o755) })
+
+	first := t.TempDir()
+	if err := extractBinary(first, name, blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	if got, _ := os.ReadFile(cached); !bytes.Equal(got, payload) {
+		t.Fatal("expected the first extraction to seed the cache")
+	}
+	for path, want := range map[string]os.FileMode{cacheDir: 0o555, cached: 0o555, stampPath(cached): 0o444} {
+		if info, err := os.Stat(path); err != nil || info.Mode().Perm() != want {
+			t.Fatalf("expected %s to be read-only (%v), got %v %v", path, want, info.Mode().Perm(), err)
+		}
+	}
+
+	second := t.TempDir()
+	if err := extractBinary(second, name, blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	if sameFile(t, filepath.Join(first, name), cached) || sameFile(t, filepath.Join(second, name), cached) {
+		t.Fatal("a share dir binary must never share the cached inode")
+	}
+	if got, _ := os.ReadFile(filepath.Join(second, name)); !bytes.Equal(got, payload) {
+		t.Fatal("expected the second workspace to get the cached binary")
+	}
+
+	// A target container rewriting its copy must not reach the cache.
+	tampered := bytes.Repeat([]byte("XXXXXX"), 1000)
+	if err := os.WriteFile(filepath.Join(second, name), tampered, 0o755); err != nil {
+		t.Fatal(err)
+	}
+	if got, _ := os.ReadFile(cached); !bytes.Equal(got, payload) {
+		t.Fatal("tampering with a workspace copy changed the cache")
+	}
+	if err := extractBinary(second, name, blob); err != nil {
+		t.Fatalf("extractBinary returned error: %v", err)
+	}
+	if got, _ := os.ReadFile(filepath.Join(second, name)); !bytes.Equal(got, payload) {
+		t.Fatal("expected the tampered workspace copy to be replaced")
+	}
+}
+
+func TestWriteFileAtomicReplaces(t *testing.T) {
+	t.Parallel()
+
+	path := filepath.Join(t.TempDir(), ReadyFileName)
+	for _, want := range []string{"1", "2"} {
+		if err := writeFileAtomic(path, []byte(want), 0o644); err != nil {
+			t.Fatalf("writeFileAtomic returned error: %v", err)
+		}
+		if got, _ := os.ReadFile(path); string(got) != want {
+			t.Fatalf("got %q want %q", got, want)
+		}
+	}
+	entries, err := os.ReadDir(filepath.Dir(path))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(entries) != 1 {
+		t.Fatalf("expected no temporary files left behind, got %d entries", len(entries))
+	}
+}
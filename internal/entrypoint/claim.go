@@ -0,0 +1,57 @@
+package entrypoint
+
+import (
+	"encoding/json"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+)
+
+// PoolClaimFileName is written by the runner into a pooled leash container's
+// share dir to bind its standby daemon to a session.
+const PoolClaimFileName = "pool.claim"
+
+// PoolClaim carries what a standby leashd learns only once a session claims
+// it: the target cgroup to enforce and the session details it reports.
+type PoolClaim struct {
+	CgroupPath    string `json:"cgroup_path"`
+	SessionID     string `json:"session_id,omitempty"`
+	WorkspaceHash string `json:"workspace_hash,omitempty"`
+	Project       string `json:"project,omitempty"`
+	Command       string `json:"command,omitempty"`
+}
+
+// WritePoolClaim atomically writes claim into dir, so a daemon waiting on
+// the file never reads it half written.
+func WritePoolClaim(dir string, claim PoolClaim) error {
+	if strings.TrimSpace(claim.CgroupPath) == "" {
+		return errors.New("pool claim requires a cgroup path")
+	}
+	data, err := json.Marshal(claim)
+	if err != nil {
+		return fmt.Errorf("marshal pool claim: %w", err)
+	}
+	if err := writeFileAtomic(filepath.Join(dir, PoolClaimFileName), append(data, '\n'), 0o644); err != nil {
+		return fmt.Errorf("write pool claim: %w", err)
+	}
+	return nil
+}
+
+// ReadPoolClaim reads and validates the claim at path.
+func ReadPoolClaim(path string) (PoolClaim, error) {
+	var claim PoolClaim
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return claim, err
+	}
+	if err := json.Unmarshal(data, &claim); err != nil {
+		return claim, fmt.Errorf("parse pool claim %s: %w", path, err)
+	}
+	claim.CgroupPath = strings.TrimSpace(claim.CgroupPath)
+	if claim.CgroupPath == "" {
+		return claim, fmt.Errorf("pool claim %s has no cgroup path", path)
+	}
+	return claim, nil
+}
@@ -0,0 +1,52 @@
+package entrypoint
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestPoolClaimRoundTrip(t *testing.T) {
+	t.Parallel()
+
+	dir := t.TempDir()
+	want := PoolClaim{
+		CgroupPath: "/sys/fs/cgroup/system.slice/docker-abc.scope",
+		SessionID:  "session-1",
+		Project:    "demo",
+	}
+	if err := WritePoolClaim(dir, want); err != nil {
+		t.Fatalf("WritePoolClaim returned error: %v", err)
+	}
+	got, err := ReadPoolClaim(filepath.Join(dir, PoolClaimFileName))
+	if err != nil {
+		t.Fatalf("ReadPoolClaim returned error: %v", err)
+	}
+	if got != want {
+		t.Fatalf("claim mismatch: got %+v want %+v", got, want)
+	}
+
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(entries) != 1 {
+		t.Fatalf("expected only the claim file, found %d entries", len(entries))
+	}
+}
+
+func TestPoolClaimRequiresCgroup(t *testing.T) {
+	t.Parallel()
+
+	dir := t.TempDir()
+	if err := WritePoolClaim(dir, PoolClaim{SessionID: "s"}); err == nil {
+		t.Fatal("expected an error for a claim without a cgroup path")
+	}
+	path := filepath.Join(dir, PoolClaimFileName)
+	if err := os.WriteFile(path, []byte(`{"cgroup_path":"  "}`), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := ReadPoolClaim(path); err == nil {
+		t.Fatal("expected an error reading a claim without a cgroup path")
+	}
+}
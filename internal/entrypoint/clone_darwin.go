@@ -0,0 +1,10 @@
+//go:build darwin
+
+package entrypoint
+
+import "golang.org/x/sys/unix"
+
+// cloneFile creates dst as an APFS copy-on-write clone of src.
+func cloneFile(src, dst string) error {
+	return unix.Clonefile(src, dst, 0)
+}
@@ -0,0 +1,9 @@
+//go:build !linux && !darwin
+
+package entrypoint
+
+import "errors"
+
+func cloneFile(src, dst string) error {
+	return errors.New("file cloning not supported")
+}
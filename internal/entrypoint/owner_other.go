@@ -0,0 +1,11 @@
+//go:build !unix
+
+package entrypoint
+
+import "os"
+
+// ownedByEffectiveUser cannot check ownership here, so the extraction cache
+// is never trusted.
+func ownedByEffectiveUser(os.FileInfo) bool {
+	return false
+}
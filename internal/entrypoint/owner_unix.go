@@ -0,0 +1,15 @@
+//go:build unix
+
+package entrypoint
+
+import (
+	"os"
+	"syscall"
+)
+
+// ownedByEffectiveUser reports whether info describes a file owned by the
+// process's effective user.
+func ownedByEffectiveUser(info os.FileInfo) bool {
+	st, ok := info.Sys().(*syscall.Stat_t)
+	return ok && int(st.Uid) == os.Geteuid()
+}
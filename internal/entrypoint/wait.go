@@ -0,0 +1,41 @@
+package entrypoint
+
+import (
+	"context"
+	"os"
+	"path/filepath"
+	"time"
+)
+
+// DefaultWaitPoll is the fallback re-check interval used by WaitForFile when
+// the caller does not supply one.
+const DefaultWaitPoll = 100 * time.Millisecond
+
+// WaitForFile blocks until path exists or ctx is done. Where the platform
+// supports it, the parent directory is watched so the file is noticed as soon
+// as it is created or renamed into place. The path is also re-checked every
+// poll interval, which covers filesystems that do not deliver change
+// notifications, such as bind mounts written from outside the Docker VM.
+func WaitForFile(ctx context.Context, path string, poll time.Duration) error {
+	if poll <= 0 {
+		poll = DefaultWaitPoll
+	}
+	changed, stop := watchDir(filepath.Dir(path))
+	defer stop()
+
+	ticker := time.NewTicker(poll)
+	defer ticker.Stop()
+	for {
+		if _, err := os.Stat(path); err == nil {
+			return nil
+		} else if !os.IsNotExist(err) {
+			return err
+		}
+		select {
+		case <-ctx.Done():
+			return ctx.Err()
+		case <-changed:
+		case <-ticker.C:
+		}
+	}
+}
@@ -0,0 +1,40 @@
+//go:build linux
+
+package entrypoint
+
+import (
+	"os"
+
+	"golang.org/x/sys/unix"
+)
+
+// watchDir reports entries created in or moved into dir using inotify. The
+// returned channel is nil, and only polling applies, when a watch cannot be
+// established.
+func watchDir(dir string) (<-chan struct{}, func()) {
+	fd, err := unix.InotifyInit1(unix.IN_NONBLOCK | unix.IN_CLOEXEC)
+	if err != nil {
+		return nil, func() {}
+	}
+	if _, err := unix.InotifyAddWatch(fd, dir, unix.IN_CREATE|unix.IN_MOVED_TO|unix.IN_CLOSE_WRITE); err != nil {
+		unix.Close(fd)
+		return nil, func() {}
+	}
+	// A non-blocking descriptor is handed to the runtime poller, so closing
+	// the file wakes the reader below.
+	f := os.NewFile(uintptr(fd), "inotify")
+	changed := make(chan struct{}, 1)
+	go func() {
+		buf := make([]byte, 4096)
+		for {
+			if _, err := f.Read(buf); err != nil {
+				return
+			}
+			select {
+			case changed <- struct{}{}:
+			default:
+			}
+		}
+	}()
+	return changed, func() { f.Close() }
+}
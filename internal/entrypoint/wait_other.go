@@ -0,0 +1,8 @@
+//go:build !linux
+
+package entrypoint
+
+// watchDir has no change notifications on this platform; WaitForFile polls.
+func watchDir(string) (<-chan struct{}, func()) {
+	return nil, func() {}
+}
@@ -0,0 +1,72 @@
+package entrypoint
+
+import (
+	"context"
+	"errors"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+func TestWaitForFileSeesRename(t *testing.T) {
+	t.Parallel()
+
+	dir := t.TempDir()
+	path := filepath.Join(dir, BootstrapReadyFileName)
+	go func() {
+		time.Sleep(20 * time.Millisecond)
+		tmp := filepath.Join(dir, "bootstrap.ready.tmp")
+		if err := os.WriteFile(tmp, []byte("{}\n"), 0o644); err == nil {
+			_ = os.Rename(tmp, path)
+		}
+	}()
+
+	// A long poll interval means only a change notification can finish the
+	// wait promptly; platforms without one fall back to the poll.
+	poll := 10 * time.Second
+	if watch, stop := watchDir(dir); watch == nil {
+		poll = 10 * time.Millisecond
+	} else {
+		stop()
+	}
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	start := time.Now()
+	if err := WaitForFile(ctx, path, poll); err != nil {
+		t.Fatalf("WaitForFile returned error: %v", err)
+	}
+	if elapsed := time.Since(start); elapsed > 2*time.Second {
+		t.Fatalf("WaitForFile took %s", elapsed)
+	}
+}
+
+func TestWaitForFileHonoursContext(t *testing.T) {
+	t.Parallel()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 50*time.Millisecond)
+	defer cancel()
+	err := WaitForFile(ctx, filepath.Join(t.TempDir(), "missing"), 10*time.Millisecond)
+	if !errors.Is(err, context.DeadlineExceeded) {
+		t.Fatalf("expected deadline exceeded, got %v", err)
+	}
+}
+
+func TestWaitForFileMissingDirectoryPolls(t *testing.T) {
+	t.Parallel()
+
+	dir := filepath.Join(t.TempDir(), "later")
+	path := filepath.Join(dir, ReadyFileName)
+	go func() {
+		time.Sleep(20 * time.Millisecond)
+		if err := os.MkdirAll(dir, 0o755); err == nil {
+			_ = os.WriteFile(path, []byte("1"), 0o644)
+		}
+	}()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	if err := WaitForFile(ctx, path, 10*time.Millisecond); err != nil {
+		t.Fatalf("WaitForFile returned error: %v", err)
+	}
+}
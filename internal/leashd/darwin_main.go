@@ -156,6 +156,8 @@ func serveDarwinHTTP(
 
 	suggest := newSuggestAPI(policyManager, wsHub)
 	suggest.register(mux)
+	stopSuggest := suggest.start()
+	defer stopSuggest()
 
 	server := httpserver.NewWebServer(bind, mux)
 
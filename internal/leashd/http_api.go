@@ -16,6 +16,7 @@ import (
 	"strconv"
 	"strings"
 	"sync"
+	"time"
 
 	cedarutil "github.com/strongdm/leash/internal/cedar"
 	autocomplete "github.com/strongdm/leash/internal/cedar/autocomplete"
@@ -51,8 +52,32 @@ type policyAPI struct {
 
 	mitmProxy *proxy.MITMProxy
 	wsHub     *websockethub.WebSocketHub
+
+	// eventLogPath is the shared event log replayed by /api/policies/replay;
+	// when empty, replay falls back to the websocket history.
+	eventLogPath string
+
+	// snapshot caches the rendered policy response until an input changes;
+	// broadcasted is the last snapshot pushed to websocket clients.
+	snapMu          sync.Mutex
+	snapshot        *policySnapshot
+	broadcasted     *policySnapshot
+	snapshotVersion uint64
+
+	// completionDocs keeps editor buffers between completion requests so
+	// incremental edits only re-parse the statement they touch.
+	completionDocs *autocomplete.DocumentCache
+
+	// runtimeHints caches the proxy/policy/hub portion of completion hints for
+	// completionHintsTTL, or until the policy manager version changes.
+	hintsMu             sync.Mutex
+	runtimeHints        autocomplete.Hints
+	runtimeHintsAt      time.Time
+	runtimeHintsVersion uint64
 }
 
+const completionHintsTTL = time.Second
+
 type completionCursor struct {
 	Line   int `json:"line"`
 	Column int `json:"column"`
@@ -63,11 +88,18 @@ type completionIDHints struct {
 	Servers []string `json:"servers,omitempty"`
 }
 
+// completionRequest carries either the whole buffer in Cedar or, when
+// DocumentID names a buffer the server already holds at BaseVersion, the edits
+// that produce Version. Without DocumentID every request is parsed from scratch.
 type completionRequest struct {
-	Cedar    string            `json:"cedar"`
-	Cursor   completionCursor  `json:"cursor"`
-	MaxItems int               `json:"maxItems,omitempty"`
-	IDHints  completionIDHints `json:"idHints,omitempty"`
+	Cedar       string              `json:"cedar"`
+	Cursor      completionCursor    `json:"cursor"`
+	MaxItems    int                 `json:"maxItems,omitempty"`
+	IDHints     completionIDHints   `json:"idHints,omitempty"`
+	DocumentID  string              `json:"documentId,omitempty"`
+	Version     int                 `json:"version,omitempty"`
+	BaseVersion int                 `json:"baseVersion,omitempty"`
+	Changes     []autocomplete.Edit `json:"changes,omitempty"`
 }
 
 type completionResponseItem struct {
@@ -91,6 +123,8 @@ func newPolicyAPI(mgr *policy.Manager, policyPath string, broadcaster policyBroa
 		broadcaster: broadcaster,
 		mitmProxy:   mitmProxy,
 		wsHub:       wsHub,
+
+		completionDocs: autocomplete.NewDocumentCache(0),
 	}
 	if api.wsHub == nil {
 		if h, ok := broadcaster.(*websockethub.WebSocketHub); ok {
@@ -157,6 +191,8 @@ func (api *policyAPI) register(mux *http.ServeMux) {
 	mux.HandleFunc("/api/policies/add", api.handleAddPolicy)
 	mux.HandleFunc("/api/policies/add-from-action", api.handleAddPolicyFromAction)
 	mux.HandleFunc("/api/policies/delete", api.handleDeletePolicy)
+	mux.HandleFunc("/api/policies/batch", api.handleBatchPolicies)
+	mux.HandleFunc("/api/policies/replay", api.handleReplayPolicies)
 }
 
 func (api *policyAPI) handlePolicies(w http.ResponseWriter, r *http.Request) {
@@ -179,8 +215,7 @@ func (api *policyAPI) handlePolicies(w http.ResponseWriter, r *http.Request) {
 }
 
 func (api *policyAPI) handleGet(w http.ResponseWriter, r *http.Request) {
-	resp := api.buildPoliciesResponse()
-	writeJSON(w, http.StatusOK, resp)
+	writePolicySnapshot(w, r, api.currentPolicySnapshot())
 }
 
 func (api *policyAPI) handlePost(w http.ResponseWriter, r *http.Request) {
@@ -253,8 +288,7 @@ func (api *policyAPI) handlePost(w http.ResponseWriter, r *http.Request) {
 	api.cedarRuntime = cedar
 	api.mu.Unlock()
 
-	resp := api.buildPoliciesResponse()
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 type patchPoliciesRequest struct {
@@ -274,24 +308,56 @@ type patchPolicyRemove struct {
 	Cedar string `json:"cedar"`
 }
 
-func (api *policyAPI) respondPolicies(w http.ResponseWriter, resp map[string]any) {
-	writeJSON(w, http.StatusOK, resp)
-	api.broadcastPolicySnapshot(resp)
+// cedarFromPatchAdd resolves an add entry (raw Cedar or an action descriptor)
+// into a single semicolon-terminated Cedar statement.
+func cedarFromPatchAdd(add patchPolicyAdd) (string, error) {
+	cedar := strings.TrimSpace(add.Cedar)
+	if cedar == "" && add.Action != nil {
+		effect := strings.ToLower(strings.TrimSpace(add.Effect))
+		if effect != "permit" && effect != "forbid" {
+			return "", errors.New("add entries with action require effect of permit or forbid")
+		}
+		c, err := buildCedarFromActionRequest(addPolicyFromActionRequest{
+			Effect: effect,
+			Action: *add.Action,
+		})
+		if err != nil {
+			return "", err
+		}
+		cedar = strings.TrimSpace(c)
+	}
+	if cedar == "" {
+		return "", errors.New("add entries require cedar or action")
+	}
+	if !strings.HasSuffix(cedar, ";") {
+		cedar += ";"
+	}
+	return cedar, nil
+}
+
+func (api *policyAPI) respondPolicies(w http.ResponseWriter) {
+	snap := api.currentPolicySnapshot()
+	writePolicySnapshot(w, nil, snap)
+	api.broadcastPolicySnapshot(snap)
 }
 
-func (api *policyAPI) broadcastPolicySnapshot(resp map[string]any) {
-	if api.broadcaster == nil {
+// broadcastPolicySnapshot pushes snap to websocket clients unless it (or a newer
+// version) was already sent, so no-op mutations do not fan out duplicate events.
+func (api *policyAPI) broadcastPolicySnapshot(snap *policySnapshot) {
+	if api.broadcaster == nil || snap == nil {
 		return
 	}
 
-	payload := map[string]any{"policies": resp}
-	if lines, err := renderPolicyLines(api.currentCedarSnapshot()); err == nil {
-		payload["lines"] = lines
-	} else {
-		logPolicyEvent("policy.lines.snapshot.error", map[string]any{"error": err.Error()})
+	api.snapMu.Lock()
+	prev := api.broadcasted
+	if prev != nil && snap.version <= prev.version {
+		api.snapMu.Unlock()
+		return
 	}
+	api.broadcasted = snap
+	api.snapMu.Unlock()
 
-	api.broadcaster.EmitJSON("policy.snapshot", payload)
+	api.broadcaster.EmitJSON("policy.snapshot", policySnapshotPayload(prev, snap))
 }
 
 func (api *policyAPI) handlePatch(w http.ResponseWriter, r *http.Request) {
@@ -374,31 +440,11 @@ func (api *policyAPI) handlePatch(w http.ResponseWriter, r *http.Request) {
 
 	newStatements := make([]string, 0, addCount)
 	for _, add := range payload.Add {
-		cedar := strings.TrimSpace(add.Cedar)
-		if cedar == "" && add.Action != nil {
-			effect := strings.ToLower(strings.TrimSpace(add.Effect))
-			if effect != "permit" && effect != "forbid" {
-				writeJSON(w, http.StatusBadRequest, map[string]any{"error": "add entries with action require effect of permit or forbid"})
-				return
-			}
-			c, err := buildCedarFromActionRequest(addPolicyFromActionRequest{
-				Effect: effect,
-				Action: *add.Action,
-			})
-			if err != nil {
-				writeJSON(w, http.StatusBadRequest, map[string]any{"error": err.Error()})
-				return
-			}
-			cedar = c
-		}
-		if cedar == "" {
-			writeJSON(w, http.StatusBadRequest, map[string]any{"error": "add entries require cedar or action"})
+		cedar, err := cedarFromPatchAdd(add)
+		if err != nil {
+			writeJSON(w, http.StatusBadRequest, map[string]any{"error": err.Error()})
 			return
 		}
-		cedar = strings.TrimSpace(cedar)
-		if !strings.HasSuffix(cedar, ";") {
-			cedar += ";"
-		}
 		newStatements = append(newStatements, cedar)
 	}
 
@@ -566,8 +612,7 @@ func (api *policyAPI) handlePatch(w http.ResponseWriter, r *http.Request) {
 		"applyMode": applyMode,
 	})
 
-	resp := api.buildPoliciesResponse()
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 // handlePersistPolicies promotes Cedar to the file layer and writes the canonical
@@ -680,8 +725,7 @@ func (api *policyAPI) handlePersistPolicies(w http.ResponseWriter, r *http.Reque
 		return
 	}
 
-	resp := api.buildPoliciesResponse()
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 // handleValidatePolicies lints Cedar and returns a summary with issue list.
@@ -794,7 +838,11 @@ func (api *policyAPI) handlePoliciesComplete(w http.ResponseWriter, r *http.Requ
 	}
 
 	hints := api.buildCompletionHints(req.IDHints)
-	items, replaceRange, err := autocomplete.Complete(req.Cedar, req.Cursor.Line, req.Cursor.Column, req.MaxItems, hints)
+	items, replaceRange, err := api.complete(req, hints)
+	if errors.Is(err, autocomplete.ErrVersionMismatch) {
+		writeJSON(w, http.StatusConflict, map[string]any{"error": map[string]any{"message": "document version mismatch; resend the full buffer"}})
+		return
+	}
 	if err != nil {
 		writeJSON(w, http.StatusInternalServerError, map[string]any{"error": map[string]any{"message": err.Error()}})
 		return
@@ -807,7 +855,73 @@ func (api *policyAPI) handlePoliciesComplete(w http.ResponseWriter, r *http.Requ
 	writeJSON(w, http.StatusOK, resp)
 }
 
+// complete runs a completion statelessly, or against the cached document when
+// the request names one.
+func (api *policyAPI) complete(req completionRequest, hints autocomplete.Hints) ([]autocomplete.Item, autocomplete.ReplaceRange, error) {
+	id := strings.TrimSpace(req.DocumentID)
+	if id == "" || api.completionDocs == nil {
+		return autocomplete.Complete(req.Cedar, req.Cursor.Line, req.Cursor.Column, req.MaxItems, hints)
+	}
+
+	doc := api.completionDocs.Get(id)
+	switch {
+	case len(req.Changes) > 0:
+		if doc == nil {
+			return nil, autocomplete.ReplaceRange{}, autocomplete.ErrVersionMismatch
+		}
+		if err := doc.ApplyEdits(req.BaseVersion, req.Version, req.Changes); err != nil {
+			return nil, autocomplete.ReplaceRange{}, err
+		}
+	case doc == nil:
+		doc = autocomplete.NewDocument(req.Version, req.Cedar)
+		api.completionDocs.Put(id, doc)
+	case doc.Version() != req.Version || doc.Text() != req.Cedar:
+		doc.Update(req.Version, req.Cedar)
+	}
+	return doc.Complete(req.Cursor.Line, req.Cursor.Column, req.MaxItems, hints)
+}
+
 func (api *policyAPI) buildCompletionHints(id completionIDHints) autocomplete.Hints {
+	observed := api.runtimeCompletionHints()
+
+	// Copy so appending client hints never writes into the cached slices.
+	hints := autocomplete.Hints{
+		Servers: append([]string(nil), observed.Servers...),
+		Tools:   append([]string(nil), observed.Tools...),
+		Hosts:   observed.Hosts,
+		Headers: observed.Headers,
+		Files:   observed.Files,
+		Dirs:    observed.Dirs,
+	}
+
+	// Client-provided hints come last so runtime data retains priority.
+	hints.Servers = append(hints.Servers, id.Servers...)
+	hints.Tools = append(hints.Tools, id.Tools...)
+
+	hints.Servers = normalizeAndDedupe(hints.Servers, 24)
+	hints.Tools = normalizeAndDedupe(hints.Tools, 24)
+	hints.Hosts = normalizeAndDedupe(hints.Hosts, 32)
+	hints.Headers = normalizeAndDedupe(hints.Headers, 32)
+	hints.Files = normalizeAndDedupe(hints.Files, 32)
+	hints.Dirs = normalizeAndDedupe(hints.Dirs, 32)
+
+	return hints
+}
+
+// runtimeCompletionHints gathers hints from the MITM proxy, policy layers and
+// websocket hub. Editors request completions on every keystroke, so the result
+// is reused briefly rather than re-snapshotting all three sources each time.
+func (api *policyAPI) runtimeCompletionHints() autocomplete.Hints {
+	var version uint64
+	if api.mgr != nil {
+		version = api.mgr.Version()
+	}
+	api.hintsMu.Lock()
+	defer api.hintsMu.Unlock()
+	if !api.runtimeHintsAt.IsZero() && api.runtimeHintsVersion == version && time.Since(api.runtimeHintsAt) < completionHintsTTL {
+		return api.runtimeHints
+	}
+
 	var hints autocomplete.Hints
 
 	if api.mitmProxy != nil {
@@ -830,17 +944,9 @@ func (api *policyAPI) buildCompletionHints(id completionIDHints) autocomplete.Hi
 		hints.Headers = append(hints.Headers, headers...)
 	}
 
-	// Client-provided hints come last so runtime data retains priority.
-	hints.Servers = append(hints.Servers, id.Servers...)
-	hints.Tools = append(hints.Tools, id.Tools...)
-
-	hints.Servers = normalizeAndDedupe(hints.Servers, 24)
-	hints.Tools = normalizeAndDedupe(hints.Tools, 24)
-	hints.Hosts = normalizeAndDedupe(hints.Hosts, 32)
-	hints.Headers = normalizeAndDedupe(hints.Headers, 32)
-	hints.Files = normalizeAndDedupe(hints.Files, 32)
-	hints.Dirs = normalizeAndDedupe(hints.Dirs, 32)
-
+	api.runtimeHints = hints
+	api.runtimeHintsAt = time.Now()
+	api.runtimeHintsVersion = version
 	return hints
 }
 
@@ -1013,8 +1119,7 @@ func (api *policyAPI) handlePermitAll(w http.ResponseWriter, r *http.Request) {
 	}
 	api.mu.Unlock()
 	api.mode = "permit-all"
-	resp := api.buildPoliciesResponse()
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 // handleEnforceApply clears runtime overlays so only file layer is active.
@@ -1080,8 +1185,7 @@ func (api *policyAPI) handleEnforceApply(w http.ResponseWriter, r *http.Request)
 	api.mu.Unlock()
 
 	api.mode = "enforce"
-	resp := api.buildPoliciesResponse()
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 func (api *policyAPI) buildPoliciesResponse() map[string]any {
@@ -1835,10 +1939,10 @@ func detectIRConflicts(ps *lsm.PolicySet) string {
 	return ""
 }
 
-func (api *policyAPI) addPolicyStatement(newCedar string) (map[string]any, int, error) {
+func (api *policyAPI) addPolicyStatement(newCedar string) (int, error) {
 	stmt := strings.TrimSpace(newCedar)
 	if stmt == "" {
-		return nil, http.StatusBadRequest, errors.New("empty policy statement")
+		return http.StatusBadRequest, errors.New("empty policy statement")
 	}
 	if !strings.HasSuffix(stmt, ";") {
 		stmt += ";"
@@ -1847,10 +1951,10 @@ func (api *policyAPI) addPolicyStatement(newCedar string) (map[string]any, int,
 	newParser := transpiler.NewCedarParser()
 	newSet, err := newParser.ParseFromString(stmt)
 	if err != nil {
-		return nil, http.StatusBadRequest, fmt.Errorf("invalid Cedar: %w", err)
+		return http.StatusBadRequest, fmt.Errorf("invalid Cedar: %w", err)
 	}
 	if len(newSet.Policies) == 0 {
-		return nil, http.StatusBadRequest, errors.New("no policy found in statement")
+		return http.StatusBadRequest, errors.New("no policy found in statement")
 	}
 	newPolicy := newSet.Policies[0]
 
@@ -1862,14 +1966,13 @@ func (api *policyAPI) addPolicyStatement(newCedar string) (map[string]any, int,
 			for _, existingPolicy := range existingSet.Policies {
 				if policiesConflict(newPolicy, existingPolicy) {
 					msg := fmt.Sprintf("%s conflicts with: %s", humanizedWithEffect(newPolicy), humanizedWithEffect(existingPolicy))
-					return nil, http.StatusConflict, errors.New(msg)
+					return http.StatusConflict, errors.New(msg)
 				}
 			}
 			for _, existingPolicy := range existingSet.Policies {
 				if policiesAreEquivalent(newPolicy, existingPolicy) {
 					logPolicyEvent("policy.add.duplicate", map[string]any{"id": newPolicy.ID})
-					resp := api.buildPoliciesResponse()
-					return resp, http.StatusOK, nil
+					return http.StatusOK, nil
 				}
 			}
 		}
@@ -1883,20 +1986,20 @@ func (api *policyAPI) addPolicyStatement(newCedar string) (map[string]any, int,
 	tr := transpiler.NewCedarToLeashTranspiler()
 	lsmRules, httpRules, err := tr.TranspileFromString(updated)
 	if err != nil {
-		return nil, http.StatusBadRequest, err
+		return http.StatusBadRequest, err
 	}
 	// IR-level conflict detection to catch exact-match allow/deny pairs
 	if msg := detectIRConflicts(lsmRules); msg != "" {
-		return nil, http.StatusConflict, errors.New(msg)
+		return http.StatusConflict, errors.New(msg)
 	}
 	if err := ensureConnectSafety(lsmRules); err != nil {
-		return nil, http.StatusBadRequest, err
+		return http.StatusBadRequest, err
 	}
 	if err := api.mgr.SetRuntimeRules(lsmRules, httpRules); err != nil {
 		if softLSMError(err) {
 			logPolicyEvent("lsm.update.skip", map[string]any{"reason": err.Error()})
 		} else {
-			return nil, http.StatusInternalServerError, err
+			return http.StatusInternalServerError, err
 		}
 	}
 
@@ -1910,8 +2013,7 @@ func (api *policyAPI) addPolicyStatement(newCedar string) (map[string]any, int,
 
 	logPolicyEvent("policy.add", map[string]any{"id": newPolicy.ID})
 
-	resp := api.buildPoliciesResponse()
-	return resp, http.StatusOK, nil
+	return http.StatusOK, nil
 }
 
 type actionPayload struct {
@@ -2159,26 +2261,26 @@ func isHostLike(s string) bool {
 	return true
 }
 
-func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int, error) {
+func (api *policyAPI) deletePolicy(req deletePolicyRequest) (int, error) {
 	id := strings.TrimSpace(req.ID)
 	targetCedar := strings.TrimSpace(req.Cedar)
 	if id == "" && targetCedar == "" {
-		return nil, http.StatusBadRequest, errors.New("id or cedar must be provided")
+		return http.StatusBadRequest, errors.New("id or cedar must be provided")
 	}
 
 	existing := strings.TrimSpace(api.editableCedar())
 	if existing == "" {
-		return nil, http.StatusBadRequest, errors.New("no policies available to delete")
+		return http.StatusBadRequest, errors.New("no policies available to delete")
 	}
 
 	statements := extractCedarStatements(existing)
 	if len(statements) == 0 {
-		return nil, http.StatusBadRequest, errors.New("no policy statements available")
+		return http.StatusBadRequest, errors.New("no policy statements available")
 	}
 
 	lines, err := renderPolicyLines(existing)
 	if err != nil {
-		return nil, http.StatusInternalServerError, fmt.Errorf("failed to parse policies: %w", err)
+		return http.StatusInternalServerError, fmt.Errorf("failed to parse policies: %w", err)
 	}
 
 	index := -1
@@ -2196,11 +2298,11 @@ func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int
 		}
 	}
 	if index == -1 {
-		return nil, http.StatusNotFound, errors.New("policy not found")
+		return http.StatusNotFound, errors.New("policy not found")
 	}
 
 	if len(statements) <= 1 {
-		return nil, http.StatusBadRequest, errors.New("cannot remove the final policy statement")
+		return http.StatusBadRequest, errors.New("cannot remove the final policy statement")
 	}
 
 	statements = append(statements[:index], statements[index+1:]...)
@@ -2209,16 +2311,16 @@ func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int
 	tr := transpiler.NewCedarToLeashTranspiler()
 	lsmRules, httpRules, err := tr.TranspileFromString(updated)
 	if err != nil {
-		return nil, http.StatusBadRequest, err
+		return http.StatusBadRequest, err
 	}
 	if err := ensureConnectSafety(lsmRules); err != nil {
-		return nil, http.StatusBadRequest, err
+		return http.StatusBadRequest, err
 	}
 	if err := api.mgr.SetRuntimeRules(lsmRules, httpRules); err != nil {
 		if softLSMError(err) {
 			logPolicyEvent("lsm.update.skip", map[string]any{"reason": err.Error()})
 		} else {
-			return nil, http.StatusInternalServerError, err
+			return http.StatusInternalServerError, err
 		}
 	}
 
@@ -2235,7 +2337,7 @@ func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int
 		if softLSMError(err) {
 			logPolicyEvent("lsm.update.skip", map[string]any{"reason": err.Error()})
 		} else {
-			return nil, http.StatusInternalServerError, err
+			return http.StatusInternalServerError, err
 		}
 	}
 
@@ -2245,7 +2347,7 @@ func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int
 	}
 	if err := api.saveCanonicalCedar([]byte(payload)); err != nil {
 		_ = api.mgr.UpdateFileRules(prevFile, prevHTTP)
-		return nil, http.StatusInternalServerError, fmt.Errorf("failed to persist Cedar: %w", err)
+		return http.StatusInternalServerError, fmt.Errorf("failed to persist Cedar: %w", err)
 	}
 
 	logPolicyEvent("policy.delete", map[string]any{
@@ -2254,8 +2356,178 @@ func (api *policyAPI) deletePolicy(req deletePolicyRequest) (map[string]any, int
 		"description": deletedLine.Humanized,
 	})
 
-	resp := api.buildPoliciesResponse()
-	return resp, http.StatusOK, nil
+	return http.StatusOK, nil
+}
+
+type batchPoliciesRequest struct {
+	Add    []patchPolicyAdd      `json:"add"`
+	Delete []deletePolicyRequest `json:"delete"`
+}
+
+// applyPolicyBatch applies many adds and deletes as one transaction. Every entry
+// is validated against the merged result before anything changes; the runtime
+// (and, when deleting, file) layers are then swapped inside a single
+// Manager.Batch so the LSM and proxy reload once regardless of entry count.
+// Adds follow addPolicyStatement semantics and deletes follow deletePolicy.
+func (api *policyAPI) applyPolicyBatch(req batchPoliciesRequest) (int, error) {
+	if len(req.Add) == 0 && len(req.Delete) == 0 {
+		return http.StatusBadRequest, errors.New("no changes provided")
+	}
+
+	existing := strings.TrimSpace(api.editableCedar())
+	statements := dedupeCedarStatements(extractCedarStatements(existing))
+
+	// Deletes resolve against the pre-batch policy lines so IDs shown in the UI
+	// stay valid even when earlier entries shift statement positions.
+	lines, err := renderPolicyLines(existing)
+	if err != nil {
+		return http.StatusInternalServerError, fmt.Errorf("failed to parse policies: %w", err)
+	}
+	idToStatement := make(map[string]string, len(lines))
+	for _, line := range lines {
+		idToStatement[line.ID] = strings.TrimSpace(line.Cedar)
+	}
+
+	for _, del := range req.Delete {
+		id := strings.TrimSpace(del.ID)
+		target := strings.TrimSpace(del.Cedar)
+		if id == "" && target == "" {
+			return http.StatusBadRequest, errors.New("delete entries require id or cedar")
+		}
+		if target == "" {
+			stmt, ok := idToStatement[id]
+			if !ok {
+				return http.StatusNotFound, fmt.Errorf("policy id %q not found", id)
+			}
+			target = stmt
+		}
+		index := -1
+		for i, stmt := range statements {
+			if stmt == target {
+				index = i
+				break
+			}
+		}
+		if index == -1 {
+			return http.StatusNotFound, errors.New("policy not found")
+		}
+		statements = append(statements[:index], statements[index+1:]...)
+	}
+
+	parser := transpiler.NewCedarParser()
+	var current []transpiler.CedarPolicy
+	if len(statements) > 0 {
+		if set, err := parser.ParseFromString(strings.Join(statements, "\n\n")); err == nil && set != nil {
+			current = set.Policies
+		}
+	}
+
+	added := make([]string, 0, len(req.Add))
+	for _, add := range req.Add {
+		stmt, err := cedarFromPatchAdd(add)
+		if err != nil {
+			return http.StatusBadRequest, err
+		}
+		newSet, err := parser.ParseFromString(stmt)
+		if err != nil {
+			return http.StatusBadRequest, fmt.Errorf("invalid Cedar: %w", err)
+		}
+		if len(newSet.Policies) == 0 {
+			return http.StatusBadRequest, errors.New("no policy found in statement")
+		}
+		newPolicy := newSet.Policies[0]
+		// Check against surviving policies and earlier adds in this batch.
+		for _, existingPolicy := range current {
+			if policiesConflict(newPolicy, existingPolicy) {
+				msg := fmt.Sprintf("%s conflicts with: %s", humanizedWithEffect(newPolicy), humanizedWithEffect(existingPolicy))
+				return http.StatusConflict, errors.New(msg)
+			}
+		}
+		duplicate := false
+		for _, existingPolicy := range current {
+			if policiesAreEquivalent(newPolicy, existingPolicy) {
+				duplicate = true
+				break
+			}
+		}
+		if duplicate {
+			continue
+		}
+		current = append(current, newPolicy)
+		added = append(added, stmt)
+	}
+
+	if len(added) == 0 && len(req.Delete) == 0 {
+		logPolicyEvent("policy.batch.duplicate", map[string]any{"add": len(req.Add)})
+		return http.StatusOK, nil
+	}
+
+	// Prepend adds newest-first, matching repeated calls to /api/policies/add.
+	merged := make([]string, 0, len(added)+len(statements))
+	for i := len(added) - 1; i >= 0; i-- {
+		merged = append(merged, added[i])
+	}
+	merged = append(merged, statements...)
+	if len(merged) == 0 {
+		return http.StatusBadRequest, errors.New("cannot remove the final policy statement")
+	}
+	updated := strings.TrimSpace(strings.Join(merged, "\n\n"))
+
+	tr := transpiler.NewCedarToLeashTranspiler()
+	lsmRules, httpRules, err := tr.TranspileFromString(updated)
+	if err != nil {
+		return http.StatusBadRequest, err
+	}
+	if msg := detectIRConflicts(lsmRules); msg != "" {
+		return http.StatusConflict, errors.New(msg)
+	}
+	if err := ensureConnectSafety(lsmRules); err != nil {
+		return http.StatusBadRequest, err
+	}
+
+	persistFile := len(req.Delete) > 0
+	batchErr := api.mgr.Batch(func(tx *policy.BatchTx) error {
+		if err := tx.SetRuntimeRules(lsmRules, httpRules); err != nil {
+			return err
+		}
+		if !persistFile {
+			return nil
+		}
+		if err := tx.UpdateFileRules(lsmRules, httpRules); err != nil {
+			return err
+		}
+		payload := updated
+		if !strings.HasSuffix(payload, "\n") {
+			payload += "\n"
+		}
+		if err := api.saveCanonicalCedar([]byte(payload)); err != nil {
+			return fmt.Errorf("failed to persist Cedar: %w", err)
+		}
+		return nil
+	})
+	if batchErr != nil {
+		if softLSMError(batchErr) {
+			logPolicyEvent("lsm.update.skip", map[string]any{"reason": batchErr.Error()})
+		} else {
+			return http.StatusInternalServerError, batchErr
+		}
+	}
+
+	if err := saveCedarRuntime([]byte(updated)); err != nil {
+		logPolicyEvent("policy.batch", map[string]any{"error": err.Error(), "persist": "cedar-runtime"})
+	}
+
+	api.mu.Lock()
+	api.cedarRuntime = updated
+	api.mu.Unlock()
+
+	logPolicyEvent("policy.batch", map[string]any{
+		"add":       len(added),
+		"duplicate": len(req.Add) - len(added),
+		"delete":    len(req.Delete),
+	})
+
+	return http.StatusOK, nil
 }
 
 // humanizeAction converts Cedar action to human-readable text.
@@ -2490,13 +2762,13 @@ func (api *policyAPI) handleAddPolicy(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
-	resp, status, applyErr := api.addPolicyStatement(newCedar)
+	status, applyErr := api.addPolicyStatement(newCedar)
 	if applyErr != nil {
 		writeJSON(w, status, map[string]any{"error": applyErr.Error()})
 		return
 	}
 
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 // handleAddPolicyFromAction builds a Cedar snippet from an action descriptor on the server.
@@ -2526,13 +2798,13 @@ func (api *policyAPI) handleAddPolicyFromAction(w http.ResponseWriter, r *http.R
 		return
 	}
 
-	resp, status, applyErr := api.addPolicyStatement(cedar)
+	status, applyErr := api.addPolicyStatement(cedar)
 	if applyErr != nil {
 		writeJSON(w, status, map[string]any{"error": applyErr.Error()})
 		return
 	}
 
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
 }
 
 // handleDeletePolicy removes a Cedar policy statement by ID or literal match.
@@ -2556,13 +2828,44 @@ func (api *policyAPI) handleDeletePolicy(w http.ResponseWriter, r *http.Request)
 		return
 	}
 
-	resp, status, delErr := api.deletePolicy(req)
+	status, delErr := api.deletePolicy(req)
 	if delErr != nil {
 		writeJSON(w, status, map[string]any{"error": delErr.Error()})
 		return
 	}
 
-	api.respondPolicies(w, resp)
+	api.respondPolicies(w)
+}
+
+// handleBatchPolicies applies many policy adds and deletes with a single
+// enforcement reload and a single snapshot broadcast.
+func (api *policyAPI) handleBatchPolicies(w http.ResponseWriter, r *http.Request) {
+	setCORS(w)
+	if r.Method == http.MethodOptions {
+		w.WriteHeader(http.StatusNoContent)
+		return
+	}
+	if r.Method != http.MethodPost {
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	r.Body = http.MaxBytesReader(w, r.Body, 1<<20)
+	defer r.Body.Close()
+
+	var req batchPoliciesRequest
+	if err := json.NewDecoder(r.Body).Decode(&req); err != nil {
+		writeJSON(w, http.StatusBadRequest, map[string]any{"error": "invalid JSON payload"})
+		return
+	}
+
+	status, batchErr := api.applyPolicyBatch(req)
+	if batchErr != nil {
+		writeJSON(w, status, map[string]any{"error": batchErr.Error()})
+		return
+	}
+
+	api.respondPolicies(w)
 }
 
 // policiesAreEquivalent checks if two policies are semantically equivalent by comparing ASTs.
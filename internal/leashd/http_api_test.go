@@ -11,9 +11,11 @@ import (
 	"sync"
 	"testing"
 
+	autocomplete "github.com/strongdm/leash/internal/cedar/autocomplete"
 	"github.com/strongdm/leash/internal/lsm"
 	"github.com/strongdm/leash/internal/policy"
 	"github.com/strongdm/leash/internal/proxy"
+	"github.com/strongdm/leash/internal/websocket"
 )
 
 func setupLeashDirs(t *testing.T) string {
@@ -615,6 +617,214 @@ func TestPoliciesPatchRejectsConflict(t *testing.T) {
 	}
 }
 
+func TestPoliciesBatchAppliesOnce(t *testing.T) {
+	t.Parallel()
+
+	tmpDir := setupLeashDirs(t)
+	policyPath := filepath.Join(tmpDir, "policies.cedar")
+
+	var mu sync.Mutex
+	pushes := 0
+	mgr := policy.NewManager(nil, func(*lsm.PolicySet, []proxy.HeaderRewriteRule) {
+		mu.Lock()
+		pushes++
+		mu.Unlock()
+	})
+	broadcast := &captureBroadcaster{}
+	mux := http.NewServeMux()
+	api := newPolicyAPI(mgr, policyPath, broadcast, nil, nil)
+	api.register(mux)
+
+	mu.Lock()
+	before := pushes
+	mu.Unlock()
+
+	hosts := []string{"a.example.com", "b.example.com", "c.example.com"}
+	adds := make([]map[string]any, 0, len(hosts))
+	for _, host := range hosts {
+		adds = append(adds, map[string]any{
+			"effect": "forbid",
+			"action": map[string]string{"type": "net/connect", "name": "https://" + host},
+		})
+	}
+	payload, _ := json.Marshal(map[string]any{"add": adds})
+	req := httptest.NewRequest(http.MethodPost, "/api/policies/batch", bytes.NewReader(payload))
+	req.Header.Set("Content-Type", "application/json")
+	w := httptest.NewRecorder()
+	mux.ServeHTTP(w, req)
+	if w.Code != http.StatusOK {
+		t.Fatalf("batch returned %d: %s", w.Code, w.Body.String())
+	}
+
+	mu.Lock()
+	got := pushes - before
+	mu.Unlock()
+	if got != 1 {
+		t.Fatalf("expected a single enforcement push for the batch, got %d", got)
+	}
+
+	var resp struct {
+		CedarRuntime string `json:"cedarRuntime"`
+	}
+	if err := json.Unmarshal(w.Body.Bytes(), &resp); err != nil {
+		t.Fatalf("failed to decode response: %v", err)
+	}
+	for _, host := range hosts {
+		if !strings.Contains(resp.CedarRuntime, host) {
+			t.Fatalf("expected cedarRuntime to contain %s, got %q", host, resp.CedarRuntime)
+		}
+	}
+
+	broadcast.mu.Lock()
+	snapshots := len(broadcast.events)
+	broadcast.mu.Unlock()
+	if snapshots != 1 {
+		t.Fatalf("expected one policy snapshot broadcast, got %d", snapshots)
+	}
+}
+
+func TestPoliciesBatchRejectsConflictWithoutApplying(t *testing.T) {
+	t.Parallel()
+
+	var mu sync.Mutex
+	pushes := 0
+	mgr := policy.NewManager(nil, func(*lsm.PolicySet, []proxy.HeaderRewriteRule) {
+		mu.Lock()
+		pushes++
+		mu.Unlock()
+	})
+	mux := http.NewServeMux()
+	api := newPolicyAPI(mgr, "", nil, nil, nil)
+	api.register(mux)
+
+	mu.Lock()
+	before := pushes
+	mu.Unlock()
+	_, _, runtimeBefore, _ := mgr.Snapshot()
+
+	body := map[string]any{
+		"add": []map[string]any{
+			{"cedar": `permit (principal, action == Action::"NetworkConnect", resource == Host::"api.openai.com");`},
+			{"cedar": `forbid (principal, action == Action::"NetworkConnect", resource == Host::"api.openai.com");`},
+		},
+	}
+	payload, _ := json.Marshal(body)
+	req := httptest.NewRequest(http.MethodPost, "/api/policies/batch", bytes.NewReader(payload))
+	req.Header.Set("Content-Type", "application/json")
+	w := httptest.NewRecorder()
+	mux.ServeHTTP(w, req)
+	if w.Code != http.StatusConflict {
+		t.Fatalf("expected 409 for conflicting batch, got %d: %s", w.Code, w.Body.String())
+	}
+
+	mu.Lock()
+	got := pushes - before
+	mu.Unlock()
+	if got != 0 {
+		t.Fatalf("expected no enforcement push for rejected batch, got %d", got)
+	}
+	_, _, runtimeAfter, _ := mgr.Snapshot()
+	if !policySetsEqual(runtimeBefore, runtimeAfter) {
+		t.Fatalf("runtime layer changed despite rejected batch")
+	}
+}
+
+func TestPoliciesGetSnapshotETag(t *testing.T) {
+	t.Parallel()
+
+	mux := http.NewServeMux()
+	mgr := policy.NewManager(nil, nil)
+	broadcast := &captureBroadcaster{}
+	api := newPolicyAPI(mgr, "", broadcast, nil, nil)
+	api.register(mux)
+
+	get := func(ifNoneMatch string) *httptest.ResponseRecorder {
+		req := httptest.NewRequest(http.MethodGet, "/api/policies", nil)
+		if ifNoneMatch != "" {
+			req.Header.Set("If-None-Match", ifNoneMatch)
+		}
+		w := httptest.NewRecorder()
+		mux.ServeHTTP(w, req)
+		return w
+	}
+	add := func(host string) {
+		payload, _ := json.Marshal(map[string]any{
+			"cedar": `forbid (principal, action == Action::"NetworkConnect", resource == Host::"` + host + `");`,
+		})
+		req := httptest.NewRequest(http.MethodPost, "/api/policies/add", bytes.NewReader(payload))
+		req.Header.Set("Content-Type", "application/json")
+		w := httptest.NewRecorder()
+		mux.ServeHTTP(w, req)
+		if w.Code != http.StatusOK {
+			t.Fatalf("add %s returned %d: %s", host, w.Code, w.Body.String())
+		}
+	}
+
+	first := get("")
+	if first.Code != http.StatusOK {
+		t.Fatalf("get policies returned %d", first.Code)
+	}
+	etag := first.Header().Get("ETag")
+	if etag == "" {
+		t.Fatalf("expected ETag header on policies response")
+	}
+	if w := get(etag); w.Code != http.StatusNotModified {
+		t.Fatalf("expected 304 for unchanged snapshot, got %d", w.Code)
+	}
+	if w := get("W/" + etag); w.Code != http.StatusNotModified {
+		t.Fatalf("expected 304 for weak validator, got %d", w.Code)
+	}
+
+	add("a.example.com")
+	add("b.example.com")
+
+	second := get(etag)
+	if second.Code != http.StatusOK {
+		t.Fatalf("expected 200 after policy change, got %d", second.Code)
+	}
+	if second.Header().Get("ETag") == etag {
+		t.Fatalf("expected ETag to change after policy change")
+	}
+	var resp struct {
+		Version      uint64 `json:"version"`
+		CedarRuntime string `json:"cedarRuntime"`
+	}
+	if err := json.Unmarshal(second.Body.Bytes(), &resp); err != nil {
+		t.Fatalf("failed to decode response: %v", err)
+	}
+	if resp.Version < 2 || !strings.Contains(resp.CedarRuntime, "b.example.com") {
+		t.Fatalf("unexpected snapshot version %d / cedar %q", resp.Version, resp.CedarRuntime)
+	}
+
+	broadcast.mu.Lock()
+	events := append([]struct {
+		event   string
+		payload any
+	}(nil), broadcast.events...)
+	broadcast.mu.Unlock()
+	if len(events) != 2 {
+		t.Fatalf("expected two snapshot broadcasts, got %d", len(events))
+	}
+	if _, ok := events[0].payload.(map[string]any)["policies"]; !ok {
+		t.Fatalf("expected first broadcast to carry the full snapshot")
+	}
+	diffPayload := events[1].payload.(map[string]any)
+	if _, ok := diffPayload["baseVersion"]; !ok {
+		t.Fatalf("expected second broadcast to reference a base version")
+	}
+	diff, ok := diffPayload["diff"].(map[string]any)
+	if !ok {
+		t.Fatalf("expected second broadcast to carry a diff, got %#v", diffPayload)
+	}
+	changed, _ := diff["policies"].(map[string]json.RawMessage)
+	if _, ok := changed["cedarRuntime"]; !ok {
+		t.Fatalf("expected diff to include cedarRuntime")
+	}
+	if _, ok := changed["cedarBaseline"]; ok {
+		t.Fatalf("expected unchanged cedarBaseline to be omitted from diff")
+	}
+}
+
 func TestPersistPoliciesRejectsConflict(t *testing.T) {
 	t.Parallel()
 
@@ -761,6 +971,63 @@ func TestPoliciesCompleteUsesPolicyHints(t *testing.T) {
 	}
 }
 
+func TestPoliciesCompleteDocumentEdits(t *testing.T) {
+	t.Parallel()
+
+	api := newPolicyAPI(policy.NewManager(nil, nil), "", nil, nil, nil)
+	complete := func(body completionRequest) *httptest.ResponseRecorder {
+		payload := new(bytes.Buffer)
+		if err := json.NewEncoder(payload).Encode(body); err != nil {
+			t.Fatalf("encode request: %v", err)
+		}
+		req := httptest.NewRequest(http.MethodPost, "/api/policies/complete", payload)
+		req.Header.Set("Content-Type", "application/json")
+		w := httptest.NewRecorder()
+		api.handlePoliciesComplete(w, req)
+		return w
+	}
+
+	cedar := "permit (principal, action == , resource);"
+	if w := complete(completionRequest{
+		Cedar:      cedar,
+		Cursor:     completionCursor{Line: 1, Column: 29},
+		DocumentID: "editor-1",
+		Version:    1,
+	}); w.Code != http.StatusOK {
+		t.Fatalf("expected 200 for full buffer, got %d: %s", w.Code, w.Body.String())
+	}
+
+	edit := completionRequest{
+		Cursor:      completionCursor{Line: 1, Column: 30},
+		DocumentID:  "editor-1",
+		Version:     2,
+		BaseVersion: 1,
+		Changes: []autocomplete.Edit{{
+			Range: autocomplete.ReplaceRange{
+				Start: autocomplete.Position{Line: 1, Column: 29},
+				End:   autocomplete.Position{Line: 1, Column: 29},
+			},
+			Text: "A",
+		}},
+	}
+	w := complete(edit)
+	if w.Code != http.StatusOK {
+		t.Fatalf("expected 200 for incremental edit, got %d: %s", w.Code, w.Body.String())
+	}
+	var resp completionResponse
+	if err := json.NewDecoder(w.Body).Decode(&resp); err != nil {
+		t.Fatalf("decode response: %v", err)
+	}
+	if !containsLabel(resp.Items, `Action::"FileOpen"`) {
+		t.Fatalf("expected action suggestions after edit, got %+v", labels(resp.Items))
+	}
+
+	// Replaying the same edit against the stale base must ask for a resync.
+	if w := complete(edit); w.Code != http.StatusConflict {
+		t.Fatalf("expected 409 for stale base version, got %d: %s", w.Code, w.Body.String())
+	}
+}
+
 func containsLabel(items []completionResponseItem, label string) bool {
 	for _, item := range items {
 		if item.Label == label {
@@ -777,3 +1044,103 @@ func labels(items []completionResponseItem) []string {
 	}
 	return out
 }
+
+func TestPoliciesReplayReportsCandidateDenials(t *testing.T) {
+	t.Parallel()
+
+	dir := t.TempDir()
+	logPath := filepath.Join(dir, "leash.log")
+	log := strings.Join([]string{
+		`time=2025-10-07T18:02:40Z event=http.request protocol=https addr="api.openai.com" path="/v1" decision=allowed status=200`,
+		`time=2025-10-07T18:02:41Z event=http.request protocol=https addr="api.openai.com" path="/v1" decision=allowed status=200`,
+		`time=2025-10-07T18:02:42Z event=heartbeat uptime=3`,
+	}, "\n") + "\n"
+	if err := os.WriteFile(logPath, []byte(log), 0o644); err != nil {
+		t.Fatal(err)
+	}
+
+	mgr := policy.NewManager(nil, nil)
+	mux := http.NewServeMux()
+	api := newPolicyAPI(mgr, "", nil, nil, nil)
+	api.eventLogPath = logPath
+	api.register(mux)
+
+	payload, _ := json.Marshal(map[string]any{
+		"cedar": `forbid (principal, action == Action::"NetworkConnect", resource == Host::"api.openai.com");`,
+	})
+	req := httptest.NewRequest(http.MethodPost, "/api/policies/replay", bytes.NewReader(payload))
+	req.Header.Set("Content-Type", "application/json")
+	w := httptest.NewRecorder()
+	mux.ServeHTTP(w, req)
+	if w.Code != http.StatusOK {
+		t.Fatalf("replay returned %d: %s", w.Code, w.Body.String())
+	}
+
+	var resp struct {
+		Source string           `json:"source"`
+		Report lsm.ReplayReport `json:"report"`
+	}
+	if err := json.Unmarshal(w.Body.Bytes(), &resp); err != nil {
+		t.Fatalf("failed to decode response: %v", err)
+	}
+	if resp.Source != "log" || resp.Report.Events != 2 || resp.Report.NewlyDenied != 2 {
+		t.Fatalf("unexpected replay response: %+v", resp)
+	}
+	if len(resp.Report.Rules) != 1 {
+		t.Fatalf("expected one denying rule, got %+v", resp.Report.Rules)
+	}
+	rule := resp.Report.Rules[0]
+	if rule.Hook != lsm.ReplayHookProxy || !strings.Contains(rule.Rule, "api.openai.com") {
+		t.Fatalf("unexpected denying rule: %+v", rule)
+	}
+	if len(rule.Top) != 1 || rule.Top[0].Target != "api.openai.com" || rule.Top[0].Count != 2 {
+		t.Fatalf("unexpected top targets: %+v", rule.Top)
+	}
+	if _, _, runtimeLSM, _ := mgr.Snapshot(); runtimeLSM != nil && len(runtimeLSM.Connect) > 0 {
+		t.Fatalf("replay must not apply the candidate policy")
+	}
+}
+
+func TestSuggestCachesTailQueriesUntilEventsArrive(t *testing.T) {
+	t.Parallel()
+	hub := websocket.NewWebSocketHub(nil, 64, 0, 0)
+	mgr := policy.NewManager(nil, nil)
+	api := newSuggestAPI(mgr, hub)
+	mux := http.NewServeMux()
+	api.register(mux)
+
+	get := func() suggestResponse {
+		t.Helper()
+		req := httptest.NewRequest(http.MethodGet, "/suggest?tail=32&window=5m", nil)
+		w := httptest.NewRecorder()
+		mux.ServeHTTP(w, req)
+		if w.Code != http.StatusOK {
+			t.Fatalf("expected 200, got %d: %s", w.Code, w.Body.String())
+		}
+		var resp suggestResponse
+		if err := json.Unmarshal(w.Body.Bytes(), &resp); err != nil {
+			t.Fatalf("decode: %v", err)
+		}
+		return resp
+	}
+
+	hub.BroadcastLog(`time=2025-10-11T15:00:00Z event=file.open exe=/usr/bin/git path=/home/agent/.gitconfig decision=allowed`)
+	first := get()
+	if first.Cached || first.EventCount != 1 {
+		t.Fatalf("unexpected first answer: %+v", first)
+	}
+	if again := get(); !again.Cached || again.EventCount != 1 {
+		t.Fatalf("expected a cached answer, got %+v", again)
+	}
+
+	// Entries that do not change the engine keep the cached answer.
+	hub.EmitJSON("leash.heartbeat", nil)
+	if again := get(); !again.Cached {
+		t.Fatalf("expected the heartbeat to keep the cache, got %+v", again)
+	}
+
+	hub.BroadcastLog(`time=2025-10-11T15:00:01Z event=file.open exe=/usr/bin/git path=/home/agent/.ssh/config decision=allowed`)
+	if next := get(); next.Cached || next.EventCount != 2 {
+		t.Fatalf("expected the new event folded in, got %+v", next)
+	}
+}
@@ -0,0 +1,116 @@
+package leashd
+
+import (
+	"encoding/json"
+	"errors"
+	"net/http"
+	"os"
+	"strings"
+	"time"
+
+	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/transpiler"
+	websockethub "github.com/strongdm/leash/internal/websocket"
+)
+
+// replayPoliciesRequest asks what a candidate policy would have decided for
+// the recorded events. An empty Cedar replays the active policy.
+type replayPoliciesRequest struct {
+	Cedar string `json:"cedar"`
+	Top   int    `json:"top"`
+}
+
+// handleReplayPolicies evaluates recorded events against a candidate policy
+// without applying it. Events come from the event log when one is configured,
+// otherwise from the websocket history buffer.
+func (api *policyAPI) handleReplayPolicies(w http.ResponseWriter, r *http.Request) {
+	setCORS(w)
+	if r.Method == http.MethodOptions {
+		w.WriteHeader(http.StatusNoContent)
+		return
+	}
+	if r.Method != http.MethodPost {
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	r.Body = http.MaxBytesReader(w, r.Body, 1<<20)
+	defer r.Body.Close()
+
+	var req replayPoliciesRequest
+	if err := json.NewDecoder(r.Body).Decode(&req); err != nil {
+		writeJSON(w, http.StatusBadRequest, map[string]any{"error": "invalid JSON payload"})
+		return
+	}
+
+	var policies *lsm.PolicySet
+	if strings.TrimSpace(req.Cedar) == "" {
+		policies, _ = api.mgr.GetActiveRules()
+	} else {
+		ps, _, err := transpiler.NewCedarToLeashTranspiler().TranspileFromString(req.Cedar)
+		if err != nil {
+			writeJSON(w, http.StatusBadRequest, map[string]any{"error": err.Error()})
+			return
+		}
+		policies = ps
+	}
+
+	started := time.Now()
+	replayer := lsm.NewPolicyReplayer(policies)
+	opts := lsm.ReplayOptions{TopN: req.Top}
+
+	source := "history"
+	var report *lsm.ReplayReport
+	if path := strings.TrimSpace(api.eventLogPath); path != "" {
+		if _, err := os.Stat(path); err == nil {
+			source = "log"
+			report, err = replayer.ReplayFiles(r.Context(), []string{path}, opts)
+			if err != nil {
+				if errors.Is(err, r.Context().Err()) {
+					return
+				}
+				writeJSON(w, http.StatusInternalServerError, map[string]any{"error": err.Error()})
+				return
+			}
+		}
+	}
+	if report == nil {
+		var history []websockethub.LogEntry
+		if api.wsHub != nil {
+			history = api.wsHub.RecentEvents(0)
+		}
+		report = replayer.ReplayEvents(replayEventsFromHistory(history), opts)
+	}
+
+	logPolicyEvent("policy.replay", map[string]any{
+		"source":      source,
+		"events":      report.Events,
+		"denied":      report.Denied,
+		"duration_ms": time.Since(started).Milliseconds(),
+	})
+	writeJSON(w, http.StatusOK, map[string]any{
+		"source": source,
+		"report": report,
+	})
+}
+
+func replayEventsFromHistory(entries []websockethub.LogEntry) []lsm.ReplayEvent {
+	events := make([]lsm.ReplayEvent, 0, len(entries))
+	for _, entry := range entries {
+		ev := lsm.ReplayEvent{
+			Event:    entry.Event,
+			Exe:      entry.Exe,
+			Path:     entry.Path,
+			Argv:     entry.Args,
+			Addr:     entry.Addr,
+			Hostname: entry.Hostname,
+			Protocol: entry.Protocol,
+			Decision: entry.Decision,
+		}
+		if entry.Argc != nil {
+			ev.Argc = *entry.Argc
+		}
+		events = append(events, ev)
+	}
+	return events
+}
@@ -0,0 +1,191 @@
+package leashd
+
+import (
+	"bytes"
+	"encoding/json"
+	"fmt"
+	"hash/fnv"
+	"net/http"
+	"os"
+	"strings"
+	"time"
+)
+
+// policySnapshot is the rendered policy state at one version. It is built once
+// per policy change and shared by GET /api/policies responses and websocket
+// broadcasts, so the layer views, canonical Cedar read, and policy lines are
+// not recomputed per request.
+type policySnapshot struct {
+	key     policySnapshotKey
+	version uint64
+	etag    string
+
+	// fields holds each top-level response key encoded once; body is the
+	// complete response document assembled from them.
+	fields map[string]json.RawMessage
+	body   []byte
+	lines  []policyLine
+}
+
+// policySnapshotKey captures every input the rendered snapshot depends on.
+// When it is unchanged the cached snapshot is still current.
+type policySnapshotKey struct {
+	mgrVersion   uint64
+	cedarRuntime string
+	cedarPrev    string
+	mode         string
+	fileSize     int64
+	fileModTime  time.Time
+}
+
+func (api *policyAPI) policySnapshotKey() policySnapshotKey {
+	api.mu.RLock()
+	key := policySnapshotKey{
+		cedarRuntime: api.cedarRuntime,
+		cedarPrev:    api.cedarPrev,
+		mode:         api.mode,
+	}
+	api.mu.RUnlock()
+	if api.mgr != nil {
+		key.mgrVersion = api.mgr.Version()
+	}
+	if path := strings.TrimSpace(api.policyPath); path != "" {
+		if info, err := os.Stat(path); err == nil {
+			key.fileSize = info.Size()
+			key.fileModTime = info.ModTime()
+		}
+	}
+	return key
+}
+
+// currentPolicySnapshot returns the cached snapshot, rebuilding it (and bumping
+// the version) only when one of its inputs changed.
+func (api *policyAPI) currentPolicySnapshot() *policySnapshot {
+	key := api.policySnapshotKey()
+
+	api.snapMu.Lock()
+	defer api.snapMu.Unlock()
+	if api.snapshot != nil && api.snapshot.key == key {
+		return api.snapshot
+	}
+
+	api.snapshotVersion++
+	version := api.snapshotVersion
+	resp := api.buildPoliciesResponse()
+	resp["version"] = version
+
+	fields := make(map[string]json.RawMessage, len(resp))
+	for k, v := range resp {
+		data, err := json.Marshal(v)
+		if err != nil {
+			logPolicyEvent("policy.snapshot.error", map[string]any{"key": k, "error": err.Error()})
+			continue
+		}
+		fields[k] = data
+	}
+	body, _ := json.Marshal(fields)
+
+	lines, err := renderPolicyLines(api.currentCedarSnapshot())
+	if err != nil {
+		logPolicyEvent("policy.lines.snapshot.error", map[string]any{"error": err.Error()})
+		lines = nil
+	}
+
+	hasher := fnv.New64a()
+	_, _ = hasher.Write(body)
+	snap := &policySnapshot{
+		key:     key,
+		version: version,
+		etag:    fmt.Sprintf(`"%d-%x"`, version, hasher.Sum64()),
+		fields:  fields,
+		body:    body,
+		lines:   lines,
+	}
+	api.snapshot = snap
+	return snap
+}
+
+// writePolicySnapshot serves the pre-encoded snapshot, answering 304 when the
+// caller already holds this version.
+func writePolicySnapshot(w http.ResponseWriter, r *http.Request, snap *policySnapshot) {
+	w.Header().Set("ETag", snap.etag)
+	w.Header().Set("Cache-Control", "no-cache")
+	if r != nil && etagMatches(r.Header.Get("If-None-Match"), snap.etag) {
+		w.WriteHeader(http.StatusNotModified)
+		return
+	}
+	w.Header().Set("Content-Type", "application/json; charset=utf-8")
+	w.WriteHeader(http.StatusOK)
+	_, _ = w.Write(snap.body)
+	_, _ = w.Write([]byte("\n"))
+}
+
+// etagMatches reports whether an If-None-Match header value lists etag. Weak
+// validators compare equal to their strong form, per RFC 9110 section 13.1.2.
+func etagMatches(header, etag string) bool {
+	header = strings.TrimSpace(header)
+	if header == "" {
+		return false
+	}
+	if header == "*" {
+		return true
+	}
+	for _, candidate := range strings.Split(header, ",") {
+		candidate = strings.TrimPrefix(strings.TrimSpace(candidate), "W/")
+		if candidate == etag {
+			return true
+		}
+	}
+	return false
+}
+
+// policySnapshotPayload builds the websocket payload for next. The first
+// broadcast carries the full document; later ones carry only the top-level
+// response keys and policy lines that changed since prev, tagged with
+// baseVersion so clients that missed prev can refetch instead of applying.
+func policySnapshotPayload(prev, next *policySnapshot) map[string]any {
+	payload := map[string]any{"version": next.version}
+	if prev == nil {
+		payload["policies"] = json.RawMessage(next.body)
+		if next.lines != nil {
+			payload["lines"] = next.lines
+		}
+		return payload
+	}
+
+	changed := make(map[string]json.RawMessage)
+	for k, v := range next.fields {
+		if !bytes.Equal(prev.fields[k], v) {
+			changed[k] = v
+		}
+	}
+
+	prevLines := make(map[string]policyLine, len(prev.lines))
+	for _, line := range prev.lines {
+		prevLines[line.ID] = line
+	}
+	upserted := make([]policyLine, 0)
+	seen := make(map[string]struct{}, len(next.lines))
+	for _, line := range next.lines {
+		seen[line.ID] = struct{}{}
+		if old, ok := prevLines[line.ID]; !ok || old != line {
+			upserted = append(upserted, line)
+		}
+	}
+	removed := make([]string, 0)
+	for _, line := range prev.lines {
+		if _, ok := seen[line.ID]; !ok {
+			removed = append(removed, line.ID)
+		}
+	}
+
+	payload["baseVersion"] = prev.version
+	payload["diff"] = map[string]any{
+		"policies": changed,
+		"lines": map[string]any{
+			"upserted": upserted,
+			"removed":  removed,
+		},
+	}
+	return payload
+}
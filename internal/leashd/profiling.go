@@ -0,0 +1,281 @@
+package leashd
+
+import (
+	"context"
+	"encoding/json"
+	"fmt"
+	"log"
+	"net/http"
+	"net/http/pprof"
+	"os"
+	"path/filepath"
+	rpprof "runtime/pprof"
+	"runtime/trace"
+	"slices"
+	"strconv"
+	"strings"
+	"time"
+)
+
+// Continuous profiling takes a CPU profile of profileCPUDuration and a heap
+// profile every profileInterval, keeping the newest profileKeep of each.
+// Sampling a sixth of the time at the runtime's default 100 Hz keeps the
+// overhead well under one percent.
+const (
+	profileInterval    = time.Minute
+	profileCPUDuration = 10 * time.Second
+	profileKeep        = 30
+)
+
+// traceDefaultSeconds and traceMaxSeconds bound /api/profile/trace.
+const (
+	traceDefaultSeconds = 5
+	traceMaxSeconds     = 60
+)
+
+// profileTags describe what leashd was doing while a profile was taken.
+type profileTags struct {
+	EventRate     float64 `json:"event_rate"`
+	PolicyVersion uint64  `json:"policy_version"`
+}
+
+// profileTagger derives profileTags from the event sequence and the policy
+// manager's version.
+type profileTagger struct {
+	lastSeq       func() uint64
+	policyVersion func() uint64
+}
+
+type profileMark struct {
+	seq uint64
+	at  time.Time
+}
+
+func (t profileTagger) mark() profileMark {
+	return profileMark{seq: t.lastSeq(), at: time.Now()}
+}
+
+// since tags a profile covering the time from m until now. The event rate
+// is the number of events emitted per second over that window.
+func (t profileTagger) since(m profileMark) profileTags {
+	tags := profileTags{PolicyVersion: t.policyVersion()}
+	if elapsed := time.Since(m.at).Seconds(); elapsed > 0 {
+		tags.EventRate = float64(t.lastSeq()-m.seq) / elapsed
+	}
+	return tags
+}
+
+// profileTagTrailers names the trace response trailers that carry its tags.
+const profileTagTrailers = "X-Leash-Event-Rate, X-Leash-Policy-Version"
+
+func (t profileTagger) setTrailers(h http.Header, tags profileTags) {
+	h.Set("X-Leash-Event-Rate", strconv.FormatFloat(tags.EventRate, 'f', 2, 64))
+	h.Set("X-Leash-Policy-Version", strconv.FormatUint(tags.PolicyVersion, 10))
+}
+
+// registerProfiling serves the runtime's pprof handlers under /debug/pprof/
+// and an execution trace capture at /api/profile/trace?seconds=N. The trace
+// is streamed, and the response carries the tags in the X-Leash-Event-Rate
+// and X-Leash-Policy-Version trailers.
+func registerProfiling(mux *http.ServeMux, tagger profileTagger) {
+	mux.HandleFunc("/debug/pprof/", pprof.Index)
+	mux.HandleFunc("/debug/pprof/cmdline", pprof.Cmdline)
+	mux.HandleFunc("/debug/pprof/profile", pprof.Profile)
+	mux.HandleFunc("/debug/pprof/symbol", pprof.Symbol)
+	mux.HandleFunc("/debug/pprof/trace", pprof.Trace)
+	mux.HandleFunc("/api/profile/trace", tagger.handleTrace)
+}
+
+func (t profileTagger) handleTrace(w http.ResponseWriter, r *http.Request) {
+	if r.Method != http.MethodGet && r.Method != http.MethodPost {
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+	seconds := traceDefaultSeconds
+	if raw := r.URL.Query().Get("seconds"); raw != "" {
+		n, err := strconv.Atoi(raw)
+		if err != nil || n <= 0 || n > traceMaxSeconds {
+			writeJSON(w, http.StatusBadRequest, map[string]any{"error": map[string]any{"message": fmt.Sprintf("seconds must be between 1 and %d", traceMaxSeconds)}})
+			return
+		}
+		seconds = n
+	}
+
+	// The tags are only known once the trace ends, so they follow it as
+	// trailers. Tracing fails before writing anything when another trace is
+	// running, which leaves room for the error response.
+	h := w.Header()
+	h.Set("Content-Type", "application/octet-stream")
+	h.Set("Content-Disposition", `attachment; filename="leashd.trace"`)
+	h.Set("Trailer", profileTagTrailers)
+	if err := trace.Start(w); err != nil {
+		h.Del("Content-Disposition")
+		h.Del("Trailer")
+		writeJSON(w, http.StatusConflict, map[string]any{"error": map[string]any{"message": err.Error()}})
+		return
+	}
+	m := t.mark()
+	timer := time.NewTimer(time.Duration(seconds) * time.Second)
+	select {
+	case <-timer.C:
+	case <-r.Context().Done():
+		timer.Stop()
+	}
+	trace.Stop()
+	t.setTrailers(h, t.since(m))
+}
+
+// profileRecorder keeps a rolling window of CPU and heap profiles in dir.
+// Each profile <kind>-<UTC time>.pb.gz has a <kind>-<UTC time>.json beside it
+// holding its tags.
+type profileRecorder struct {
+	dir         string
+	interval    time.Duration
+	cpuDuration time.Duration
+	keep        int
+	tagger      profileTagger
+}
+
+type profileMeta struct {
+	Kind       string    `json:"kind"`
+	CapturedAt time.Time `json:"captured_at"`
+	Seconds    float64   `json:"seconds,omitempty"`
+	profileTags
+}
+
+func newProfileRecorder(dir string, tagger profileTagger) *profileRecorder {
+	return &profileRecorder{
+		dir:         dir,
+		interval:    profileInterval,
+		cpuDuration: profileCPUDuration,
+		keep:        profileKeep,
+		tagger:      tagger,
+	}
+}
+
+// run takes a snapshot every interval until ctx is done.
+func (p *profileRecorder) run(ctx context.Context) {
+	ticker := time.NewTicker(p.interval)
+	defer ticker.Stop()
+	heapMark := p.tagger.mark()
+	for {
+		select {
+		case <-ctx.Done():
+			return
+		case <-ticker.C:
+		}
+		if err := p.snapshotCPU(ctx); err != nil {
+			logPolicyEvent("profile.snapshot", map[string]any{"kind": "cpu", "error": err.Error()})
+		}
+		if err := p.snapshotHeap(heapMark); err != nil {
+			logPolicyEvent("profile.snapshot", map[string]any{"kind": "heap", "error": err.Error()})
+		}
+		heapMark = p.tagger.mark()
+	}
+}
+
+// snapshotCPU profiles the CPU for cpuDuration. It fails if another CPU
+// profile, such as /debug/pprof/profile, is running.
+func (p *profileRecorder) snapshotCPU(ctx context.Context) error {
+	now := time.Now().UTC()
+	path := p.path("cpu", now)
+	f, err := os.Create(path + ".tmp")
+	if err != nil {
+		return err
+	}
+	if err := rpprof.StartCPUProfile(f); err != nil {
+		f.Close()
+		os.Remove(f.Name())
+		return err
+	}
+	m := p.tagger.mark()
+	timer := time.NewTimer(p.cpuDuration)
+	select {
+	case <-timer.C:
+	case <-ctx.Done():
+		timer.Stop()
+	}
+	rpprof.StopCPUProfile()
+	tags := p.tagger.since(m)
+	if err := f.Close(); err != nil {
+		os.Remove(f.Name())
+		return err
+	}
+	if err := os.Rename(f.Name(), path); err != nil {
+		return err
+	}
+	return p.finish(path, profileMeta{Kind: "cpu", CapturedAt: now, Seconds: time.Since(m.at).Seconds(), profileTags: tags})
+}
+
+// snapshotHeap writes the heap profile, tagged with the event rate since
+// the previous heap snapshot.
+func (p *profileRecorder) snapshotHeap(since profileMark) error {
+	now := time.Now().UTC()
+	path := p.path("heap", now)
+	f, err := os.Create(path + ".tmp")
+	if err != nil {
+		return err
+	}
+	if err := rpprof.Lookup("heap").WriteTo(f, 0); err != nil {
+		f.Close()
+		os.Remove(f.Name())
+		return err
+	}
+	if err := f.Close(); err != nil {
+		os.Remove(f.Name())
+		return err
+	}
+	if err := os.Rename(f.Name(), path); err != nil {
+		return err
+	}
+	return p.finish(path, profileMeta{Kind: "heap", CapturedAt: now, profileTags: p.tagger.since(since)})
+}
+
+func (p *profileRecorder) path(kind string, at time.Time) string {
+	return filepath.Join(p.dir, kind+"-"+at.Format("20060102T150405.000Z")+".pb.gz")
+}
+
+// finish writes the tags for the profile at path and drops the oldest
+// profiles of its kind beyond keep.
+func (p *profileRecorder) finish(path string, meta profileMeta) error {
+	data, err := json.Marshal(meta)
+	if err != nil {
+		return err
+	}
+	if err := os.WriteFile(strings.TrimSuffix(path, ".pb.gz")+".json", data, 0o644); err != nil {
+		return err
+	}
+
+	profiles, err := filepath.Glob(filepath.Join(p.dir, meta.Kind+"-*.pb.gz"))
+	if err != nil {
+		return err
+	}
+	// The timestamps sort lexically.
+	slices.Sort(profiles)
+	for len(profiles) > p.keep {
+		old := strings.TrimSuffix(profiles[0], ".pb.gz")
+		os.Remove(old + ".pb.gz")
+		os.Remove(old + ".json")
+		profiles = profiles[1:]
+	}
+	return nil
+}
+
+// startProfiling begins continuous profiling into dir. The returned func
+// stops it.
+func startProfiling(dir string, tagger profileTagger) (func(), error) {
+	if err := os.MkdirAll(dir, 0o755); err != nil {
+		return nil, fmt.Errorf("create profile dir: %w", err)
+	}
+	ctx, cancel := context.WithCancel(context.Background())
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		newProfileRecorder(dir, tagger).run(ctx)
+	}()
+	log.Printf("continuous profiling: writing CPU and heap profiles to %s", dir)
+	return func() {
+		cancel()
+		<-done
+	}, nil
+}
@@ -0,0 +1,115 @@
+package leashd
+
+import (
+	"context"
+	"encoding/json"
+	"net/http"
+	"net/http/httptest"
+	"os"
+	"path/filepath"
+	"runtime/trace"
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+func testProfileTagger(seq *atomic.Uint64, version uint64) profileTagger {
+	return profileTagger{
+		lastSeq:       seq.Load,
+		policyVersion: func() uint64 { return version },
+	}
+}
+
+func TestProfileRecorderKeepsRollingWindow(t *testing.T) {
+	var seq atomic.Uint64
+	dir := t.TempDir()
+	rec := newProfileRecorder(dir, testProfileTagger(&seq, 7))
+	rec.keep = 2
+
+	for i := 0; i < 3; i++ {
+		mark := rec.tagger.mark()
+		seq.Add(100)
+		if err := rec.snapshotHeap(mark); err != nil {
+			t.Fatalf("heap snapshot: %v", err)
+		}
+		// Snapshot names carry millisecond timestamps.
+		time.Sleep(2 * time.Millisecond)
+	}
+
+	profiles, _ := filepath.Glob(filepath.Join(dir, "heap-*.pb.gz"))
+	tags, _ := filepath.Glob(filepath.Join(dir, "heap-*.json"))
+	if len(profiles) != 2 || len(tags) != 2 {
+		t.Fatalf("expected the newest 2 profiles with their tags, got %v %v", profiles, tags)
+	}
+
+	data, err := os.ReadFile(tags[1])
+	if err != nil {
+		t.Fatal(err)
+	}
+	var meta profileMeta
+	if err := json.Unmarshal(data, &meta); err != nil {
+		t.Fatalf("decode tags: %v", err)
+	}
+	if meta.Kind != "heap" || meta.PolicyVersion != 7 || meta.EventRate <= 0 {
+		t.Fatalf("unexpected tags: %s", data)
+	}
+}
+
+func TestProfileRecorderCPUSnapshot(t *testing.T) {
+	var seq atomic.Uint64
+	dir := t.TempDir()
+	rec := newProfileRecorder(dir, testProfileTagger(&seq, 1))
+	rec.cpuDuration = 50 * time.Millisecond
+
+	if err := rec.snapshotCPU(context.Background()); err != nil {
+		t.Fatalf("cpu snapshot: %v", err)
+	}
+	profiles, _ := filepath.Glob(filepath.Join(dir, "cpu-*"))
+	if len(profiles) != 2 {
+		t.Fatalf("expected a CPU profile and its tags, got %v", profiles)
+	}
+}
+
+func TestProfileTraceAPI(t *testing.T) {
+	var seq atomic.Uint64
+	mux := http.NewServeMux()
+	registerProfiling(mux, testProfileTagger(&seq, 3))
+
+	rec := httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodGet, "/api/profile/trace?seconds=0", nil))
+	if rec.Code != http.StatusBadRequest {
+		t.Fatalf("expected seconds=0 to be rejected, got %d", rec.Code)
+	}
+
+	rec = httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodGet, "/api/profile/trace?seconds=1", nil))
+	if rec.Code != http.StatusOK {
+		t.Fatalf("trace: %d %s", rec.Code, rec.Body.String())
+	}
+	if rec.Body.Len() == 0 {
+		t.Fatal("expected trace data")
+	}
+	trailer := rec.Result().Trailer
+	if got := trailer.Get("X-Leash-Policy-Version"); got != "3" {
+		t.Fatalf("expected policy version tag, got %q", got)
+	}
+	if trailer.Get("X-Leash-Event-Rate") == "" {
+		t.Fatal("expected event rate tag")
+	}
+
+	// A second trace cannot start while one is running.
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		mux.ServeHTTP(httptest.NewRecorder(), httptest.NewRequest(http.MethodGet, "/api/profile/trace?seconds=1", nil))
+	}()
+	for !trace.IsEnabled() {
+		time.Sleep(time.Millisecond)
+	}
+	rec = httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodGet, "/api/profile/trace?seconds=1", nil))
+	<-done
+	if rec.Code != http.StatusConflict || rec.Header().Get("Trailer") != "" {
+		t.Fatalf("expected a plain conflict, got %d %v", rec.Code, rec.Header())
+	}
+}
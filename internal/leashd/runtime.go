@@ -31,7 +31,9 @@ import (
 	"github.com/strongdm/leash/internal/lsm"
 	"github.com/strongdm/leash/internal/policy"
 	"github.com/strongdm/leash/internal/proxy"
+	"github.com/strongdm/leash/internal/telemetry/metrics"
 	"github.com/strongdm/leash/internal/telemetry/otel"
+	"github.com/strongdm/leash/internal/telemetry/startup"
 	"github.com/strongdm/leash/internal/telemetry/statsig"
 	"github.com/strongdm/leash/internal/ui"
 	websockethub "github.com/strongdm/leash/internal/websocket"
@@ -84,12 +86,21 @@ func Main(args []string) error {
 	})
 	defer statsig.Stop(context.Background())
 
-	if err := preFlight(cfg); err != nil {
+	timeline := startup.Default
+	timeline.SetComponent("leashd")
+
+	end := timeline.Begin("preflight")
+	err = preFlight(cfg)
+	end(err)
+	if err != nil {
 		return err
 	}
 
 	leashDir := getLeashDirFromEnv()
-	if err := entrypoint.InflateBinaries(leashDir); err != nil {
+	end = timeline.Begin("inflate_binaries")
+	err = entrypoint.InflateBinaries(leashDir)
+	end(err)
+	if err != nil {
 		return err
 	}
 
@@ -103,6 +114,14 @@ func Main(args []string) error {
 	}
 	defer rt.Close()
 
+	if cfg.ProfileDir != "" {
+		stop, err := startProfiling(cfg.ProfileDir, rt.profileTagger())
+		if err != nil {
+			return err
+		}
+		rt.profilerStop = stop
+	}
+
 	return rt.Run()
 }
 
@@ -128,6 +147,10 @@ type runtimeConfig struct {
 	BulkMaxEvents    int
 	BulkMaxBytes     int
 	CgroupPath       string
+	Standby          bool
+	MultiTenant      bool
+	Pprof            bool
+	ProfileDir       string
 	BootstrapTimeout time.Duration
 	MCPConfig        proxy.MCPConfig
 	TelemetryConfig  otel.Config
@@ -142,10 +165,12 @@ type runtimeState struct {
 	lsmManager        *lsm.LSMManager
 	policyManager     *policy.Manager
 	policyWatcherStop func()
+	profilerStop      func()
 	policyReady       atomic.Bool
 	closeOnce         sync.Once
 	bootstrapPath     string
 	telemetryProvider *otel.Provider
+	tenants           *tenantRegistry
 }
 
 // parseConfig reads CLI flags and environment hints to build the runtime configuration.
@@ -172,11 +197,15 @@ func parseConfig(args []string) (*runtimeConfig, error) {
 	bulkMaxBytes := fs.Int("ws-bulk-max-bytes", 1_000_000, "Max bytes to include in initial WebSocket bulk message (0 = unlimited)")
 	defaultCgroupPath := strings.TrimSpace(os.Getenv("LEASH_CGROUP_PATH"))
 	cgroupFlag := fs.String("cgroup", defaultCgroupPath, "Cgroup path to monitor")
+	standby := fs.Bool("standby", strings.TrimSpace(os.Getenv("LEASH_STANDBY")) == "1", "Start without a cgroup and wait for a session to claim this daemon")
+	multiTenant := fs.Bool("multi-tenant", strings.TrimSpace(os.Getenv("LEASH_MULTI_TENANT")) == "1", "Start without a cgroup and enforce per-cgroup policies registered through /api/tenants")
+	pprofFlag := fs.Bool("pprof", strings.TrimSpace(os.Getenv("LEASH_PPROF")) == "1", "Serve pprof handlers under /debug/pprof/ and trace capture at /api/profile/trace on the control port")
+	profileDir := fs.String("profile-dir", strings.TrimSpace(os.Getenv("LEASH_PROFILE_DIR")), "Keep a rolling window of CPU and heap profiles in this directory (optional)")
 	fs.Usage = func() {
 		fmt.Fprintf(fs.Output(), "Usage: %s [flags]\n\n", name)
 		fmt.Fprintf(fs.Output(), "Flags:\n")
 		fs.PrintDefaults()
-		fmt.Fprintf(fs.Output(), "\nEnvironment:\n  LEASH_CGROUP_PATH  Default value for --cgroup\n  LEASH_LISTEN       Default value for --listen (blank disables Control UI)\n  LEASH_EXTRA_ARGS   Additional CLI arguments\n")
+		fmt.Fprintf(fs.Output(), "\nEnvironment:\n  LEASH_CGROUP_PATH  Default value for --cgroup\n  LEASH_STANDBY      Set to 1 for --standby\n  LEASH_MULTI_TENANT Set to 1 for --multi-tenant\n  LEASH_PPROF        Set to 1 for --pprof\n  LEASH_PROFILE_DIR  Default value for --profile-dir\n  LEASH_LISTEN       Default value for --listen (blank disables Control UI)\n  LEASH_EXTRA_ARGS   Additional CLI arguments\n")
 	}
 
 	var flagArgs []string
@@ -190,6 +219,9 @@ func parseConfig(args []string) (*runtimeConfig, error) {
 	if len(fs.Args()) > 0 {
 		return nil, fmt.Errorf("unexpected extra arguments: %v", fs.Args())
 	}
+	if *multiTenant && (*standby || strings.TrimSpace(*cgroupFlag) != "") {
+		return nil, fmt.Errorf("--multi-tenant cannot be combined with --standby or --cgroup")
+	}
 
 	listenCfg := listen.Default()
 	if listenFlag.set {
@@ -228,6 +260,10 @@ func parseConfig(args []string) (*runtimeConfig, error) {
 		BulkMaxEvents:    *bulkMaxEvents,
 		BulkMaxBytes:     *bulkMaxBytes,
 		CgroupPath:       strings.TrimSpace(*cgroupFlag),
+		Standby:          *standby,
+		MultiTenant:      *multiTenant,
+		Pprof:            *pprofFlag,
+		ProfileDir:       strings.TrimSpace(*profileDir),
 		BootstrapTimeout: timeout,
 	}
 	cfg.MCPConfig = loadMCPConfigFromEnv()
@@ -255,19 +291,12 @@ func preFlight(cfg *runtimeConfig) error {
 		return fmt.Errorf("failed to parse Cedar policy: %w", err)
 	}
 
-	if strings.TrimSpace(cfg.CgroupPath) == "" {
-		return fmt.Errorf("cgroup path required (set --cgroup)")
-	}
-	info, err := os.Stat(cfg.CgroupPath)
-	if err != nil {
-		return fmt.Errorf("invalid cgroup path %q: %w", cfg.CgroupPath, err)
-	}
-	if !info.IsDir() {
-		return fmt.Errorf("invalid cgroup path %q: not a directory", cfg.CgroupPath)
-	}
-	controllersPath := filepath.Join(cfg.CgroupPath, "cgroup.controllers")
-	if _, err := os.Stat(controllersPath); err != nil {
-		return fmt.Errorf("invalid cgroup path %q: %v", cfg.CgroupPath, err)
+	// A standby daemon is told its cgroup when a session claims it; a
+	// multi-tenant daemon is given one per tenant.
+	if !cfg.Standby && !cfg.MultiTenant {
+		if err := validateCgroupPath(cfg.CgroupPath); err != nil {
+			return err
+		}
 	}
 
 	logPath := strings.TrimSpace(cfg.LogPath)
@@ -302,13 +331,19 @@ func preFlight(cfg *runtimeConfig) error {
 		if _, err := findIptables(); err != nil {
 			return err
 		}
+		// Tenants are only isolated if their IPv6 traffic is too.
+		if cfg.MultiTenant {
+			if _, err := findIp6tables(); err != nil {
+				return fmt.Errorf("multi-tenant mode requires ip6tables: %w", err)
+			}
+		}
 	}
 
 	privateDir := strings.TrimSpace(os.Getenv("LEASH_PRIVATE_DIR"))
 	if privateDir == "" {
 		return fmt.Errorf("LEASH_PRIVATE_DIR environment variable is required")
 	}
-	info, err = os.Stat(privateDir)
+	info, err := os.Stat(privateDir)
 	if err != nil {
 		return fmt.Errorf("validate LEASH_PRIVATE_DIR %q: %w", privateDir, err)
 	}
@@ -338,6 +373,24 @@ func preFlight(cfg *runtimeConfig) error {
 	return nil
 }
 
+func validateCgroupPath(cgroupPath string) error {
+	if strings.TrimSpace(cgroupPath) == "" {
+		return fmt.Errorf("cgroup path required (set --cgroup)")
+	}
+	info, err := os.Stat(cgroupPath)
+	if err != nil {
+		return fmt.Errorf("invalid cgroup path %q: %w", cgroupPath, err)
+	}
+	if !info.IsDir() {
+		return fmt.Errorf("invalid cgroup path %q: not a directory", cgroupPath)
+	}
+	controllersPath := filepath.Join(cgroupPath, "cgroup.controllers")
+	if _, err := os.Stat(controllersPath); err != nil {
+		return fmt.Errorf("invalid cgroup path %q: %v", cgroupPath, err)
+	}
+	return nil
+}
+
 func initRuntime(cfg *runtimeConfig, leashDir string) (*runtimeState, error) {
 	logger, err := lsm.NewSharedLogger(cfg.LogPath)
 	if err != nil {
@@ -361,7 +414,9 @@ func initRuntime(cfg *runtimeConfig, leashDir string) (*runtimeState, error) {
 	}
 	cfg.MCPConfig.Telemetry = telemetryProvider.MCP()
 
+	end := startup.Default.Begin("policy.compile")
 	initialPolicy, err := policy.Parse(cfg.PolicyPath)
+	end(err)
 	if err != nil {
 		logger.Close()
 		var detail *cedarutil.ErrorDetail
@@ -376,7 +431,9 @@ func initRuntime(cfg *runtimeConfig, leashDir string) (*runtimeState, error) {
 	policyChecker := lsm.NewSimplePolicyChecker(connectRules, defaultAllow, initialPolicy.LSMPolicies.MCP)
 
 	// n.b. This kicks off certificate creation.
+	end = startup.Default.Begin("ca.init")
 	mitmProxy, err := proxy.NewMITMProxy(cfg.ProxyPort, headerRewriter, policyChecker, logger, cfg.MCPConfig)
+	end(err)
 	if err != nil {
 		logger.Close()
 		return nil, fmt.Errorf("failed to create MITM proxy: %w", err)
@@ -397,37 +454,80 @@ func initRuntime(cfg *runtimeConfig, leashDir string) (*runtimeState, error) {
 		telemetryProvider: telemetryProvider,
 	}
 
-	policyManager := policy.NewManager(lsmManager, func(rules *lsm.PolicySet, httpRules []proxy.HeaderRewriteRule) {
+	state.policyManager = policy.NewManager(lsmManager, func(rules *lsm.PolicySet, httpRules []proxy.HeaderRewriteRule) {
 		state.headerRewriter.SetRules(httpRules)
 		applyPolicyToProxy(state.mitmProxy, rules)
 	})
-
-	if err := policyManager.UpdateFileRules(initialPolicy.LSMPolicies, initialPolicy.HTTPRewrites); err != nil {
+	observeLSM(telemetryProvider.LSM(), wsHub, state.policyManager)
+
+	if cfg.MultiTenant {
+		// The policy file is the default for traffic outside any tenant.
+		// The programs attach once the first tenant policy is loaded.
+		applyPolicyToProxy(mitmProxy, initialPolicy.LSMPolicies)
+		headerRewriter.SetRules(initialPolicy.HTTPRewrites)
+		proxyPort, _ := strconv.Atoi(cfg.ProxyPort)
+		state.tenants = newTenantRegistry(lsmManager, mitmProxy, wsHub, logger, proxyPort, controlPort(cfg.WebBind))
+	} else if cfg.Standby {
+		// Attaching needs the claimed cgroup, but loading and verifying the
+		// programs does not.
+		if err := lsmManager.Preload(); err != nil {
+			log.Printf("Warning: failed to preload LSM programs: %v", err)
+		}
+	} else if err := state.applyPolicy(initialPolicy); err != nil {
 		state.Close()
-		return nil, fmt.Errorf("failed to load file policies: %w", err)
+		return nil, err
 	}
-	headerRewriter.SetRules(initialPolicy.HTTPRewrites)
-	state.policyManager = policyManager
-
-	logPolicyEvent("policy.restore", map[string]any{
-		"source":        "file",
-		"lsm_open":      len(initialPolicy.LSMPolicies.Open),
-		"lsm_exec":      len(initialPolicy.LSMPolicies.Exec),
-		"lsm_connect":   len(initialPolicy.LSMPolicies.Connect),
-		"http_rewrites": len(initialPolicy.HTTPRewrites),
-	})
 
 	state.policyReady.Store(false)
 
 	return state, nil
 }
 
+// applyPolicy loads the policy read at startup into the LSM programs and
+// the proxy. The first load attaches the programs to the target cgroup.
+func (rt *runtimeState) applyPolicy(cfg *policy.Config) error {
+	end := startup.Default.Begin("policy.apply")
+	err := rt.policyManager.UpdateFileRules(cfg.LSMPolicies, cfg.HTTPRewrites)
+	end(err)
+	if err != nil {
+		return fmt.Errorf("failed to load file policies: %w", err)
+	}
+	rt.headerRewriter.SetRules(cfg.HTTPRewrites)
+
+	logPolicyEvent("policy.restore", map[string]any{
+		"source":        "file",
+		"lsm_open":      len(cfg.LSMPolicies.Open),
+		"lsm_exec":      len(cfg.LSMPolicies.Exec),
+		"lsm_connect":   len(cfg.LSMPolicies.Connect),
+		"http_rewrites": len(cfg.HTTPRewrites),
+	})
+	return nil
+}
+
 func (rt *runtimeState) Run() error {
-	if err := rt.startFrontend(); err != nil {
+	if rt.cfg.MultiTenant {
+		return rt.runMultiTenant()
+	}
+	if rt.cfg.Standby {
+		end := startup.Default.Begin("pool.claim.wait")
+		err := rt.waitForClaim()
+		end(err)
+		if err != nil {
+			return err
+		}
+	}
+
+	end := startup.Default.Begin("frontend.start")
+	err := rt.startFrontend()
+	end(err)
+	if err != nil {
 		return err
 	}
 
-	if err := rt.waitForBootstrap(); err != nil {
+	end = startup.Default.Begin("bootstrap.wait")
+	err = rt.waitForBootstrap()
+	end(err)
+	if err != nil {
 		return err
 	}
 
@@ -446,9 +546,13 @@ func (rt *runtimeState) activate() error {
 		return err
 	}
 
-	if err := rt.configureNetwork(); err != nil {
+	end := startup.Default.Begin("network.configure")
+	err := rt.configureNetwork()
+	end(err)
+	if err != nil {
 		return err
 	}
+	go emitStartupTimeline()
 
 	go func() {
 		if err := rt.mitmProxy.Run(); err != nil {
@@ -465,6 +569,40 @@ func (rt *runtimeState) activate() error {
 	return nil
 }
 
+// runMultiTenant serves the tenants registered through /api/tenants. There
+// is no bootstrap handshake; a tenant is registered once its container is
+// ready.
+func (rt *runtimeState) runMultiTenant() error {
+	end := startup.Default.Begin("frontend.start")
+	err := rt.startFrontend()
+	end(err)
+	if err != nil {
+		return err
+	}
+	if err := rt.startPolicyWatcher(); err != nil {
+		return err
+	}
+
+	end = startup.Default.Begin("network.configure")
+	err = rt.configureNetwork()
+	end(err)
+	if err != nil {
+		return err
+	}
+	go emitStartupTimeline()
+
+	go func() {
+		if err := rt.mitmProxy.Run(); err != nil {
+			log.Fatal(err)
+		}
+	}()
+
+	logPolicyEvent("tenants.ready", map[string]any{"proxy_port": rt.cfg.ProxyPort, "max_tenants": lsm.MaxTenants})
+	rt.policyReady.Store(true)
+	waitForShutdown()
+	return nil
+}
+
 func (rt *runtimeState) waitForBootstrap() error {
 	path := rt.bootstrapPath
 	if strings.TrimSpace(path) == "" {
@@ -472,32 +610,63 @@ func (rt *runtimeState) waitForBootstrap() error {
 		rt.bootstrapPath = path
 	}
 
-	deadline := time.Now().Add(rt.cfg.BootstrapTimeout)
 	logPolicyEvent("bootstrap.wait", map[string]any{
 		"path":    path,
 		"timeout": rt.cfg.BootstrapTimeout.String(),
 	})
 
-	for {
-		info, err := os.Stat(path)
-		if err == nil {
-			meta, metaErr := readBootstrapMetadata(path)
-			if metaErr != nil {
-				logPolicyEvent("bootstrap.ready", map[string]any{"path": path, "error": metaErr.Error()})
-			} else {
-				meta["mtime"] = info.ModTime().UTC().Format(time.RFC3339Nano)
-				logPolicyEvent("bootstrap.ready", meta)
-			}
-			return nil
-		}
-		if err != nil && !os.IsNotExist(err) {
-			return fmt.Errorf("check bootstrap marker: %w", err)
-		}
-		if time.Now().After(deadline) {
+	started := time.Now()
+	ctx, cancel := context.WithTimeout(context.Background(), rt.cfg.BootstrapTimeout)
+	defer cancel()
+	if err := entrypoint.WaitForFile(ctx, path, 250*time.Millisecond); err != nil {
+		if errors.Is(err, context.DeadlineExceeded) {
 			return fmt.Errorf("bootstrap marker %s not observed within %s", path, rt.cfg.BootstrapTimeout)
 		}
-		time.Sleep(250 * time.Millisecond)
+		return fmt.Errorf("check bootstrap marker: %w", err)
+	}
+
+	meta, metaErr := readBootstrapMetadata(path)
+	if metaErr != nil {
+		meta = map[string]any{"path": path, "error": metaErr.Error()}
+	} else if info, err := os.Stat(path); err == nil {
+		meta["mtime"] = info.ModTime().UTC().Format(time.RFC3339Nano)
+	}
+	if raw, ok := meta["timeline"]; ok {
+		// leash-entry's phases are reported with leashd's own.
+		delete(meta, "timeline")
+		var entry startup.Snapshot
+		if data, err := json.Marshal(raw); err == nil && json.Unmarshal(data, &entry) == nil {
+			startup.Default.Merge(entry)
+		}
+	}
+	meta["wait_ms"] = time.Since(started).Milliseconds()
+	logPolicyEvent("bootstrap.ready", meta)
+	return nil
+}
+
+// startupTimelineWait bounds how long the timeline waits for phases still in
+// flight, such as BPF programs attaching in the background.
+const startupTimelineWait = 30 * time.Second
+
+// emitStartupTimeline logs one event=startup.timeline line once every phase
+// begun so far has finished, and writes the trace file when
+// LEASH_STARTUP_TRACE is set.
+func emitStartupTimeline() {
+	ctx, cancel := context.WithTimeout(context.Background(), startupTimelineWait)
+	defer cancel()
+	waitErr := startup.Default.Wait(ctx)
+	s, path, err := startup.Default.Flush()
+	fields := s.Fields()
+	if waitErr != nil {
+		fields["incomplete"] = true
+	}
+	if path != "" {
+		fields["trace"] = path
+	}
+	if err != nil {
+		fields["error"] = err.Error()
 	}
+	logPolicyEvent("startup.timeline", fields)
 }
 
 func readBootstrapMetadata(path string) (map[string]any, error) {
@@ -536,12 +705,21 @@ func (rt *runtimeState) Close() {
 		if rt.policyWatcherStop != nil {
 			rt.policyWatcherStop()
 		}
+		if rt.profilerStop != nil {
+			rt.profilerStop()
+		}
 		if rt.logger != nil {
 			_ = rt.logger.Close()
 		}
 	})
 }
 
+// profileTagger tags profiles with the hub's event rate and the active
+// policy version.
+func (rt *runtimeState) profileTagger() profileTagger {
+	return profileTagger{lastSeq: rt.wsHub.LastSeq, policyVersion: rt.policyManager.Version}
+}
+
 func (rt *runtimeState) startFrontend() error {
 	uiFS, err := fs.Sub(ui.Dir, "dist")
 	if err != nil {
@@ -564,15 +742,25 @@ func (rt *runtimeState) startFrontend() error {
 		w.WriteHeader(http.StatusOK)
 		_, _ = w.Write([]byte("ready"))
 	})
+	mux.Handle("/metrics", metrics.Default.Handler())
+	if rt.cfg.Pprof {
+		registerProfiling(mux, rt.profileTagger())
+	}
 	title := ui.ComposeTitle(os.Getenv("LEASH_PROJECT"), os.Getenv("LEASH_COMMAND"))
 	mux.Handle("/", ui.NewSPAHandlerWithTitle(http.FS(uiFS), title))
 
 	api := newPolicyAPI(rt.policyManager, rt.cfg.PolicyPath, rt.wsHub, rt.mitmProxy, rt.wsHub)
+	api.eventLogPath = rt.cfg.LogPath
 	api.register(mux)
 
 	// Suggestion API for raw suggestions preview
 	suggest := newSuggestAPI(rt.policyManager, rt.wsHub)
 	suggest.register(mux)
+	suggest.start()
+
+	if rt.tenants != nil {
+		rt.tenants.register(mux)
+	}
 
 	if rt.cfg.WebDisabled {
 		logPolicyEvent("frontend.disabled", map[string]any{"addr": ""})
@@ -634,17 +822,13 @@ func (rt *runtimeState) configureNetwork() error {
 		return nil
 	}
 
-	// Extract leashd control plane port from WebBind (e.g., ":18080" or "127.0.0.1:18080")
-	var leashPort string
-	if rt.cfg.WebBind != "" {
-		_, port, err := net.SplitHostPort(rt.cfg.WebBind)
-		if err == nil {
-			leashPort = port
-		}
-	}
-
 	fmt.Fprintf(os.Stderr, "leash: applying network interception rules\n")
-	if err := applyNetworkRules(rt.cfg.ProxyPort, leashPort, rt.cfg.CgroupPath); err != nil {
+	if rt.cfg.MultiTenant {
+		// Tenant rules are iptables rules, so the base rules must be too.
+		if err := applyTenantBaseRules(rt.cfg.ProxyPort, controlPort(rt.cfg.WebBind)); err != nil {
+			return err
+		}
+	} else if err := applyNetworkRules(rt.cfg.ProxyPort, controlPort(rt.cfg.WebBind), rt.cfg.CgroupPath); err != nil {
 		return err
 	}
 
@@ -678,6 +862,19 @@ func (rt *runtimeState) configureNetwork() error {
 	return nil
 }
 
+// controlPort extracts the leashd control plane port from the listen
+// address (e.g., ":18080" or "127.0.0.1:18080").
+func controlPort(webBind string) string {
+	if webBind == "" {
+		return ""
+	}
+	_, port, err := net.SplitHostPort(webBind)
+	if err != nil {
+		return ""
+	}
+	return port
+}
+
 func connectDefaultAllow(policies *lsm.PolicySet) bool {
 	if policies == nil {
 		return false
@@ -777,6 +974,40 @@ func applyIptablesRules(port, leashPort, cgroupPath string) error {
 	return nil
 }
 
+// tenantChain is the nat and filter chain that holds the per-tenant rules.
+const tenantChain = "LEASH_TENANTS"
+
+// applyTenantBaseRules installs the base rules of a multi-tenant daemon for
+// IPv4 and IPv6, each with a jump to tenantChain ahead of the default
+// redirects. Unlike applyIptablesRules, IPv6 is not best-effort: a tenant's
+// IPv6 traffic would otherwise reach the default listener and the control
+// port, so any failure refuses to start.
+func applyTenantBaseRules(port, leashPort string) error {
+	if port == "" {
+		port = "18000"
+	}
+	if _, err := findIptables(); err != nil {
+		return err
+	}
+	if _, err := findIp6tables(); err != nil {
+		return err
+	}
+	for _, script := range []struct{ name, body string }{
+		{"iptables", assets.ApplyIptablesScript},
+		{"ip6tables", assets.ApplyIp6tablesScript},
+	} {
+		cmd := exec.Command("/bin/sh", "-s", port, leashPort, "")
+		cmd.Stdin = strings.NewReader(script.body)
+		cmd.Stdout = os.Stdout
+		cmd.Stderr = os.Stderr
+		cmd.Env = append(os.Environ(), "PROXY_MARK="+proxyMark, "TENANT_CHAIN="+tenantChain)
+		if err := cmd.Run(); err != nil {
+			return fmt.Errorf("apply %s tenant base rules: %w", script.name, err)
+		}
+	}
+	return nil
+}
+
 // findIptables locates the iptables binary by searching PATH first,
 // then common sbin locations used in minimal containers.
 func findIptables() (string, error) {
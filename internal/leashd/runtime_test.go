@@ -332,6 +332,23 @@ func TestPreFlightInvalidCgroup(t *testing.T) {
 	}
 }
 
+func TestPreFlightStandbySkipsCgroup(t *testing.T) {
+	t.Parallel()
+	_, _ = provisionLeashEnv(t)
+	policyPath := writePolicyFile(t, sampleCedarPolicy)
+	cfg := &runtimeConfig{
+		PolicyPath: policyPath,
+		ProxyPort:  "18000",
+		Standby:    true,
+	}
+	if err := preFlight(cfg); err != nil {
+		t.Fatalf("expected standby preFlight without a cgroup to pass, got %v", err)
+	}
+	if err := validateCgroupPath(createCgroupStub(t, false)); err == nil {
+		t.Fatalf("expected claimed cgroup without controllers to be rejected")
+	}
+}
+
 func TestPreFlightInvalidProxyPort(t *testing.T) {
 	t.Parallel()
 	_, _ = provisionLeashEnv(t)
@@ -375,6 +392,17 @@ func TestParseConfigListenEnvValue(t *testing.T) {
 	}
 }
 
+func TestParseConfigStandbyEnv(t *testing.T) {
+	t.Setenv("LEASH_STANDBY", "1")
+	cfg, err := parseConfig([]string{"leashd"})
+	if err != nil {
+		t.Fatalf("parseConfig returned error: %v", err)
+	}
+	if !cfg.Standby {
+		t.Fatalf("expected standby mode from LEASH_STANDBY=1")
+	}
+}
+
 func TestParseConfigListenFlagOverridesEnv(t *testing.T) {
 	t.Setenv("LEASH_LISTEN", ":19001")
 	cfg, err := parseConfig([]string{"leashd", "--listen", "127.0.0.1:19002"})
@@ -431,3 +459,38 @@ func TestPreFlightMissingIptables(t *testing.T) {
 		t.Fatalf("expected iptables error, got %v", err)
 	}
 }
+
+func TestPreFlightMultiTenantRequiresIp6tables(t *testing.T) {
+	if runtime.GOOS != "linux" {
+		t.Skip("iptables dependency only enforced on linux")
+	}
+	policyPath := writePolicyFile(t, sampleCedarPolicy)
+	binDir := filepath.Join(t.TempDir(), "bin")
+	if err := os.MkdirAll(binDir, 0o755); err != nil {
+		t.Fatalf("failed to create bin dir: %v", err)
+	}
+	for _, name := range []string{"mount", "iptables"} {
+		if err := os.WriteFile(filepath.Join(binDir, name), []byte("#!/bin/sh\nexit 0\n"), 0o755); err != nil {
+			t.Fatalf("failed to create %s stub: %v", name, err)
+		}
+	}
+	t.Setenv("PATH", binDir)
+	cfg := &runtimeConfig{
+		PolicyPath:  policyPath,
+		LogPath:     filepath.Join(t.TempDir(), "events.log"),
+		ProxyPort:   "18000",
+		MultiTenant: true,
+	}
+
+	iptablesOverrideMu.Lock()
+	restoreName := ip6tablesBinaryName
+	ip6tablesBinaryName = "ip6tables_missing_for_test"
+	t.Cleanup(func() {
+		ip6tablesBinaryName = restoreName
+		iptablesOverrideMu.Unlock()
+	})
+
+	if err := preFlight(cfg); err == nil || !strings.Contains(err.Error(), "ip6tables") {
+		t.Fatalf("expected ip6tables error, got %v", err)
+	}
+}
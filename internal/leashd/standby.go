@@ -0,0 +1,77 @@
+package leashd
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"time"
+
+	cedarutil "github.com/strongdm/leash/internal/cedar"
+	"github.com/strongdm/leash/internal/entrypoint"
+	"github.com/strongdm/leash/internal/policy"
+	"github.com/strongdm/leash/internal/telemetry/startup"
+)
+
+// claimPoll is the fallback re-check interval while a standby daemon waits to
+// be claimed; creation of the claim file is normally seen through inotify.
+const claimPoll = time.Second
+
+// waitForClaim parks a standby daemon until a session writes its claim into
+// the share dir. The daemon then binds to the claimed cgroup and applies the
+// policy the session put in place, which attaches the preloaded programs.
+func (rt *runtimeState) waitForClaim() error {
+	path := filepath.Join(filepath.Dir(rt.bootstrapPath), entrypoint.PoolClaimFileName)
+	logPolicyEvent("pool.standby", map[string]any{"path": path})
+
+	started := time.Now()
+	if err := entrypoint.WaitForFile(context.Background(), path, claimPoll); err != nil {
+		return fmt.Errorf("wait for pool claim: %w", err)
+	}
+	claim, err := entrypoint.ReadPoolClaim(path)
+	if err != nil {
+		return err
+	}
+	if err := validateCgroupPath(claim.CgroupPath); err != nil {
+		return err
+	}
+
+	rt.cfg.CgroupPath = claim.CgroupPath
+	rt.lsmManager.SetCgroupPath(claim.CgroupPath)
+	// The frontend reads these for its title when it starts.
+	for key, value := range map[string]string{
+		"LEASH_SESSION_ID":     claim.SessionID,
+		"LEASH_WORKSPACE_HASH": claim.WorkspaceHash,
+		"LEASH_PROJECT":        claim.Project,
+		"LEASH_COMMAND":        claim.Command,
+	} {
+		if strings.TrimSpace(value) != "" {
+			_ = os.Setenv(key, value)
+		}
+	}
+
+	// The session copies its policy into /cfg before claiming, so the policy
+	// parsed at startup may be stale.
+	end := startup.Default.Begin("policy.compile")
+	cfg, err := policy.Parse(rt.cfg.PolicyPath)
+	end(err)
+	if err != nil {
+		var detail *cedarutil.ErrorDetail
+		if errors.As(err, &detail) {
+			return errors.New(formatCedarErrorForCLI(detail))
+		}
+		return fmt.Errorf("failed to parse Cedar policy: %w", err)
+	}
+	if err := rt.applyPolicy(cfg); err != nil {
+		return err
+	}
+
+	logPolicyEvent("pool.claim", map[string]any{
+		"cgroup":     claim.CgroupPath,
+		"session_id": claim.SessionID,
+		"wait_ms":    time.Since(started).Milliseconds(),
+	})
+	return nil
+}
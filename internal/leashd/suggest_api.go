@@ -1,29 +1,135 @@
 package leashd
 
 import (
+	"context"
 	"net/http"
 	"strconv"
+	"strings"
+	"sync"
 	"time"
 
 	"github.com/strongdm/leash/internal/policy"
 	"github.com/strongdm/leash/internal/policy/suggest"
+	"github.com/strongdm/leash/internal/policy/suggest/drift"
+	"github.com/strongdm/leash/internal/telemetry/metrics"
 	"github.com/strongdm/leash/internal/websocket"
 )
 
+// suggestUpdateInterval bounds how often the engine is re-ranked for
+// suggest.update pushes; bursts of events collapse into one recompute.
+const suggestUpdateInterval = 2 * time.Second
+
+// suggestBudget is the default time /suggest spends analysing before it
+// answers with whatever passes have finished. Requests may lower or raise it
+// with ?budget= up to suggestMaxBudget.
+const (
+	suggestBudget    = 2 * time.Second
+	suggestMaxBudget = 30 * time.Second
+)
+
+// suggestDriftContributors is how many tokens a drift report lists.
+const suggestDriftContributors = 5
+
+var (
+	suggestLatencyAPI     = metrics.Default.Histogram("leash_suggest_seconds", "Time to compute a suggestion ranking.", metrics.DefBuckets, "source", "api")
+	suggestLatencyPublish = metrics.Default.Histogram("leash_suggest_seconds", "Time to compute a suggestion ranking.", metrics.DefBuckets, "source", "publish")
+)
+
 type suggestAPI struct {
-	mgr  *policy.Manager
-	hub  *websocket.WebSocketHub
-	opts suggest.Options
+	mgr    *policy.Manager
+	hub    *websocket.WebSocketHub
+	opts   suggest.Options
+	engine *suggest.Engine
+	cache  *suggestCache
+
+	// liveMu guards live, the memoized answer of engine.
+	liveMu sync.Mutex
+	live   suggestMemo
+}
+
+type suggestResponse struct {
+	GeneratedAt   time.Time            `json:"generated_at"`
+	EventCount    int                  `json:"event_count"`
+	SequenceCount int                  `json:"sequence_count"`
+	Suggestions   []suggest.Suggestion `json:"suggestions"`
+	// Cached is set when the answer was reused because no relevant events
+	// arrived and the policy did not change since it was computed.
+	Cached bool `json:"cached,omitempty"`
+	// Partial is set when the budget ran out before every pass finished.
+	Partial bool                `json:"partial,omitempty"`
+	Timings []suggestPassTiming `json:"timings,omitempty"`
+	// Drift is the live drift monitor's state; only engine answers carry it.
+	Drift *suggestDrift `json:"drift,omitempty"`
+}
+
+// suggestDrift is the body of suggest.drift events.
+type suggestDrift struct {
+	Drifting        bool                      `json:"drifting"`
+	PSI             float64                   `json:"psi"`
+	Threshold       float64                   `json:"threshold"`
+	CurrentEvents   float64                   `json:"current_events"`
+	ReferenceEvents float64                   `json:"reference_events"`
+	Contributors    []suggestDriftContributor `json:"contributors"`
+}
+
+type suggestDriftContributor struct {
+	Token string  `json:"token"`
+	Value float64 `json:"value"`
+}
+
+func (api *suggestAPI) driftReport(status drift.StreamStatus) *suggestDrift {
+	out := &suggestDrift{
+		Drifting:        status.IsDrift,
+		PSI:             status.PSI,
+		Threshold:       api.engine.Options().DriftThreshold,
+		CurrentEvents:   status.Current,
+		ReferenceEvents: status.Reference,
+		Contributors:    make([]suggestDriftContributor, 0, len(status.TopContributors)),
+	}
+	for _, c := range status.TopContributors {
+		out.Contributors = append(out.Contributors, suggestDriftContributor{Token: c.Token, Value: c.Value})
+	}
+	return out
+}
+
+type suggestPassTiming struct {
+	Pass       string  `json:"pass"`
+	DurationMS float64 `json:"duration_ms"`
+	Completed  bool    `json:"completed"`
+}
+
+func passTimings(timings []suggest.PassTiming) []suggestPassTiming {
+	out := make([]suggestPassTiming, 0, len(timings))
+	for _, t := range timings {
+		out = append(out, suggestPassTiming{
+			Pass:       t.Pass,
+			DurationMS: float64(t.Duration) / float64(time.Millisecond),
+			Completed:  t.Completed,
+		})
+	}
+	return out
 }
 
 func newSuggestAPI(mgr *policy.Manager, hub *websocket.WebSocketHub) *suggestAPI {
+	opts := suggest.DefaultOptions()
 	return &suggestAPI{
-		mgr:  mgr,
-		hub:  hub,
-		opts: suggest.DefaultOptions(),
+		mgr:    mgr,
+		hub:    hub,
+		opts:   opts,
+		engine: suggest.NewEngine(opts),
+		cache:  newSuggestCache(),
 	}
 }
 
+// start feeds the streaming engine from the hub and pushes suggest.update
+// whenever the ranking changes. The returned func stops both.
+func (api *suggestAPI) start() func() {
+	ctx, cancel := context.WithCancel(context.Background())
+	go api.engine.Run(ctx, api.hub)
+	go api.publish(ctx, suggestUpdateInterval)
+	return cancel
+}
+
 func (api *suggestAPI) register(mux *http.ServeMux) {
 	mux.HandleFunc("/suggest", api.handleSuggest)
 }
@@ -40,40 +146,113 @@ func (api *suggestAPI) handleSuggest(w http.ResponseWriter, r *http.Request) {
 	}
 
 	opts := api.opts
+	query := r.URL.Query()
+	budget := suggestBudget
+	if budgetStr := query.Get("budget"); budgetStr != "" {
+		if dur, err := time.ParseDuration(budgetStr); err == nil && dur > 0 {
+			budget = min(dur, suggestMaxBudget)
+		}
+	}
+	ctx, cancel := context.WithTimeout(r.Context(), budget)
+	defer cancel()
+	defer suggestLatencyAPI.Since(time.Now())
 
-	if tailStr := r.URL.Query().Get("tail"); tailStr != "" {
+	if query.Get("tail") == "" && query.Get("window") == "" {
+		writeJSON(w, http.StatusOK, api.engineResponse(ctx))
+		return
+	}
+
+	if tailStr := query.Get("tail"); tailStr != "" {
 		if v, err := strconv.Atoi(tailStr); err == nil {
 			opts.TailLimit = v
 		}
 	}
-	if winStr := r.URL.Query().Get("window"); winStr != "" {
+	if winStr := query.Get("window"); winStr != "" {
 		if dur, err := time.ParseDuration(winStr); err == nil {
 			opts.SessionWindow = dur
 		}
 	}
 
-	events := api.hub.RecentEvents(opts.TailLimit)
-	sequences := suggest.BuildSequencesFromLogs(events, opts.SessionWindow)
-	policies, httpRules := api.mgr.GetActiveRules()
-
-	inputs := suggest.Inputs{
-		LSMPolicies:    policies,
-		HTTPRewrites:   httpRules,
-		EventSequences: sequences,
+	// A tail of zero or less means the whole buffer; the engine needs the
+	// bound spelled out.
+	if opts.TailLimit <= 0 {
+		opts.TailLimit = api.hub.BufferSize()
 	}
-	result := suggest.Analyze(inputs, opts)
-
-	response := struct {
-		GeneratedAt   time.Time            `json:"generated_at"`
-		EventCount    int                  `json:"event_count"`
-		SequenceCount int                  `json:"sequence_count"`
-		Suggestions   []suggest.Suggestion `json:"suggestions"`
-	}{
-		GeneratedAt:   time.Now().UTC(),
-		EventCount:    len(events),
-		SequenceCount: len(sequences),
-		Suggestions:   result.Suggestions,
+
+	entry := api.cache.entry(opts)
+	entry.mu.Lock()
+	defer entry.mu.Unlock()
+	api.catchUp(entry, opts)
+	writeJSON(w, http.StatusOK, api.answer(ctx, entry.engine, &entry.memo))
+}
+
+// engineResponse answers from the streaming engine's materialized state,
+// within the time left on ctx. The drift report is always current.
+func (api *suggestAPI) engineResponse(ctx context.Context) suggestResponse {
+	api.liveMu.Lock()
+	resp := api.answer(ctx, api.engine, &api.live)
+	api.liveMu.Unlock()
+	resp.Drift = api.driftReport(api.engine.Drift(suggestDriftContributors))
+	return resp
+}
+
+// publish re-ranks when the engine or the active policy has changed since the
+// last tick and emits suggest.update only if the ranking differs from the one
+// last pushed. It also emits suggest.drift whenever the live drift monitor
+// raises or clears an alert.
+func (api *suggestAPI) publish(ctx context.Context, interval time.Duration) {
+	ticker := time.NewTicker(interval)
+	defer ticker.Stop()
+
+	var lastEngine, lastPolicy, lastDrift uint64
+	lastRanking := ""
+	for {
+		select {
+		case <-ctx.Done():
+			return
+		case <-ticker.C:
+		}
+		if status := api.engine.Drift(suggestDriftContributors); status.Transitions != lastDrift {
+			lastDrift = status.Transitions
+			api.hub.EmitJSON("suggest.drift", api.driftReport(status))
+		}
+		engineVersion, policyVersion := api.engine.Version(), api.mgr.Version()
+		if engineVersion == lastEngine && policyVersion == lastPolicy {
+			continue
+		}
+
+		budgetCtx, cancel := context.WithTimeout(ctx, suggestBudget)
+		start := time.Now()
+		resp := api.engineResponse(budgetCtx)
+		suggestLatencyPublish.Since(start)
+		cancel()
+		// A partial ranking is not pushed, and the versions are left alone
+		// so the next tick tries again.
+		if resp.Partial {
+			continue
+		}
+		lastEngine, lastPolicy = engineVersion, policyVersion
+		ranking := suggestionRanking(resp.Suggestions)
+		if ranking == lastRanking {
+			continue
+		}
+		lastRanking = ranking
+		api.hub.EmitJSON("suggest.update", resp)
 	}
+}
 
-	writeJSON(w, http.StatusOK, response)
+// suggestionRanking identifies the ordered suggestion list by what a reader
+// would notice changing: which suggestions appear, in what order, and their
+// policy counts. Score drift alone does not trigger a push.
+func suggestionRanking(suggestions []suggest.Suggestion) string {
+	var sb strings.Builder
+	for _, s := range suggestions {
+		sb.WriteString(string(s.Kind))
+		sb.WriteByte('|')
+		sb.WriteString(s.Summary)
+		sb.WriteByte('|')
+		sb.WriteString(strconv.Itoa(s.PolicyCount))
+		sb.WriteByte('\n')
+	}
+	return sb.String()
 }
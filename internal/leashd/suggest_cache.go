@@ -0,0 +1,131 @@
+package leashd
+
+import (
+	"context"
+	"fmt"
+	"hash/fnv"
+	"sync"
+	"time"
+
+	"github.com/strongdm/leash/internal/policy/suggest"
+)
+
+// suggestCacheSize bounds how many tail/window combinations keep an engine.
+const suggestCacheSize = 8
+
+// suggestCache holds an engine per option set for /suggest queries that pass
+// tail or window. Each engine is fed only the hub entries that arrived since
+// the previous request with those options, so a poll with no new events
+// returns the stored answer and a poll after a few events folds in just
+// those.
+type suggestCache struct {
+	mu      sync.Mutex
+	entries map[uint64]*suggestCacheEntry
+	tick    uint64
+}
+
+type suggestCacheEntry struct {
+	mu     sync.Mutex
+	engine *suggest.Engine
+	// seq is the hub sequence number of the last entry fed to engine.
+	seq  uint64
+	memo suggestMemo
+	used uint64
+}
+
+// suggestMemo is one computed answer and the versions it was computed from.
+type suggestMemo struct {
+	valid         bool
+	engineVersion uint64
+	policyVersion uint64
+	resp          suggestResponse
+}
+
+func newSuggestCache() *suggestCache {
+	return &suggestCache{entries: make(map[uint64]*suggestCacheEntry)}
+}
+
+// entry returns the cache slot for opts, evicting the least recently used
+// slot when full. Callers lock the entry while using it.
+func (c *suggestCache) entry(opts suggest.Options) *suggestCacheEntry {
+	key := optionsHash(opts)
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	c.tick++
+	e := c.entries[key]
+	if e == nil {
+		if len(c.entries) >= suggestCacheSize {
+			var oldest uint64
+			for k, candidate := range c.entries {
+				if e == nil || candidate.used < e.used {
+					oldest, e = k, candidate
+				}
+			}
+			delete(c.entries, oldest)
+		}
+		e = &suggestCacheEntry{}
+		c.entries[key] = e
+	}
+	e.used = c.tick
+	return e
+}
+
+func optionsHash(opts suggest.Options) uint64 {
+	h := fnv.New64a()
+	fmt.Fprintf(h, "%#v", opts)
+	return h.Sum64()
+}
+
+// catchUp feeds the entry's engine the hub entries it has not seen yet. The
+// engine is rebuilt from the buffer when it is new, when some entries have
+// already left the buffer, or when the delta alone would fill the window.
+func (api *suggestAPI) catchUp(e *suggestCacheEntry, opts suggest.Options) {
+	if e.engine != nil {
+		if api.hub.LastSeq() == e.seq {
+			return
+		}
+		if events, ok := api.hub.EventsSince(e.seq); ok && len(events) <= opts.TailLimit {
+			for _, entry := range events {
+				e.engine.Observe(entry)
+				e.seq = entry.Seq
+			}
+			return
+		}
+	}
+
+	e.engine = suggest.NewEngine(opts)
+	e.memo = suggestMemo{}
+	e.seq = 0
+	for _, entry := range api.hub.RecentEvents(opts.TailLimit) {
+		e.engine.Observe(entry)
+		e.seq = entry.Seq
+	}
+}
+
+// answer returns engine's suggestions, reusing memo while neither the engine
+// nor the active policy has changed. Partial answers are not kept. The caller
+// serializes access to memo.
+func (api *suggestAPI) answer(ctx context.Context, engine *suggest.Engine, memo *suggestMemo) suggestResponse {
+	engineVersion, policyVersion := engine.Version(), api.mgr.Version()
+	if memo.valid && memo.engineVersion == engineVersion && memo.policyVersion == policyVersion {
+		resp := memo.resp
+		resp.Cached = true
+		return resp
+	}
+
+	policies, httpRules := api.mgr.GetActiveRules()
+	result, stats := engine.Analyze(ctx, policies, httpRules)
+	resp := suggestResponse{
+		GeneratedAt:   time.Now().UTC(),
+		EventCount:    stats.Events,
+		SequenceCount: stats.Sequences,
+		Suggestions:   result.Suggestions,
+		Partial:       result.Partial,
+		Timings:       passTimings(result.Timings),
+	}
+	if !resp.Partial {
+		*memo = suggestMemo{valid: true, engineVersion: engineVersion, policyVersion: policyVersion, resp: resp}
+	}
+	return resp
+}
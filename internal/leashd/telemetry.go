@@ -0,0 +1,61 @@
+package leashd
+
+import (
+	"log"
+	"strings"
+
+	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/policy"
+	"github.com/strongdm/leash/internal/telemetry/otel"
+	websockethub "github.com/strongdm/leash/internal/websocket"
+)
+
+// observeLSM feeds LSM decisions, ring buffer lag and policy reloads to
+// OTel. Decisions are taken from the hub rather than the LSM readers so that
+// sampled denials can name their event's sequence number. Nothing is
+// installed when telemetry is off.
+func observeLSM(inst *otel.LSMInstruments, hub *websockethub.WebSocketHub, mgr *policy.Manager) {
+	if inst == nil {
+		return
+	}
+	for _, program := range lsm.Programs {
+		if err := inst.ObserveRingBufferLag(program, func() int64 { return lsm.PendingBytes(program) }); err != nil {
+			log.Printf("Warning: failed to observe %s ring buffer lag: %v", program, err)
+		}
+	}
+	mgr.SetReloadObserver(inst.RecordPolicyReload)
+	hub.SetObserver(func(entry websockethub.LogEntry) {
+		op, ok := lsmOperation(entry.Event)
+		if !ok {
+			return
+		}
+		d := otel.LSMDecision{
+			Operation: op,
+			Denied:    entry.Decision == "denied",
+			Seq:       entry.Seq,
+			Exe:       entry.Exe,
+			Target:    entry.Path,
+		}
+		if entry.PID != nil {
+			d.PID = *entry.PID
+		}
+		if op == otel.LSMNetConnect {
+			d.Target = entry.Addr
+		}
+		inst.RecordDecision(d)
+	})
+}
+
+// lsmOperation maps an LSM event name to its operation. File opens carry
+// their access mode as a suffix (file.open:ro).
+func lsmOperation(event string) (otel.LSMOperation, bool) {
+	switch {
+	case event == "proc.exec":
+		return otel.LSMProcExec, true
+	case event == "net.send":
+		return otel.LSMNetConnect, true
+	case event == "file.open" || strings.HasPrefix(event, "file.open:"):
+		return otel.LSMFileOpen, true
+	}
+	return 0, false
+}
@@ -0,0 +1,343 @@
+package leashd
+
+import (
+	"cmp"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"net/http"
+	"os"
+	"os/exec"
+	"slices"
+	"strconv"
+	"strings"
+	"sync"
+
+	"github.com/strongdm/leash/internal/assets"
+	cedarutil "github.com/strongdm/leash/internal/cedar"
+	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/proxy"
+	websockethub "github.com/strongdm/leash/internal/websocket"
+)
+
+// tenantEnforcer loads tenant policies into the LSM programs.
+type tenantEnforcer interface {
+	AddTenant(cgroupPath string, policies *lsm.PolicySet) (lsm.Tenant, error)
+	RemoveTenant(id uint64) error
+}
+
+// tenantProxy serves each tenant on its own proxy listener.
+type tenantProxy interface {
+	AddTenant(id uint64, port string, policyChecker proxy.PolicyChecker, headerRewriter *proxy.HeaderRewriter) (int, error)
+	SetTenantPolicyChecker(id uint64, pc proxy.PolicyChecker) error
+	RemoveTenant(id uint64) error
+}
+
+// tenantEvents is the event history tenant streams are filtered from.
+type tenantEvents interface {
+	EventsSince(seq uint64) ([]websockethub.LogEntry, bool)
+	RecentEvents(limit int) []websockethub.LogEntry
+}
+
+// applyTenantNetworkRules installs ("add") or removes ("del") the IPv4 and
+// IPv6 rules that send a tenant cgroup's traffic to its proxy listener.
+// Tests replace it.
+var applyTenantNetworkRules = func(action string, port int, proxyPorts, leashPort, cgroupPath string) error {
+	if _, err := findIptables(); err != nil {
+		return err
+	}
+	if _, err := findIp6tables(); err != nil {
+		return err
+	}
+	cmd := exec.Command("/bin/sh", "-s", action, strconv.Itoa(port), proxyPorts, leashPort, cgroupPath)
+	cmd.Stdin = strings.NewReader(assets.ApplyTenantIptablesScript)
+	cmd.Stdout = os.Stdout
+	cmd.Stderr = os.Stderr
+	cmd.Env = append(os.Environ(), "TENANT_CHAIN="+tenantChain)
+	return cmd.Run()
+}
+
+type tenantEntry struct {
+	tenant         lsm.Tenant
+	port           int
+	cedar          string
+	headerRewriter *proxy.HeaderRewriter
+}
+
+// tenantInfo is the API view of a tenant.
+type tenantInfo struct {
+	ID     uint64 `json:"id"`
+	Cgroup string `json:"cgroup"`
+	Port   int    `json:"port"`
+	Cedar  string `json:"cedar"`
+}
+
+// tenantRegistry tracks the tenants of a multi-tenant leashd. Tenant
+// listeners use the ports right after the default proxy port, one slot per
+// tenant, so one port range covers every listener in the isolation rules.
+type tenantRegistry struct {
+	enforcer  tenantEnforcer
+	proxy     tenantProxy
+	events    tenantEvents
+	logger    *lsm.SharedLogger
+	proxyPort int
+	leashPort string
+
+	mu      sync.Mutex
+	tenants map[uint64]*tenantEntry
+}
+
+func newTenantRegistry(enforcer tenantEnforcer, p tenantProxy, events tenantEvents, logger *lsm.SharedLogger, proxyPort int, leashPort string) *tenantRegistry {
+	return &tenantRegistry{
+		enforcer:  enforcer,
+		proxy:     p,
+		events:    events,
+		logger:    logger,
+		proxyPort: proxyPort,
+		leashPort: leashPort,
+		tenants:   make(map[uint64]*tenantEntry),
+	}
+}
+
+func (r *tenantRegistry) proxyPorts() string {
+	return fmt.Sprintf("%d:%d", r.proxyPort, r.proxyPort+lsm.MaxTenants)
+}
+
+// freePortLocked returns the first tenant slot port not in use.
+func (r *tenantRegistry) freePortLocked() (int, error) {
+	used := make(map[int]bool, len(r.tenants))
+	for _, e := range r.tenants {
+		used[e.port] = true
+	}
+	for port := r.proxyPort + 1; port <= r.proxyPort+lsm.MaxTenants; port++ {
+		if !used[port] {
+			return port, nil
+		}
+	}
+	return 0, fmt.Errorf("tenant limit of %d reached", lsm.MaxTenants)
+}
+
+// put enforces cedar on the cgroup subtree at cgroupPath, registering the
+// tenant on first use and replacing its policy afterwards.
+func (r *tenantRegistry) put(cgroupPath, cedar string) (tenantInfo, error) {
+	if err := validateCgroupPath(cgroupPath); err != nil {
+		return tenantInfo{}, err
+	}
+	compilation, err := cedarutil.CompileString("tenant.cedar", cedar)
+	if err != nil {
+		return tenantInfo{}, err
+	}
+	policies := compilation.Policies
+	checker := lsm.NewSimplePolicyChecker(lsm.ConvertToConnectRules(policies.Connect), connectDefaultAllow(policies), policies.MCP)
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	tenant, err := r.enforcer.AddTenant(cgroupPath, policies)
+	if err != nil {
+		return tenantInfo{}, err
+	}
+	if e, ok := r.tenants[tenant.ID]; ok {
+		if err := r.proxy.SetTenantPolicyChecker(tenant.ID, checker); err != nil {
+			return tenantInfo{}, err
+		}
+		e.headerRewriter.SetRules(compilation.HTTPRules)
+		e.cedar = cedar
+		logPolicyEvent("tenant.update", map[string]any{"tenant": tenant.ID, "cgroup": cgroupPath})
+		return e.info(), nil
+	}
+
+	port, err := r.freePortLocked()
+	if err == nil {
+		e := &tenantEntry{tenant: tenant, cedar: cedar, headerRewriter: proxy.NewHeaderRewriter()}
+		e.headerRewriter.SetSharedLogger(r.logger)
+		e.headerRewriter.SetRules(compilation.HTTPRules)
+		if e.port, err = r.proxy.AddTenant(tenant.ID, strconv.Itoa(port), checker, e.headerRewriter); err == nil {
+			if err = applyTenantNetworkRules("add", e.port, r.proxyPorts(), r.leashPort, cgroupPath); err == nil {
+				r.tenants[tenant.ID] = e
+				logPolicyEvent("tenant.add", map[string]any{"tenant": tenant.ID, "cgroup": cgroupPath, "port": e.port})
+				return e.info(), nil
+			}
+			err = fmt.Errorf("failed to apply tenant network rules: %w", err)
+			_ = applyTenantNetworkRules("del", e.port, r.proxyPorts(), r.leashPort, cgroupPath)
+			_ = r.proxy.RemoveTenant(tenant.ID)
+		}
+	}
+	return tenantInfo{}, errors.Join(err, r.enforcer.RemoveTenant(tenant.ID))
+}
+
+// remove stops enforcing a tenant and releases its listener.
+func (r *tenantRegistry) remove(id uint64) error {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	e, ok := r.tenants[id]
+	if !ok {
+		return fmt.Errorf("unknown tenant %d", id)
+	}
+	delete(r.tenants, id)
+	err := errors.Join(
+		applyTenantNetworkRules("del", e.port, r.proxyPorts(), r.leashPort, e.tenant.CgroupPath),
+		r.proxy.RemoveTenant(id),
+		r.enforcer.RemoveTenant(id),
+	)
+	logPolicyEvent("tenant.remove", map[string]any{"tenant": id, "cgroup": e.tenant.CgroupPath})
+	return err
+}
+
+func (r *tenantRegistry) list() []tenantInfo {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	out := make([]tenantInfo, 0, len(r.tenants))
+	for _, e := range r.tenants {
+		out = append(out, e.info())
+	}
+	slices.SortFunc(out, func(a, b tenantInfo) int { return cmp.Compare(a.ID, b.ID) })
+	return out
+}
+
+func (r *tenantRegistry) get(id uint64) (tenantInfo, bool) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	e, ok := r.tenants[id]
+	if !ok {
+		return tenantInfo{}, false
+	}
+	return e.info(), true
+}
+
+func (e *tenantEntry) info() tenantInfo {
+	return tenantInfo{ID: e.tenant.ID, Cgroup: e.tenant.CgroupPath, Port: e.port, Cedar: e.cedar}
+}
+
+// eventBelongsTo reports whether an event came from the tenant. LSM events
+// carry the raw cgroup ID; proxy events on a tenant listener carry the
+// tenant ID itself.
+func eventBelongsTo(entry websockethub.LogEntry, id uint64) bool {
+	if entry.Cgroup == nil {
+		return false
+	}
+	cgroupID := uint64(*entry.Cgroup)
+	if cgroupID == id {
+		return true
+	}
+	tenant, ok := lsm.TenantOf(cgroupID)
+	return ok && tenant == id
+}
+
+func (r *tenantRegistry) register(mux *http.ServeMux) {
+	mux.HandleFunc("/api/tenants", r.handleTenants)
+	mux.HandleFunc("/api/tenants/", r.handleTenant)
+}
+
+type putTenantRequest struct {
+	Cgroup string `json:"cgroup"`
+	Cedar  string `json:"cedar"`
+}
+
+// handleTenants lists tenants (GET) or adds/updates one (POST).
+func (r *tenantRegistry) handleTenants(w http.ResponseWriter, req *http.Request) {
+	setCORS(w)
+	switch req.Method {
+	case http.MethodOptions:
+		w.WriteHeader(http.StatusNoContent)
+	case http.MethodGet:
+		writeJSON(w, http.StatusOK, map[string]any{"tenants": r.list()})
+	case http.MethodPost:
+		req.Body = http.MaxBytesReader(w, req.Body, 1<<20) // 1 MiB
+		var body putTenantRequest
+		if err := json.NewDecoder(req.Body).Decode(&body); err != nil {
+			writeJSON(w, http.StatusBadRequest, map[string]any{"error": map[string]any{"message": "invalid JSON body"}})
+			return
+		}
+		info, err := r.put(strings.TrimSpace(body.Cgroup), body.Cedar)
+		if err != nil {
+			var detail *cedarutil.ErrorDetail
+			if errors.As(err, &detail) {
+				writeJSON(w, http.StatusBadRequest, map[string]any{"error": cedarutil.BuildErrorResponse(detail)})
+				return
+			}
+			writeJSON(w, http.StatusBadRequest, map[string]any{"error": map[string]any{"message": err.Error()}})
+			return
+		}
+		writeJSON(w, http.StatusOK, info)
+	default:
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+	}
+}
+
+// handleTenant serves /api/tenants/{id} (GET, DELETE) and
+// /api/tenants/{id}/events, the tenant's slice of the event history.
+func (r *tenantRegistry) handleTenant(w http.ResponseWriter, req *http.Request) {
+	setCORS(w)
+	w.Header().Set("Access-Control-Allow-Methods", "GET, DELETE, OPTIONS")
+	if req.Method == http.MethodOptions {
+		w.WriteHeader(http.StatusNoContent)
+		return
+	}
+	rest := strings.TrimPrefix(req.URL.Path, "/api/tenants/")
+	idPart, sub, _ := strings.Cut(rest, "/")
+	id, err := strconv.ParseUint(idPart, 10, 64)
+	if err != nil {
+		http.Error(w, "invalid tenant id", http.StatusBadRequest)
+		return
+	}
+
+	switch {
+	case sub == "events" && req.Method == http.MethodGet:
+		r.handleTenantEvents(w, req, id)
+	case sub != "":
+		http.NotFound(w, req)
+	case req.Method == http.MethodGet:
+		info, ok := r.get(id)
+		if !ok {
+			http.NotFound(w, req)
+			return
+		}
+		writeJSON(w, http.StatusOK, info)
+	case req.Method == http.MethodDelete:
+		if err := r.remove(id); err != nil {
+			writeJSON(w, http.StatusNotFound, map[string]any{"error": map[string]any{"message": err.Error()}})
+			return
+		}
+		w.WriteHeader(http.StatusNoContent)
+	default:
+		http.Error(w, "method not allowed", http.StatusMethodNotAllowed)
+	}
+}
+
+// handleTenantEvents returns the tenant's buffered events, or those newer
+// than ?since=<seq> so clients can poll it as a stream.
+func (r *tenantRegistry) handleTenantEvents(w http.ResponseWriter, req *http.Request, id uint64) {
+	if _, ok := r.get(id); !ok {
+		http.NotFound(w, req)
+		return
+	}
+	var (
+		events   []websockethub.LogEntry
+		since    uint64
+		complete = true
+	)
+	if raw := req.URL.Query().Get("since"); raw != "" {
+		var err error
+		if since, err = strconv.ParseUint(raw, 10, 64); err != nil {
+			http.Error(w, "invalid since", http.StatusBadRequest)
+			return
+		}
+		events, complete = r.events.EventsSince(since)
+	} else {
+		events = r.events.RecentEvents(0)
+	}
+
+	// last_seq covers events of other tenants too, so the next poll skips them.
+	lastSeq := since
+	filtered := make([]websockethub.LogEntry, 0, len(events))
+	for _, entry := range events {
+		lastSeq = max(lastSeq, entry.Seq)
+		if eventBelongsTo(entry, id) {
+			filtered = append(filtered, entry)
+		}
+	}
+	writeJSON(w, http.StatusOK, map[string]any{"events": filtered, "last_seq": lastSeq, "complete": complete})
+}
@@ -0,0 +1,217 @@
+package leashd
+
+import (
+	"bytes"
+	"encoding/json"
+	"errors"
+	"net/http"
+	"net/http/httptest"
+	"strconv"
+	"sync"
+	"testing"
+
+	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/proxy"
+	websockethub "github.com/strongdm/leash/internal/websocket"
+)
+
+type fakeTenantEnforcer struct {
+	ids     map[string]uint64
+	removed []uint64
+}
+
+func (f *fakeTenantEnforcer) AddTenant(cgroupPath string, policies *lsm.PolicySet) (lsm.Tenant, error) {
+	id, ok := f.ids[cgroupPath]
+	if !ok {
+		return lsm.Tenant{}, errors.New("unknown cgroup")
+	}
+	return lsm.Tenant{ID: id, CgroupPath: cgroupPath}, nil
+}
+
+func (f *fakeTenantEnforcer) RemoveTenant(id uint64) error {
+	f.removed = append(f.removed, id)
+	return nil
+}
+
+type fakeTenantProxy struct {
+	ports    map[uint64]int
+	checkers map[uint64]proxy.PolicyChecker
+}
+
+func (f *fakeTenantProxy) AddTenant(id uint64, port string, pc proxy.PolicyChecker, hr *proxy.HeaderRewriter) (int, error) {
+	n, err := strconv.Atoi(port)
+	if err != nil {
+		return 0, err
+	}
+	f.ports[id] = n
+	f.checkers[id] = pc
+	return n, nil
+}
+
+func (f *fakeTenantProxy) SetTenantPolicyChecker(id uint64, pc proxy.PolicyChecker) error {
+	f.checkers[id] = pc
+	return nil
+}
+
+func (f *fakeTenantProxy) RemoveTenant(id uint64) error {
+	delete(f.ports, id)
+	delete(f.checkers, id)
+	return nil
+}
+
+type fakeTenantEvents []websockethub.LogEntry
+
+func (f fakeTenantEvents) EventsSince(seq uint64) ([]websockethub.LogEntry, bool) {
+	var out []websockethub.LogEntry
+	for _, e := range f {
+		if e.Seq > seq {
+			out = append(out, e)
+		}
+	}
+	return out, true
+}
+
+func (f fakeTenantEvents) RecentEvents(limit int) []websockethub.LogEntry { return f }
+
+// stubTenantNetworkRules records rule changes instead of running iptables.
+func stubTenantNetworkRules(t *testing.T, fail bool) *[]string {
+	t.Helper()
+	var (
+		mu    sync.Mutex
+		calls []string
+	)
+	prev := applyTenantNetworkRules
+	applyTenantNetworkRules = func(action string, port int, proxyPorts, leashPort, cgroupPath string) error {
+		mu.Lock()
+		defer mu.Unlock()
+		calls = append(calls, action+" "+strconv.Itoa(port)+" "+proxyPorts)
+		if fail && action == "add" {
+			return errors.New("iptables unavailable")
+		}
+		return nil
+	}
+	t.Cleanup(func() { applyTenantNetworkRules = prev })
+	return &calls
+}
+
+func TestTenantRegistryAddUpdateRemove(t *testing.T) {
+	calls := stubTenantNetworkRules(t, false)
+
+	cgroupA := createCgroupStub(t, true)
+	cgroupB := createCgroupStub(t, true)
+	enforcer := &fakeTenantEnforcer{ids: map[string]uint64{cgroupA: 101, cgroupB: 202}}
+	px := &fakeTenantProxy{ports: map[uint64]int{}, checkers: map[uint64]proxy.PolicyChecker{}}
+	reg := newTenantRegistry(enforcer, px, fakeTenantEvents{}, nil, 18000, "18080")
+
+	infoA, err := reg.put(cgroupA, `forbid (principal, action == Action::"NetworkConnect", resource == Host::"example.com");`)
+	if err != nil {
+		t.Fatalf("put A: %v", err)
+	}
+	infoB, err := reg.put(cgroupB, `permit (principal, action == Action::"NetworkConnect", resource == Host::"example.com");`)
+	if err != nil {
+		t.Fatalf("put B: %v", err)
+	}
+	if infoA.Port != 18001 || infoB.Port != 18002 {
+		t.Fatalf("expected consecutive tenant ports, got %d and %d", infoA.Port, infoB.Port)
+	}
+	if px.checkers[101].CheckConnect("example.com", "", 443) || !px.checkers[202].CheckConnect("example.com", "", 443) {
+		t.Fatal("expected each tenant to get its own connect policy")
+	}
+
+	// Re-registering a cgroup replaces its policy and keeps its listener.
+	if _, err := reg.put(cgroupA, `permit (principal, action == Action::"NetworkConnect", resource == Host::"example.com");`); err != nil {
+		t.Fatalf("update A: %v", err)
+	}
+	if !px.checkers[101].CheckConnect("example.com", "", 443) || px.ports[101] != 18001 {
+		t.Fatal("expected the update to replace the policy on the same port")
+	}
+
+	if err := reg.remove(101); err != nil {
+		t.Fatalf("remove: %v", err)
+	}
+	if len(reg.list()) != 1 || len(enforcer.removed) != 1 || enforcer.removed[0] != 101 {
+		t.Fatalf("unexpected state after remove: %+v %v", reg.list(), enforcer.removed)
+	}
+	// The freed slot is reused.
+	if info, err := reg.put(cgroupA, `permit (principal, action == Action::"FileOpen", resource) when { resource in [ Dir::"/tmp/" ] };`); err != nil || info.Port != 18001 {
+		t.Fatalf("expected the freed port to be reused, got %+v %v", info, err)
+	}
+	want := []string{"add 18001 18000:18064", "add 18002 18000:18064", "del 18001 18000:18064", "add 18001 18000:18064"}
+	if len(*calls) != len(want) {
+		t.Fatalf("unexpected network rule calls: %v", *calls)
+	}
+	for i := range want {
+		if (*calls)[i] != want[i] {
+			t.Fatalf("unexpected network rule calls: %v", *calls)
+		}
+	}
+}
+
+func TestTenantRegistryRollsBackWhenRulesFail(t *testing.T) {
+	stubTenantNetworkRules(t, true)
+
+	cgroup := createCgroupStub(t, true)
+	enforcer := &fakeTenantEnforcer{ids: map[string]uint64{cgroup: 7}}
+	px := &fakeTenantProxy{ports: map[uint64]int{}, checkers: map[uint64]proxy.PolicyChecker{}}
+	reg := newTenantRegistry(enforcer, px, fakeTenantEvents{}, nil, 18000, "")
+
+	if _, err := reg.put(cgroup, `permit (principal, action == Action::"FileOpen", resource) when { resource in [ Dir::"/tmp/" ] };`); err == nil {
+		t.Fatal("expected put to fail")
+	}
+	if len(reg.list()) != 0 || len(px.ports) != 0 || len(enforcer.removed) != 1 {
+		t.Fatalf("expected the tenant to be rolled back: %+v %v %v", reg.list(), px.ports, enforcer.removed)
+	}
+}
+
+func TestTenantEventsAPIFiltersByTenant(t *testing.T) {
+	stubTenantNetworkRules(t, false)
+
+	cgroup := createCgroupStub(t, true)
+	enforcer := &fakeTenantEnforcer{ids: map[string]uint64{cgroup: 55}}
+	px := &fakeTenantProxy{ports: map[uint64]int{}, checkers: map[uint64]proxy.PolicyChecker{}}
+	own, other := 55, 66
+	events := fakeTenantEvents{
+		{Seq: 1, Event: "http.request", Cgroup: &own},
+		{Seq: 2, Event: "http.request", Cgroup: &other},
+		{Seq: 3, Event: "http.request"},
+		{Seq: 4, Event: "file.open", Cgroup: &own},
+	}
+	reg := newTenantRegistry(enforcer, px, events, nil, 18000, "")
+	mux := http.NewServeMux()
+	reg.register(mux)
+
+	body, _ := json.Marshal(putTenantRequest{Cgroup: cgroup, Cedar: `permit (principal, action == Action::"FileOpen", resource) when { resource in [ Dir::"/tmp/" ] };`})
+	rec := httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodPost, "/api/tenants", bytes.NewReader(body)))
+	if rec.Code != http.StatusOK {
+		t.Fatalf("POST /api/tenants: %d %s", rec.Code, rec.Body.String())
+	}
+
+	rec = httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodGet, "/api/tenants/55/events?since=1", nil))
+	if rec.Code != http.StatusOK {
+		t.Fatalf("GET events: %d %s", rec.Code, rec.Body.String())
+	}
+	var resp struct {
+		Events  []websockethub.LogEntry `json:"events"`
+		LastSeq uint64                  `json:"last_seq"`
+	}
+	if err := json.Unmarshal(rec.Body.Bytes(), &resp); err != nil {
+		t.Fatalf("decode events: %v", err)
+	}
+	if len(resp.Events) != 1 || resp.Events[0].Seq != 4 || resp.LastSeq != 4 {
+		t.Fatalf("unexpected tenant events: %+v", resp)
+	}
+
+	rec = httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodGet, "/api/tenants/66/events", nil))
+	if rec.Code != http.StatusNotFound {
+		t.Fatalf("expected unknown tenant to 404, got %d", rec.Code)
+	}
+
+	rec = httptest.NewRecorder()
+	mux.ServeHTTP(rec, httptest.NewRequest(http.MethodDelete, "/api/tenants/55", nil))
+	if rec.Code != http.StatusNoContent {
+		t.Fatalf("DELETE tenant: %d %s", rec.Code, rec.Body.String())
+	}
+}
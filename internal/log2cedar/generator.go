@@ -1,7 +1,7 @@
 package log2cedar
 
 import (
-	"bufio"
+	"context"
 	"fmt"
 	"io"
 	"sort"
@@ -38,16 +38,9 @@ func NewGenerator(targetAllowed bool) *Generator {
 	}
 }
 
+// Ingest reads a whole log. It is IngestParallel with default options.
 func (g *Generator) Ingest(r io.Reader) error {
-	scanner := bufio.NewScanner(r)
-	for scanner.Scan() {
-		line := scanner.Text()
-		g.ProcessLine(line)
-	}
-	if err := scanner.Err(); err != nil {
-		return fmt.Errorf("failed reading log: %w", err)
-	}
-	return nil
+	return g.IngestParallel(context.Background(), r, IngestOptions{})
 }
 
 func (g *Generator) ProcessLine(line string) {
@@ -136,8 +129,13 @@ func parseKeyValuePairs(line string) (map[string]string, bool) {
 	if !strings.Contains(line, "=") {
 		return nil, false
 	}
-
 	result := make(map[string]string)
+	return result, parseKeyValuePairsInto(line, result)
+}
+
+// parseKeyValuePairsInto parses logfmt pairs into result, which callers on hot
+// paths clear and reuse between lines.
+func parseKeyValuePairsInto(line string, result map[string]string) bool {
 	i := 0
 	n := len(line)
 
@@ -193,7 +191,7 @@ func parseKeyValuePairs(line string) (map[string]string, bool) {
 		result[key] = strings.TrimSpace(value)
 	}
 
-	return result, len(result) > 0
+	return len(result) > 0
 }
 
 func matchesDecision(fields map[string]string, decision string) bool {
@@ -0,0 +1,365 @@
+package log2cedar
+
+import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"runtime"
+	"strings"
+	"sync"
+	"sync/atomic"
+)
+
+const (
+	defaultChunkSize = 4 << 20
+	suggestionShards = 64
+)
+
+// ErrTooManySuggestions is returned when a log produces more unique
+// suggestions than IngestOptions.MaxSuggestions allows.
+var ErrTooManySuggestions = errors.New("log2cedar: unique suggestion limit exceeded")
+
+// IngestOptions tunes IngestParallel. The zero value uses one worker per CPU,
+// 4 MiB chunks and no suggestion limit.
+type IngestOptions struct {
+	// Workers is the number of goroutines parsing chunks.
+	Workers int
+	// ChunkSize is the read size; chunks are cut on line boundaries. Up to
+	// 3*Workers+1 chunks are held at once (2*Workers queued, one per worker
+	// being parsed and one being filled), which bounds buffered input. A line
+	// longer than ChunkSize grows its chunk beyond that.
+	ChunkSize int
+	// MaxSuggestions caps the number of unique (action, resource) pairs kept in
+	// memory. Zero means no limit.
+	MaxSuggestions int
+	// Progress, when set, is called after each chunk is parsed. Calls are
+	// serialized.
+	Progress func(Progress)
+}
+
+// Progress reports cumulative ingest counters.
+type Progress struct {
+	// Bytes and Lines count parsed input. TotalBytes is the combined size of
+	// the inputs when known (IngestFiles), otherwise zero.
+	Bytes      int64
+	TotalBytes int64
+	Lines      int64
+	// Matched counts lines whose decision matched the generator's target.
+	Matched int64
+	// Unique is the number of distinct suggestions seen so far.
+	Unique int64
+}
+
+// IngestFiles runs IngestParallel over each path in order, e.g. a log and its
+// rotated segments, reporting progress against their combined size.
+func (g *Generator) IngestFiles(ctx context.Context, paths []string, opts IngestOptions) error {
+	var total int64
+	for _, path := range paths {
+		info, err := os.Stat(path)
+		if err != nil {
+			return fmt.Errorf("failed reading log: %w", err)
+		}
+		total += info.Size()
+	}
+
+	ing := g.newIngester(opts, total)
+	for _, path := range paths {
+		f, err := os.Open(path)
+		if err != nil {
+			return fmt.Errorf("failed reading log: %w", err)
+		}
+		err = ing.run(ctx, f)
+		f.Close()
+		if err != nil {
+			return err
+		}
+	}
+	ing.merge(g)
+	return nil
+}
+
+// IngestParallel reads r in large chunks split on line boundaries and parses
+// them on a worker pool. Suggestions are deduplicated in a sharded set and
+// merged into the generator once the input is exhausted, so the result is the
+// same as feeding every line to ProcessLine.
+func (g *Generator) IngestParallel(ctx context.Context, r io.Reader, opts IngestOptions) error {
+	ing := g.newIngester(opts, 0)
+	if err := ing.run(ctx, r); err != nil {
+		return err
+	}
+	ing.merge(g)
+	return nil
+}
+
+type ingester struct {
+	opts          IngestOptions
+	matchDecision string
+	set           *suggestionSet
+	buffers       sync.Pool
+
+	progressMu sync.Mutex
+	progress   Progress
+}
+
+func (g *Generator) newIngester(opts IngestOptions, total int64) *ingester {
+	if opts.Workers <= 0 {
+		opts.Workers = runtime.GOMAXPROCS(0)
+	}
+	if opts.ChunkSize <= 0 {
+		opts.ChunkSize = defaultChunkSize
+	}
+	ing := &ingester{
+		opts:          opts,
+		matchDecision: g.matchDecision,
+		set:           newSuggestionSet(opts.MaxSuggestions),
+	}
+	ing.progress.TotalBytes = total
+	ing.buffers.New = func() any {
+		buf := make([]byte, opts.ChunkSize)
+		return &buf
+	}
+	return ing
+}
+
+// run splits r into chunks ending at a newline and fans them out to workers.
+// Buffers are recycled through a pool; a line longer than the chunk size grows
+// its buffer rather than failing.
+func (ing *ingester) run(ctx context.Context, r io.Reader) error {
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+
+	chunks := make(chan *[]byte, ing.opts.Workers*2)
+	var (
+		wg       sync.WaitGroup
+		errOnce  sync.Once
+		firstErr error
+	)
+	fail := func(err error) {
+		errOnce.Do(func() {
+			firstErr = err
+			cancel()
+		})
+	}
+
+	for i := 0; i < ing.opts.Workers; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			fields := make(map[string]string, 16)
+			seen := make(map[suggestion]struct{})
+			for buf := range chunks {
+				if err := ing.parseChunk(*buf, fields, seen); err != nil {
+					fail(err)
+				}
+				ing.release(buf)
+			}
+		}()
+	}
+
+	readErr := ing.split(ctx, r, chunks)
+	close(chunks)
+	wg.Wait()
+
+	if readErr != nil {
+		if errors.Is(readErr, context.Canceled) && firstErr != nil {
+			return firstErr
+		}
+		return readErr
+	}
+	return firstErr
+}
+
+func (ing *ingester) split(ctx context.Context, r io.Reader, chunks chan<- *[]byte) error {
+	var carry []byte
+	for {
+		if err := ctx.Err(); err != nil {
+			return err
+		}
+
+		buf := ing.buffers.Get().(*[]byte)
+		if len(carry) >= len(*buf) {
+			ing.release(buf)
+			grown := make([]byte, 2*len(carry))
+			buf = &grown
+		}
+		data := *buf
+		n := copy(data, carry)
+		m, err := io.ReadFull(r, data[n:])
+		n += m
+		eof := errors.Is(err, io.EOF) || errors.Is(err, io.ErrUnexpectedEOF)
+		if err != nil && !eof {
+			ing.release(buf)
+			return fmt.Errorf("failed reading log: %w", err)
+		}
+
+		if eof && n == 0 {
+			ing.release(buf)
+			return nil
+		}
+		cut := n
+		if !eof {
+			cut = bytes.LastIndexByte(data[:n], '\n') + 1
+		}
+		if cut == 0 {
+			// No newline in a full buffer: keep accumulating this line.
+			carry = append(carry[:0], data[:n]...)
+			ing.release(buf)
+			continue
+		}
+		carry = append(carry[:0], data[cut:n]...)
+
+		chunk := data[:cut]
+		select {
+		case chunks <- &chunk:
+		case <-ctx.Done():
+			ing.release(buf)
+			return ctx.Err()
+		}
+		if eof {
+			return nil
+		}
+	}
+}
+
+func (ing *ingester) release(buf *[]byte) {
+	if cap(*buf) != ing.opts.ChunkSize {
+		return
+	}
+	full := (*buf)[:cap(*buf)]
+	ing.buffers.Put(&full)
+}
+
+// parseChunk parses complete lines. seen is the worker's own record of
+// suggestions already in the shared set, so repeats skip the shard lock. Its
+// keys are the copies returned by add and never alias a log line.
+func (ing *ingester) parseChunk(chunk []byte, fields map[string]string, seen map[suggestion]struct{}) error {
+	size := int64(len(chunk))
+	var lines, matched int64
+	for len(chunk) > 0 {
+		var line []byte
+		if idx := bytes.IndexByte(chunk, '\n'); idx >= 0 {
+			line, chunk = chunk[:idx], chunk[idx+1:]
+		} else {
+			line, chunk = chunk, nil
+		}
+		lines++
+		line = bytes.TrimSuffix(line, []byte{'\r'})
+		// Every matching line carries a decision field; skip the rest before
+		// paying for a full parse.
+		if !bytes.Contains(line, []byte("decision")) {
+			continue
+		}
+
+		clear(fields)
+		if !parseKeyValuePairsInto(string(line), fields) || !matchesDecision(fields, ing.matchDecision) {
+			continue
+		}
+		matched++
+		for _, s := range suggestionsFromFields(fields) {
+			if s.Action == "" || s.Resource.Type == "" || s.Resource.Value == "" {
+				continue
+			}
+			if _, ok := seen[s]; ok {
+				continue
+			}
+			stored, err := ing.set.add(s)
+			if err != nil {
+				return err
+			}
+			seen[stored] = struct{}{}
+		}
+	}
+	ing.report(size, lines, matched)
+	return nil
+}
+
+func (ing *ingester) report(bytesRead, lines, matched int64) {
+	ing.progressMu.Lock()
+	defer ing.progressMu.Unlock()
+	ing.progress.Bytes += bytesRead
+	ing.progress.Lines += lines
+	ing.progress.Matched += matched
+	ing.progress.Unique = ing.set.count.Load()
+	if ing.opts.Progress != nil {
+		ing.opts.Progress(ing.progress)
+	}
+}
+
+func (ing *ingester) merge(g *Generator) {
+	for i := range ing.set.shards {
+		for s := range ing.set.shards[i].keys {
+			g.addSuggestion(s)
+		}
+	}
+}
+
+// suggestionSet deduplicates suggestions across workers. Keys are spread over
+// independently locked shards by hash so workers rarely contend.
+type suggestionSet struct {
+	shards [suggestionShards]suggestionShard
+	count  atomic.Int64
+	limit  int64
+}
+
+type suggestionShard struct {
+	mu   sync.Mutex
+	keys map[suggestion]struct{}
+}
+
+func newSuggestionSet(limit int) *suggestionSet {
+	set := &suggestionSet{limit: int64(limit)}
+	for i := range set.shards {
+		set.shards[i].keys = make(map[suggestion]struct{})
+	}
+	return set
+}
+
+// add records sg and returns a copy that does not alias the log line it was
+// parsed from, whether or not sg was already present.
+func (s *suggestionSet) add(sg suggestion) (suggestion, error) {
+	shard := &s.shards[suggestionHash(sg)%suggestionShards]
+
+	shard.mu.Lock()
+	defer shard.mu.Unlock()
+	if _, ok := shard.keys[sg]; ok {
+		return cloneSuggestion(sg), nil
+	}
+	if n := s.count.Add(1); s.limit > 0 && n > s.limit {
+		s.count.Add(-1)
+		return sg, fmt.Errorf("%w (%d)", ErrTooManySuggestions, s.limit)
+	}
+	sg = cloneSuggestion(sg)
+	shard.keys[sg] = struct{}{}
+	return sg, nil
+}
+
+// cloneSuggestion copies the values out of the whole log line they are
+// substrings of, so keeping the suggestion does not keep the line.
+func cloneSuggestion(sg suggestion) suggestion {
+	sg.Action = strings.Clone(sg.Action)
+	sg.Resource.Type = strings.Clone(sg.Resource.Type)
+	sg.Resource.Value = strings.Clone(sg.Resource.Value)
+	return sg
+}
+
+// suggestionHash is FNV-1a over the canonical key (action, type, value) with
+// a 0xff separator, computed inline to avoid a hash.Hash allocation per line.
+func suggestionHash(sg suggestion) uint64 {
+	const (
+		offset64 = 14695981039346656037
+		prime64  = 1099511628211
+	)
+	h := uint64(offset64)
+	for _, part := range [...]string{sg.Action, sg.Resource.Type, sg.Resource.Value} {
+		for i := 0; i < len(part); i++ {
+			h ^= uint64(part[i])
+			h *= prime64
+		}
+		h ^= 0xff
+		h *= prime64
+	}
+	return h
+}
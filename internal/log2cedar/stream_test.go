@@ -0,0 +1,133 @@
+package log2cedar
+
+import (
+	"bufio"
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func syntheticLog(lines int) []byte {
+	var buf bytes.Buffer
+	for i := 0; i < lines; i++ {
+		switch i % 4 {
+		case 0:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:02:40Z event=http.request protocol=https addr=\"host%d.example.com\" path=\"/\" decision=denied status=403\n", i%97)
+		case 1:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=proc.exec pid=%d exe=\"bash\" path=\"/usr/bin/tool%d\" argv=\"/usr/bin/tool%d\" decision=denied\r\n", i, i%13, i%13)
+		case 2:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=file.open:ro path=\"/etc/conf%d/\" decision=allowed\n", i%7)
+		default:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=heartbeat uptime=%d\n", i)
+		}
+	}
+	return buf.Bytes()
+}
+
+func sequentialRender(t testing.TB, data []byte, targetAllowed bool) string {
+	t.Helper()
+	gen := NewGenerator(targetAllowed)
+	scanner := bufio.NewScanner(bytes.NewReader(data))
+	scanner.Buffer(make([]byte, 0, 64*1024), len(data)+1)
+	for scanner.Scan() {
+		gen.ProcessLine(scanner.Text())
+	}
+	if err := scanner.Err(); err != nil {
+		t.Fatalf("scan: %v", err)
+	}
+	return gen.Render()
+}
+
+func TestIngestParallelMatchesSequential(t *testing.T) {
+	data := syntheticLog(2000)
+	// A line longer than the chunk size and no trailing newline exercise the
+	// buffer growth and final partial chunk paths.
+	data = append(data, []byte("event=http.request addr=\""+strings.Repeat("a", 300)+".example.com\" decision=denied\n")...)
+	data = append(data, []byte("event=proc.exec path=\"/usr/bin/last\" decision=denied")...)
+
+	for _, allowed := range []bool{false, true} {
+		want := sequentialRender(t, data, allowed)
+		gen := NewGenerator(allowed)
+		err := gen.IngestParallel(context.Background(), bytes.NewReader(data), IngestOptions{Workers: 4, ChunkSize: 128})
+		if err != nil {
+			t.Fatalf("IngestParallel: %v", err)
+		}
+		if got := gen.Render(); got != want {
+			t.Fatalf("parallel output differs (allowed=%v):\nwant:\n%s\ngot:\n%s", allowed, want, got)
+		}
+	}
+}
+
+func TestIngestParallelSuggestionLimit(t *testing.T) {
+	gen := NewGenerator(false)
+	err := gen.IngestParallel(context.Background(), bytes.NewReader(syntheticLog(400)), IngestOptions{MaxSuggestions: 10})
+	if !errors.Is(err, ErrTooManySuggestions) {
+		t.Fatalf("expected ErrTooManySuggestions, got %v", err)
+	}
+}
+
+func TestIngestFilesReportsProgress(t *testing.T) {
+	dir := t.TempDir()
+	data := syntheticLog(1000)
+	half := bytes.IndexByte(data[len(data)/2:], '\n') + len(data)/2 + 1
+	paths := []string{filepath.Join(dir, "leash.log.1"), filepath.Join(dir, "leash.log")}
+	if err := os.WriteFile(paths[0], data[:half], 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.WriteFile(paths[1], data[half:], 0o644); err != nil {
+		t.Fatal(err)
+	}
+
+	var last Progress
+	calls := 0
+	gen := NewGenerator(false)
+	err := gen.IngestFiles(context.Background(), paths, IngestOptions{
+		ChunkSize: 4096,
+		Progress: func(p Progress) {
+			calls++
+			last = p
+		},
+	})
+	if err != nil {
+		t.Fatalf("IngestFiles: %v", err)
+	}
+	if calls < 2 {
+		t.Fatalf("expected progress per chunk, got %d calls", calls)
+	}
+	if last.Bytes != int64(len(data)) || last.TotalBytes != int64(len(data)) {
+		t.Fatalf("expected %d bytes read of %d, got %+v", len(data), len(data), last)
+	}
+	if last.Lines != 1000 || last.Matched != 500 {
+		t.Fatalf("unexpected line counts: %+v", last)
+	}
+	if got, want := gen.Render(), sequentialRender(t, data, false); got != want {
+		t.Fatalf("file output differs:\nwant:\n%s\ngot:\n%s", want, got)
+	}
+}
+
+func BenchmarkIngest(b *testing.B) {
+	data := syntheticLog(200_000)
+
+	b.Run("sequential", func(b *testing.B) {
+		b.SetBytes(int64(len(data)))
+		for i := 0; i < b.N; i++ {
+			sequentialRender(b, data, false)
+		}
+	})
+
+	b.Run("parallel", func(b *testing.B) {
+		b.SetBytes(int64(len(data)))
+		for i := 0; i < b.N; i++ {
+			gen := NewGenerator(false)
+			if err := gen.IngestParallel(context.Background(), bytes.NewReader(data), IngestOptions{}); err != nil {
+				b.Fatal(err)
+			}
+			gen.Render()
+		}
+	})
+}
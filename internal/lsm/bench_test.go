@@ -0,0 +1,153 @@
+package lsm
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"strings"
+	"testing"
+)
+
+// discardBroadcaster stands in for the websocket hub so decoder benchmarks
+// measure decoding and formatting rather than file syncs.
+type discardBroadcaster struct{ n int }
+
+func (d *discardBroadcaster) BroadcastLog(entry string) { d.n += len(entry) }
+
+func benchLogger(b *testing.B) *SharedLogger {
+	b.Helper()
+	logger, err := NewSharedLogger("")
+	if err != nil {
+		b.Fatal(err)
+	}
+	logger.SetBroadcaster(&discardBroadcaster{})
+	return logger
+}
+
+// encodeEvent lays out event the way the ring buffer delivers it.
+func encodeEvent(b *testing.B, event any) []byte {
+	b.Helper()
+	var buf bytes.Buffer
+	if err := binary.Write(&buf, binary.LittleEndian, event); err != nil {
+		b.Fatal(err)
+	}
+	return buf.Bytes()
+}
+
+// benchPath returns an absolute path of exactly n bytes.
+func benchPath(n int) string {
+	p := "/home/agent/src/"
+	for len(p) < n {
+		p += "dir/"
+	}
+	return p[:n]
+}
+
+func BenchmarkHandleOpenEvent(b *testing.B) {
+	for _, size := range []int{16, 128, 255} {
+		b.Run(fmt.Sprintf("path=%d", size), func(b *testing.B) {
+			l := &OpenLsm{logger: benchLogger(b)}
+			event := OpenEvent{PID: 42, TGID: 42, CgroupID: 7, Operation: uint32(OpOpenRO)}
+			copy(event.Comm[:], "claude")
+			copy(event.Path[:], benchPath(size))
+			data := encodeEvent(b, &event)
+			b.SetBytes(int64(len(data)))
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				// Distinct timestamps keep duplicate suppression out of the way.
+				binary.LittleEndian.PutUint64(data[8:], uint64(i)*uint64(duplicateSuppressionWindow)*2)
+				l.handleEvent(data)
+			}
+		})
+	}
+}
+
+func BenchmarkHandleConnectEvent(b *testing.B) {
+	for _, size := range []int{0, 32, 127} {
+		b.Run(fmt.Sprintf("hostname=%d", size), func(b *testing.B) {
+			l := &ConnectLsm{logger: benchLogger(b), dnsCache: make(map[uint32]string)}
+			event := ConnectEvent{PID: 42, TGID: 42, CgroupID: 7, Family: 2, Protocol: 6, DestIP: 0x5db8d822, DestPort: 0xbb01}
+			copy(event.Comm[:], "curl")
+			copy(event.DestHostname[:], strings.Repeat("a", size))
+			data := encodeEvent(b, &event)
+			b.SetBytes(int64(len(data)))
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				l.handleEvent(data)
+			}
+		})
+	}
+}
+
+func BenchmarkHandleExecEvent(b *testing.B) {
+	for _, argc := range []int{0, 6} {
+		b.Run(fmt.Sprintf("argc=%d", argc), func(b *testing.B) {
+			l := &ExecLsm{logger: benchLogger(b)}
+			event := ExecEvent{PID: 42, CgroupID: 7, Argc: int32(argc)}
+			copy(event.Comm[:], "bash")
+			copy(event.Path[:], "/usr/bin/git")
+			for i := 0; i < argc; i++ {
+				copy(event.DetailedArgs[i][:], fmt.Sprintf("--argument-%d", i))
+			}
+			data := encodeEvent(b, &event)
+			b.SetBytes(int64(len(data)))
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				l.handleEvent(data)
+			}
+		})
+	}
+}
+
+func BenchmarkParseRuleString(b *testing.B) {
+	rules := map[string]string{
+		"file":    "allow file.open:ro /usr/lib/",
+		"exec":    "deny proc.exec /bin/sh -c",
+		"connect": "allow net.send api.example.com:443",
+		"ip":      "deny net.send 10.0.0.1:22",
+	}
+	for _, kind := range []string{"file", "exec", "connect", "ip"} {
+		line := rules[kind]
+		b.Run(kind, func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				if _, err := ParseRuleString(line); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkCheckConnect(b *testing.B) {
+	for _, n := range []int{16, 64, 256} {
+		b.Run(fmt.Sprintf("rules=%d", n), func(b *testing.B) {
+			parsed := make([]PolicyRule, 0, n)
+			for i := 0; i < n; i++ {
+				line := fmt.Sprintf("allow net.send host%d.example.com:443", i)
+				if i%4 == 3 {
+					line = fmt.Sprintf("allow net.send *.svc%d.example.org", i)
+				}
+				rule, err := ParseRuleString(line)
+				if err != nil {
+					b.Fatal(err)
+				}
+				parsed = append(parsed, *rule)
+			}
+			checker := NewSimplePolicyChecker(ConvertToConnectRules(parsed), false, nil)
+			// Only the last rule, a wildcard, matches, so every call scans the
+			// whole list.
+			host := fmt.Sprintf("api.svc%d.example.org", n-1)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				if !checker.CheckConnect(host, "93.184.216.34", 443) {
+					b.Fatalf("expected %s to be allowed", host)
+				}
+			}
+		})
+	}
+}
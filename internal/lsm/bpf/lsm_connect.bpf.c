@@ -29,6 +29,8 @@ typedef int bool;
 // BPF map types
 #define BPF_MAP_TYPE_ARRAY 2
 #define BPF_MAP_TYPE_HASH 1
+#define BPF_MAP_TYPE_PERCPU_ARRAY 6
+#define BPF_MAP_TYPE_HASH_OF_MAPS 13
 #define BPF_MAP_TYPE_RINGBUF 27
 #define BPF_ANY 0
 
@@ -38,6 +40,8 @@ char LICENSE[] SEC("license") = "GPL";
 #define MAX_ENTRIES 8192
 // BPF verifier-friendly constant bound for policy rules (max 256 with loop-based implementation)
 #define MAX_POLICY_RULES 256
+// Cgroup subtrees that can hold their own policy at once (must match Go MaxTenants)
+#define MAX_TENANTS 64
 
 // Operation types (must match Go constants)
 #define OP_CONNECT 4    // connect
@@ -75,6 +79,14 @@ struct {
     __uint(max_entries, 256 * 1024);
 } connect_events SEC(".maps");
 
+// Events lost because the ring buffer was full, counted per CPU
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, u64);
+} connect_dropped_events SEC(".maps");
+
 // Map to store the target cgroup ID for filtering (root of subtree to monitor)
 struct {
     __uint(type, BPF_MAP_TYPE_ARRAY);
@@ -83,6 +95,66 @@ struct {
     __type(value, u64);
 } connect_target_cgroup SEC(".maps");
 
+// DNS hostname cache: IP -> hostname mapping
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, 4096);
+    __type(key, u32);   // IPv4 address
+    __type(value, char[MAX_HOSTNAME_LEN]); // Hostname
+} dns_cache SEC(".maps");
+
+#ifdef LEASH_MULTI_TENANT
+// Map from each monitored cgroup ID (a tenant root or descendant) to its tenant ID
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, MAX_ENTRIES);
+    __type(key, u64);
+    __type(value, u64);
+} connect_allowed_cgroups SEC(".maps");
+
+// Slot after the rules in a tenant's rule array. It holds the rule count and
+// default result, so they are swapped in together with the rules.
+#define POLICY_HEADER_SLOT MAX_POLICY_RULES
+
+struct policy_header {
+    u32 num_rules;
+    u32 default_result; // 0 = deny, 1 = allow
+};
+
+// One tenant's policy rules (indexed by rule number, supports up to 256 rules)
+// followed by its policy_header
+struct connect_policy_rules_inner {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, MAX_POLICY_RULES + 1);
+    __type(key, u32);
+    __type(value, struct connect_policy_rule);
+};
+
+// Map from tenant ID to its rules; userspace swaps in a new rule array on reload
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH_OF_MAPS);
+    __uint(max_entries, MAX_TENANTS);
+    __type(key, u64);
+    __array(values, struct connect_policy_rules_inner);
+} connect_policy_rules SEC(".maps");
+
+// Helper to find the tenant of the current cgroup; 0 means it is not monitored
+static __always_inline u64 connect_target_tenant(void)
+{
+    u64 current_cgroup_id = bpf_get_current_cgroup_id();
+    
+    // Check if monitoring is enabled
+    u32 key = 0;
+    u64 *target_ptr = bpf_map_lookup_elem(&connect_target_cgroup, &key);
+    if (!target_ptr || *target_ptr == 0) {
+        return 0;
+    }
+    
+    // Look up the tenant the current cgroup belongs to
+    u64 *tenant = bpf_map_lookup_elem(&connect_allowed_cgroups, &current_cgroup_id);
+    return tenant ? *tenant : 0;
+}
+#else
 // Map to store multiple cgroup IDs to monitor (for descendants)
 struct {
     __uint(type, BPF_MAP_TYPE_HASH);
@@ -115,14 +187,6 @@ struct {
     __type(value, u32);
 } connect_default_policy SEC(".maps");
 
-// DNS hostname cache: IP -> hostname mapping
-struct {
-    __uint(type, BPF_MAP_TYPE_HASH);
-    __uint(max_entries, 4096);
-    __type(key, u32);   // IPv4 address
-    __type(value, char[MAX_HOSTNAME_LEN]); // Hostname
-} dns_cache SEC(".maps");
-
 // Helper to check if current cgroup should be monitored
 static __always_inline bool is_connect_target_cgroup(void)
 {
@@ -139,6 +203,7 @@ static __always_inline bool is_connect_target_cgroup(void)
     u8 *allowed = bpf_map_lookup_elem(&connect_allowed_cgroups, &current_cgroup_id);
     return allowed != NULL;
 }
+#endif
 
 // Helper function for simple string prefix matching (BPF verifier friendly)
 static __always_inline bool hostname_starts_with(const char *hostname, const char *prefix, u32 prefix_len)
@@ -200,6 +265,52 @@ static __always_inline bool hostname_matches_wildcard(const char *hostname, cons
     return true;
 }
 
+#ifdef LEASH_MULTI_TENANT
+// Check connect policy for destination IP and port (hostname matching disabled for compatibility)
+static __always_inline int check_connect_policy(u64 tenant, u32 dest_ip, u16 dest_port)
+{
+    void *rules = bpf_map_lookup_elem(&connect_policy_rules, &tenant);
+    if (!rules) {
+        return 0; // Default to deny if no rules loaded
+    }
+    u32 key = POLICY_HEADER_SLOT;
+    struct policy_header *header = bpf_map_lookup_elem(rules, &key);
+    if (!header) {
+        return 0;
+    }
+    
+    u32 num_rules = header->num_rules;
+    if (num_rules == 0) {
+        // No rules, check default policy
+        return header->default_result;
+    }
+    
+    // Check each policy rule (rules are sorted by specificity in userspace)
+    #pragma clang loop unroll(disable)
+    for (u32 i = 0; i < MAX_POLICY_RULES; i++) {
+        if (i >= num_rules) break;
+        u32 rule_key = i;
+        struct connect_policy_rule *rule = bpf_map_lookup_elem(rules, &rule_key);
+        if (!rule) continue;
+        
+        // Check IP match (0 means any IP, for hostname-only rules)
+        if (rule->dest_ip != 0 && rule->dest_ip != dest_ip) {
+            continue;
+        }
+        
+        // Check port match (0 means any port)
+        if (rule->dest_port != 0 && rule->dest_port != dest_port) {
+            continue;
+        }
+        
+        // Rule matches
+        return rule->action;
+    }
+    
+    // No matching rule found, use default policy
+    return header->default_result;
+}
+#else
 // Check connect policy for destination IP and port (hostname matching disabled for compatibility)
 static __always_inline int check_connect_policy(u32 dest_ip, u16 dest_port)
 {
@@ -242,9 +353,14 @@ static __always_inline int check_connect_policy(u32 dest_ip, u16 dest_port)
     u32 *default_ptr = bpf_map_lookup_elem(&connect_default_policy, &key);
     return default_ptr ? *default_ptr : 0; // Default to deny
 }
+#endif
 
 // Helper function to process network events and apply policy (shared between hooks)
+#ifdef LEASH_MULTI_TENANT
+static __always_inline int process_network_event(u64 tenant, struct socket *sock, u32 dest_ip, u16 dest_port, u16 family)
+#else
 static __always_inline int process_network_event(struct socket *sock, u32 dest_ip, u16 dest_port, u16 family)
+#endif
 {
     struct connect_event *event;
     int policy_result = 0;
@@ -263,11 +379,20 @@ static __always_inline int process_network_event(struct socket *sock, u32 dest_i
     }
     
     // Check policy for this destination (hostname ignored for enforcement)
+#ifdef LEASH_MULTI_TENANT
+    policy_result = check_connect_policy(tenant, dest_ip, dest_port);
+#else
     policy_result = check_connect_policy(dest_ip, dest_port);
+#endif
     
     // Reserve ringbuf space for event logging
     event = bpf_ringbuf_reserve(&connect_events, sizeof(*event), 0);
     if (!event) {
+        u32 zero = 0;
+        u64 *dropped = bpf_map_lookup_elem(&connect_dropped_events, &zero);
+        if (dropped) {
+            __sync_fetch_and_add(dropped, 1);
+        }
         // Still need to enforce policy even if we can't log
         return policy_result ? 0 : -13; // -EACCES = 13
     }
@@ -308,9 +433,16 @@ SEC("lsm/socket_connect")
 int BPF_PROG(lsm_connect, struct socket *sock, struct sockaddr *address, int addrlen)
 {
     // Check if we should monitor this cgroup
+#ifdef LEASH_MULTI_TENANT
+    u64 tenant = connect_target_tenant();
+    if (!tenant) {
+        return 0;
+    }
+#else
     if (!is_connect_target_cgroup()) {
         return 0;
     }
+#endif
     
     u32 dest_ip = 0;
     u16 dest_port = 0;
@@ -332,16 +464,27 @@ int BPF_PROG(lsm_connect, struct socket *sock, struct sockaddr *address, int add
     dest_ip = uaddr.sin_addr.s_addr; // Network byte order
     dest_port = uaddr.sin_port;      // Network byte order
     
+#ifdef LEASH_MULTI_TENANT
+    return process_network_event(tenant, sock, dest_ip, dest_port, family);
+#else
     return process_network_event(sock, dest_ip, dest_port, family);
+#endif
 }
 
 SEC("lsm/socket_sendmsg")
 int BPF_PROG(lsm_sendmsg, struct socket *sock, void *msg, int size)
 {
     // Check if we should monitor this cgroup
+#ifdef LEASH_MULTI_TENANT
+    u64 tenant = connect_target_tenant();
+    if (!tenant) {
+        return 0;
+    }
+#else
     if (!is_connect_target_cgroup()) {
         return 0;
     }
+#endif
     
     // Handle both connectionless sockets (UDP, raw) and any sends with explicit destinations
     // Note: Connected sockets may also be caught here, but that provides additional coverage
@@ -378,5 +521,9 @@ int BPF_PROG(lsm_sendmsg, struct socket *sock, void *msg, int size)
     dest_ip = kaddr.sin_addr.s_addr; // Network byte order
     dest_port = kaddr.sin_port;      // Network byte order
     
+#ifdef LEASH_MULTI_TENANT
+    return process_network_event(tenant, sock, dest_ip, dest_port, family);
+#else
     return process_network_event(sock, dest_ip, dest_port, family);
+#endif
 }
@@ -28,6 +28,8 @@ typedef int bool;
 // BPF map types
 #define BPF_MAP_TYPE_ARRAY 2
 #define BPF_MAP_TYPE_HASH 1
+#define BPF_MAP_TYPE_PERCPU_ARRAY 6
+#define BPF_MAP_TYPE_HASH_OF_MAPS 13
 #define BPF_MAP_TYPE_RINGBUF 27
 #define BPF_ANY 0
 
@@ -37,6 +39,8 @@ char LICENSE[] SEC("license") = "GPL";
 #define MAX_ENTRIES 8192
 // BPF verifier-friendly constant bound for policy rules (max 64 to reduce instruction count)
 #define MAX_POLICY_RULES 64
+// Cgroup subtrees that can hold their own policy at once (must match Go MaxTenants)
+#define MAX_TENANTS 64
 
 // Operation types (must match Go constants)
 #define OP_EXEC 3    // exec
@@ -73,6 +77,14 @@ struct {
     __uint(max_entries, 256 * 1024);
 } exec_events SEC(".maps");
 
+// Events lost because the ring buffer was full, counted per CPU
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, u64);
+} exec_dropped_events SEC(".maps");
+
 // Map to store the target cgroup ID for filtering (root of subtree to monitor)
 struct {
     __uint(type, BPF_MAP_TYPE_ARRAY);
@@ -81,6 +93,59 @@ struct {
     __type(value, u64);
 } exec_target_cgroup SEC(".maps");
 
+#ifdef LEASH_MULTI_TENANT
+// Map from each monitored cgroup ID (a tenant root or descendant) to its tenant ID
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, MAX_ENTRIES);
+    __type(key, u64);
+    __type(value, u64);
+} exec_allowed_cgroups SEC(".maps");
+
+// Slot after the rules in a tenant's rule array. It holds the rule count and
+// default result, so they are swapped in together with the rules.
+#define POLICY_HEADER_SLOT MAX_POLICY_RULES
+
+struct policy_header {
+    u32 num_rules;
+    u32 default_result; // 0 = deny, 1 = allow
+};
+
+// One tenant's policy rules (indexed by rule number, supports up to 64 rules)
+// followed by its policy_header
+struct exec_policy_rules_inner {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, MAX_POLICY_RULES + 1);
+    __type(key, u32);
+    __type(value, struct exec_policy_rule);
+};
+
+// Map from tenant ID to its rules; userspace swaps in a new rule array on reload
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH_OF_MAPS);
+    __uint(max_entries, MAX_TENANTS);
+    __type(key, u64);
+    __array(values, struct exec_policy_rules_inner);
+} exec_policy_rules SEC(".maps");
+
+// Helper to find the tenant of the current cgroup; 0 means it is not monitored
+static __always_inline u64 exec_target_tenant()
+{
+    u32 key = 0;
+    u64 *target_cgroup_id = bpf_map_lookup_elem(&exec_target_cgroup, &key);
+    if (!target_cgroup_id || *target_cgroup_id == 0) {
+        // No target cgroup set, don't monitor anything
+        return 0;
+    }
+    
+    // Get the current cgroup ID
+    u64 current_cgroup_id = bpf_get_current_cgroup_id();
+    
+    // Look up the tenant this cgroup ID belongs to
+    u64 *tenant = bpf_map_lookup_elem(&exec_allowed_cgroups, &current_cgroup_id);
+    return tenant ? *tenant : 0;
+}
+#else
 // Map to store multiple cgroup IDs to monitor (for descendants)
 struct {
     __uint(type, BPF_MAP_TYPE_HASH);
@@ -134,6 +199,7 @@ static __always_inline bool is_exec_target_cgroup()
     
     return false;
 }
+#endif
 
 // Bounded loop string comparison with disabled unrolling for BPF verifier
 static __always_inline int simple_string_starts_with(const char *s, const char *p, __u32 max_len)
@@ -176,6 +242,71 @@ struct {
     __type(value, struct pending_exec_args);
 } pending_exec_args SEC(".maps");
 
+#ifdef LEASH_MULTI_TENANT
+// Simple policy check
+static __always_inline int check_exec_policy(u64 tenant, const char *path)
+{
+    void *rules = bpf_map_lookup_elem(&exec_policy_rules, &tenant);
+    if (!rules) {
+        return 0; // Default to deny until the tenant's rules are loaded
+    }
+    __u32 key = POLICY_HEADER_SLOT;
+    struct policy_header *header = bpf_map_lookup_elem(rules, &key);
+    if (!header) {
+        return 0;
+    }
+    __u32 n = header->num_rules;
+    if (n == 0) {
+        // No rules defined, use default policy from userspace
+        return header->default_result;
+    }
+    if (n > 64) n = 64;
+
+    #pragma clang loop unroll(disable)
+    for (__u32 i = 0; i < n && i < 64; i++) {
+        key = i;
+        struct exec_policy_rule *rule = bpf_map_lookup_elem(rules, &key);
+        if (!rule || rule->path_len == 0 || rule->path_len > 64) continue;
+
+        // Simple prefix matching - Go code handles directory expansion
+        if (simple_string_starts_with(path, rule->path, rule->path_len)) {
+            // Path matches, now check arguments if rule has any
+            if (rule->arg_count == 0) {
+                // No arguments specified = match any (implicit wildcard)
+                return rule->action; // Return immediately (back to original logic)
+            }
+            
+            // Get correlated arguments from tracepoint
+            u64 pid_tgid = bpf_get_current_pid_tgid();
+            u32 pid = pid_tgid >> 32;
+            struct pending_exec_args *pending = bpf_map_lookup_elem(&pending_exec_args, &pid);
+            
+            // Argument blacklist: deny if any blacklisted arg is found
+            if (pending && pending->argc > 1 && rule->arg_count > 0 && rule->action == 0) {
+                // Deny rule: check if any policy arg matches any actual arg (blacklist)
+                for (u32 p = 0; p < rule->arg_count && p < 3; p++) {
+                    for (u32 a = 1; a < pending->argc && a < 4; a++) { // Skip argv[0]
+                        int match = 1;
+                        for (u32 j = 0; j < rule->arg_lens[p] && j < 16; j++) {
+                            if (pending->detailed_args[a][j] != rule->args[p][j]) {
+                                match = 0;
+                                break;
+                            }
+                        }
+                        if (match) return 0; // Deny - found blacklisted arg
+                    }
+                }
+            }
+            
+            // Continue to next rule
+            continue;
+        }
+    }
+    
+    // No matching rule found, use default policy from userspace
+    return header->default_result;
+}
+#else
 // Simple policy check
 static __always_inline int check_exec_policy(const char *path)
 {
@@ -235,14 +366,22 @@ static __always_inline int check_exec_policy(const char *path)
     __u32 *default_ptr = bpf_map_lookup_elem(&exec_default_policy, &key);
     return default_ptr ? *default_ptr : 0; // Default to deny if map lookup fails
 }
+#endif
 
 SEC("lsm/bprm_check_security")
 int BPF_PROG(lsm_exec, struct linux_binprm *bprm)
 {
     // Check if we should monitor this cgroup
+#ifdef LEASH_MULTI_TENANT
+    u64 tenant = exec_target_tenant();
+    if (!tenant) {
+        return 0;
+    }
+#else
     if (!is_exec_target_cgroup()) {
         return 0;
     }
+#endif
 
     struct exec_event *event;
     char path[MAX_PATH_LEN];
@@ -264,11 +403,20 @@ int BPF_PROG(lsm_exec, struct linux_binprm *bprm)
     }
     
     // Check policy for this path (arguments temporarily disabled due to BPF size limits)
+#ifdef LEASH_MULTI_TENANT
+    policy_result = check_exec_policy(tenant, path);
+#else
     policy_result = check_exec_policy(path);
+#endif
     
     // Reserve ringbuf space
     event = bpf_ringbuf_reserve(&exec_events, sizeof(*event), 0);
     if (!event) {
+        u32 zero = 0;
+        u64 *dropped = bpf_map_lookup_elem(&exec_dropped_events, &zero);
+        if (dropped) {
+            __sync_fetch_and_add(dropped, 1);
+        }
         // Still need to enforce policy even if we can't log
         return policy_result ? 0 : -13; // -EACCES = 13
     }
@@ -321,9 +469,15 @@ SEC("tracepoint/syscalls/sys_enter_execve")
 int trace_sys_enter_execve(struct sys_enter_execve_args *ctx)
 {
     // Check if we should monitor this cgroup
+#ifdef LEASH_MULTI_TENANT
+    if (!exec_target_tenant()) {
+        return 0;
+    }
+#else
     if (!is_exec_target_cgroup()) {
         return 0;
     }
+#endif
 
     u64 pid_tgid = bpf_get_current_pid_tgid();
     u32 pid = pid_tgid >> 32;
@@ -28,6 +28,8 @@ typedef int bool;
 // BPF map types
 #define BPF_MAP_TYPE_ARRAY 2
 #define BPF_MAP_TYPE_HASH 1
+#define BPF_MAP_TYPE_PERCPU_ARRAY 6
+#define BPF_MAP_TYPE_HASH_OF_MAPS 13
 #define BPF_MAP_TYPE_RINGBUF 27
 #define BPF_ANY 0
 
@@ -37,6 +39,8 @@ char LICENSE[] SEC("license") = "GPL";
 #define MAX_ENTRIES 8192
 // BPF verifier-friendly constant bound for policy rules (max 256 with loop-based implementation)
 #define MAX_POLICY_RULES 256
+// Cgroup subtrees that can hold their own policy at once (must match Go MaxTenants)
+#define MAX_TENANTS 64
 
 // Operation types (must match Go constants)
 #define OP_OPEN 0    // open (any mode)
@@ -68,6 +72,14 @@ struct {
     __uint(max_entries, 256 * 1024);
 } events SEC(".maps");
 
+// Events lost because the ring buffer was full, counted per CPU
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __uint(max_entries, 1);
+    __type(key, u32);
+    __type(value, u64);
+} dropped_events SEC(".maps");
+
 // Map to store the target cgroup ID for filtering (root of subtree to monitor)
 struct {
     __uint(type, BPF_MAP_TYPE_ARRAY);
@@ -76,6 +88,60 @@ struct {
     __type(value, u64);
 } target_cgroup SEC(".maps");
 
+#ifdef LEASH_MULTI_TENANT
+// Map from each monitored cgroup ID (a tenant root or descendant) to its tenant ID
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH);
+    __uint(max_entries, MAX_ENTRIES);
+    __type(key, u64);
+    __type(value, u64);
+} allowed_cgroups SEC(".maps");
+
+// Slot after the rules in a tenant's rule array. It holds the rule count and
+// default result, so they are swapped in together with the rules.
+#define POLICY_HEADER_SLOT MAX_POLICY_RULES
+
+struct policy_header {
+    u32 num_rules;
+    u32 default_result; // 0 = deny, 1 = allow
+};
+
+// One tenant's policy rules (indexed by rule number, supports up to 256 rules)
+// followed by its policy_header
+struct policy_rules_inner {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __uint(max_entries, MAX_POLICY_RULES + 1);
+    __type(key, u32);
+    __type(value, struct policy_rule);
+};
+
+// Map from tenant ID to its rules; userspace swaps in a new rule array on reload
+struct {
+    __uint(type, BPF_MAP_TYPE_HASH_OF_MAPS);
+    __uint(max_entries, MAX_TENANTS);
+    __type(key, u64);
+    __array(values, struct policy_rules_inner);
+} policy_rules SEC(".maps");
+
+// Helper to find the tenant of the current cgroup; 0 means it is not monitored
+static __always_inline u64 target_tenant()
+{
+    u32 key = 0;
+    u64 *target_cgroup_id = bpf_map_lookup_elem(&target_cgroup, &key);
+    if (!target_cgroup_id || *target_cgroup_id == 0) {
+        // No target cgroup set, don't monitor anything
+        return 0;
+    }
+
+    // Get the current cgroup ID
+    u64 current_cgroup_id = bpf_get_current_cgroup_id();
+
+    // The userspace program populates this with the descendant cgroup IDs of
+    // every tenant
+    u64 *tenant = bpf_map_lookup_elem(&allowed_cgroups, &current_cgroup_id);
+    return tenant ? *tenant : 0;
+}
+#else
 // Map to store multiple cgroup IDs to monitor (for descendants)
 struct {
     __uint(type, BPF_MAP_TYPE_HASH);
@@ -130,6 +196,7 @@ static __always_inline bool is_target_cgroup()
 
     return false;
 }
+#endif
 
 // Bounded loop string comparison with disabled unrolling for BPF verifier
 static __always_inline int simple_string_starts_with(const char *s, const char *p, __u32 max_len)
@@ -229,6 +296,55 @@ static __always_inline u32 get_file_operation_type(struct file *file)
     return OP_OPEN;
 }
 
+#ifdef LEASH_MULTI_TENANT
+// Clean loop-based policy check for up to 256 rules with BPF verifier compatibility
+static __always_inline int check_path_policy(u64 tenant, const char *path, u32 file_op_type)
+{
+    void *rules = bpf_map_lookup_elem(&policy_rules, &tenant);
+    if (!rules) {
+        return 0; // Default to deny until the tenant's rules are loaded
+    }
+    __u32 key = POLICY_HEADER_SLOT;
+    struct policy_header *header = bpf_map_lookup_elem(rules, &key);
+    if (!header) {
+        return 0;
+    }
+    __u32 n = header->num_rules;
+    if (n == 0) {
+        // No rules defined, use default policy from userspace
+        return header->default_result;
+    }
+    if (n > 256) n = 256;
+
+    #pragma clang loop unroll(disable)
+    for (__u32 i = 0; i < 256; i++) {
+        if (i >= n) break;
+
+        key = i;
+        struct policy_rule *rule = bpf_map_lookup_elem(rules, &key);
+        if (!rule) continue;
+
+        __u32 len = rule->path_len;
+        if (len == 0 || len > 64) continue;
+
+        // Simple prefix matching - Go code handles directory expansion
+        if (simple_string_starts_with(path, rule->path, len)) {
+            // Check if operation types match
+            if (rule->operation == OP_OPEN) {
+                // "open" matches any file operation type
+                return rule->action;
+            } else if (rule->operation == file_op_type) {
+                // Exact operation match (open:ro or open:rw)
+                return rule->action;
+            }
+            // Path matches but operation doesn't, continue to next rule
+        }
+    }
+
+    // No matching rule found, use default policy from userspace
+    return header->default_result;
+}
+#else
 // Clean loop-based policy check for up to 256 rules with BPF verifier compatibility
 static __always_inline int check_path_policy(const char *path, u32 file_op_type)
 {
@@ -272,14 +388,22 @@ static __always_inline int check_path_policy(const char *path, u32 file_op_type)
     __u32 *default_ptr = bpf_map_lookup_elem(&default_policy, &key);
     return default_ptr ? *default_ptr : 0; // Default to deny if map lookup fails
 }
+#endif
 
 SEC("lsm/file_open")
 int BPF_PROG(lsm_open, struct file *file)
 {
     // Check if we should monitor this cgroup
+#ifdef LEASH_MULTI_TENANT
+    u64 tenant = target_tenant();
+    if (!tenant) {
+        return 0;
+    }
+#else
     if (!is_target_cgroup()) {
         return 0;
     }
+#endif
 
     struct open_event *event;
     char path[MAX_PATH_LEN];
@@ -303,11 +427,20 @@ int BPF_PROG(lsm_open, struct file *file)
     u32 file_op_type = get_file_operation_type(file);
 
     // Check policy for this path and operation type
+#ifdef LEASH_MULTI_TENANT
+    policy_result = check_path_policy(tenant, path, file_op_type);
+#else
     policy_result = check_path_policy(path, file_op_type);
+#endif
 
     // Reserve ringbuf space
     event = bpf_ringbuf_reserve(&events, sizeof(*event), 0);
     if (!event) {
+        u32 zero = 0;
+        u64 *dropped = bpf_map_lookup_elem(&dropped_events, &zero);
+        if (dropped) {
+            __sync_fetch_and_add(dropped, 1);
+        }
         // Still need to enforce policy even if we can't log
         return policy_result ? 0 : -13; // -EACCES = 13
     }
@@ -10,12 +10,17 @@ import (
 	"path/filepath"
 	"strconv"
 	"strings"
+	"sync"
+	"sync/atomic"
 	"syscall"
 	"time"
 
 	"github.com/cilium/ebpf"
 	"github.com/cilium/ebpf/link"
 	"github.com/cilium/ebpf/ringbuf"
+
+	"github.com/strongdm/leash/internal/telemetry/metrics"
+	"github.com/strongdm/leash/internal/telemetry/startup"
 )
 
 // Common policy rule structure that can be converted to specific types
@@ -409,15 +414,18 @@ type BPFConfig struct {
 	EventMapName      string   // Name of the event ring buffer map
 	AllowedCgroupsMap string   // Name of the allowed cgroups map
 	TargetCgroupMap   string   // Name of the target cgroup map
+	DropMapName       string   // Name of the per-CPU count of events the ring buffer had no room for
 	StartMessage      string   // Success message to display
 	ShutdownMessage   string   // Shutdown message to display
+
+	metrics *programMetrics
 }
 
 // LSMModule interface for modules that can load BPF programs
 type LSMModule interface {
 	loadPolicyIntoBPF(*ebpf.Collection) error
 	getCgroupPath() string
-	setEbpfCollection(*ebpf.Collection)
+	setEbpfCollection(*ebpf.Collection, *ebpf.CollectionSpec) error
 	handleEvent([]byte)
 }
 
@@ -437,20 +445,24 @@ func LoadAndAttachBPFWithSetup(
 	config BPFConfig,
 	customSetup func(*ebpf.Collection) error,
 ) error {
-	// Load BPF program
-	spec, err := loader()
-	if err != nil {
-		return fmt.Errorf("failed to load BPF spec: %w", err)
-	}
-
-	coll, err := ebpf.NewCollection(spec)
-	if err != nil {
-		return fmt.Errorf("failed to create BPF collection: %w", err)
+	// Load BPF program. The kernel verifies each program as it is loaded, so
+	// this phase covers both. A collection preloaded for these programs
+	// skips it.
+	programs := strings.Join(config.ProgramNames, "+")
+	coll, spec := takePreloaded(programs)
+	if coll == nil {
+		var err error
+		if coll, spec, err = loadCollection("bpf.load."+programs, loader); err != nil {
+			return err
+		}
 	}
 	defer coll.Close()
 
-	// Store the eBPF collection for policy reloading
-	module.setEbpfCollection(coll)
+	// Store the eBPF collection for policy reloading; this also writes the
+	// policies of tenants registered before the programs were loaded.
+	if err := module.setEbpfCollection(coll, spec); err != nil {
+		return fmt.Errorf("failed to load tenant policies into BPF: %w", err)
+	}
 
 	// Load policy into BPF maps
 	if err := module.loadPolicyIntoBPF(coll); err != nil {
@@ -464,9 +476,13 @@ func LoadAndAttachBPFWithSetup(
 		}
 	}
 
-	// Populate the allowed_cgroups map with the target cgroup subtree
-	if err := addDescendantCgroups(coll.Maps[config.AllowedCgroupsMap], module.getCgroupPath()); err != nil {
-		return fmt.Errorf("failed to add descendant cgroups: %w", err)
+	// Populate the allowed_cgroups map with the target cgroup subtree. A
+	// module without a cgroup maps its tenants' subtrees instead.
+	if cgroupPath := module.getCgroupPath(); cgroupPath != "" {
+		value := uint8(1)
+		if err := addDescendantCgroups(coll.Maps[config.AllowedCgroupsMap], cgroupPath, &value); err != nil {
+			return fmt.Errorf("failed to add descendant cgroups: %w", err)
+		}
 	}
 
 	// Set a non-zero value in target_cgroup to enable monitoring
@@ -486,9 +502,11 @@ func LoadAndAttachBPFWithSetup(
 	}()
 
 	for _, programName := range config.ProgramNames {
+		endAttach := startup.Default.Begin("bpf.attach." + programName)
 		lsmLink, err := link.AttachLSM(link.LSMOptions{
 			Program: coll.Programs[programName],
 		})
+		endAttach(err)
 		if err != nil {
 			fmt.Fprintf(os.Stderr, "Failed to attach %s LSM program: %v\n", programName, err)
 			fmt.Fprintf(os.Stderr, "Note: LSM attachment requires proper kernel support\n")
@@ -497,6 +515,15 @@ func LoadAndAttachBPFWithSetup(
 		links = append(links, lsmLink)
 	}
 
+	if config.DropMapName != "" {
+		if dropMap := coll.Maps[config.DropMapName]; dropMap != nil {
+			metrics.Default.CounterFunc("leash_lsm_events_dropped_total", "LSM events lost because the ring buffer was full.",
+				dropCounter(dropMap), "program", config.metrics.program)
+		} else {
+			fmt.Fprintf(os.Stderr, "Warning: %s has no %s map; ring buffer drops are not counted\n", config.metrics.program, config.DropMapName)
+		}
+	}
+
 	// Set up ring buffer
 	rd, err := ringbuf.NewReader(coll.Maps[config.EventMapName])
 	if err != nil {
@@ -524,6 +551,8 @@ func LoadAndAttachBPFWithSetup(
 				errChan <- err
 				return
 			}
+			config.metrics.events.Inc()
+			config.metrics.pendingBytes.Set(int64(rd.AvailableBytes()))
 			eventChan <- record
 		}
 	}()
@@ -557,6 +586,94 @@ cleanup:
 	return nil
 }
 
+// dropCounter sums the per-CPU drop counts in m. Once the collection is
+// closed the last total is reported, so the counter never goes backwards. A
+// nil m, from an object built without the map, always reports zero.
+func dropCounter(m *ebpf.Map) func() float64 {
+	var last atomic.Uint64
+	return func() float64 {
+		if m == nil {
+			return 0
+		}
+		var perCPU []uint64
+		if err := m.Lookup(uint32(0), &perCPU); err == nil {
+			var total uint64
+			for _, n := range perCPU {
+				total += n
+			}
+			last.Store(total)
+		}
+		return float64(last.Load())
+	}
+}
+
+// preloaded holds collections loaded by PreloadBPF, keyed by their joined
+// program names, until LoadAndAttachBPFWithSetup claims them.
+var preloaded struct {
+	sync.Mutex
+	colls map[string]preloadedCollection
+}
+
+type preloadedCollection struct {
+	coll *ebpf.Collection
+	spec *ebpf.CollectionSpec
+}
+
+// PreloadBPF loads and verifies the collection for programNames before the
+// target cgroup is known, so a later LoadAndAttachBPF for the same programs
+// only fills the maps and attaches. Collections already preloaded are kept.
+func PreloadBPF(programNames []string, loader func() (*ebpf.CollectionSpec, error)) error {
+	key := strings.Join(programNames, "+")
+	preloaded.Lock()
+	_, ok := preloaded.colls[key]
+	preloaded.Unlock()
+	if ok {
+		return nil
+	}
+
+	coll, spec, err := loadCollection("bpf.preload."+key, loader)
+	if err != nil {
+		return err
+	}
+	preloaded.Lock()
+	defer preloaded.Unlock()
+	if _, ok := preloaded.colls[key]; ok {
+		coll.Close()
+		return nil
+	}
+	if preloaded.colls == nil {
+		preloaded.colls = make(map[string]preloadedCollection)
+	}
+	preloaded.colls[key] = preloadedCollection{coll: coll, spec: spec}
+	return nil
+}
+
+func takePreloaded(key string) (*ebpf.Collection, *ebpf.CollectionSpec) {
+	preloaded.Lock()
+	defer preloaded.Unlock()
+	p := preloaded.colls[key]
+	delete(preloaded.colls, key)
+	return p.coll, p.spec
+}
+
+// loadCollection loads the spec and creates its collection, timed as phase.
+// The spec is returned too, since tenant rule arrays are created from its
+// inner map specs.
+func loadCollection(phase string, loader func() (*ebpf.CollectionSpec, error)) (*ebpf.Collection, *ebpf.CollectionSpec, error) {
+	end := startup.Default.Begin(phase)
+	spec, err := loader()
+	if err != nil {
+		end(err)
+		return nil, nil, fmt.Errorf("failed to load BPF spec: %w", err)
+	}
+	coll, err := ebpf.NewCollection(spec)
+	end(err)
+	if err != nil {
+		return nil, nil, fmt.Errorf("failed to create BPF collection: %w", err)
+	}
+	return coll, spec, nil
+}
+
 // ParseRuleString parses a rule string back into a PolicyRule
 func ParseRuleString(ruleStr string) (*PolicyRule, error) {
 	// Reuse existing parsePolicyLine logic
@@ -0,0 +1,9 @@
+package lsm
+
+import "testing"
+
+func TestDropCounterWithoutMap(t *testing.T) {
+	if got := dropCounter(nil)(); got != 0 {
+		t.Fatalf("expected zero drops without a map, got %v", got)
+	}
+}
@@ -72,19 +72,23 @@ type OpenLsm struct {
 
 	// BPF program state
 	ebpfCollection *ebpf.Collection
+	tenants        tenantTable[OpenPolicyRule]
 
 	lastEvent openEventFingerprint
 }
 
+// NewOpenLsm creates the file open module. An empty cgroupPath leaves out
+// the module's own cgroup, so only tenants added with SetTenantPolicies are
+// enforced.
 func NewOpenLsm(cgroupPath string, logger *SharedLogger) (*OpenLsm, error) {
-	if cgroupPath == "" {
-		return nil, fmt.Errorf("cgroup path is required")
-	}
-
 	l := &OpenLsm{
 		cgroupPath:          cgroupPath,
 		logger:              logger,
 		defaultPolicyResult: false, // Default to deny (false)
+		tenants: tenantTable[OpenPolicyRule]{maps: tenantMaps{
+			allowedCgroups: "allowed_cgroups",
+			rules:          "policy_rules",
+		}},
 	}
 
 	// Note: Policy loading is now done separately via LoadPolicies()
@@ -97,22 +101,18 @@ func (l *OpenLsm) getCgroupPath() string {
 	return l.cgroupPath
 }
 
-func (l *OpenLsm) setEbpfCollection(coll *ebpf.Collection) {
+func (l *OpenLsm) setEbpfCollection(coll *ebpf.Collection, spec *ebpf.CollectionSpec) error {
 	l.ebpfCollection = coll
+	if l.cgroupPath != "" {
+		return nil
+	}
+	return l.tenants.bind(coll, spec)
 }
 
 // LoadPolicies loads file open policy rules into the LSM
 func (l *OpenLsm) LoadPolicies(policies []OpenPolicyRule) error {
-	l.policyRules = policies
-	l.numPolicyRules = len(policies)
-
-	// Sort policy rules by path length (longest first) for specificity
-	sort.Slice(l.policyRules, func(i, j int) bool {
-		return l.policyRules[i].PathLen > l.policyRules[j].PathLen
-	})
-
-	// Check if root path "/" is allowed to set default policy result
-	l.checkRootPathPolicy()
+	l.policyRules, l.defaultPolicyResult = compileOpenPolicies(policies)
+	l.numPolicyRules = len(l.policyRules)
 
 	fmt.Printf("Loaded %d file open policy rules\n", l.numPolicyRules)
 	if l.defaultPolicyResult {
@@ -132,35 +132,58 @@ func (l *OpenLsm) LoadPolicies(policies []OpenPolicyRule) error {
 	return nil
 }
 
+// SetTenantPolicies enforces policies on the tenant's cgroup subtree,
+// replacing any rules it had before.
+func (l *OpenLsm) SetTenantPolicies(tenant Tenant, policies []OpenPolicyRule) error {
+	rules, defaultAllow := compileOpenPolicies(policies)
+	return l.tenants.set(tenant, rules, defaultAllow)
+}
+
+// RemoveTenant stops enforcing the tenant's policy.
+func (l *OpenLsm) RemoveTenant(id uint64) error {
+	return l.tenants.remove(id)
+}
+
 func (l *OpenLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error)) error {
 	config := BPFConfig{
 		ProgramNames:      []string{"lsm_open"},
 		EventMapName:      "events",
 		AllowedCgroupsMap: "allowed_cgroups",
 		TargetCgroupMap:   "target_cgroup",
+		DropMapName:       "dropped_events",
 		StartMessage:      "Successfully started monitoring file opens",
 		ShutdownMessage:   "Shutting down open LSM tracker",
+		metrics:           openMetrics,
 	}
 	return LoadAndAttachBPF(l, loader, config)
 }
 
-// checkRootPathPolicy checks if the root path "/" is explicitly allowed in the policy rules
-// and sets the default policy result accordingly
-func (l *OpenLsm) checkRootPathPolicy() {
-	// Default is false (deny)
-	l.defaultPolicyResult = false
+// compileOpenPolicies sorts rules by path length (longest first) for
+// specificity. The default result is allow only when the root path "/" is
+// explicitly allowed.
+func compileOpenPolicies(policies []OpenPolicyRule) ([]OpenPolicyRule, bool) {
+	sort.Slice(policies, func(i, j int) bool {
+		return policies[i].PathLen > policies[j].PathLen
+	})
 
-	// Check if any rule explicitly allows root path "/"
-	for _, rule := range l.policyRules {
+	defaultAllow := false
+	for _, rule := range policies {
 		pathStr := string(bytes.TrimRight(rule.Path[:rule.PathLen], "\x00"))
 		if pathStr == "/" && rule.Action == PolicyAllow {
-			l.defaultPolicyResult = true
+			defaultAllow = true
 			break
 		}
 	}
+	return policies, defaultAllow
 }
 
+// loadPolicyIntoBPF writes the rules of the module's own cgroup. A module
+// without one enforces only tenants, whose rules tenants.bind writes.
 func (l *OpenLsm) loadPolicyIntoBPF(coll *ebpf.Collection) error {
+	if l.cgroupPath == "" {
+		return nil
+	}
+
 	// Always load the default policy result into BPF map
 	key := uint32(0)
 	defaultResult := uint32(0) // Default to deny
@@ -216,6 +239,7 @@ func validateEvent(event *OpenEvent) bool {
 
 func (l *OpenLsm) handleEvent(data []byte) {
 	if len(data) < int(unsafe.Sizeof(OpenEvent{})) {
+		openMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received incomplete event\n")
 		return
 	}
@@ -223,12 +247,14 @@ func (l *OpenLsm) handleEvent(data []byte) {
 	var event OpenEvent
 	reader := bytes.NewReader(data)
 	if err := binary.Read(reader, binary.LittleEndian, &event); err != nil {
+		openMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: failed to parse event: %v\n", err)
 		return
 	}
 
 	// Validate event data to prevent corruption
 	if !validateEvent(&event) {
+		openMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received corrupted event data (missing null terminators)\n")
 		return
 	}
@@ -239,6 +265,7 @@ func (l *OpenLsm) handleEvent(data []byte) {
 
 	// Additional validation - reject obviously corrupted data
 	if len(comm) == 0 || len(path) == 0 {
+		openMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received event with empty comm or path\n")
 		return
 	}
@@ -246,6 +273,8 @@ func (l *OpenLsm) handleEvent(data []byte) {
 	// Use current time for ISO 8601 format (BPF timestamp is kernel boot time, not Unix time)
 	timestamp := time.Now().Format(time.RFC3339)
 
+	openMetrics.decision(event.Result)
+
 	// Format result string (match C version)
 	resultStr := "allowed"
 	if event.Result != 0 {
@@ -314,13 +343,13 @@ func (l *OpenLsm) handleEvent(data []byte) {
 	// Unique path logging removed
 }
 
-func addDescendantCgroups(cgroupMap *ebpf.Map, cgroupPath string) error {
-	value := uint8(1)
-
+// addDescendantCgroups adds cgroupPath and every cgroup below it to
+// cgroupMap with value: 1 for a single-target program, or the tenant ID.
+func addDescendantCgroups(cgroupMap *ebpf.Map, cgroupPath string, value any) error {
 	// Add the current directory's cgroup ID (matching C version exactly)
 	cgroupID, err := getCgroupID(cgroupPath)
 	if err == nil {
-		if err := cgroupMap.Put(&cgroupID, &value); err == nil {
+		if err := cgroupMap.Put(&cgroupID, value); err == nil {
 			// fmt.Printf("Added cgroup ID %d: %s\n", cgroupID, cgroupPath)
 		}
 	}
@@ -358,7 +387,7 @@ func addDescendantCgroups(cgroupMap *ebpf.Map, cgroupPath string) error {
 			}
 
 			// Recursively add subdirectory (matching C version)
-			addDescendantCgroups(cgroupMap, fullPath)
+			addDescendantCgroups(cgroupMap, fullPath, value)
 		}
 	}
 
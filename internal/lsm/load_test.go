@@ -0,0 +1,123 @@
+//go:build linux
+
+package lsm
+
+import (
+	"encoding/binary"
+	"os"
+	"strings"
+	"testing"
+
+	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/link"
+)
+
+// requireBPFLSM skips unless the test can load and attach LSM programs.
+// With LEASH_LSM_LOAD_TEST=1 (make lsm-load-test) it fails instead, so a
+// passing run means the programs really went through the verifier.
+func requireBPFLSM(t *testing.T) {
+	t.Helper()
+	skip := t.Skip
+	if os.Getenv("LEASH_LSM_LOAD_TEST") == "1" {
+		skip = t.Fatal
+	}
+	if os.Geteuid() != 0 {
+		skip("loading BPF programs requires root")
+	}
+	lsms, err := os.ReadFile("/sys/kernel/security/lsm")
+	if err != nil || !strings.Contains(string(lsms), "bpf") {
+		skip("BPF LSM is not enabled")
+	}
+	if err := BumpMemlockRlimit(); err != nil {
+		t.Fatalf("memlock rlimit: %v", err)
+	}
+}
+
+// TestProgramsLoadAndAttach runs both builds of every program through the
+// kernel verifier and attaches their LSM hooks.
+func TestProgramsLoadAndAttach(t *testing.T) {
+	requireBPFLSM(t)
+
+	for _, tc := range []struct {
+		name     string
+		loader   func() (*ebpf.CollectionSpec, error)
+		programs []string
+		dropMap  string
+	}{
+		{"open", loadLsmOpen, []string{"lsm_open"}, "dropped_events"},
+		{"exec", loadLsmExec, []string{"lsm_exec"}, "exec_dropped_events"},
+		{"connect", loadLsmConnect, []string{"lsm_connect", "lsm_sendmsg"}, "connect_dropped_events"},
+		{"open-tenants", loadLsmOpenTenants, []string{"lsm_open"}, "dropped_events"},
+		{"exec-tenants", loadLsmExecTenants, []string{"lsm_exec"}, "exec_dropped_events"},
+		{"connect-tenants", loadLsmConnectTenants, []string{"lsm_connect", "lsm_sendmsg"}, "connect_dropped_events"},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			coll, _, err := loadCollection("test."+tc.name, tc.loader)
+			if err != nil {
+				t.Fatal(err)
+			}
+			defer coll.Close()
+			if drops := dropCounter(coll.Maps[tc.dropMap])(); coll.Maps[tc.dropMap] == nil || drops != 0 {
+				t.Fatalf("expected an empty %s map, got %v (present %v)", tc.dropMap, drops, coll.Maps[tc.dropMap] != nil)
+			}
+			for _, name := range tc.programs {
+				l, err := link.AttachLSM(link.LSMOptions{Program: coll.Programs[name]})
+				if err != nil {
+					t.Fatalf("attach %s: %v", name, err)
+				}
+				l.Close()
+			}
+		})
+	}
+}
+
+// TestTenantWriteSwapsHeaderWithRules checks that a tenant's rule count and
+// default result arrive in the same inner array as its rules.
+func TestTenantWriteSwapsHeaderWithRules(t *testing.T) {
+	requireBPFLSM(t)
+
+	coll, spec, err := loadCollection("test.exec-tenants", loadLsmExecTenants)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer coll.Close()
+	table := tenantTable[ExecPolicyRule]{maps: tenantMaps{
+		allowedCgroups: "exec_allowed_cgroups",
+		rules:          "exec_policy_rules",
+	}}
+	if err := table.bind(coll, spec); err != nil {
+		t.Fatal(err)
+	}
+
+	tenant, err := ResolveTenant(t.TempDir())
+	if err != nil {
+		t.Fatal(err)
+	}
+	rules, _ := compileExecPolicies(ConvertToExecRules(replayPolicySet(t, "allow proc.exec /usr/bin/", "deny proc.exec /usr/bin/curl").Exec))
+	if err := table.set(tenant, rules, true); err != nil {
+		t.Fatal(err)
+	}
+
+	var innerID ebpf.MapID
+	if err := coll.Maps["exec_policy_rules"].Lookup(&tenant.ID, &innerID); err != nil {
+		t.Fatalf("lookup tenant rules: %v", err)
+	}
+	inner, err := ebpf.NewMapFromID(innerID)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer inner.Close()
+	header := make([]byte, inner.ValueSize())
+	if err := inner.Lookup(inner.MaxEntries()-1, &header); err != nil {
+		t.Fatalf("lookup header: %v", err)
+	}
+	if n := binary.NativeEndian.Uint32(header); n != 2 {
+		t.Fatalf("expected 2 rules in the header, got %d", n)
+	}
+	if allow := binary.NativeEndian.Uint32(header[4:]); allow != 1 {
+		t.Fatalf("expected an allow default in the header, got %d", allow)
+	}
+	if owner, ok := TenantOf(tenant.ID); !ok || owner != tenant.ID {
+		t.Fatalf("expected the tenant root to map to itself, got %d %v", owner, ok)
+	}
+}
@@ -1,11 +1,14 @@
-//go:generate bash -c "if [ \"$(uname -s)\" = 'Linux' ]; then command -v bpf2go 1>/dev/null 2>&1 || go install github.com/cilium/ebpf/cmd/bpf2go && bpf2go -cc clang -tags linux lsmOpen bpf/lsm_open.bpf.c -- -I./bpf && bpf2go -cc clang -tags linux lsmExec bpf/lsm_exec.bpf.c -- -I./bpf && bpf2go -cc clang -tags linux lsmConnect bpf/lsm_connect.bpf.c -- -I./bpf; else echo 'Skipping bpf2go in non-Linux build environment'; fi"
+//go:generate bash -c "if [ \"$(uname -s)\" = 'Linux' ]; then command -v bpf2go 1>/dev/null 2>&1 || go install github.com/cilium/ebpf/cmd/bpf2go && bpf2go -cc clang -tags linux lsmOpen bpf/lsm_open.bpf.c -- -I./bpf && bpf2go -cc clang -tags linux lsmExec bpf/lsm_exec.bpf.c -- -I./bpf && bpf2go -cc clang -tags linux lsmConnect bpf/lsm_connect.bpf.c -- -I./bpf && bpf2go -cc clang -tags linux lsmOpenTenants bpf/lsm_open.bpf.c -- -I./bpf -DLEASH_MULTI_TENANT && bpf2go -cc clang -tags linux lsmExecTenants bpf/lsm_exec.bpf.c -- -I./bpf -DLEASH_MULTI_TENANT && bpf2go -cc clang -tags linux lsmConnectTenants bpf/lsm_connect.bpf.c -- -I./bpf -DLEASH_MULTI_TENANT; else echo 'Skipping bpf2go in non-Linux build environment'; fi"
 
 package lsm
 
 import (
+	"cmp"
+	"errors"
 	"fmt"
 	"os"
 	"os/signal"
+	"slices"
 	"sync"
 	"syscall"
 )
@@ -20,6 +23,17 @@ type LSMManager struct {
 	execLsm    *ExecLsm
 	connectLsm *ConnectLsm
 
+	// Rules most recently loaded into each program. Reloads whose converted
+	// rules are unchanged are skipped so a policy change only rewrites the
+	// maps of the programs it actually touches.
+	appliedOpen           []OpenPolicyRule
+	appliedExec           []ExecPolicyRule
+	appliedConnect        []ConnectPolicyRule
+	appliedConnectDefault *bool
+
+	// Tenants registered with AddTenant, keyed by tenant ID.
+	tenants map[uint64]Tenant
+
 	reloadMutex sync.RWMutex
 }
 
@@ -30,6 +44,25 @@ func NewLSMManager(cgroupPath string, logger *SharedLogger) *LSMManager {
 	}
 }
 
+// SetCgroupPath sets the cgroup the programs are bound to when they are
+// first attached. A standby daemon learns it only once a session claims it.
+func (m *LSMManager) SetCgroupPath(cgroupPath string) {
+	m.reloadMutex.Lock()
+	defer m.reloadMutex.Unlock()
+	m.cgroupPath = cgroupPath
+}
+
+// Preload loads and verifies every LSM collection ahead of the first policy
+// update, so attaching later skips the kernel verifier. The program names
+// match each module's BPFConfig.
+func (m *LSMManager) Preload() error {
+	return errors.Join(
+		PreloadBPF([]string{"lsm_open"}, loadLsmOpen),
+		PreloadBPF([]string{"lsm_exec"}, loadLsmExec),
+		PreloadBPF([]string{"lsm_connect", "lsm_sendmsg"}, loadLsmConnect),
+	)
+}
+
 func (m *LSMManager) LoadAndStart() error {
 	// Set up signal handling for graceful shutdown
 	sigChan := make(chan os.Signal, 1)
@@ -47,12 +80,20 @@ func (m *LSMManager) LoadAndStart() error {
 }
 
 func (m *LSMManager) updateOpenLSM(policies *PolicySet) error {
+	rules := ConvertToFileOpenRules(policies.Open)
+	if m.openLsm != nil && slices.Equal(rules, m.appliedOpen) {
+		return nil
+	}
+
 	if !policies.HasOpenPolicies() {
 		// No open policies, ensure LSM is stopped
 		if m.openLsm != nil {
 			fmt.Printf("No open policies found, open LSM will continue with empty rules\n")
 			// Just reload with empty rules instead of stopping
-			return m.openLsm.LoadPolicies([]OpenPolicyRule{})
+			if err := m.openLsm.LoadPolicies([]OpenPolicyRule{}); err != nil {
+				return err
+			}
+			m.appliedOpen = nil
 		}
 		return nil
 	}
@@ -66,9 +107,10 @@ func (m *LSMManager) updateOpenLSM(policies *PolicySet) error {
 		}
 
 		// Load policies and start in background
-		if err := m.openLsm.LoadPolicies(ConvertToFileOpenRules(policies.Open)); err != nil {
+		if err := m.openLsm.LoadPolicies(slices.Clone(rules)); err != nil {
 			return fmt.Errorf("failed to load open policies: %w", err)
 		}
+		m.appliedOpen = rules
 
 		go func() {
 			if err := m.openLsm.LoadAndAttach(loadLsmOpen); err != nil {
@@ -77,17 +119,28 @@ func (m *LSMManager) updateOpenLSM(policies *PolicySet) error {
 		}()
 	} else {
 		// Update existing policies
-		return m.openLsm.LoadPolicies(ConvertToFileOpenRules(policies.Open))
+		if err := m.openLsm.LoadPolicies(slices.Clone(rules)); err != nil {
+			return err
+		}
+		m.appliedOpen = rules
 	}
 
 	return nil
 }
 
 func (m *LSMManager) updateExecLSM(policies *PolicySet) error {
+	rules := ConvertToExecRules(policies.Exec)
+	if m.execLsm != nil && slices.Equal(rules, m.appliedExec) {
+		return nil
+	}
+
 	if !policies.HasExecPolicies() {
 		if m.execLsm != nil {
 			fmt.Printf("No exec policies found, exec LSM will continue with empty rules\n")
-			return m.execLsm.LoadPolicies([]ExecPolicyRule{})
+			if err := m.execLsm.LoadPolicies([]ExecPolicyRule{}); err != nil {
+				return err
+			}
+			m.appliedExec = nil
 		}
 		return nil
 	}
@@ -99,9 +152,10 @@ func (m *LSMManager) updateExecLSM(policies *PolicySet) error {
 			return fmt.Errorf("failed to create exec LSM: %w", err)
 		}
 
-		if err := m.execLsm.LoadPolicies(ConvertToExecRules(policies.Exec)); err != nil {
+		if err := m.execLsm.LoadPolicies(slices.Clone(rules)); err != nil {
 			return fmt.Errorf("failed to load exec policies: %w", err)
 		}
+		m.appliedExec = rules
 
 		go func() {
 			if err := m.execLsm.LoadAndAttach(loadLsmExec); err != nil {
@@ -109,7 +163,10 @@ func (m *LSMManager) updateExecLSM(policies *PolicySet) error {
 			}
 		}()
 	} else {
-		return m.execLsm.LoadPolicies(ConvertToExecRules(policies.Exec))
+		if err := m.execLsm.LoadPolicies(slices.Clone(rules)); err != nil {
+			return err
+		}
+		m.appliedExec = rules
 	}
 
 	return nil
@@ -122,10 +179,18 @@ func (m *LSMManager) updateConnectLSM(policies *PolicySet) error {
 		defaultOverride = &val
 	}
 
+	rules := ConvertToConnectRules(policies.Connect)
+	if m.connectLsm != nil && slices.Equal(rules, m.appliedConnect) && sameDefaultOverride(defaultOverride, m.appliedConnectDefault) {
+		return nil
+	}
+
 	if !policies.HasConnectPolicies() {
 		if m.connectLsm != nil {
 			fmt.Printf("No connect policies found, connect LSM will continue with empty rules\n")
-			return m.connectLsm.LoadPolicies([]ConnectPolicyRule{}, defaultOverride)
+			if err := m.connectLsm.LoadPolicies([]ConnectPolicyRule{}, defaultOverride); err != nil {
+				return err
+			}
+			m.appliedConnect, m.appliedConnectDefault = nil, defaultOverride
 		}
 		return nil
 	}
@@ -137,9 +202,10 @@ func (m *LSMManager) updateConnectLSM(policies *PolicySet) error {
 			return fmt.Errorf("failed to create connect LSM: %w", err)
 		}
 
-		if err := m.connectLsm.LoadPolicies(ConvertToConnectRules(policies.Connect), defaultOverride); err != nil {
+		if err := m.connectLsm.LoadPolicies(slices.Clone(rules), defaultOverride); err != nil {
 			return fmt.Errorf("failed to load connect policies: %w", err)
 		}
+		m.appliedConnect, m.appliedConnectDefault = rules, defaultOverride
 
 		go func() {
 			if err := m.connectLsm.LoadAndAttach(loadLsmConnect); err != nil {
@@ -147,12 +213,165 @@ func (m *LSMManager) updateConnectLSM(policies *PolicySet) error {
 			}
 		}()
 	} else {
-		return m.connectLsm.LoadPolicies(ConvertToConnectRules(policies.Connect), defaultOverride)
+		if err := m.connectLsm.LoadPolicies(slices.Clone(rules), defaultOverride); err != nil {
+			return err
+		}
+		m.appliedConnect, m.appliedConnectDefault = rules, defaultOverride
 	}
 
 	return nil
 }
 
+// AddTenant enforces policies on the cgroup subtree at cgroupPath, or
+// replaces the tenant's policies when it is already registered. Tenants are
+// only available to a manager without its own cgroup; the programs built
+// for tenants are attached once and shared by every tenant. A tenant whose
+// policy has no rules for a program is not monitored by it.
+func (m *LSMManager) AddTenant(cgroupPath string, policies *PolicySet) (Tenant, error) {
+	m.reloadMutex.Lock()
+	defer m.reloadMutex.Unlock()
+
+	if m.cgroupPath != "" {
+		return Tenant{}, fmt.Errorf("tenants require a manager without a target cgroup (have %s)", m.cgroupPath)
+	}
+	tenant, err := ResolveTenant(cgroupPath)
+	if err != nil {
+		return Tenant{}, err
+	}
+	if _, ok := m.tenants[tenant.ID]; !ok && len(m.tenants) >= MaxTenants {
+		return Tenant{}, fmt.Errorf("tenant limit of %d reached", MaxTenants)
+	}
+
+	if err := m.setTenantOpen(tenant, policies); err != nil {
+		return Tenant{}, fmt.Errorf("failed to load open policies for tenant %d: %w", tenant.ID, err)
+	}
+	if err := m.setTenantExec(tenant, policies); err != nil {
+		return Tenant{}, fmt.Errorf("failed to load exec policies for tenant %d: %w", tenant.ID, err)
+	}
+	if err := m.setTenantConnect(tenant, policies); err != nil {
+		return Tenant{}, fmt.Errorf("failed to load connect policies for tenant %d: %w", tenant.ID, err)
+	}
+
+	if m.tenants == nil {
+		m.tenants = make(map[uint64]Tenant)
+	}
+	m.tenants[tenant.ID] = tenant
+	return tenant, nil
+}
+
+// RemoveTenant stops enforcing a tenant added with AddTenant.
+func (m *LSMManager) RemoveTenant(id uint64) error {
+	m.reloadMutex.Lock()
+	defer m.reloadMutex.Unlock()
+
+	if _, ok := m.tenants[id]; !ok {
+		return fmt.Errorf("unknown tenant %d", id)
+	}
+	var errs []error
+	if m.openLsm != nil {
+		errs = append(errs, m.openLsm.RemoveTenant(id))
+	}
+	if m.execLsm != nil {
+		errs = append(errs, m.execLsm.RemoveTenant(id))
+	}
+	if m.connectLsm != nil {
+		errs = append(errs, m.connectLsm.RemoveTenant(id))
+	}
+	delete(m.tenants, id)
+	return errors.Join(errs...)
+}
+
+// Tenants returns the registered tenants ordered by ID.
+func (m *LSMManager) Tenants() []Tenant {
+	m.reloadMutex.RLock()
+	defer m.reloadMutex.RUnlock()
+
+	tenants := make([]Tenant, 0, len(m.tenants))
+	for _, tenant := range m.tenants {
+		tenants = append(tenants, tenant)
+	}
+	slices.SortFunc(tenants, func(a, b Tenant) int { return cmp.Compare(a.ID, b.ID) })
+	return tenants
+}
+
+func (m *LSMManager) setTenantOpen(tenant Tenant, policies *PolicySet) error {
+	if !policies.HasOpenPolicies() {
+		if m.openLsm == nil {
+			return nil
+		}
+		return m.openLsm.RemoveTenant(tenant.ID)
+	}
+	if m.openLsm == nil {
+		module, err := NewOpenLsm("", m.logger)
+		if err != nil {
+			return err
+		}
+		m.openLsm = module
+		go func() {
+			if err := module.LoadAndAttach(loadLsmOpenTenants); err != nil {
+				fmt.Fprintf(os.Stderr, "File open LSM error: %v\n", err)
+			}
+		}()
+	}
+	return m.openLsm.SetTenantPolicies(tenant, ConvertToFileOpenRules(policies.Open))
+}
+
+func (m *LSMManager) setTenantExec(tenant Tenant, policies *PolicySet) error {
+	if !policies.HasExecPolicies() {
+		if m.execLsm == nil {
+			return nil
+		}
+		return m.execLsm.RemoveTenant(tenant.ID)
+	}
+	if m.execLsm == nil {
+		module, err := NewExecLsm("", m.logger)
+		if err != nil {
+			return err
+		}
+		m.execLsm = module
+		go func() {
+			if err := module.LoadAndAttach(loadLsmExecTenants); err != nil {
+				fmt.Fprintf(os.Stderr, "Exec LSM error: %v\n", err)
+			}
+		}()
+	}
+	return m.execLsm.SetTenantPolicies(tenant, ConvertToExecRules(policies.Exec))
+}
+
+func (m *LSMManager) setTenantConnect(tenant Tenant, policies *PolicySet) error {
+	if !policies.HasConnectPolicies() {
+		if m.connectLsm == nil {
+			return nil
+		}
+		return m.connectLsm.RemoveTenant(tenant.ID)
+	}
+	if m.connectLsm == nil {
+		module, err := NewConnectLsm("", m.logger)
+		if err != nil {
+			return err
+		}
+		m.connectLsm = module
+		go func() {
+			if err := module.LoadAndAttach(loadLsmConnectTenants); err != nil {
+				fmt.Fprintf(os.Stderr, "Connect LSM error: %v\n", err)
+			}
+		}()
+	}
+	var defaultOverride *bool
+	if policies.ConnectDefaultExplicit {
+		val := policies.ConnectDefaultAllow
+		defaultOverride = &val
+	}
+	return m.connectLsm.SetTenantPolicies(tenant, ConvertToConnectRules(policies.Connect), defaultOverride)
+}
+
+func sameDefaultOverride(a, b *bool) bool {
+	if a == nil || b == nil {
+		return a == b
+	}
+	return *a == *b
+}
+
 // UpdateRuntimeRules updates all LSM modules with new runtime rules
 func (m *LSMManager) UpdateRuntimeRules(policies *PolicySet) error {
 	m.reloadMutex.Lock()
@@ -0,0 +1,60 @@
+package lsm
+
+import (
+	"github.com/strongdm/leash/internal/telemetry/metrics"
+)
+
+// programMetrics counts what one LSM program reports through its ring
+// buffer.
+type programMetrics struct {
+	program      string
+	events       *metrics.Counter
+	allowed      *metrics.Counter
+	denied       *metrics.Counter
+	decodeErrors *metrics.Counter
+	pendingBytes *metrics.Gauge
+}
+
+var (
+	openMetrics    = newProgramMetrics("open")
+	execMetrics    = newProgramMetrics("exec")
+	connectMetrics = newProgramMetrics("connect")
+)
+
+func newProgramMetrics(program string) *programMetrics {
+	r := metrics.Default
+	return &programMetrics{
+		program:      program,
+		events:       r.Counter("leash_lsm_events_total", "Events read from the LSM ring buffers.", "program", program),
+		allowed:      r.Counter("leash_lsm_decisions_total", "Decisions reported by the LSM programs.", "program", program, "decision", "allow"),
+		denied:       r.Counter("leash_lsm_decisions_total", "Decisions reported by the LSM programs.", "program", program, "decision", "deny"),
+		decodeErrors: r.Counter("leash_lsm_decode_errors_total", "LSM events that were truncated or failed validation.", "program", program),
+		pendingBytes: r.Gauge("leash_lsm_ringbuf_pending_bytes", "Bytes written to the ring buffer but not yet read, sampled after each read.", "program", program),
+	}
+}
+
+// decision records the result of a decoded event; non-zero results deny.
+func (m *programMetrics) decision(result int32) {
+	if result != 0 {
+		m.denied.Inc()
+		return
+	}
+	m.allowed.Inc()
+}
+
+// Programs names the LSM programs, as used in metric labels.
+var Programs = []string{"open", "exec", "connect"}
+
+// PendingBytes reports how many bytes program's ring buffer holds that its
+// reader has not consumed yet, as of the last read.
+func PendingBytes(program string) int64 {
+	switch program {
+	case "open":
+		return openMetrics.pendingBytes.Value()
+	case "exec":
+		return execMetrics.pendingBytes.Value()
+	case "connect":
+		return connectMetrics.pendingBytes.Value()
+	}
+	return 0
+}
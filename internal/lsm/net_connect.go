@@ -5,6 +5,7 @@ import (
 	"encoding/binary"
 	"fmt"
 	"log"
+	"maps"
 	"net"
 	"net/url"
 	"os"
@@ -123,24 +124,29 @@ type ConnectLsm struct {
 	logMutex            sync.Mutex // Protect concurrent writes to stdout and log file
 
 	// DNS cache for hostname resolution
-	dnsCache    map[uint32]string // IP -> hostname mapping
+	dnsCache    map[uint32]string            // IP -> hostname mapping
+	tenantHosts map[uint64]map[uint32]string // Entries resolved for each tenant's rules
 	dnsCacheMux sync.RWMutex
 
 	// BPF program state
 	ebpfCollection *ebpf.Collection
+	tenants        tenantTable[ConnectPolicyRuleBPF]
 }
 
+// NewConnectLsm creates the connect module. An empty cgroupPath leaves out
+// the module's own cgroup, so only tenants added with SetTenantPolicies are
+// enforced.
 func NewConnectLsm(cgroupPath string, logger *SharedLogger) (*ConnectLsm, error) {
-	if cgroupPath == "" {
-		return nil, fmt.Errorf("cgroup path is required")
-	}
-
 	l := &ConnectLsm{
 		cgroupPath: cgroupPath,
 		logger:     logger,
 
 		dnsCache:            make(map[uint32]string),
 		defaultPolicyResult: false, // Default to deny (false)
+		tenants: tenantTable[ConnectPolicyRuleBPF]{maps: tenantMaps{
+			allowedCgroups: "connect_allowed_cgroups",
+			rules:          "connect_policy_rules",
+		}},
 	}
 
 	// Note: Policy loading is now done separately via LoadPolicies()
@@ -153,29 +159,116 @@ func (l *ConnectLsm) getCgroupPath() string {
 	return l.cgroupPath
 }
 
-func (l *ConnectLsm) setEbpfCollection(coll *ebpf.Collection) {
+func (l *ConnectLsm) setEbpfCollection(coll *ebpf.Collection, spec *ebpf.CollectionSpec) error {
 	l.ebpfCollection = coll
+	if l.cgroupPath != "" {
+		return nil
+	}
+	return l.tenants.bind(coll, spec)
+}
+
+// compiledConnectPolicy is a connect policy in the form the kernel enforces.
+type compiledConnectPolicy struct {
+	rules           []ConnectPolicyRuleBPF
+	defaultAllow    bool
+	hosts           map[uint32]string // resolved IP -> hostname
+	skippedWildcard int
+	failedResolves  int
 }
 
 // LoadPolicies loads connect policy rules into the LSM
 func (l *ConnectLsm) LoadPolicies(policies []ConnectPolicyRule, defaultOverride *bool) error {
-	// Convert hostname-based rules to IP-based rules so kernel enforces IP+port only
-	var expanded []ConnectPolicyRuleBPF
-	var skippedWildcard, failedResolves int
+	compiled := compileConnectPolicies(policies, defaultOverride)
+	explicitDefault := defaultOverride != nil
+
+	// Reset DNS cache before repopulating, keeping the tenants' entries
+	l.dnsCacheMux.Lock()
+	l.dnsCache = compiled.hosts
+	for _, hosts := range l.tenantHosts {
+		maps.Copy(l.dnsCache, hosts)
+	}
+	l.dnsCacheMux.Unlock()
+
+	l.policyRules = compiled.rules
+	l.numPolicyRules = len(compiled.rules)
+	l.defaultPolicyResult = compiled.defaultAllow
+
+	fmt.Printf("Loaded %d connect IP rules (skipped %d wildcard, %d unresolved)\n", l.numPolicyRules, compiled.skippedWildcard, compiled.failedResolves)
+	if explicitDefault {
+		if l.defaultPolicyResult {
+			fmt.Printf("Default connect policy result: ALLOW (configured override)\n")
+		} else {
+			fmt.Printf("Default connect policy result: DENY (configured override)\n")
+		}
+	} else {
+		if l.defaultPolicyResult {
+			fmt.Printf("Default connect policy result: ALLOW (wildcard '*' is allowed)\n")
+		} else {
+			fmt.Printf("Default connect policy result: DENY (no wildcard rule found)\n")
+		}
+	}
+
+	// If eBPF collection is already loaded, update the BPF maps
+	if l.ebpfCollection != nil {
+		if err := l.loadPolicyIntoBPF(l.ebpfCollection); err != nil {
+			return fmt.Errorf("failed to update BPF maps: %w", err)
+		}
+
+		// Also update the DNS cache in BPF
+		if err := l.updateDNSCacheInBPF(l.ebpfCollection); err != nil {
+			fmt.Printf("Warning: failed to update DNS cache in BPF: %v\n", err)
+		}
+
+		fmt.Printf("Updated BPF maps with new connect policies\n")
+	}
+
+	return nil
+}
+
+// SetTenantPolicies enforces policies on the tenant's cgroup subtree,
+// replacing any rules it had before.
+func (l *ConnectLsm) SetTenantPolicies(tenant Tenant, policies []ConnectPolicyRule, defaultOverride *bool) error {
+	compiled := compileConnectPolicies(policies, defaultOverride)
+	l.dnsCacheMux.Lock()
+	if l.tenantHosts == nil {
+		l.tenantHosts = make(map[uint64]map[uint32]string)
+	}
+	l.tenantHosts[tenant.ID] = compiled.hosts
+	maps.Copy(l.dnsCache, compiled.hosts)
+	l.dnsCacheMux.Unlock()
 
-	// Reset DNS cache before repopulating
+	if err := l.tenants.set(tenant, compiled.rules, compiled.defaultAllow); err != nil {
+		return err
+	}
+	if l.ebpfCollection != nil {
+		if err := l.updateDNSCacheInBPF(l.ebpfCollection); err != nil {
+			fmt.Printf("Warning: failed to update DNS cache in BPF: %v\n", err)
+		}
+	}
+	return nil
+}
+
+// RemoveTenant stops enforcing the tenant's policy.
+func (l *ConnectLsm) RemoveTenant(id uint64) error {
 	l.dnsCacheMux.Lock()
-	l.dnsCache = make(map[uint32]string)
+	delete(l.tenantHosts, id)
 	l.dnsCacheMux.Unlock()
+	return l.tenants.remove(id)
+}
+
+// compileConnectPolicies converts hostname-based rules to IP-based rules so
+// the kernel enforces IP+port only, and derives the default result.
+func compileConnectPolicies(policies []ConnectPolicyRule, defaultOverride *bool) compiledConnectPolicy {
+	var expanded []ConnectPolicyRuleBPF
+	c := compiledConnectPolicy{hosts: make(map[uint32]string)}
 
 	allowAny := false
 	explicitDefault := defaultOverride != nil
 	if explicitDefault {
-		l.defaultPolicyResult = *defaultOverride
-	} else {
-		l.defaultPolicyResult = false
+		c.defaultAllow = *defaultOverride
 	}
 	for _, rule := range policies {
+
 		// If rule already has an IP (non-zero), keep as-is
 		if rule.DestIP != 0 {
 			expanded = append(expanded, ConnectPolicyRuleBPF{
@@ -207,7 +300,7 @@ func (l *ConnectLsm) LoadPolicies(policies []ConnectPolicyRule, defaultOverride
 
 		// Skip wildcards in kernel; enforce via userspace proxy
 		if rule.IsWildcard == 1 {
-			skippedWildcard++
+			c.skippedWildcard++
 			continue
 		}
 
@@ -221,7 +314,7 @@ func (l *ConnectLsm) LoadPolicies(policies []ConnectPolicyRule, defaultOverride
 		}
 		ips, err := net.LookupIP(hostname)
 		if err != nil {
-			failedResolves++
+			c.failedResolves++
 			continue
 		}
 
@@ -243,77 +336,34 @@ func (l *ConnectLsm) LoadPolicies(policies []ConnectPolicyRule, defaultOverride
 			expanded = append(expanded, newRule)
 
 			// Populate DNS cache for logging/BPF map
-			l.dnsCacheMux.Lock()
-			l.dnsCache[ipNum] = hostname
-			l.dnsCacheMux.Unlock()
+			c.hosts[ipNum] = hostname
 		}
 	}
 
-	l.policyRules = expanded
-	l.numPolicyRules = len(expanded)
-
 	// Sort by port then IP for readability (optional)
-	sort.Slice(l.policyRules, func(i, j int) bool {
-		if l.policyRules[i].DestPort == l.policyRules[j].DestPort {
-			return l.policyRules[i].DestIP < l.policyRules[j].DestIP
+	sort.Slice(expanded, func(i, j int) bool {
+		if expanded[i].DestPort == expanded[j].DestPort {
+			return expanded[i].DestIP < expanded[j].DestIP
 		}
-		return l.policyRules[i].DestPort < l.policyRules[j].DestPort
+		return expanded[i].DestPort < expanded[j].DestPort
 	})
+	c.rules = expanded
 
 	if !explicitDefault {
-		// Check if root path "/" is allowed to set default policy result
-		l.checkRootConnectPolicy()
+		// A rule that allows all IPs/hostnames makes the default permissive
+		for _, rule := range expanded {
+			if rule.Action == PolicyAllow && rule.DestIP == 0 && rule.HostnameLen == 0 {
+				c.defaultAllow = true
+				break
+			}
+		}
 
 		// If we saw "allow net.send *", set default allow in the kernel
 		if allowAny {
-			l.defaultPolicyResult = true
-		}
-	}
-
-	fmt.Printf("Loaded %d connect IP rules (skipped %d wildcard, %d unresolved)\n", l.numPolicyRules, skippedWildcard, failedResolves)
-	if explicitDefault {
-		if l.defaultPolicyResult {
-			fmt.Printf("Default connect policy result: ALLOW (configured override)\n")
-		} else {
-			fmt.Printf("Default connect policy result: DENY (configured override)\n")
-		}
-	} else {
-		if l.defaultPolicyResult {
-			fmt.Printf("Default connect policy result: ALLOW (wildcard '*' is allowed)\n")
-		} else {
-			fmt.Printf("Default connect policy result: DENY (no wildcard rule found)\n")
-		}
-	}
-
-	// If eBPF collection is already loaded, update the BPF maps
-	if l.ebpfCollection != nil {
-		if err := l.loadPolicyIntoBPF(l.ebpfCollection); err != nil {
-			return fmt.Errorf("failed to update BPF maps: %w", err)
-		}
-
-		// Also update the DNS cache in BPF
-		if err := l.updateDNSCacheInBPF(l.ebpfCollection); err != nil {
-			fmt.Printf("Warning: failed to update DNS cache in BPF: %v\n", err)
-		}
-
-		fmt.Printf("Updated BPF maps with new connect policies\n")
-	}
-
-	return nil
-}
-
-// checkRootConnectPolicy checks if there's a wildcard rule that allows all connections
-func (l *ConnectLsm) checkRootConnectPolicy() {
-	// Default is false (deny)
-	l.defaultPolicyResult = false
-
-	// For connect policies, we consider a rule that allows all IPs/hostnames as permissive
-	for _, rule := range l.policyRules {
-		if rule.Action == PolicyAllow && rule.DestIP == 0 && rule.HostnameLen == 0 {
-			l.defaultPolicyResult = true
-			break
+			c.defaultAllow = true
 		}
 	}
+	return c
 }
 
 func (l *ConnectLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error)) error {
@@ -322,8 +372,10 @@ func (l *ConnectLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error))
 		EventMapName:      "connect_events",
 		AllowedCgroupsMap: "connect_allowed_cgroups",
 		TargetCgroupMap:   "connect_target_cgroup",
+		DropMapName:       "connect_dropped_events",
 		StartMessage:      "Successfully started monitoring network connections and sendmsg operations",
 		ShutdownMessage:   "Shutting down connect LSM tracker",
+		metrics:           connectMetrics,
 	}
 
 	// Custom setup for DNS cache
@@ -338,7 +390,13 @@ func (l *ConnectLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error))
 	return LoadAndAttachBPFWithSetup(l, loader, config, customSetup)
 }
 
+// loadPolicyIntoBPF writes the rules of the module's own cgroup. A module
+// without one enforces only tenants, whose rules tenants.bind writes.
 func (l *ConnectLsm) loadPolicyIntoBPF(coll *ebpf.Collection) error {
+	if l.cgroupPath == "" {
+		return nil
+	}
+
 	// Always load the default policy result into BPF map
 	key := uint32(0)
 	defaultResult := uint32(0) // Default to deny
@@ -411,6 +469,7 @@ func validateConnectEvent(event *ConnectEvent) bool {
 
 func (l *ConnectLsm) handleEvent(data []byte) {
 	if len(data) < int(unsafe.Sizeof(ConnectEvent{})) {
+		connectMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received incomplete connect event\n")
 		return
 	}
@@ -418,12 +477,14 @@ func (l *ConnectLsm) handleEvent(data []byte) {
 	var event ConnectEvent
 	reader := bytes.NewReader(data)
 	if err := binary.Read(reader, binary.LittleEndian, &event); err != nil {
+		connectMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: failed to parse connect event: %v\n", err)
 		return
 	}
 
 	// Validate event data to prevent corruption
 	if !validateConnectEvent(&event) {
+		connectMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received corrupted connect event data\n")
 		return
 	}
@@ -434,6 +495,7 @@ func (l *ConnectLsm) handleEvent(data []byte) {
 
 	// Additional validation
 	if len(comm) == 0 {
+		connectMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received connect event with empty comm\n")
 		return
 	}
@@ -448,6 +510,8 @@ func (l *ConnectLsm) handleEvent(data []byte) {
 	// Use current time for ISO 8601 format (BPF timestamp is kernel boot time, not Unix time)
 	timestamp := time.Now().Format(time.RFC3339)
 
+	connectMetrics.decision(event.Result)
+
 	// Format result string
 	resultStr := "allowed"
 	if event.Result != 0 {
@@ -520,14 +584,22 @@ func (l *ConnectLsm) GetDNSCache() map[uint32]string {
 // SimplePolicyChecker implements a basic policy checker for MITMProxy integration
 type SimplePolicyChecker struct {
 	rules         []ConnectPolicyRule
-	defaultPolicy bool // true = allow, false = deny
+	hostnames     []string // rules[i].Hostname as a string, trimmed once
+	defaultPolicy bool     // true = allow, false = deny
 	mcpRules      []MCPPolicyRule
 }
 
 // NewSimplePolicyChecker creates a new policy checker with the given rules
 func NewSimplePolicyChecker(rules []ConnectPolicyRule, defaultPolicy bool, mcpRules []MCPPolicyRule) *SimplePolicyChecker {
+	hostnames := make([]string, len(rules))
+	for i := range rules {
+		if rules[i].HostnameLen > 0 {
+			hostnames[i] = string(bytes.TrimRight(rules[i].Hostname[:], "\x00"))
+		}
+	}
 	return &SimplePolicyChecker{
 		rules:         rules,
+		hostnames:     hostnames,
 		defaultPolicy: defaultPolicy,
 		mcpRules:      normalizeMCPRules(mcpRules),
 	}
@@ -544,8 +616,21 @@ func (pc *SimplePolicyChecker) CheckConnect(hostname string, ip string, port uin
 		}
 	}
 
+	if idx := pc.matchConnect(hostname, ipNum, port); idx >= 0 {
+		return pc.rules[idx].Action == PolicyAllow
+	}
+
+	log.Printf("CheckConnect: no rule matched, using default policy: %v", pc.defaultPolicy)
+
+	// No rule matched, use default policy
+	return pc.defaultPolicy
+}
+
+// matchConnect returns the index of the first rule matching the destination,
+// or -1 when the default policy applies.
+func (pc *SimplePolicyChecker) matchConnect(hostname string, ipNum uint32, port uint16) int {
 	// Check each rule (rules should be sorted by specificity)
-	for _, rule := range pc.rules {
+	for i, rule := range pc.rules {
 		matches := false
 
 		// Check IP match (0 means any IP, for hostname-only rules)
@@ -560,7 +645,7 @@ func (pc *SimplePolicyChecker) CheckConnect(hostname string, ip string, port uin
 
 		// Check hostname match if hostname is provided and rule has hostname restriction
 		if rule.HostnameLen > 0 {
-			ruleHostname := string(bytes.TrimRight(rule.Hostname[:], "\x00"))
+			ruleHostname := pc.hostnames[i]
 
 			if rule.IsWildcard == 1 {
 				// Wildcard matching (*.example.com)
@@ -585,14 +670,10 @@ func (pc *SimplePolicyChecker) CheckConnect(hostname string, ip string, port uin
 		}
 
 		if matches {
-			return rule.Action == PolicyAllow
+			return i
 		}
 	}
-
-	log.Printf("CheckConnect: no rule matched, using default policy: %v", pc.defaultPolicy)
-
-	// No rule matched, use default policy
-	return pc.defaultPolicy
+	return -1
 }
 
 // CheckMCPCall evaluates whether an MCP tools/call should be allowed, matching on server and tool.
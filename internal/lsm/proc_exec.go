@@ -61,19 +61,23 @@ type ExecLsm struct {
 
 	// BPF program state
 	ebpfCollection *ebpf.Collection
+	tenants        tenantTable[ExecPolicyRule]
 	// Keep the tracepoint link alive for the lifetime of this module.
 	tracepointLink link.Link
 }
 
+// NewExecLsm creates the exec module. An empty cgroupPath leaves out the
+// module's own cgroup, so only tenants added with SetTenantPolicies are
+// enforced.
 func NewExecLsm(cgroupPath string, logger *SharedLogger) (*ExecLsm, error) {
-	if cgroupPath == "" {
-		return nil, fmt.Errorf("cgroup path is required")
-	}
-
 	l := &ExecLsm{
 		cgroupPath:          cgroupPath,
 		logger:              logger,
 		defaultPolicyResult: false, // Default to deny (false)
+		tenants: tenantTable[ExecPolicyRule]{maps: tenantMaps{
+			allowedCgroups: "exec_allowed_cgroups",
+			rules:          "exec_policy_rules",
+		}},
 	}
 
 	return l, nil
@@ -85,21 +89,17 @@ func (l *ExecLsm) getCgroupPath() string {
 	return l.cgroupPath
 }
 
-func (l *ExecLsm) setEbpfCollection(coll *ebpf.Collection) {
+func (l *ExecLsm) setEbpfCollection(coll *ebpf.Collection, spec *ebpf.CollectionSpec) error {
 	l.ebpfCollection = coll
+	if l.cgroupPath != "" {
+		return nil
+	}
+	return l.tenants.bind(coll, spec)
 }
 
 func (l *ExecLsm) LoadPolicies(policies []ExecPolicyRule) error {
-	l.policyRules = policies
-	l.numPolicyRules = len(policies)
-
-	// Sort policy rules by path length (longest first) for specificity
-	sort.Slice(l.policyRules, func(i, j int) bool {
-		return l.policyRules[i].PathLen > l.policyRules[j].PathLen
-	})
-
-	// Check if root path "/" is allowed to set default policy result
-	l.checkRootPathPolicy()
+	l.policyRules, l.defaultPolicyResult = compileExecPolicies(policies)
+	l.numPolicyRules = len(l.policyRules)
 
 	fmt.Printf("Loaded %d exec policy rules\n", l.numPolicyRules)
 	if l.defaultPolicyResult {
@@ -119,19 +119,35 @@ func (l *ExecLsm) LoadPolicies(policies []ExecPolicyRule) error {
 	return nil
 }
 
-// checkRootPathPolicy checks if the root path "/" is explicitly allowed in the policy rules
-func (l *ExecLsm) checkRootPathPolicy() {
-	// Default is false (deny)
-	l.defaultPolicyResult = false
+// SetTenantPolicies enforces policies on the tenant's cgroup subtree,
+// replacing any rules it had before.
+func (l *ExecLsm) SetTenantPolicies(tenant Tenant, policies []ExecPolicyRule) error {
+	rules, defaultAllow := compileExecPolicies(policies)
+	return l.tenants.set(tenant, rules, defaultAllow)
+}
+
+// RemoveTenant stops enforcing the tenant's policy.
+func (l *ExecLsm) RemoveTenant(id uint64) error {
+	return l.tenants.remove(id)
+}
+
+// compileExecPolicies sorts rules by path length (longest first) for
+// specificity. The default result is allow only when the root path "/" is
+// explicitly allowed.
+func compileExecPolicies(policies []ExecPolicyRule) ([]ExecPolicyRule, bool) {
+	sort.Slice(policies, func(i, j int) bool {
+		return policies[i].PathLen > policies[j].PathLen
+	})
 
-	// Check if any rule explicitly allows root path "/"
-	for _, rule := range l.policyRules {
+	defaultAllow := false
+	for _, rule := range policies {
 		pathStr := string(bytes.TrimRight(rule.Path[:rule.PathLen], "\x00"))
 		if pathStr == "/" && rule.Action == PolicyAllow {
-			l.defaultPolicyResult = true
+			defaultAllow = true
 			break
 		}
 	}
+	return policies, defaultAllow
 }
 
 func (l *ExecLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error)) error {
@@ -140,8 +156,10 @@ func (l *ExecLsm) LoadAndAttach(loader func() (*ebpf.CollectionSpec, error)) err
 		EventMapName:      "exec_events",
 		AllowedCgroupsMap: "exec_allowed_cgroups",
 		TargetCgroupMap:   "exec_target_cgroup",
+		DropMapName:       "exec_dropped_events",
 		StartMessage:      "Successfully started monitoring program execution",
 		ShutdownMessage:   "Shutting down exec LSM tracker",
+		metrics:           execMetrics,
 	}
 	return LoadAndAttachBPFWithSetup(l, loader, config, l.attachTracepoint)
 }
@@ -168,7 +186,13 @@ func (l *ExecLsm) attachTracepoint(coll *ebpf.Collection) error {
 	return nil
 }
 
+// loadPolicyIntoBPF writes the rules of the module's own cgroup. A module
+// without one enforces only tenants, whose rules tenants.bind writes.
 func (l *ExecLsm) loadPolicyIntoBPF(coll *ebpf.Collection) error {
+	if l.cgroupPath == "" {
+		return nil
+	}
+
 	// Always load the default policy result into BPF map
 	key := uint32(0)
 	defaultResult := uint32(0) // Default to deny
@@ -233,6 +257,7 @@ func validateExecEvent(event *ExecEvent) bool {
 
 func (l *ExecLsm) handleEvent(data []byte) {
 	if len(data) < int(unsafe.Sizeof(ExecEvent{})) {
+		execMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received incomplete exec event\n")
 		return
 	}
@@ -240,12 +265,14 @@ func (l *ExecLsm) handleEvent(data []byte) {
 	var event ExecEvent
 	reader := bytes.NewReader(data)
 	if err := binary.Read(reader, binary.LittleEndian, &event); err != nil {
+		execMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: failed to parse exec event: %v\n", err)
 		return
 	}
 
 	// Validate event data to prevent corruption
 	if !validateExecEvent(&event) {
+		execMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received corrupted exec event data\n")
 		return
 	}
@@ -256,6 +283,7 @@ func (l *ExecLsm) handleEvent(data []byte) {
 
 	// Additional validation
 	if len(comm) == 0 || len(path) == 0 {
+		execMetrics.decodeErrors.Inc()
 		fmt.Fprintf(os.Stderr, "Error: received exec event with empty comm or path\n")
 		return
 	}
@@ -272,6 +300,8 @@ func (l *ExecLsm) handleEvent(data []byte) {
 	// Use current time for ISO 8601 format (BPF timestamp is kernel boot time, not Unix time)
 	timestamp := time.Now().Format(time.RFC3339)
 
+	execMetrics.decision(event.Result)
+
 	// Format result string
 	resultStr := "allowed"
 	if event.Result != 0 {
@@ -0,0 +1,845 @@
+package lsm
+
+import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"os"
+	"runtime"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+)
+
+const (
+	defaultReplayChunkSize = 4 << 20
+	defaultReplayTopN      = 10
+	// maxReplayTargets bounds the distinct paths/hosts tracked per rule; the
+	// remainder is counted in ReplayRuleStats.Other.
+	maxReplayTargets = 10000
+
+	// Rule table limits of the BPF programs (see check_path_policy and
+	// check_exec_policy).
+	maxOpenRulesBPF  = 256
+	maxExecRulesBPF  = 64
+	maxRulePathBPF   = 64
+	maxExecArgPrefix = 16
+	maxExecArgLen    = 23
+)
+
+// Replay hooks identify which enforcement point a decision came from.
+const (
+	ReplayHookOpen  = "file.open"
+	ReplayHookExec  = "proc.exec"
+	ReplayHookNet   = "net.send"
+	ReplayHookProxy = "http.request"
+)
+
+// ReplayEvent is one recorded event in the fields the enforcement points see.
+// Log lines and websocket history entries are both converted to this form.
+type ReplayEvent struct {
+	Event    string
+	Exe      string
+	Path     string
+	Argv     string
+	Argc     int
+	Addr     string
+	Hostname string
+	Protocol string
+	Decision string
+}
+
+// ReplayVerdict is the decision a policy set makes for a ReplayEvent. Rule is
+// the index of the deciding rule in the PolicySet slice for the hook (Open,
+// Exec or Connect), or -1 when the default applied.
+type ReplayVerdict struct {
+	Hook      string
+	Allowed   bool
+	Rule      int
+	Evaluated bool
+}
+
+// ReplayOptions tunes Replay. The zero value uses one worker per CPU, 4 MiB
+// chunks and the top 10 targets per rule.
+type ReplayOptions struct {
+	Workers   int
+	ChunkSize int
+	TopN      int
+}
+
+// ReplayReport summarizes a replay.
+type ReplayReport struct {
+	// Events counts file, exec and network events that were evaluated;
+	// Skipped counts other lines.
+	Events  int64 `json:"events"`
+	Skipped int64 `json:"skipped"`
+	Allowed int64 `json:"allowed"`
+	Denied  int64 `json:"denied"`
+	// NewlyDenied and NewlyAllowed count events whose recorded decision
+	// differs from the replayed one.
+	NewlyDenied  int64             `json:"newlyDenied"`
+	NewlyAllowed int64             `json:"newlyAllowed"`
+	Rules        []ReplayRuleStats `json:"rules"`
+}
+
+// ReplayRuleStats reports the denials attributed to one rule, or to a hook's
+// default when Rule is "default".
+type ReplayRuleStats struct {
+	Hook        string         `json:"hook"`
+	Rule        string         `json:"rule"`
+	Denied      int64          `json:"denied"`
+	NewlyDenied int64          `json:"newlyDenied"`
+	Top         []ReplayTarget `json:"top"`
+	Other       int64          `json:"other,omitempty"`
+}
+
+// ReplayTarget is a path or host and the number of denials it received.
+type ReplayTarget struct {
+	Target string `json:"target"`
+	Count  int64  `json:"count"`
+}
+
+// PolicyReplayer evaluates recorded events against a PolicySet in userspace,
+// mirroring check_path_policy, check_exec_policy and check_connect_policy for
+// kernel events and SimplePolicyChecker for proxied requests.
+type PolicyReplayer struct {
+	open    replayPathTable
+	exec    replayPathTable
+	connect replayConnectTable
+	proxy   *SimplePolicyChecker
+
+	openNames    []string
+	execNames    []string
+	connectNames []string
+}
+
+type replayPathRule struct {
+	index  int
+	action int32
+	op     int32
+	path   string
+
+	argCount int
+	args     [3]string
+}
+
+type replayPathTable struct {
+	attached     bool
+	defaultAllow bool
+	rules        []replayPathRule
+}
+
+type replayConnectRule struct {
+	index  int
+	action int32
+	ip     uint32
+	port   uint16
+	// hostname is set for rules the kernel expands by DNS. Replay matches it
+	// against the hostname recorded with the event instead of resolving.
+	hostname string
+}
+
+type replayConnectTable struct {
+	attached     bool
+	defaultAllow bool
+	rules        []replayConnectRule
+}
+
+// NewPolicyReplayer compiles policies into the rule tables the LSMs and proxy
+// would load.
+func NewPolicyReplayer(policies *PolicySet) *PolicyReplayer {
+	if policies == nil {
+		policies = &PolicySet{}
+	}
+	r := &PolicyReplayer{
+		openNames:    ruleNames(policies.Open),
+		execNames:    ruleNames(policies.Exec),
+		connectNames: ruleNames(policies.Connect),
+	}
+	r.open = compileOpenTable(policies)
+	r.exec = compileExecTable(policies)
+	r.connect = compileConnectTable(policies)
+	r.proxy = NewSimplePolicyChecker(ConvertToConnectRules(policies.Connect), policies.ConnectDefaultAllow, policies.MCP)
+	return r
+}
+
+func ruleNames(rules []PolicyRule) []string {
+	names := make([]string, len(rules))
+	for i := range rules {
+		names[i] = rules[i].String()
+	}
+	return names
+}
+
+// sortedRuleOrder returns rule indices in the order LoadPolicies leaves them.
+// sort.Slice is not stable, but it is deterministic: sorting indices with the
+// same comparisons yields the same permutation as sorting the rules.
+func sortedRuleOrder(n int, pathLen func(int) uint32) []int {
+	order := make([]int, n)
+	for i := range order {
+		order[i] = i
+	}
+	sort.Slice(order, func(i, j int) bool {
+		return pathLen(order[i]) > pathLen(order[j])
+	})
+	return order
+}
+
+func compileOpenTable(policies *PolicySet) replayPathTable {
+	table := replayPathTable{attached: policies.HasOpenPolicies()}
+	rules := ConvertToFileOpenRules(policies.Open)
+	order := sortedRuleOrder(len(rules), func(i int) uint32 { return rules[i].PathLen })
+	for pos, idx := range order {
+		rule := rules[idx]
+		path := string(bytes.TrimRight(rule.Path[:min(int(rule.PathLen), len(rule.Path))], "\x00"))
+		if path == "/" && rule.Action == PolicyAllow {
+			table.defaultAllow = true
+		}
+		if pos >= maxOpenRulesBPF || rule.PathLen == 0 || rule.PathLen > maxRulePathBPF {
+			continue
+		}
+		table.rules = append(table.rules, replayPathRule{
+			index:  idx,
+			action: int32(rule.Action),
+			op:     int32(rule.Operation),
+			path:   path,
+		})
+	}
+	return table
+}
+
+func compileExecTable(policies *PolicySet) replayPathTable {
+	table := replayPathTable{attached: policies.HasExecPolicies()}
+	rules := ConvertToExecRules(policies.Exec)
+	order := sortedRuleOrder(len(rules), func(i int) uint32 { return uint32(rules[i].PathLen) })
+	for pos, idx := range order {
+		rule := rules[idx]
+		if rule.PathLen < 0 || int(rule.PathLen) > len(rule.Path) {
+			continue
+		}
+		path := string(bytes.TrimRight(rule.Path[:rule.PathLen], "\x00"))
+		if path == "/" && rule.Action == PolicyAllow {
+			table.defaultAllow = true
+		}
+		if pos >= maxExecRulesBPF || rule.PathLen == 0 || rule.PathLen > maxRulePathBPF {
+			continue
+		}
+		compiled := replayPathRule{
+			index:    idx,
+			action:   rule.Action,
+			op:       OpExec,
+			path:     path,
+			argCount: int(rule.ArgCount),
+		}
+		for p := 0; p < compiled.argCount && p < len(compiled.args); p++ {
+			n := min(int(rule.ArgLens[p]), maxExecArgPrefix, len(rule.Args[p]))
+			compiled.args[p] = string(rule.Args[p][:max(n, 0)])
+		}
+		table.rules = append(table.rules, compiled)
+	}
+	return table
+}
+
+// compileConnectTable mirrors ConnectLsm.LoadPolicies. Hostname rules keep
+// their name rather than resolved addresses and sort after IP rules on the
+// same port, since their addresses are not known offline.
+func compileConnectTable(policies *PolicySet) replayConnectTable {
+	table := replayConnectTable{attached: policies.HasConnectPolicies()}
+	allowAny := false
+	for idx, rule := range ConvertToConnectRules(policies.Connect) {
+		compiled := replayConnectRule{index: idx, action: rule.Action, ip: rule.DestIP, port: rule.DestPort}
+		if rule.DestIP == 0 && rule.HostnameLen > 0 {
+			if rule.IsWildcard == 1 {
+				continue
+			}
+			hostname := string(bytes.TrimRight(rule.Hostname[:], "\x00"))
+			if hostname == "*" {
+				if rule.Action == PolicyAllow && !policies.ConnectDefaultExplicit {
+					allowAny = true
+				}
+				continue
+			}
+			compiled.hostname = hostname
+		}
+		table.rules = append(table.rules, compiled)
+	}
+	sort.SliceStable(table.rules, func(i, j int) bool {
+		a, b := table.rules[i], table.rules[j]
+		if a.port != b.port {
+			return a.port < b.port
+		}
+		if (a.hostname != "") != (b.hostname != "") {
+			return b.hostname != ""
+		}
+		return a.ip < b.ip
+	})
+
+	if policies.ConnectDefaultExplicit {
+		table.defaultAllow = policies.ConnectDefaultAllow
+	} else {
+		for _, rule := range table.rules {
+			if rule.action == PolicyAllow && rule.ip == 0 && rule.hostname == "" {
+				table.defaultAllow = true
+				break
+			}
+		}
+		table.defaultAllow = table.defaultAllow || allowAny
+	}
+	return table
+}
+
+// Evaluate returns the decision for ev. Events that no hook enforces are
+// returned with Evaluated false.
+func (r *PolicyReplayer) Evaluate(ev ReplayEvent) ReplayVerdict {
+	switch ev.Event {
+	case "file.open", "file.open:ro", "file.open:rw":
+		return r.evaluateOpen(ev)
+	case "proc.exec":
+		return r.evaluateExec(ev)
+	case "net.send":
+		return r.evaluateConnect(ev)
+	case "http.request":
+		return r.evaluateProxy(ev)
+	}
+	return ReplayVerdict{Rule: -1}
+}
+
+func (r *PolicyReplayer) evaluateOpen(ev ReplayEvent) ReplayVerdict {
+	verdict := ReplayVerdict{Hook: ReplayHookOpen, Rule: -1, Evaluated: true}
+	// lsm_open lets package managers through regardless of policy.
+	if ev.Exe == "apt-get" || strings.HasPrefix(ev.Exe, "dpkg") || strings.HasPrefix(ev.Exe, "update") || !r.open.attached {
+		verdict.Allowed = true
+		return verdict
+	}
+	op := int32(OpOpen)
+	switch ev.Event {
+	case "file.open:ro":
+		op = OpOpenRO
+	case "file.open:rw":
+		op = OpOpenRW
+	}
+	for i := range r.open.rules {
+		rule := &r.open.rules[i]
+		if !strings.HasPrefix(ev.Path, rule.path) {
+			continue
+		}
+		if rule.op == OpOpen || rule.op == op {
+			verdict.Allowed = rule.action == PolicyAllow
+			verdict.Rule = rule.index
+			return verdict
+		}
+	}
+	verdict.Allowed = r.open.defaultAllow
+	return verdict
+}
+
+func (r *PolicyReplayer) evaluateExec(ev ReplayEvent) ReplayVerdict {
+	verdict := ReplayVerdict{Hook: ReplayHookExec, Rule: -1, Evaluated: true}
+	if !r.exec.attached {
+		verdict.Allowed = true
+		return verdict
+	}
+	argc := ev.Argc
+	if argc == 0 && ev.Argv != "" {
+		argc = strings.Count(ev.Argv, " ") + 1
+	}
+	for i := range r.exec.rules {
+		rule := &r.exec.rules[i]
+		if !strings.HasPrefix(ev.Path, rule.path) {
+			continue
+		}
+		if rule.argCount == 0 {
+			verdict.Allowed = rule.action == PolicyAllow
+			verdict.Rule = rule.index
+			return verdict
+		}
+		// Argument rules only act as a deny list; otherwise evaluation moves
+		// on to the next rule.
+		if argc > 1 && rule.action == PolicyDeny && execArgsMatch(rule, ev.Argv, argc) {
+			verdict.Rule = rule.index
+			return verdict
+		}
+	}
+	verdict.Allowed = r.exec.defaultAllow
+	return verdict
+}
+
+// execArgsMatch compares rule arguments against argv[1..3] as the BPF program
+// sees them: truncated to 23 bytes and compared on at most 16.
+func execArgsMatch(rule *replayPathRule, argv string, argc int) bool {
+	var actual [3]string
+	n := 0
+	rest := argv
+	for a := 0; a < 4 && a < argc; a++ {
+		field := rest
+		if sp := strings.IndexByte(rest, ' '); sp >= 0 {
+			field, rest = rest[:sp], rest[sp+1:]
+		} else {
+			rest = ""
+		}
+		if a == 0 {
+			continue
+		}
+		actual[n] = field[:min(len(field), maxExecArgLen)]
+		n++
+	}
+	for p := 0; p < rule.argCount && p < len(rule.args); p++ {
+		for a := 0; a < n; a++ {
+			if strings.HasPrefix(actual[a], rule.args[p]) {
+				return true
+			}
+		}
+	}
+	return false
+}
+
+func (r *PolicyReplayer) evaluateConnect(ev ReplayEvent) ReplayVerdict {
+	verdict := ReplayVerdict{Hook: ReplayHookNet, Rule: -1, Evaluated: true}
+	if !r.connect.attached {
+		verdict.Allowed = true
+		return verdict
+	}
+	host, port := splitReplayAddr(ev.Addr, 0)
+	ip := ipv4ToUint32(host)
+	for i := range r.connect.rules {
+		rule := &r.connect.rules[i]
+		if rule.hostname != "" {
+			if ev.Hostname != rule.hostname {
+				continue
+			}
+		} else if rule.ip != 0 && rule.ip != ip {
+			continue
+		}
+		if rule.port != 0 && rule.port != port {
+			continue
+		}
+		verdict.Allowed = rule.action == PolicyAllow
+		verdict.Rule = rule.index
+		return verdict
+	}
+	verdict.Allowed = r.connect.defaultAllow
+	return verdict
+}
+
+func (r *PolicyReplayer) evaluateProxy(ev ReplayEvent) ReplayVerdict {
+	verdict := ReplayVerdict{Hook: ReplayHookProxy, Rule: -1, Evaluated: true}
+	defaultPort := uint16(80)
+	if ev.Protocol == "https" {
+		defaultPort = 443
+	}
+	host, port := splitReplayAddr(ev.Addr, defaultPort)
+	if idx := r.proxy.matchConnect(host, ipv4ToUint32(host), port); idx >= 0 {
+		verdict.Allowed = r.proxy.rules[idx].Action == PolicyAllow
+		verdict.Rule = idx
+		return verdict
+	}
+	verdict.Allowed = r.proxy.defaultPolicy
+	return verdict
+}
+
+// splitReplayAddr splits the addr field of net.send ("ip:port") and
+// http.request ("host" or "host:port") events.
+func splitReplayAddr(addr string, defaultPort uint16) (string, uint16) {
+	colon := strings.LastIndexByte(addr, ':')
+	if colon < 0 || strings.IndexByte(addr[:colon], ':') >= 0 {
+		return addr, defaultPort
+	}
+	port, err := strconv.ParseUint(addr[colon+1:], 10, 16)
+	if err != nil {
+		return addr, defaultPort
+	}
+	return addr[:colon], uint16(port)
+}
+
+func ipv4ToUint32(s string) uint32 {
+	if s == "" || (s[0] < '0' || s[0] > '9') {
+		return 0
+	}
+	ip := net.ParseIP(s).To4()
+	if ip == nil {
+		return 0
+	}
+	return uint32(ip[0])<<24 | uint32(ip[1])<<16 | uint32(ip[2])<<8 | uint32(ip[3])
+}
+
+// ReplayFiles replays each log in order, e.g. a log and its rotated segments.
+func (r *PolicyReplayer) ReplayFiles(ctx context.Context, paths []string, opts ReplayOptions) (*ReplayReport, error) {
+	run := r.newReplayRun(opts)
+	for _, path := range paths {
+		f, err := os.Open(path)
+		if err != nil {
+			return nil, fmt.Errorf("failed reading log: %w", err)
+		}
+		err = run.read(ctx, f)
+		f.Close()
+		if err != nil {
+			return nil, err
+		}
+	}
+	return run.report(), nil
+}
+
+// Replay evaluates every event line in the logfmt log read from in. The input
+// is read in large chunks cut on line boundaries and evaluated on a worker
+// pool; each worker keeps its own tallies, which are merged at the end.
+func (r *PolicyReplayer) Replay(ctx context.Context, in io.Reader, opts ReplayOptions) (*ReplayReport, error) {
+	run := r.newReplayRun(opts)
+	if err := run.read(ctx, in); err != nil {
+		return nil, err
+	}
+	return run.report(), nil
+}
+
+// ReplayEvents evaluates already parsed events, such as the websocket history.
+func (r *PolicyReplayer) ReplayEvents(events []ReplayEvent, opts ReplayOptions) *ReplayReport {
+	run := r.newReplayRun(opts)
+	tally := newReplayTally()
+	for i := range events {
+		tally.add(r, events[i])
+	}
+	run.tallies = append(run.tallies, tally)
+	return run.report()
+}
+
+type replayRun struct {
+	replayer *PolicyReplayer
+	opts     ReplayOptions
+
+	mu      sync.Mutex
+	tallies []*replayTally
+}
+
+func (r *PolicyReplayer) newReplayRun(opts ReplayOptions) *replayRun {
+	if opts.Workers <= 0 {
+		opts.Workers = runtime.GOMAXPROCS(0)
+	}
+	if opts.ChunkSize <= 0 {
+		opts.ChunkSize = defaultReplayChunkSize
+	}
+	if opts.TopN <= 0 {
+		opts.TopN = defaultReplayTopN
+	}
+	return &replayRun{replayer: r, opts: opts}
+}
+
+func (run *replayRun) read(ctx context.Context, in io.Reader) error {
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+
+	chunks := make(chan string, run.opts.Workers*2)
+	var wg sync.WaitGroup
+	for i := 0; i < run.opts.Workers; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			tally := newReplayTally()
+			var ev ReplayEvent
+			for chunk := range chunks {
+				for len(chunk) > 0 {
+					line := chunk
+					if idx := strings.IndexByte(chunk, '\n'); idx >= 0 {
+						line, chunk = chunk[:idx], chunk[idx+1:]
+					} else {
+						chunk = ""
+					}
+					if parseReplayLine(strings.TrimSuffix(line, "\r"), &ev) {
+						tally.add(run.replayer, ev)
+					} else if line != "" {
+						tally.skipped++
+					}
+				}
+			}
+			run.mu.Lock()
+			run.tallies = append(run.tallies, tally)
+			run.mu.Unlock()
+		}()
+	}
+
+	err := splitReplayChunks(ctx, in, run.opts.ChunkSize, chunks)
+	close(chunks)
+	wg.Wait()
+	return err
+}
+
+// splitReplayChunks sends in to chunks as strings ending at a newline. Each
+// chunk is converted once so lines and fields can be sliced without copying.
+func splitReplayChunks(ctx context.Context, in io.Reader, size int, chunks chan<- string) error {
+	buf := make([]byte, size)
+	carry := 0
+	for {
+		if err := ctx.Err(); err != nil {
+			return err
+		}
+		if carry == len(buf) {
+			grown := make([]byte, 2*len(buf))
+			copy(grown, buf)
+			buf = grown
+		}
+		n, err := io.ReadFull(in, buf[carry:])
+		n += carry
+		eof := errors.Is(err, io.EOF) || errors.Is(err, io.ErrUnexpectedEOF)
+		if err != nil && !eof {
+			return fmt.Errorf("failed reading log: %w", err)
+		}
+		cut := n
+		if !eof {
+			cut = bytes.LastIndexByte(buf[:n], '\n') + 1
+		}
+		if cut > 0 {
+			select {
+			case chunks <- string(buf[:cut]):
+			case <-ctx.Done():
+				return ctx.Err()
+			}
+		}
+		if eof {
+			return nil
+		}
+		carry = copy(buf, buf[cut:n])
+	}
+}
+
+// parseReplayLine fills ev from a logfmt line and reports whether it is an
+// event the replayer understands. Values alias line unless they contain
+// escapes.
+func parseReplayLine(line string, ev *ReplayEvent) bool {
+	// Enforcement events always carry a decision; skip the rest cheaply.
+	if !strings.Contains(line, "decision=") {
+		return false
+	}
+	*ev = ReplayEvent{}
+	for i := 0; i < len(line); {
+		for i < len(line) && line[i] == ' ' {
+			i++
+		}
+		eq := strings.IndexByte(line[i:], '=')
+		if eq < 0 {
+			break
+		}
+		key := line[i : i+eq]
+		i += eq + 1
+
+		var value string
+		if i < len(line) && line[i] == '"' {
+			value, i = scanQuoted(line, i+1)
+		} else {
+			end := strings.IndexByte(line[i:], ' ')
+			if end < 0 {
+				end = len(line) - i
+			}
+			value = line[i : i+end]
+			i += end
+		}
+
+		switch key {
+		case "event":
+			ev.Event = value
+		case "exe":
+			ev.Exe = value
+		case "path":
+			ev.Path = value
+		case "argv":
+			ev.Argv = value
+		case "argc":
+			ev.Argc, _ = strconv.Atoi(value)
+		case "addr":
+			ev.Addr = value
+		case "hostname":
+			ev.Hostname = value
+		case "protocol":
+			ev.Protocol = value
+		case "decision":
+			ev.Decision = value
+		}
+	}
+	switch ev.Event {
+	case "file.open", "file.open:ro", "file.open:rw", "proc.exec", "net.send", "http.request":
+		return true
+	}
+	return false
+}
+
+// scanQuoted returns the value starting at i (just past the opening quote)
+// and the index after the closing quote.
+func scanQuoted(line string, i int) (string, int) {
+	start := i
+	for i < len(line) {
+		switch line[i] {
+		case '"':
+			return line[start:i], i + 1
+		case '\\':
+			var sb strings.Builder
+			sb.WriteString(line[start:i])
+			for i < len(line) && line[i] != '"' {
+				if line[i] == '\\' && i+1 < len(line) {
+					i++
+				}
+				sb.WriteByte(line[i])
+				i++
+			}
+			return sb.String(), min(i+1, len(line))
+		}
+		i++
+	}
+	return line[start:], len(line)
+}
+
+type replayRuleKey struct {
+	hook string
+	rule int
+}
+
+type replayRuleTally struct {
+	denied      int64
+	newlyDenied int64
+	other       int64
+	targets     map[string]int64
+}
+
+type replayTally struct {
+	events, skipped, allowed, denied int64
+	newlyDenied, newlyAllowed        int64
+	rules                            map[replayRuleKey]*replayRuleTally
+}
+
+func newReplayTally() *replayTally {
+	return &replayTally{rules: make(map[replayRuleKey]*replayRuleTally)}
+}
+
+func (t *replayTally) add(r *PolicyReplayer, ev ReplayEvent) {
+	verdict := r.Evaluate(ev)
+	if !verdict.Evaluated {
+		t.skipped++
+		return
+	}
+	t.events++
+	recordedDenied := ev.Decision == "denied"
+	if verdict.Allowed {
+		t.allowed++
+		if recordedDenied {
+			t.newlyAllowed++
+		}
+		return
+	}
+	t.denied++
+	if !recordedDenied {
+		t.newlyDenied++
+	}
+
+	key := replayRuleKey{hook: verdict.Hook, rule: verdict.Rule}
+	rule := t.rules[key]
+	if rule == nil {
+		rule = &replayRuleTally{targets: make(map[string]int64)}
+		t.rules[key] = rule
+	}
+	rule.denied++
+	if !recordedDenied {
+		rule.newlyDenied++
+	}
+	target := ev.Path
+	if verdict.Hook == ReplayHookNet || verdict.Hook == ReplayHookProxy {
+		target = ev.Addr
+		if ev.Hostname != "" {
+			target = ev.Hostname
+		}
+	}
+	if _, ok := rule.targets[target]; ok {
+		rule.targets[target]++
+	} else if len(rule.targets) < maxReplayTargets {
+		// Targets are substrings of a whole chunk; keep only the value.
+		rule.targets[strings.Clone(target)] = 1
+	} else {
+		rule.other++
+	}
+}
+
+func (run *replayRun) report() *ReplayReport {
+	merged := newReplayTally()
+	for _, t := range run.tallies {
+		merged.events += t.events
+		merged.skipped += t.skipped
+		merged.allowed += t.allowed
+		merged.denied += t.denied
+		merged.newlyDenied += t.newlyDenied
+		merged.newlyAllowed += t.newlyAllowed
+		for key, rule := range t.rules {
+			into := merged.rules[key]
+			if into == nil {
+				merged.rules[key] = rule
+				continue
+			}
+			into.denied += rule.denied
+			into.newlyDenied += rule.newlyDenied
+			into.other += rule.other
+			for target, count := range rule.targets {
+				into.targets[target] += count
+			}
+		}
+	}
+
+	report := &ReplayReport{
+		Events:       merged.events,
+		Skipped:      merged.skipped,
+		Allowed:      merged.allowed,
+		Denied:       merged.denied,
+		NewlyDenied:  merged.newlyDenied,
+		NewlyAllowed: merged.newlyAllowed,
+		Rules:        make([]ReplayRuleStats, 0, len(merged.rules)),
+	}
+	for key, rule := range merged.rules {
+		stats := ReplayRuleStats{
+			Hook:        key.hook,
+			Rule:        run.replayer.ruleName(key),
+			Denied:      rule.denied,
+			NewlyDenied: rule.newlyDenied,
+			Other:       rule.other,
+		}
+		for target, count := range rule.targets {
+			stats.Top = append(stats.Top, ReplayTarget{Target: target, Count: count})
+		}
+		sort.Slice(stats.Top, func(i, j int) bool {
+			if stats.Top[i].Count != stats.Top[j].Count {
+				return stats.Top[i].Count > stats.Top[j].Count
+			}
+			return stats.Top[i].Target < stats.Top[j].Target
+		})
+		if len(stats.Top) > run.opts.TopN {
+			for _, t := range stats.Top[run.opts.TopN:] {
+				stats.Other += t.Count
+			}
+			stats.Top = stats.Top[:run.opts.TopN]
+		}
+		report.Rules = append(report.Rules, stats)
+	}
+	sort.Slice(report.Rules, func(i, j int) bool {
+		a, b := report.Rules[i], report.Rules[j]
+		if a.Denied != b.Denied {
+			return a.Denied > b.Denied
+		}
+		if a.Hook != b.Hook {
+			return a.Hook < b.Hook
+		}
+		return a.Rule < b.Rule
+	})
+	return report
+}
+
+func (r *PolicyReplayer) ruleName(key replayRuleKey) string {
+	var names []string
+	switch key.hook {
+	case ReplayHookOpen:
+		names = r.openNames
+	case ReplayHookExec:
+		names = r.execNames
+	case ReplayHookNet, ReplayHookProxy:
+		names = r.connectNames
+	}
+	if key.rule < 0 || key.rule >= len(names) {
+		return "default"
+	}
+	return names[key.rule]
+}
@@ -0,0 +1,208 @@
+package lsm
+
+import (
+	"bytes"
+	"context"
+	"fmt"
+	"sort"
+	"strings"
+	"testing"
+)
+
+func replayPolicySet(t testing.TB, lines ...string) *PolicySet {
+	t.Helper()
+	ps := &PolicySet{}
+	for _, line := range lines {
+		rule, err := ParseRuleString(line)
+		if err != nil {
+			t.Fatalf("ParseRuleString(%q): %v", line, err)
+		}
+		switch rule.Operation {
+		case OpExec:
+			ps.Exec = append(ps.Exec, *rule)
+		case OpConnect:
+			ps.Connect = append(ps.Connect, *rule)
+		default:
+			ps.Open = append(ps.Open, *rule)
+		}
+	}
+	return ps
+}
+
+func TestPolicyReplayerMatchesEnforcementSemantics(t *testing.T) {
+	t.Parallel()
+
+	ps := replayPolicySet(t,
+		"allow file.open /",
+		"deny file.open:rw /etc/",
+		"allow file.open /etc/passwd",
+		"allow proc.exec /",
+		"deny proc.exec /usr/bin/curl --upload-file",
+		"deny net.send evil.example.com",
+		"allow net.send 10.0.0.1:443",
+		"allow net.send *.example.com",
+	)
+	r := NewPolicyReplayer(ps)
+
+	cases := []struct {
+		name    string
+		ev      ReplayEvent
+		allowed bool
+		rule    string
+	}{
+		{"longest prefix wins", ReplayEvent{Event: "file.open:rw", Exe: "vim", Path: "/etc/passwd"}, true, "allow file.open /etc/passwd"},
+		{"operation must match", ReplayEvent{Event: "file.open:ro", Exe: "cat", Path: "/etc/hosts"}, true, "allow file.open /"},
+		{"write denied", ReplayEvent{Event: "file.open:rw", Exe: "vim", Path: "/etc/hosts"}, false, "deny file.open:rw /etc/"},
+		{"package managers bypass", ReplayEvent{Event: "file.open:rw", Exe: "dpkg-deb", Path: "/etc/hosts"}, true, "default"},
+		{"denied argument", ReplayEvent{Event: "proc.exec", Path: "/usr/bin/curl", Argv: "curl --upload-file x http://a", Argc: 4}, false, "deny proc.exec /usr/bin/curl --upload-file"},
+		{"argument rules fall through", ReplayEvent{Event: "proc.exec", Path: "/usr/bin/curl", Argv: "curl -s http://a", Argc: 3}, true, "allow proc.exec /"},
+		{"kernel hostname rule", ReplayEvent{Event: "net.send", Addr: "1.2.3.4:443", Hostname: "evil.example.com"}, false, "deny net.send evil.example.com"},
+		{"kernel ip rule", ReplayEvent{Event: "net.send", Addr: "10.0.0.1:443"}, true, "allow net.send 10.0.0.1:443"},
+		{"kernel ignores wildcards", ReplayEvent{Event: "net.send", Addr: "10.0.0.2:443", Hostname: "api.example.com"}, false, "default"},
+		{"proxy wildcard", ReplayEvent{Event: "http.request", Protocol: "https", Addr: "api.example.com"}, true, "allow net.send *.example.com"},
+		{"proxy default", ReplayEvent{Event: "http.request", Protocol: "https", Addr: "other.test:8443"}, false, "default"},
+	}
+	for _, tc := range cases {
+		verdict := r.Evaluate(tc.ev)
+		if !verdict.Evaluated || verdict.Allowed != tc.allowed {
+			t.Errorf("%s: got %+v, want allowed=%v", tc.name, verdict, tc.allowed)
+			continue
+		}
+		if got := r.ruleName(replayRuleKey{hook: verdict.Hook, rule: verdict.Rule}); got != tc.rule {
+			t.Errorf("%s: decided by %q, want %q", tc.name, got, tc.rule)
+		}
+	}
+}
+
+func TestPolicyReplayerRuleOrderMatchesLoadPolicies(t *testing.T) {
+	t.Parallel()
+
+	// Equal path lengths leave the order to sort.Slice; the replayer must
+	// settle ties exactly as OpenLsm.LoadPolicies does.
+	var lines []string
+	for i := 0; i < 40; i++ {
+		action := "allow"
+		if i%3 == 0 {
+			action = "deny"
+		}
+		lines = append(lines, fmt.Sprintf("%s file.open /srv/d%02d/", action, i%20))
+	}
+	ps := replayPolicySet(t, lines...)
+	r := NewPolicyReplayer(ps)
+
+	// Same call as OpenLsm.LoadPolicies.
+	loaded := ConvertToFileOpenRules(ps.Open)
+	sort.Slice(loaded, func(i, j int) bool {
+		return loaded[i].PathLen > loaded[j].PathLen
+	})
+	if len(loaded) != len(r.open.rules) {
+		t.Fatalf("got %d rules, want %d", len(r.open.rules), len(loaded))
+	}
+	for i, rule := range loaded {
+		if got := r.open.rules[i]; got.action != int32(rule.Action) || got.path != string(rule.Path[:rule.PathLen]) {
+			t.Fatalf("rule %d: got %+v, want %+v", i, got, rule)
+		}
+	}
+}
+
+func replayLog(lines int) []byte {
+	var buf bytes.Buffer
+	for i := 0; i < lines; i++ {
+		switch i % 5 {
+		case 0:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=file.open:rw pid=%d cgroup=1 exe=\"vim\" path=\"/etc/conf%d\" decision=allowed\n", i, i%7)
+		case 1:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=file.open:ro pid=%d cgroup=1 exe=\"cat\" path=\"/usr/share/doc%d\" decision=allowed\n", i, i%11)
+		case 2:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=proc.exec pid=%d cgroup=1 exe=\"bash\" path=\"/usr/bin/curl\" argc=3 argv=\"curl --upload-file f%d\" decision=allowed\n", i, i%3)
+		case 3:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:02:40Z event=http.request protocol=https addr=\"host%d.example.com\" path=\"/\" decision=denied status=403\n", i%13)
+		default:
+			fmt.Fprintf(&buf, "time=2025-10-07T18:20:36Z event=heartbeat uptime=%d\n", i)
+		}
+	}
+	return buf.Bytes()
+}
+
+func TestPolicyReplayerReplay(t *testing.T) {
+	t.Parallel()
+
+	ps := replayPolicySet(t,
+		"allow file.open /",
+		"deny file.open:rw /etc/",
+		"allow proc.exec /",
+		"deny proc.exec /usr/bin/curl --upload-file",
+		"allow net.send host1.example.com",
+	)
+	r := NewPolicyReplayer(ps)
+	data := replayLog(1000)
+
+	report, err := r.Replay(context.Background(), bytes.NewReader(data), ReplayOptions{Workers: 3, ChunkSize: 512, TopN: 3})
+	if err != nil {
+		t.Fatalf("Replay: %v", err)
+	}
+	if report.Events != 800 || report.Skipped != 200 {
+		t.Fatalf("unexpected event counts: %+v", report)
+	}
+	// Writes under /etc and curl uploads flip to denied; every request but
+	// host1 stays denied.
+	if report.NewlyDenied != 400 || report.NewlyAllowed != 15 || report.Denied != 585 {
+		t.Fatalf("unexpected decision counts: %+v", report)
+	}
+
+	byRule := make(map[string]ReplayRuleStats)
+	for _, stats := range report.Rules {
+		byRule[stats.Hook+" "+stats.Rule] = stats
+	}
+	etc := byRule["file.open deny file.open:rw /etc/"]
+	if etc.Denied != 200 || len(etc.Top) != 3 || etc.Top[0].Count < etc.Top[2].Count || etc.Other != 200-sumTargets(etc.Top) {
+		t.Fatalf("unexpected /etc stats: %+v", etc)
+	}
+	if proxy := byRule["http.request default"]; proxy.Denied != 185 || proxy.NewlyDenied != 0 {
+		t.Fatalf("unexpected proxy default stats: %+v", proxy)
+	}
+
+	events := make([]ReplayEvent, 0, 1000)
+	for _, line := range strings.Split(strings.TrimSpace(string(data)), "\n") {
+		var ev ReplayEvent
+		if parseReplayLine(line, &ev) {
+			events = append(events, ev)
+		}
+	}
+	sequential := r.ReplayEvents(events, ReplayOptions{TopN: 3})
+	if sequential.Denied != report.Denied || sequential.NewlyDenied != report.NewlyDenied || len(sequential.Rules) != len(report.Rules) {
+		t.Fatalf("ReplayEvents differs from Replay:\n%+v\n%+v", sequential, report)
+	}
+}
+
+func sumTargets(targets []ReplayTarget) int64 {
+	var n int64
+	for _, t := range targets {
+		n += t.Count
+	}
+	return n
+}
+
+func BenchmarkPolicyReplay(b *testing.B) {
+	var lines []string
+	for i := 0; i < 100; i++ {
+		lines = append(lines, fmt.Sprintf("allow file.open /usr/share/doc%d/", i))
+	}
+	lines = append(lines,
+		"allow file.open /",
+		"deny file.open:rw /etc/",
+		"allow proc.exec /",
+		"deny proc.exec /usr/bin/curl --upload-file",
+		"allow net.send *.example.com",
+	)
+	r := NewPolicyReplayer(replayPolicySet(b, lines...))
+	data := replayLog(1_000_000)
+
+	b.SetBytes(int64(len(data)))
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := r.Replay(context.Background(), bytes.NewReader(data), ReplayOptions{}); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
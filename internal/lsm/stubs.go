@@ -22,3 +22,15 @@ func loadLsmExec() (*ebpf.CollectionSpec, error) {
 func loadLsmConnect() (*ebpf.CollectionSpec, error) {
 	return nil, fmt.Errorf("bpf2go generated loader not available on non-linux")
 }
+
+func loadLsmOpenTenants() (*ebpf.CollectionSpec, error) {
+	return nil, fmt.Errorf("bpf2go generated loader not available on non-linux")
+}
+
+func loadLsmExecTenants() (*ebpf.CollectionSpec, error) {
+	return nil, fmt.Errorf("bpf2go generated loader not available on non-linux")
+}
+
+func loadLsmConnectTenants() (*ebpf.CollectionSpec, error) {
+	return nil, fmt.Errorf("bpf2go generated loader not available on non-linux")
+}
@@ -0,0 +1,215 @@
+package lsm
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"sync"
+
+	"github.com/cilium/ebpf"
+)
+
+// MaxTenants bounds how many cgroup subtrees one set of programs enforces
+// with their own policy. It matches MAX_TENANTS in the BPF programs.
+const MaxTenants = 64
+
+// Tenant is a cgroup subtree enforced under its own policy. Its ID is the
+// cgroup ID of the subtree root, which the programs map every descendant
+// cgroup to before looking up rules.
+type Tenant struct {
+	ID         uint64
+	CgroupPath string
+}
+
+// ResolveTenant returns the tenant rooted at cgroupPath.
+func ResolveTenant(cgroupPath string) (Tenant, error) {
+	id, err := getCgroupID(cgroupPath)
+	if err != nil {
+		return Tenant{}, err
+	}
+	return Tenant{ID: id, CgroupPath: cgroupPath}, nil
+}
+
+// cgroupTenants mirrors the allowed cgroups maps, so events, which carry the
+// raw cgroup ID, are attributed to a tenant without a map lookup.
+var cgroupTenants sync.Map // cgroup ID -> tenant ID
+
+// TenantOf returns the tenant a monitored cgroup belongs to.
+func TenantOf(cgroupID uint64) (uint64, bool) {
+	tenant, ok := cgroupTenants.Load(cgroupID)
+	if !ok {
+		return 0, false
+	}
+	return tenant.(uint64), true
+}
+
+// tenantMaps names the maps a program keeps per tenant. Tenants are only
+// enforced by the programs built with LEASH_MULTI_TENANT; a single-target
+// daemon keeps its rules in plain arrays.
+type tenantMaps struct {
+	allowedCgroups string // cgroup ID -> tenant ID
+	rules          string // tenant ID -> inner rule array (hash of maps)
+}
+
+type tenantPolicy[R any] struct {
+	tenant       Tenant
+	rules        []R
+	defaultAllow bool
+}
+
+// tenantTable holds the compiled policy of every tenant a program enforces
+// and mirrors it into the program's maps. Policies set before the
+// collection is loaded are written when it is bound.
+type tenantTable[R any] struct {
+	maps tenantMaps
+
+	mu       sync.Mutex
+	coll     *ebpf.Collection
+	inner    *ebpf.MapSpec
+	policies map[uint64]tenantPolicy[R]
+}
+
+// bind attaches the table to a loaded collection and writes the policies
+// recorded so far.
+func (t *tenantTable[R]) bind(coll *ebpf.Collection, spec *ebpf.CollectionSpec) error {
+	outer, ok := spec.Maps[t.maps.rules]
+	if !ok || outer.InnerMap == nil {
+		return fmt.Errorf("map %s has no inner map spec", t.maps.rules)
+	}
+
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	t.coll = coll
+	t.inner = outer.InnerMap.Copy()
+	var errs []error
+	for _, p := range t.policies {
+		errs = append(errs, t.write(p))
+	}
+	return errors.Join(errs...)
+}
+
+// set records the policy for tenant, writing it straight away once bound.
+func (t *tenantTable[R]) set(tenant Tenant, rules []R, defaultAllow bool) error {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	if _, ok := t.policies[tenant.ID]; !ok && len(t.policies) >= MaxTenants {
+		return fmt.Errorf("tenant limit of %d reached", MaxTenants)
+	}
+	p := tenantPolicy[R]{tenant: tenant, rules: rules, defaultAllow: defaultAllow}
+	if t.policies == nil {
+		t.policies = make(map[uint64]tenantPolicy[R])
+	}
+	t.policies[tenant.ID] = p
+	if t.coll == nil {
+		return nil
+	}
+	return t.write(p)
+}
+
+// remove stops enforcing the tenant and forgets its policy.
+func (t *tenantTable[R]) remove(id uint64) error {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	delete(t.policies, id)
+	if t.coll == nil {
+		return nil
+	}
+
+	// Unmap the cgroups first so no hook resolves to a tenant without rules.
+	if err := removeTenantCgroups(t.coll.Maps[t.maps.allowedCgroups], id); err != nil {
+		return err
+	}
+	if err := t.coll.Maps[t.maps.rules].Delete(id); err != nil && !errors.Is(err, ebpf.ErrKeyNotExist) {
+		return fmt.Errorf("failed to delete tenant %d from %s: %w", id, t.maps.rules, err)
+	}
+	return nil
+}
+
+// write fills a fresh inner rule array and swaps it in for the tenant. The
+// rule count and default result live in the array's last slot, so the one
+// outer map update replaces all three and hooks never see a half-written
+// rule set. The cgroup subtree is mapped last, which also picks up cgroups
+// created since the previous write.
+func (t *tenantTable[R]) write(p tenantPolicy[R]) error {
+	headerSlot := t.inner.MaxEntries - 1
+	if len(p.rules) > int(headerSlot) {
+		return fmt.Errorf("tenant %d has %d rules, the limit is %d", p.tenant.ID, len(p.rules), headerSlot)
+	}
+
+	inner, err := ebpf.NewMap(t.inner)
+	if err != nil {
+		return fmt.Errorf("failed to create rule map for tenant %d: %w", p.tenant.ID, err)
+	}
+	// The outer map holds its own reference once the array is inserted.
+	defer inner.Close()
+	for i := range p.rules {
+		if err := inner.Put(uint32(i), &p.rules[i]); err != nil {
+			return fmt.Errorf("failed to update %s for tenant %d rule %d: %w", t.maps.rules, p.tenant.ID, i, err)
+		}
+	}
+	header := policyHeader(t.inner.ValueSize, len(p.rules), p.defaultAllow)
+	if err := inner.Put(headerSlot, header); err != nil {
+		return fmt.Errorf("failed to update %s header for tenant %d: %w", t.maps.rules, p.tenant.ID, err)
+	}
+
+	id := p.tenant.ID
+	if err := t.coll.Maps[t.maps.rules].Put(&id, inner); err != nil {
+		return fmt.Errorf("failed to update %s map: %w", t.maps.rules, err)
+	}
+
+	allowed := t.coll.Maps[t.maps.allowedCgroups]
+	if err := addDescendantCgroups(allowed, p.tenant.CgroupPath, &id); err != nil {
+		return fmt.Errorf("failed to add descendant cgroups: %w", err)
+	}
+	return mirrorTenantCgroups(allowed, id)
+}
+
+// policyHeader encodes the struct policy_header the programs read from the
+// last slot of a tenant's rule array, padded to the array's value size.
+func policyHeader(valueSize uint32, numRules int, defaultAllow bool) []byte {
+	header := make([]byte, valueSize)
+	binary.NativeEndian.PutUint32(header[0:], uint32(numRules))
+	if defaultAllow {
+		binary.NativeEndian.PutUint32(header[4:], 1)
+	}
+	return header
+}
+
+// mirrorTenantCgroups records every cgroup mapped to tenant in cgroupTenants.
+func mirrorTenantCgroups(cgroupMap *ebpf.Map, tenant uint64) error {
+	var cgroupID, owner uint64
+	iter := cgroupMap.Iterate()
+	for iter.Next(&cgroupID, &owner) {
+		if owner == tenant {
+			cgroupTenants.Store(cgroupID, tenant)
+		}
+	}
+	if err := iter.Err(); err != nil {
+		return fmt.Errorf("failed to list tenant %d cgroups: %w", tenant, err)
+	}
+	return nil
+}
+
+// removeTenantCgroups deletes every cgroup mapped to tenant.
+func removeTenantCgroups(cgroupMap *ebpf.Map, tenant uint64) error {
+	var (
+		cgroupID, owner uint64
+		stale           []uint64
+	)
+	iter := cgroupMap.Iterate()
+	for iter.Next(&cgroupID, &owner) {
+		if owner == tenant {
+			stale = append(stale, cgroupID)
+		}
+	}
+	if err := iter.Err(); err != nil {
+		return fmt.Errorf("failed to list tenant %d cgroups: %w", tenant, err)
+	}
+	for _, id := range stale {
+		if err := cgroupMap.Delete(id); err != nil && !errors.Is(err, ebpf.ErrKeyNotExist) {
+			return fmt.Errorf("failed to remove cgroup ID %d: %w", id, err)
+		}
+		cgroupTenants.Delete(id)
+	}
+	return nil
+}
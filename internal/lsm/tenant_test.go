@@ -0,0 +1,79 @@
+package lsm
+
+import (
+	"encoding/binary"
+	"strings"
+	"testing"
+	"unsafe"
+)
+
+func TestCompileOpenPoliciesOrdersRulesAndDerivesDefault(t *testing.T) {
+	t.Parallel()
+
+	ps := replayPolicySet(t,
+		"deny file.open /etc/",
+		"allow file.open /",
+		"allow file.open /etc/passwd",
+	)
+	rules, defaultAllow := compileOpenPolicies(ConvertToFileOpenRules(ps.Open))
+	if !defaultAllow {
+		t.Fatal("expected allowed root path to make the default allow")
+	}
+	if got := string(rules[0].Path[:rules[0].PathLen]); got != "/etc/passwd" {
+		t.Fatalf("expected the longest path first, got %q", got)
+	}
+
+	ps = replayPolicySet(t, "allow file.open /tmp/")
+	if _, defaultAllow := compileOpenPolicies(ConvertToFileOpenRules(ps.Open)); defaultAllow {
+		t.Fatal("expected deny default without an allowed root path")
+	}
+}
+
+func TestCompileConnectPoliciesDefault(t *testing.T) {
+	t.Parallel()
+
+	ps := replayPolicySet(t, "allow net.send 10.0.0.1:443")
+	compiled := compileConnectPolicies(ConvertToConnectRules(ps.Connect), nil)
+	if len(compiled.rules) != 1 || compiled.defaultAllow {
+		t.Fatalf("unexpected compilation: %+v", compiled)
+	}
+
+	allow := true
+	if compiled := compileConnectPolicies(ConvertToConnectRules(ps.Connect), &allow); !compiled.defaultAllow {
+		t.Fatal("expected the explicit default to win")
+	}
+
+	ps = replayPolicySet(t, "allow net.send *")
+	if compiled := compileConnectPolicies(ConvertToConnectRules(ps.Connect), nil); !compiled.defaultAllow || len(compiled.rules) != 0 {
+		t.Fatalf("expected wildcard allow to become the default: %+v", compiled)
+	}
+}
+
+func TestAddTenantRequiresManagerWithoutCgroup(t *testing.T) {
+	t.Parallel()
+
+	m := NewLSMManager("/sys/fs/cgroup/leash-target", nil)
+	_, err := m.AddTenant(t.TempDir(), &PolicySet{})
+	if err == nil || !strings.Contains(err.Error(), "without a target cgroup") {
+		t.Fatalf("expected AddTenant to be refused, got %v", err)
+	}
+	if len(m.Tenants()) != 0 {
+		t.Fatal("expected no tenants to be registered")
+	}
+}
+
+func TestPolicyHeaderLayout(t *testing.T) {
+	t.Parallel()
+
+	valueSize := uint32(unsafe.Sizeof(ConnectPolicyRuleBPF{}))
+	header := policyHeader(valueSize, 3, true)
+	if len(header) != int(valueSize) {
+		t.Fatalf("expected the header padded to %d bytes, got %d", valueSize, len(header))
+	}
+	if n, allow := binary.NativeEndian.Uint32(header), binary.NativeEndian.Uint32(header[4:]); n != 3 || allow != 1 {
+		t.Fatalf("unexpected header fields: num_rules=%d default=%d", n, allow)
+	}
+	if allow := binary.NativeEndian.Uint32(policyHeader(valueSize, 0, false)[4:]); allow != 0 {
+		t.Fatalf("expected a deny default, got %d", allow)
+	}
+}
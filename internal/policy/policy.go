@@ -6,11 +6,13 @@ import (
 	"os"
 	"strings"
 	"sync"
+	"sync/atomic"
 	"time"
 
 	"github.com/strongdm/leash/internal/cedar"
 	"github.com/strongdm/leash/internal/lsm"
 	"github.com/strongdm/leash/internal/proxy"
+	"github.com/strongdm/leash/internal/telemetry/metrics"
 )
 
 // Config is the parsed policy content split for different subsystems.
@@ -171,6 +173,18 @@ type Manager struct {
 	// Subsystem references for live updates
 	lsmManager   *lsm.LSMManager
 	proxyUpdater func(*lsm.PolicySet, []proxy.HeaderRewriteRule) // Callback to update proxy
+
+	// reloadObserver, when set, is told how long each push took.
+	reloadObserver func(elapsed time.Duration, err error)
+
+	// writeMutex serializes layer mutations together with the push that
+	// follows them. Batch holds it until its merged result is pushed, so other
+	// callers' mutations wait rather than being deferred or rolled back.
+	writeMutex sync.Mutex
+
+	// version increments on every layer mutation so callers can cache views
+	// of the policy state and cheaply detect when they go stale.
+	version atomic.Uint64
 }
 
 // NewManager creates a new policy manager
@@ -190,6 +204,15 @@ type PolicySetCompat = lsm.PolicySet
 
 // AddRule adds a rule at runtime
 func (m *Manager) AddRule(ruleStr string) error {
+	return m.mutate(func() error { return m.addRule(ruleStr) })
+}
+
+// RemoveRule removes a rule at runtime
+func (m *Manager) RemoveRule(ruleStr string) error {
+	return m.mutate(func() error { return m.removeRule(ruleStr) })
+}
+
+func (m *Manager) addRule(ruleStr string) error {
 	m.runtimeMutex.Lock()
 	defer m.runtimeMutex.Unlock()
 
@@ -217,12 +240,11 @@ func (m *Manager) AddRule(ruleStr string) error {
 			m.runtimeRules.Connect = append(m.runtimeRules.Connect, *rule)
 		}
 	}
-
-	return m.applyChanges()
+	m.version.Add(1)
+	return nil
 }
 
-// RemoveRule removes a rule at runtime
-func (m *Manager) RemoveRule(ruleStr string) error {
+func (m *Manager) removeRule(ruleStr string) error {
 	m.runtimeMutex.Lock()
 	defer m.runtimeMutex.Unlock()
 
@@ -235,8 +257,8 @@ func (m *Manager) RemoveRule(ruleStr string) error {
 		m.runtimeRules.Exec = m.removeLSMRuleFromSlice(m.runtimeRules.Exec, ruleStr)
 		m.runtimeRules.Connect = m.removeLSMRuleFromSlice(m.runtimeRules.Connect, ruleStr)
 	}
-
-	return m.applyChanges()
+	m.version.Add(1)
+	return nil
 }
 
 // GetActiveRules returns the merged file and runtime rules
@@ -289,12 +311,18 @@ func (m *Manager) GetActiveRules() (*lsm.PolicySet, []proxy.HeaderRewriteRule) {
 
 // UpdateFileRules updates the file-based rules
 func (m *Manager) UpdateFileRules(newFileRules *lsm.PolicySet, newHTTPRules []proxy.HeaderRewriteRule) error {
+	return m.mutate(func() error {
+		m.setFileRules(newFileRules, newHTTPRules)
+		return nil
+	})
+}
+
+func (m *Manager) setFileRules(newFileRules *lsm.PolicySet, newHTTPRules []proxy.HeaderRewriteRule) {
 	m.runtimeMutex.Lock()
 	m.fileRules = newFileRules
 	m.fileHTTPRules = newHTTPRules
+	m.version.Add(1)
 	m.runtimeMutex.Unlock()
-
-	return m.applyChanges()
 }
 
 // Helper functions
@@ -366,7 +394,133 @@ func dedupeMCPRules(rules []lsm.MCPPolicyRule) []lsm.MCPPolicyRule {
 	return result
 }
 
-func (m *Manager) applyChanges() error {
+// mutate applies fn to the layers and pushes the merged result, holding
+// writeMutex throughout so concurrent callers reach enforcement in order.
+func (m *Manager) mutate(fn func() error) error {
+	m.writeMutex.Lock()
+	defer m.writeMutex.Unlock()
+	if err := fn(); err != nil {
+		return err
+	}
+	return m.pushActiveRules()
+}
+
+// BatchTx mutates the rule layers inside Batch. Its changes only touch
+// in-memory state until Batch pushes them.
+type BatchTx struct {
+	m *Manager
+}
+
+// AddRule adds a runtime rule as part of the batch.
+func (tx *BatchTx) AddRule(ruleStr string) error { return tx.m.addRule(ruleStr) }
+
+// RemoveRule removes a runtime rule as part of the batch.
+func (tx *BatchTx) RemoveRule(ruleStr string) error { return tx.m.removeRule(ruleStr) }
+
+// UpdateFileRules replaces the file layer as part of the batch.
+func (tx *BatchTx) UpdateFileRules(newFileRules *lsm.PolicySet, newHTTPRules []proxy.HeaderRewriteRule) error {
+	tx.m.setFileRules(newFileRules, newHTTPRules)
+	return nil
+}
+
+// SetRuntimeRules replaces the runtime layer as part of the batch.
+func (tx *BatchTx) SetRuntimeRules(newLSM *lsm.PolicySet, newHTTP []proxy.HeaderRewriteRule) error {
+	tx.m.setRuntimeRules(newLSM, newHTTP)
+	return nil
+}
+
+// SetRuntimeOnly toggles runtime-only mode as part of the batch.
+func (tx *BatchTx) SetRuntimeOnly(enabled bool) error {
+	tx.m.setRuntimeOnly(enabled)
+	return nil
+}
+
+// Batch runs fn as one transaction over the rule layers. Mutations made
+// through tx only change in-memory state; the merged result is pushed to the
+// LSM and proxy once when fn returns. If fn returns an error, the layers are
+// restored to their pre-batch state and the error is returned. Other callers'
+// mutations wait for the batch to finish, so a rollback never discards them.
+// fn must not call the Manager's own mutators, which would deadlock.
+func (m *Manager) Batch(fn func(tx *BatchTx) error) error {
+	m.writeMutex.Lock()
+	defer m.writeMutex.Unlock()
+
+	m.runtimeMutex.RLock()
+	saved := managerLayers{
+		fileRules:        clonePolicySet(m.fileRules),
+		fileHTTPRules:    append([]proxy.HeaderRewriteRule(nil), m.fileHTTPRules...),
+		runtimeRules:     clonePolicySet(m.runtimeRules),
+		runtimeHTTPRules: append([]proxy.HeaderRewriteRule(nil), m.runtimeHTTPRules...),
+		runtimeOnly:      m.runtimeOnly,
+	}
+	startVersion := m.version.Load()
+	m.runtimeMutex.RUnlock()
+
+	if err := fn(&BatchTx{m: m}); err != nil {
+		m.runtimeMutex.Lock()
+		m.fileRules = saved.fileRules
+		m.fileHTTPRules = saved.fileHTTPRules
+		m.runtimeRules = saved.runtimeRules
+		m.runtimeHTTPRules = saved.runtimeHTTPRules
+		m.runtimeOnly = saved.runtimeOnly
+		m.version.Add(1)
+		m.runtimeMutex.Unlock()
+		return err
+	}
+	if m.version.Load() == startVersion {
+		return nil
+	}
+	return m.pushActiveRules()
+}
+
+// managerLayers is a copy of every layer taken so Batch can roll back.
+type managerLayers struct {
+	fileRules        *lsm.PolicySet
+	fileHTTPRules    []proxy.HeaderRewriteRule
+	runtimeRules     *lsm.PolicySet
+	runtimeHTTPRules []proxy.HeaderRewriteRule
+	runtimeOnly      bool
+}
+
+func clonePolicySet(ps *lsm.PolicySet) *lsm.PolicySet {
+	return &lsm.PolicySet{
+		Open:                   append([]lsm.PolicyRule(nil), ps.Open...),
+		Exec:                   append([]lsm.PolicyRule(nil), ps.Exec...),
+		Connect:                append([]lsm.PolicyRule(nil), ps.Connect...),
+		MCP:                    append([]lsm.MCPPolicyRule(nil), ps.MCP...),
+		ConnectDefaultAllow:    ps.ConnectDefaultAllow,
+		ConnectDefaultExplicit: ps.ConnectDefaultExplicit,
+	}
+}
+
+var (
+	reloadsOK      = metrics.Default.Counter("leash_policy_reloads_total", "Merged policy pushes to the LSM programs and proxy.", "result", "ok")
+	reloadsError   = metrics.Default.Counter("leash_policy_reloads_total", "Merged policy pushes to the LSM programs and proxy.", "result", "error")
+	reloadDuration = metrics.Default.Histogram("leash_policy_reload_seconds", "Time to push the merged policy to the LSM programs and proxy.", metrics.DefBuckets)
+)
+
+// SetReloadObserver registers fn to be called after every push of the merged
+// rules. It must be called before the manager is shared.
+func (m *Manager) SetReloadObserver(fn func(elapsed time.Duration, err error)) {
+	m.reloadObserver = fn
+}
+
+// pushActiveRules sends the merged active rules to the LSM and proxy.
+func (m *Manager) pushActiveRules() (err error) {
+	start := time.Now()
+	defer func() {
+		elapsed := time.Since(start)
+		reloadDuration.ObserveDuration(elapsed)
+		if m.reloadObserver != nil {
+			m.reloadObserver(elapsed, err)
+		}
+		if err != nil {
+			reloadsError.Inc()
+		} else {
+			reloadsOK.Inc()
+		}
+	}()
+
 	activeRules, activeHTTPRules := m.GetActiveRules()
 
 	// Attempt LSM update; record error but do not short-circuit proxy updates so
@@ -389,6 +543,13 @@ func (m *Manager) applyChanges() error {
 
 // SetRuntimeRules replaces the current runtime rule layers atomically.
 func (m *Manager) SetRuntimeRules(newLSM *lsm.PolicySet, newHTTP []proxy.HeaderRewriteRule) error {
+	return m.mutate(func() error {
+		m.setRuntimeRules(newLSM, newHTTP)
+		return nil
+	})
+}
+
+func (m *Manager) setRuntimeRules(newLSM *lsm.PolicySet, newHTTP []proxy.HeaderRewriteRule) {
 	m.runtimeMutex.Lock()
 	// Defensive copies
 	rr := &lsm.PolicySet{
@@ -402,18 +563,31 @@ func (m *Manager) SetRuntimeRules(newLSM *lsm.PolicySet, newHTTP []proxy.HeaderR
 	rh := append([]proxy.HeaderRewriteRule(nil), newHTTP...)
 	m.runtimeRules = rr
 	m.runtimeHTTPRules = rh
+	m.version.Add(1)
 	m.runtimeMutex.Unlock()
-	return m.applyChanges()
 }
 
 // SetRuntimeOnly toggles whether the Manager should ignore the file layer when
 // computing active rules. When enabled, only runtime rules are applied to the
 // LSM/proxy; file rules continue to be tracked and exposed via Snapshot() for UI.
 func (m *Manager) SetRuntimeOnly(enabled bool) error {
+	return m.mutate(func() error {
+		m.setRuntimeOnly(enabled)
+		return nil
+	})
+}
+
+func (m *Manager) setRuntimeOnly(enabled bool) {
 	m.runtimeMutex.Lock()
 	m.runtimeOnly = enabled
+	m.version.Add(1)
 	m.runtimeMutex.Unlock()
-	return m.applyChanges()
+}
+
+// Version returns a counter that increases whenever any rule layer or the
+// runtime-only toggle changes.
+func (m *Manager) Version() uint64 {
+	return m.version.Load()
 }
 
 // Snapshot returns copies of file and runtime rule layers for safe inspection.
@@ -1,10 +1,13 @@
 package policy
 
 import (
+	"errors"
 	"os"
 	"path/filepath"
 	"strings"
+	"sync"
 	"testing"
+	"time"
 
 	cedarutil "github.com/strongdm/leash/internal/cedar"
 	"github.com/strongdm/leash/internal/lsm"
@@ -124,3 +127,106 @@ func TestManagerDedupeConnectRules(t *testing.T) {
 		t.Fatalf("unexpected host %q", host)
 	}
 }
+
+func TestManagerBatchAppliesOnce(t *testing.T) {
+	t.Parallel()
+
+	pushes := 0
+	mgr := NewManager(nil, func(*lsm.PolicySet, []proxy.HeaderRewriteRule) { pushes++ })
+
+	allowAny := lsm.PolicyRule{Action: lsm.PolicyAllow, Operation: lsm.OpConnect}
+	copy(allowAny.Hostname[:], "*")
+	allowAny.HostnameLen = 1
+
+	err := mgr.Batch(func(tx *BatchTx) error {
+		if err := tx.UpdateFileRules(&lsm.PolicySet{Connect: []lsm.PolicyRule{allowAny}}, nil); err != nil {
+			return err
+		}
+		if err := tx.SetRuntimeRules(&lsm.PolicySet{}, nil); err != nil {
+			return err
+		}
+		return tx.SetRuntimeOnly(false)
+	})
+	if err != nil {
+		t.Fatalf("Batch: %v", err)
+	}
+	if pushes != 1 {
+		t.Fatalf("expected one push for batch, got %d", pushes)
+	}
+	active, _ := mgr.GetActiveRules()
+	if len(active.Connect) != 1 {
+		t.Fatalf("expected batched file rule to be active, got %d connect rules", len(active.Connect))
+	}
+}
+
+func TestManagerBatchRollsBackOnError(t *testing.T) {
+	t.Parallel()
+
+	pushes := 0
+	mgr := NewManager(nil, func(*lsm.PolicySet, []proxy.HeaderRewriteRule) { pushes++ })
+
+	if err := mgr.AddRule("allow net.send example.com"); err != nil {
+		t.Fatalf("AddRule: %v", err)
+	}
+	pushes = 0
+
+	err := mgr.Batch(func(tx *BatchTx) error {
+		if err := tx.AddRule("deny net.send blocked.example.com"); err != nil {
+			return err
+		}
+		if err := tx.SetRuntimeOnly(true); err != nil {
+			return err
+		}
+		return errors.New("boom")
+	})
+	if err == nil || err.Error() != "boom" {
+		t.Fatalf("expected batch error to propagate, got %v", err)
+	}
+	if pushes != 0 {
+		t.Fatalf("expected no push for rolled back batch, got %d", pushes)
+	}
+	_, _, runtimeLSM, _ := mgr.Snapshot()
+	if len(runtimeLSM.Connect) != 1 {
+		t.Fatalf("expected runtime layer to be restored, got %d connect rules", len(runtimeLSM.Connect))
+	}
+}
+
+func TestManagerBatchRollbackKeepsConcurrentMutations(t *testing.T) {
+	t.Parallel()
+
+	var pushMu sync.Mutex
+	pushes := 0
+	mgr := NewManager(nil, func(*lsm.PolicySet, []proxy.HeaderRewriteRule) {
+		pushMu.Lock()
+		pushes++
+		pushMu.Unlock()
+	})
+
+	done := make(chan error, 1)
+	err := mgr.Batch(func(tx *BatchTx) error {
+		if err := tx.AddRule("deny net.send blocked.example.com"); err != nil {
+			return err
+		}
+		// Another caller mutates while the batch is open. It must wait for
+		// the batch rather than be deferred into it or wiped by its rollback.
+		go func() { done <- mgr.AddRule("allow net.send example.com") }()
+		time.Sleep(20 * time.Millisecond)
+		return errors.New("boom")
+	})
+	if err == nil || err.Error() != "boom" {
+		t.Fatalf("expected batch error to propagate, got %v", err)
+	}
+	if err := <-done; err != nil {
+		t.Fatalf("concurrent AddRule: %v", err)
+	}
+
+	_, _, runtimeLSM, _ := mgr.Snapshot()
+	if len(runtimeLSM.Connect) != 1 || runtimeLSM.Connect[0].Action != lsm.PolicyAllow {
+		t.Fatalf("expected only the concurrent rule to survive, got %+v", runtimeLSM.Connect)
+	}
+	pushMu.Lock()
+	defer pushMu.Unlock()
+	if pushes != 1 {
+		t.Fatalf("expected the concurrent mutation to push once, got %d", pushes)
+	}
+}
@@ -0,0 +1,82 @@
+package suggest
+
+import (
+	"net"
+	"strings"
+	"sync"
+
+	"github.com/strongdm/leash/internal/policy/suggest/pattern"
+	"github.com/strongdm/leash/internal/policy/suggest/prefix"
+)
+
+// activity indexes the file paths and hosts named by observed events, so
+// directory and domain proposals can report how much real traffic falls
+// under them. A nil *activity reports nothing.
+type activity struct {
+	// mu, when set, guards paths and hosts for queries; the owner holds it
+	// while calling observe.
+	mu    *sync.Mutex
+	paths *prefix.Trie
+	hosts *prefix.Trie
+}
+
+func newActivity(mu *sync.Mutex) *activity {
+	return &activity{
+		mu:    mu,
+		paths: prefix.NewPathTrie(),
+		hosts: prefix.NewDomainTrie(),
+	}
+}
+
+// activityFromSequences indexes every event in seqs, or returns nil when
+// there are none.
+func activityFromSequences(seqs []pattern.Sequence) *activity {
+	if len(seqs) == 0 {
+		return nil
+	}
+	a := newActivity(nil)
+	for _, seq := range seqs {
+		for _, evt := range seq.Events {
+			a.observe(evt, 1)
+		}
+	}
+	return a
+}
+
+// observe counts evt, or withdraws it when delta is negative.
+func (a *activity) observe(evt pattern.Event, delta int) {
+	switch evt.ResourceClass {
+	case "unix.file":
+		a.paths.Add(evt.ResourceFacet, delta)
+	case "http.host":
+		host := evt.ResourceFacet
+		if h, _, err := net.SplitHostPort(host); err == nil {
+			host = h
+		}
+		if host != "" && net.ParseIP(host) == nil && strings.Contains(host, ".") {
+			a.hosts.Add(host, delta)
+		}
+	}
+}
+
+func (a *activity) pathStats(dir string) prefix.Stats {
+	if a == nil {
+		return prefix.Stats{}
+	}
+	if a.mu != nil {
+		a.mu.Lock()
+		defer a.mu.Unlock()
+	}
+	return a.paths.Stats(dir)
+}
+
+func (a *activity) hostStats(domain string) prefix.Stats {
+	if a == nil {
+		return prefix.Stats{}
+	}
+	if a.mu != nil {
+		a.mu.Lock()
+		defer a.mu.Unlock()
+	}
+	return a.hosts.Stats(domain)
+}
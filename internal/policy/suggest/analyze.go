@@ -2,10 +2,10 @@ package suggest
 
 import (
 	"bytes"
+	"context"
 	"fmt"
 	"math"
 	"net"
-	"path/filepath"
 	"sort"
 	"strconv"
 	"strings"
@@ -15,6 +15,7 @@ import (
 	"github.com/strongdm/leash/internal/policy/suggest/drift"
 	"github.com/strongdm/leash/internal/policy/suggest/encoding"
 	"github.com/strongdm/leash/internal/policy/suggest/pattern"
+	"github.com/strongdm/leash/internal/policy/suggest/prefix"
 	"github.com/strongdm/leash/internal/policy/suggest/scoring"
 	"github.com/strongdm/leash/internal/proxy"
 )
@@ -31,281 +32,237 @@ type Inputs struct {
 // result. Callers can provide nil inputs; the engine will simply skip the
 // corresponding passes.
 func Analyze(inputs Inputs, opts Options) Result {
-	defaults := DefaultOptions()
-	if opts.MinDirectoryGroup <= 0 {
-		opts.MinDirectoryGroup = defaults.MinDirectoryGroup
-	}
-	if opts.MinDomainGroup <= 0 {
-		opts.MinDomainGroup = defaults.MinDomainGroup
-	}
-	if opts.MinHTTPGroup <= 0 {
-		opts.MinHTTPGroup = defaults.MinHTTPGroup
-	}
-	if opts.MinSequenceSupport <= 0 {
-		opts.MinSequenceSupport = defaults.MinSequenceSupport
-	}
-	if opts.MaxSequenceLength <= 0 {
-		opts.MaxSequenceLength = defaults.MaxSequenceLength
-	}
-	if opts.ClusterSimilarity <= 0 {
-		opts.ClusterSimilarity = defaults.ClusterSimilarity
-	}
-	if opts.SessionWindow <= 0 {
-		opts.SessionWindow = defaults.SessionWindow
-	}
-	if opts.DriftThreshold <= 0 {
-		opts.DriftThreshold = defaults.DriftThreshold
-	}
-	if opts.TailLimit == 0 {
-		opts.TailLimit = defaults.TailLimit
-	}
-	if opts.MaxClusters <= 0 {
-		opts.MaxClusters = defaults.MaxClusters
-	}
-	if opts.MinClusterSize <= 0 {
-		opts.MinClusterSize = defaults.MinClusterSize
-	}
-
-	suggestions := make([]Suggestion, 0)
-
-	if inputs.LSMPolicies != nil {
-		suggestions = append(suggestions, directorySuggestions(inputs.LSMPolicies, opts)...)
-		suggestions = append(suggestions, domainSuggestions(inputs.LSMPolicies, opts)...)
-	}
+	return AnalyzeContext(context.Background(), inputs, opts)
+}
 
-	if len(inputs.HTTPRewrites) > 0 {
-		suggestions = append(suggestions, httpSuggestions(inputs.HTTPRewrites, opts)...)
-	}
+// AnalyzeContext is Analyze bounded by ctx. Passes run concurrently and
+// workflow clusters are mined on up to opts.Workers goroutines. If ctx ends
+// first, the suggestions finished by then are returned with Partial set.
+func AnalyzeContext(ctx context.Context, inputs Inputs, opts Options) Result {
+	opts = opts.withDefaults()
 
+	var workflows workflowPass
 	if len(inputs.EventSequences) > 0 {
-		suggestions = append(suggestions, workflowSuggestions(inputs.EventSequences, opts)...)
-	}
-
-	sort.SliceStable(suggestions, func(i, j int) bool {
-		if suggestions[i].Kind == suggestions[j].Kind {
-			return suggestions[i].PolicyCount > suggestions[j].PolicyCount
+		workflows = func(ctx context.Context) ([]Suggestion, bool) {
+			return workflowSuggestions(ctx, inputs.EventSequences, opts)
 		}
-		return suggestions[i].Kind < suggestions[j].Kind
-	})
-
-	return Result{Suggestions: suggestions}
-}
-
-// directorySuggestions groups file policies by directory and effect.
-func directorySuggestions(ps *lsm.PolicySet, opts Options) []Suggestion {
-	type key struct {
-		dir    string
-		effect string
 	}
-	buckets := make(map[key]*dirBucket)
+	return runPasses(ctx, inputs, activityFromSequences(inputs.EventSequences), workflows, opts)
+}
 
-	addRule := func(rule lsm.PolicyRule, opName string) {
+// directorySuggestions proposes Dir:: containers for file policies. Rule
+// paths are indexed per effect in a path trie, and each proposal is the
+// tightest directory holding at least MinDirectoryGroup rules over two or
+// more paths. Observed file activity under the directory is reported
+// alongside, so a reviewer can see what else the container would admit. The
+// bool is false when ctx ended first.
+func directorySuggestions(ctx context.Context, ps *lsm.PolicySet, observed *activity, opts Options) ([]Suggestion, bool) {
+	groups := make(map[string]*ruleGroup)
+	for i, rule := range ps.Open {
+		if i%ctxCheckInterval == 0 && ctx.Err() != nil {
+			return nil, false
+		}
 		path := strings.TrimSpace(rulePath(&rule))
 		if path == "" {
-			return
+			continue
 		}
 		// Skip explicit directory rules; they already use Dir::.
 		if rule.IsDirectory == 1 {
-			return
-		}
-		dir := filepath.Clean(filepath.Dir(path))
-		if dir == "." || dir == "" {
-			dir = "/"
+			continue
 		}
 		effect := effectString(rule.Action)
-		bucket := buckets[key{dir: dir, effect: effect}]
-		if bucket == nil {
-			bucket = newDirBucket(dir, effect)
-			buckets[key{dir: dir, effect: effect}] = bucket
+		g := groups[effect]
+		if g == nil {
+			g = newRuleGroup(prefix.NewPathTrie())
+			groups[effect] = g
 		}
-		bucket.addRule(rule, opName)
-	}
-
-	for _, rule := range ps.Open {
-		addRule(rule, operationName(rule.Operation))
+		opName := operationName(rule.Operation)
+		g.add(path, PolicyReference{
+			Effect:    effect,
+			Operation: opName,
+			Target:    path,
+			Source:    "lsm",
+		})
 	}
 	// Exec policies have exact paths; we do not currently suggest grouping them
 	// by directory because exec control is typically more precise.
 
 	suggestions := make([]Suggestion, 0)
-	for _, bucket := range buckets {
-		if bucket.count < opts.MinDirectoryGroup {
-			continue
-		}
-		if len(bucket.targets) <= 1 {
-			continue
+	for _, effect := range sortedKeys(groups) {
+		g := groups[effect]
+		for _, cover := range g.trie.Covers(2, opts.MinDirectoryGroup, 1) {
+			if ctx.Err() != nil {
+				return suggestions, false
+			}
+			refs := g.claim(cover)
+			ops := make(map[string]struct{})
+			for _, ref := range refs {
+				ops[ref.Operation] = struct{}{}
+			}
+			opNames := sortedKeys(ops)
+			seen := observed.pathStats(cover.Prefix)
+			suggestions = append(suggestions, Suggestion{
+				Kind:          SuggestDirectory,
+				Summary:       effectTitle(effect) + " " + strings.Join(opNames, ", ") + " in directory " + cover.Prefix,
+				ProposedCedar: buildDirectoryCedar(effect, cover.Prefix, opNames),
+				PolicyCount:   cover.Weight,
+				Confidence:    confidenceFromCounts(len(cover.Keys), cover.Weight),
+				PolicyRefs:    refs,
+				Metadata: map[string]string{
+					"directory":       cover.Prefix,
+					"rule_paths":      strconv.Itoa(cover.All.Keys),
+					"observed_paths":  strconv.Itoa(seen.Keys),
+					"observed_events": strconv.Itoa(seen.Weight),
+				},
+			})
 		}
-		suggestions = append(suggestions, bucket.toSuggestion())
 	}
-	return suggestions
+	return suggestions, true
 }
 
-type dirBucket struct {
-	dir        string
-	effect     string
-	count      int
-	operations map[string]struct{}
-	targets    map[string]struct{}
-	refs       []PolicyReference
+// ctxCheckInterval is how many rules the rule-based passes index between
+// checks of their context.
+const ctxCheckInterval = 256
+
+// ruleGroup indexes rule targets that could share a container, keeping each
+// target's references so a cover can list the rules it replaces.
+type ruleGroup struct {
+	trie *prefix.Trie
+	refs map[string][]PolicyReference
 }
 
-func newDirBucket(dir, effect string) *dirBucket {
-	return &dirBucket{
-		dir:        dir,
-		effect:     effect,
-		operations: make(map[string]struct{}),
-		targets:    make(map[string]struct{}),
-		refs:       make([]PolicyReference, 0),
-	}
+func newRuleGroup(trie *prefix.Trie) *ruleGroup {
+	return &ruleGroup{trie: trie, refs: make(map[string][]PolicyReference)}
 }
 
-func (b *dirBucket) addRule(rule lsm.PolicyRule, opName string) {
-	b.count++
-	b.operations[opName] = struct{}{}
-	target := strings.TrimSpace(rulePath(&rule))
-	b.targets[target] = struct{}{}
-	b.refs = append(b.refs, PolicyReference{
-		Effect:    b.effect,
-		Operation: opName,
-		Target:    target,
-		Source:    "lsm",
-	})
+func (g *ruleGroup) add(target string, ref PolicyReference) {
+	g.trie.Add(target, 1)
+	key := g.trie.Canonical(target)
+	g.refs[key] = append(g.refs[key], ref)
 }
 
-func (b *dirBucket) toSuggestion() Suggestion {
-	ops := make([]string, 0, len(b.operations))
-	for opName := range b.operations {
-		ops = append(ops, opName)
-	}
-	sort.Strings(ops)
-
-	proposed := buildDirectoryCedar(b.effect, b.dir, ops)
-	summary := b.effectTitle() + " " + strings.Join(ops, ", ") + " in directory " + b.dir
-	return Suggestion{
-		Kind:          SuggestDirectory,
-		Summary:       summary,
-		ProposedCedar: proposed,
-		PolicyCount:   b.count,
-		Confidence:    confidenceFromCounts(len(b.targets), b.count),
-		PolicyRefs:    b.refs,
-		Metadata: map[string]string{
-			"directory": b.dir,
-		},
+func (g *ruleGroup) claim(cover prefix.Cover) []PolicyReference {
+	refs := make([]PolicyReference, 0, cover.Weight)
+	for _, key := range cover.Keys {
+		refs = append(refs, g.refs[key]...)
 	}
+	return refs
 }
 
-func (b *dirBucket) effectTitle() string {
-	if b.effect == "permit" {
+func effectTitle(effect string) string {
+	if effect == "permit" {
 		return "Allow"
 	}
 	return "Deny"
 }
 
-// domainSuggestions groups connect rules by shared base domain.
-func domainSuggestions(ps *lsm.PolicySet, opts Options) []Suggestion {
+func sortedKeys[V any](m map[string]V) []string {
+	keys := make([]string, 0, len(m))
+	for k := range m {
+		keys = append(keys, k)
+	}
+	sort.Strings(keys)
+	return keys
+}
+
+// domainSuggestions proposes wildcard hosts for connect rules. Host names are
+// indexed per effect and port in a reversed-domain trie, and each proposal is
+// the tightest domain, at least two labels deep, holding MinDomainGroup rules
+// over two or more hosts. IP rules are left alone. The bool is false when ctx
+// ended first.
+func domainSuggestions(ctx context.Context, ps *lsm.PolicySet, observed *activity, opts Options) ([]Suggestion, bool) {
 	type key struct {
-		base   string
 		effect string
 		port   uint16
 	}
-	buckets := make(map[key]*domainBucket)
+	groups := make(map[key]*ruleGroup)
 
-	for _, rule := range ps.Connect {
-		host := strings.TrimSpace(connectHostname(&rule))
-		if host == "" {
+	for i, rule := range ps.Connect {
+		if i%ctxCheckInterval == 0 && ctx.Err() != nil {
+			return nil, false
+		}
+		if rule.HostnameLen == 0 {
 			continue
 		}
-		base, ok := baseDomain(host)
-		if !ok {
+		host := strings.TrimSpace(connectHostname(&rule))
+		if host == "" || net.ParseIP(host) != nil {
 			continue
 		}
 		effect := effectString(rule.Action)
-		k := key{base: base, effect: effect, port: rule.DestPort}
-		bucket := buckets[k]
-		if bucket == nil {
-			bucket = newDomainBucket(base, effect, rule.DestPort)
-			buckets[k] = bucket
+		k := key{effect: effect, port: rule.DestPort}
+		g := groups[k]
+		if g == nil {
+			g = newRuleGroup(prefix.NewDomainTrie())
+			groups[k] = g
 		}
-		bucket.addRule(rule)
-	}
-
-	suggestions := make([]Suggestion, 0)
-	for _, bucket := range buckets {
-		if bucket.count < opts.MinDomainGroup {
-			continue
+		md := map[string]string{}
+		if rule.DestPort > 0 {
+			md["port"] = fmt.Sprintf("%d", rule.DestPort)
 		}
-		suggestions = append(suggestions, bucket.toSuggestion())
-	}
-	return suggestions
-}
-
-type domainBucket struct {
-	base   string
-	effect string
-	port   uint16
-	count  int
-	hosts  map[string]struct{}
-	refs   []PolicyReference
-}
-
-func newDomainBucket(base, effect string, port uint16) *domainBucket {
-	return &domainBucket{
-		base:   base,
-		effect: effect,
-		port:   port,
-		hosts:  make(map[string]struct{}),
-		refs:   make([]PolicyReference, 0),
+		g.add(host, PolicyReference{
+			Effect:    effect,
+			Operation: operationName(rule.Operation),
+			Target:    host,
+			Source:    "lsm",
+			Metadata:  md,
+		})
 	}
-}
 
-func (b *domainBucket) addRule(rule lsm.PolicyRule) {
-	b.count++
-	host := strings.TrimSpace(connectHostname(&rule))
-	b.hosts[host] = struct{}{}
-	md := map[string]string{}
-	if rule.DestPort > 0 {
-		md["port"] = fmt.Sprintf("%d", rule.DestPort)
+	keys := make([]key, 0, len(groups))
+	for k := range groups {
+		keys = append(keys, k)
 	}
-	if rule.HostnameLen == 0 && rule.DestIP != 0 {
-		md["ip"] = ipString(rule.DestIP)
-	}
-	b.refs = append(b.refs, PolicyReference{
-		Effect:    effectString(rule.Action),
-		Operation: operationName(rule.Operation),
-		Target:    host,
-		Source:    "lsm",
-		Metadata:  md,
+	sort.Slice(keys, func(i, j int) bool {
+		if keys[i].effect != keys[j].effect {
+			return keys[i].effect < keys[j].effect
+		}
+		return keys[i].port < keys[j].port
 	})
-}
 
-func (b *domainBucket) toSuggestion() Suggestion {
-	wildcard := "*." + b.base
-	resource := fmt.Sprintf("Host::\"%s\"", wildcard)
-	proposed := fmt.Sprintf("%s (principal, action == Action::\"NetworkConnect\", resource == %s);", b.effect, resource)
-	summary := fmt.Sprintf("%s network connect to *.%s", strings.Title(b.effect), b.base)
-	md := map[string]string{"base_domain": b.base}
-	if b.port > 0 {
-		md["port"] = fmt.Sprintf("%d", b.port)
-	}
-	return Suggestion{
-		Kind:          SuggestDomain,
-		Summary:       summary,
-		ProposedCedar: proposed,
-		PolicyCount:   b.count,
-		Confidence:    confidenceFromCounts(len(b.hosts), b.count),
-		PolicyRefs:    b.refs,
-		Metadata:      md,
+	suggestions := make([]Suggestion, 0)
+	for _, k := range keys {
+		g := groups[k]
+		for _, cover := range g.trie.Covers(2, opts.MinDomainGroup, 2) {
+			if ctx.Err() != nil {
+				return suggestions, false
+			}
+			seen := observed.hostStats(cover.Prefix)
+			md := map[string]string{
+				"base_domain":       cover.Prefix,
+				"rule_hosts":        strconv.Itoa(cover.All.Keys),
+				"observed_hosts":    strconv.Itoa(seen.Keys),
+				"observed_requests": strconv.Itoa(seen.Weight),
+			}
+			if k.port > 0 {
+				md["port"] = fmt.Sprintf("%d", k.port)
+			}
+			resource := fmt.Sprintf("Host::\"*.%s\"", cover.Prefix)
+			suggestions = append(suggestions, Suggestion{
+				Kind:          SuggestDomain,
+				Summary:       fmt.Sprintf("%s network connect to *.%s", strings.Title(k.effect), cover.Prefix),
+				ProposedCedar: fmt.Sprintf("%s (principal, action == Action::\"NetworkConnect\", resource == %s);", k.effect, resource),
+				PolicyCount:   cover.Weight,
+				Confidence:    confidenceFromCounts(len(cover.Keys), cover.Weight),
+				PolicyRefs:    g.claim(cover),
+				Metadata:      md,
+			})
+		}
 	}
+	return suggestions, true
 }
 
-// httpSuggestions groups header rewrite rules by host base domain.
-func httpSuggestions(rules []proxy.HeaderRewriteRule, opts Options) []Suggestion {
+// httpSuggestions groups header rewrite rules by host base domain. The bool
+// is false when ctx ended first.
+func httpSuggestions(ctx context.Context, rules []proxy.HeaderRewriteRule, opts Options) ([]Suggestion, bool) {
 	type key struct {
 		base string
 	}
 	buckets := make(map[key]*httpBucket)
 
-	for _, rule := range rules {
+	for i, rule := range rules {
+		if i%ctxCheckInterval == 0 && ctx.Err() != nil {
+			return nil, false
+		}
 		base, ok := baseDomain(rule.Host)
 		if !ok {
 			continue
@@ -321,12 +278,15 @@ func httpSuggestions(rules []proxy.HeaderRewriteRule, opts Options) []Suggestion
 
 	suggestions := make([]Suggestion, 0)
 	for _, bucket := range buckets {
+		if ctx.Err() != nil {
+			return suggestions, false
+		}
 		if bucket.count < opts.MinHTTPGroup {
 			continue
 		}
 		suggestions = append(suggestions, bucket.toSuggestion())
 	}
-	return suggestions
+	return suggestions, true
 }
 
 type httpBucket struct {
@@ -420,7 +380,9 @@ func (b *httpBucket) toSuggestion() Suggestion {
 	}
 }
 
-func workflowSuggestions(seqs []pattern.Sequence, opts Options) []Suggestion {
+// workflowSuggestions clusters the sequences and ranks the clusters. The bool
+// is false when ctx ended before every needed cluster was mined.
+func workflowSuggestions(ctx context.Context, seqs []pattern.Sequence, opts Options) ([]Suggestion, bool) {
 	filtered := make([]pattern.Sequence, 0, len(seqs))
 	seqIndex := make(map[string]pattern.Sequence, len(seqs))
 	for _, seq := range seqs {
@@ -434,20 +396,105 @@ func workflowSuggestions(seqs []pattern.Sequence, opts Options) []Suggestion {
 		seqIndex[seq.SessionID] = seq
 	}
 	if len(filtered) == 0 {
-		return nil
+		return nil, true
 	}
 
 	clusters := encoding.AffinityCluster(filtered, encoding.BagOfNGrams, opts.ClusterSimilarity)
 	if len(clusters) == 0 {
-		return nil
+		return nil, true
+	}
+
+	candidates := make([]workflowCluster, 0, len(clusters))
+	for _, cl := range clusters {
+		clusterSeqs := make([]pattern.Sequence, 0, len(cl.Members))
+		for _, id := range cl.Members {
+			if seq, ok := seqIndex[id]; ok {
+				clusterSeqs = append(clusterSeqs, seq)
+			}
+		}
+		candidates = append(candidates, workflowCluster{id: cl.ID, size: len(cl.Members), seqs: clusterSeqs})
 	}
+	return rankWorkflows(ctx, candidates, len(principalSet(filtered)), eventDistribution(filtered), opts)
+}
+
+// workflowCluster is a cluster of sequences awaiting ranking. profile is
+// computed from seqs on demand when nil, so callers holding a cached profile
+// need not supply the sequences.
+type workflowCluster struct {
+	id      string
+	size    int
+	seqs    []pattern.Sequence
+	profile *clusterProfile
+}
 
+// clusterProfile holds the parts of a workflow suggestion that depend only on
+// the cluster's own sequences. Mining dominates its cost.
+type clusterProfile struct {
+	patterns   []pattern.Pattern
+	principals int
+	series     []scoring.TimeSeriesPoint
+	dist       map[string]float64
+	refs       []PolicyReference
+}
+
+func profileCluster(seqs []pattern.Sequence, opts Options) *clusterProfile {
+	cfg := pattern.DefaultConfig()
+	cfg.MinSupport = opts.MinSequenceSupport
+	cfg.MaxLength = opts.MaxSequenceLength
+	cfg.TargetActions = deriveTargetActions(seqs)
+	profile := &clusterProfile{patterns: pattern.Mine(seqs, cfg)}
+	if len(profile.patterns) == 0 {
+		return profile
+	}
+	profile.principals = len(principalSet(seqs))
+	profile.series = buildTimeSeries(seqs, opts.SessionWindow)
+	profile.dist = eventDistribution(seqs)
+	profile.refs = samplePolicyRefs(seqs, 4)
+	return profile
+}
+
+// rankWorkflows turns the largest clusters into workflow suggestions.
+// Clusters are profiled in order, a wave of opts.Workers at a time, until
+// MaxClusters of them have patterns, so the result is the same as profiling
+// them one by one. When ctx ends mid-wave, the clusters profiled so far are
+// ranked and the bool is false.
+func rankWorkflows(ctx context.Context, clusters []workflowCluster, allPrincipals int, overallDist map[string]float64, opts Options) ([]Suggestion, bool) {
 	sort.SliceStable(clusters, func(i, j int) bool {
-		return len(clusters[i].Members) > len(clusters[j].Members)
+		return clusters[i].size > clusters[j].size
 	})
 
-	allPrincipals := principalSet(filtered)
-	overallDist := eventDistribution(filtered)
+	eligible := make([]int, 0, len(clusters))
+	for i := range clusters {
+		if clusters[i].size >= opts.MinClusterSize {
+			eligible = append(eligible, i)
+		}
+	}
+	complete := true
+	found := 0
+	for start := 0; start < len(eligible); start += opts.Workers {
+		if opts.MaxClusters > 0 && found >= opts.MaxClusters {
+			break
+		}
+		if ctx.Err() != nil {
+			complete = false
+			break
+		}
+		end := start + opts.Workers
+		if end > len(eligible) {
+			end = len(eligible)
+		}
+		wave := eligible[start:end]
+		if !profileWave(ctx, clusters, wave, opts) {
+			complete = false
+			break
+		}
+		for _, i := range wave {
+			if len(clusters[i].profile.patterns) > 0 {
+				found++
+			}
+		}
+	}
+
 	scorer := scoring.IntensityScorer{
 		HalfLife:           opts.SessionWindow,
 		Floor:              0.1,
@@ -455,39 +502,24 @@ func workflowSuggestions(seqs []pattern.Sequence, opts Options) []Suggestion {
 		ObservationHorizon: opts.SessionWindow * 12,
 	}
 
-	suggestions := make([]Suggestion, 0, len(clusters))
-	for _, cl := range clusters {
-		clusterSeqs := make([]pattern.Sequence, 0, len(cl.Members))
-		for _, id := range cl.Members {
-			if seq, ok := seqIndex[id]; ok {
-				clusterSeqs = append(clusterSeqs, seq)
-			}
-		}
-		if len(clusterSeqs) < opts.MinClusterSize {
-			continue
-		}
-
-		cfg := pattern.DefaultConfig()
-		cfg.MinSupport = opts.MinSequenceSupport
-		cfg.MaxLength = opts.MaxSequenceLength
-		cfg.TargetActions = deriveTargetActions(clusterSeqs)
-		patterns := pattern.Mine(clusterSeqs, cfg)
-		if len(patterns) == 0 {
+	suggestions := make([]Suggestion, 0, len(eligible))
+	for _, i := range eligible {
+		cl := &clusters[i]
+		profile := cl.profile
+		if profile == nil || len(profile.patterns) == 0 {
 			continue
 		}
 
-		clusterPrincipals := principalSet(clusterSeqs)
-		coverageScore, recencyScore := scorer.Score(buildTimeSeries(clusterSeqs, opts.SessionWindow), len(clusterPrincipals), len(allPrincipals))
+		coverageScore, recencyScore := scorer.Score(profile.series, profile.principals, allPrincipals)
 		confidence := math.Min(1.0, math.Max(0.1, (coverageScore+recencyScore)/2))
 
-		topPattern := patterns[0]
-		clusterDist := eventDistribution(clusterSeqs)
-		driftResult := drift.Detect(overallDist, clusterDist, opts.DriftThreshold)
+		topPattern := profile.patterns[0]
+		driftResult := drift.Detect(overallDist, profile.dist, opts.DriftThreshold)
 
 		metadata := map[string]string{
-			"cluster_id":      cl.ID,
-			"session_count":   strconv.Itoa(len(cl.Members)),
-			"principal_count": strconv.Itoa(len(clusterPrincipals)),
+			"cluster_id":      cl.id,
+			"session_count":   strconv.Itoa(cl.size),
+			"principal_count": strconv.Itoa(profile.principals),
 			"coverage_score":  fmt.Sprintf("%.3f", coverageScore),
 			"recency_score":   fmt.Sprintf("%.3f", recencyScore),
 			"confidence":      fmt.Sprintf("%.3f", confidence),
@@ -500,14 +532,12 @@ func workflowSuggestions(seqs []pattern.Sequence, opts Options) []Suggestion {
 			metadata["support_sessions"] = strings.Join(topPattern.Sessions, ",")
 		}
 
-		refs := samplePolicyRefs(clusterSeqs, 4)
-
 		suggestions = append(suggestions, Suggestion{
 			Kind:        SuggestWorkflow,
-			Summary:     fmt.Sprintf("Workflow %s (%d sessions)", cl.ID, len(cl.Members)),
-			PolicyCount: len(cl.Members),
+			Summary:     fmt.Sprintf("Workflow %s (%d sessions)", cl.id, cl.size),
+			PolicyCount: cl.size,
 			Confidence:  confidence,
-			PolicyRefs:  refs,
+			PolicyRefs:  profile.refs,
 			Metadata:    metadata,
 		})
 
@@ -520,7 +550,38 @@ func workflowSuggestions(seqs []pattern.Sequence, opts Options) []Suggestion {
 		return suggestions[i].PolicyCount > suggestions[j].PolicyCount
 	})
 
-	return suggestions
+	return suggestions, complete
+}
+
+// profileWave profiles the listed clusters that have no profile yet, one
+// goroutine each. It returns false if ctx ends first; profiles that finished
+// by then are kept and the rest are abandoned.
+func profileWave(ctx context.Context, clusters []workflowCluster, wave []int, opts Options) bool {
+	type done struct {
+		index   int
+		profile *clusterProfile
+	}
+	pending := 0
+	results := make(chan done, len(wave))
+	for _, i := range wave {
+		if clusters[i].profile != nil {
+			continue
+		}
+		pending++
+		seqs := clusters[i].seqs
+		go func(i int) {
+			results <- done{index: i, profile: profileCluster(seqs, opts)}
+		}(i)
+	}
+	for ; pending > 0; pending-- {
+		select {
+		case r := <-results:
+			clusters[r.index].profile = r.profile
+		case <-ctx.Done():
+			return false
+		}
+	}
+	return true
 }
 
 func principalSet(seqs []pattern.Sequence) map[string]struct{} {
@@ -586,23 +647,28 @@ func eventDistribution(seqs []pattern.Sequence) map[string]float64 {
 }
 
 func canonicalEventToken(evt pattern.Event) string {
-	family := evt.ActionFamily
+	facet := evt.ResourceFacet
+	if facet == "" {
+		facet = "*"
+	}
+	if evt.Kind > 0 {
+		return kindByID(evt.Kind).token + strings.ToLower(facet)
+	}
+	return canonicalTokenPrefix(evt.ActionFamily, evt.ActionName, evt.ResourceClass) + strings.ToLower(facet)
+}
+
+// canonicalTokenPrefix is the part of an event token before the facet.
+func canonicalTokenPrefix(family, action, resource string) string {
 	if family == "" {
 		family = "unknown"
 	}
-	action := evt.ActionName
 	if action == "" {
 		action = "event"
 	}
-	resource := evt.ResourceClass
 	if resource == "" {
 		resource = "resource"
 	}
-	facet := evt.ResourceFacet
-	if facet == "" {
-		facet = "*"
-	}
-	return strings.ToLower(strings.Join([]string{family, action, resource, facet}, ":"))
+	return strings.ToLower(family + ":" + action + ":" + resource + ":")
 }
 
 func deriveTargetActions(seqs []pattern.Sequence) []string {
@@ -1,10 +1,12 @@
 package suggest
 
 import (
+	"context"
 	"strings"
 	"testing"
 
 	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/policy/suggest/pattern"
 	"github.com/strongdm/leash/internal/proxy"
 )
 
@@ -66,6 +68,44 @@ func TestAnalyzeDomainSuggestions(t *testing.T) {
 	}
 }
 
+func TestAnalyzeDirectorySuggestionsUseTightestCoveringDirectory(t *testing.T) {
+	t.Parallel()
+
+	ps := &lsm.PolicySet{}
+	ps.Open = append(ps.Open,
+		allowFileRule("/workspace/app/src/main.go", lsm.OpOpenRO),
+		allowFileRule("/workspace/app/src/util.go", lsm.OpOpenRO),
+		allowFileRule("/workspace/app/test/main_test.go", lsm.OpOpenRO),
+		allowFileRule("/etc/hosts", lsm.OpOpenRO),
+	)
+	observed := []pattern.Sequence{{
+		SessionID: "go@1",
+		Principal: "go",
+		Events: []pattern.Event{
+			{ResourceClass: "unix.file", ResourceFacet: "/workspace/app/src/main.go"},
+			{ResourceClass: "unix.file", ResourceFacet: "/workspace/app/src/main.go"},
+			{ResourceClass: "unix.file", ResourceFacet: "/workspace/app/go.mod"},
+			{ResourceClass: "unix.file", ResourceFacet: "/etc/passwd"},
+		},
+	}}
+
+	result := Analyze(Inputs{LSMPolicies: ps, EventSequences: observed}, Options{MinDirectoryGroup: 3})
+	var dirs []Suggestion
+	for _, s := range result.Suggestions {
+		if s.Kind == SuggestDirectory {
+			dirs = append(dirs, s)
+		}
+	}
+	// Each directory alone holds too few rules; /workspace/app is the
+	// tightest one holding three, and /etc/hosts stays out of it.
+	if len(dirs) != 1 || dirs[0].Metadata["directory"] != "/workspace/app" || dirs[0].PolicyCount != 3 {
+		t.Fatalf("unexpected directory suggestions: %+v", dirs)
+	}
+	if dirs[0].Metadata["observed_paths"] != "2" || dirs[0].Metadata["observed_events"] != "3" {
+		t.Fatalf("unexpected observed coverage: %v", dirs[0].Metadata)
+	}
+}
+
 func TestAnalyzeHTTPSuggestions(t *testing.T) {
 	rewrites := []proxy.HeaderRewriteRule{
 		{Host: "api.openai.com", Header: "X-Test", Value: "one"},
@@ -89,6 +129,65 @@ func TestAnalyzeHTTPSuggestions(t *testing.T) {
 	}
 }
 
+func TestAnalyzeContextReportsPartialResult(t *testing.T) {
+	t.Parallel()
+
+	opts := DefaultOptions()
+	inputs := Inputs{EventSequences: BuildSequencesFromLogs(streamLogs(6, opts.SessionWindow), opts.SessionWindow)}
+
+	full := AnalyzeContext(context.Background(), inputs, opts)
+	if full.Partial || len(full.Timings) != 1 || !full.Timings[0].Completed {
+		t.Fatalf("expected a complete workflow pass, got partial=%v timings=%+v", full.Partial, full.Timings)
+	}
+	if len(workflowKeys(full)) == 0 {
+		t.Fatalf("expected workflow suggestions")
+	}
+
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	partial := AnalyzeContext(ctx, inputs, opts)
+	if !partial.Partial {
+		t.Fatalf("expected a partial result from an expired context")
+	}
+	if len(partial.Timings) != 1 || partial.Timings[0].Pass != "workflow" || partial.Timings[0].Completed {
+		t.Fatalf("unexpected timings: %+v", partial.Timings)
+	}
+	if len(workflowKeys(partial)) != 0 {
+		t.Fatalf("expected no workflow suggestions, got %v", workflowKeys(partial))
+	}
+}
+
+func TestRulePassesStopWhenContextEnds(t *testing.T) {
+	t.Parallel()
+
+	ps := &lsm.PolicySet{}
+	ps.Open = append(ps.Open,
+		allowFileRule("/etc/ssh/sshd_config", lsm.OpOpen),
+		allowFileRule("/etc/ssh/ssh_config", lsm.OpOpenRO),
+	)
+	ps.Connect = append(ps.Connect,
+		allowConnectRule("api.openai.com", 443),
+		allowConnectRule("files.openai.com", 443),
+	)
+	rewrites := []proxy.HeaderRewriteRule{
+		{Host: "api.openai.com", Header: "X-Test", Value: "one"},
+		{Host: "files.openai.com", Header: "X-Test", Value: "two"},
+	}
+	opts := Options{MinDirectoryGroup: 2, MinDomainGroup: 2, MinHTTPGroup: 2}
+
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if _, complete := directorySuggestions(ctx, ps, nil, opts); complete {
+		t.Fatal("directory pass ignored the expired context")
+	}
+	if _, complete := domainSuggestions(ctx, ps, nil, opts); complete {
+		t.Fatal("domain pass ignored the expired context")
+	}
+	if _, complete := httpSuggestions(ctx, rewrites, opts); complete {
+		t.Fatal("http pass ignored the expired context")
+	}
+}
+
 // Helpers -----------------------------------------------------------------
 
 func allowFileRule(path string, op int32) lsm.PolicyRule {
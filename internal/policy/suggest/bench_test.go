@@ -0,0 +1,102 @@
+package suggest
+
+import (
+	"fmt"
+	"testing"
+	"time"
+
+	"github.com/strongdm/leash/internal/policy/suggest/drift"
+	"github.com/strongdm/leash/internal/policy/suggest/encoding"
+	"github.com/strongdm/leash/internal/policy/suggest/pattern"
+	"github.com/strongdm/leash/internal/policy/suggest/synth"
+	"github.com/strongdm/leash/internal/websocket"
+)
+
+// The benchmarks in this file run each stage of the suggestion pipeline over
+// synthetic agent sessions at a few scales. `make bench-suggest` runs them
+// and compares against testdata/benchmarks/baseline.txt.
+
+var benchScales = []int{10_000, 100_000}
+
+func benchLogs(b *testing.B, n int) []websocket.LogEntry {
+	b.Helper()
+	return synth.Generate(synth.Config{Events: n, Agents: 8})
+}
+
+func benchSequences(b *testing.B, n int) []pattern.Sequence {
+	b.Helper()
+	return BuildSequencesFromLogs(benchLogs(b, n), 10*time.Minute)
+}
+
+func BenchmarkPipelineBuildSequences(b *testing.B) {
+	for _, n := range benchScales {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			logs := benchLogs(b, n)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				BuildSequencesFromLogs(logs, 10*time.Minute)
+			}
+		})
+	}
+}
+
+func BenchmarkPipelineMine(b *testing.B) {
+	for _, n := range benchScales {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			seqs := benchSequences(b, n)
+			cfg := pattern.DefaultConfig()
+			cfg.MinSupport = 3
+			cfg.MaxLength = 5
+			cfg.TargetActions = deriveTargetActions(seqs)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				pattern.Mine(seqs, cfg)
+			}
+		})
+	}
+}
+
+func BenchmarkPipelineAffinityCluster(b *testing.B) {
+	for _, n := range benchScales {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			seqs := benchSequences(b, n)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				encoding.AffinityCluster(seqs, encoding.BagOfNGrams, 0.72)
+			}
+		})
+	}
+}
+
+func BenchmarkPipelineDriftDetect(b *testing.B) {
+	for _, n := range benchScales {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			seqs := benchSequences(b, n)
+			// Compare the first half of the sessions against the whole stream,
+			// as rankWorkflows compares a cluster against the overall mix.
+			expected := eventDistribution(seqs)
+			observed := eventDistribution(seqs[:len(seqs)/2])
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				drift.Detect(expected, observed, 0.25)
+			}
+		})
+	}
+}
+
+func BenchmarkPipelineAnalyze(b *testing.B) {
+	for _, n := range benchScales {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			seqs := benchSequences(b, n)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				Analyze(Inputs{EventSequences: seqs}, Options{})
+			}
+		})
+	}
+}
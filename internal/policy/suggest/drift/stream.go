@@ -0,0 +1,250 @@
+package drift
+
+import (
+	"math"
+	"sort"
+	"time"
+)
+
+// StreamConfig tunes a Stream. Zero values fall back to the defaults noted on
+// each field.
+type StreamConfig struct {
+	// CurrentHalfLife is how quickly the current window forgets (5m).
+	CurrentHalfLife time.Duration
+	// ReferenceHalfLife is how quickly the reference window forgets (1h). It
+	// must be longer than CurrentHalfLife.
+	ReferenceHalfLife time.Duration
+	// Threshold is the PSI above which the stream reports drift (0.25).
+	Threshold float64
+	// MinEvents is the decayed event count the current window needs before
+	// drift is reported at all (30).
+	MinEvents float64
+}
+
+// StreamStatus is a point-in-time view of a Stream.
+type StreamStatus struct {
+	Result
+	// Current and Reference are the decayed event counts of each window.
+	Current   float64
+	Reference float64
+	// Transitions counts how often IsDrift has flipped, so pollers can tell a
+	// new alert from one they have already pushed.
+	Transitions uint64
+}
+
+// clearFraction is the share of Threshold PSI must fall below before an alert
+// clears, so a PSI hovering at the threshold does not flap.
+const clearFraction = 0.8
+
+// rescaleExponent bounds how far weights grow before they are rebased.
+const rescaleExponent = 16
+
+// pruneWeight drops tokens whose reference weight has decayed below it.
+const pruneWeight = 1e-6
+
+// Stream compares a fast-decaying current window against a slow-decaying
+// reference window of event tokens, both fed by every event.
+//
+// Decay is applied lazily: an event at time t adds exp(rate*(t-base)) to its
+// token instead of shrinking every other count, and since PSI only depends on
+// proportions the common factor never has to be divided out. PSI is kept as
+//
+//	PSI = (Scc - Scr)/C + (Srr - Src)/R
+//
+// where Sxy = sum over tokens of X_k*ln(Y_k) and C, R are the window totals,
+// so an event only updates the four sums for its own token. When the weights
+// grow large they are rebased to the latest event, the sums are recomputed
+// and long-decayed tokens are pruned, which keeps rounding from accumulating.
+//
+// A Stream is not safe for concurrent use.
+type Stream struct {
+	cfg StreamConfig
+
+	base   time.Time
+	latest time.Time
+
+	curRate, refRate float64
+	cur, ref         float64
+	tokens           map[string]*streamToken
+
+	scc, scr, src, srr float64
+
+	drifting    bool
+	transitions uint64
+}
+
+type streamToken struct {
+	cur, ref float64
+}
+
+// NewStream returns an empty stream.
+func NewStream(cfg StreamConfig) *Stream {
+	if cfg.CurrentHalfLife <= 0 {
+		cfg.CurrentHalfLife = 5 * time.Minute
+	}
+	if cfg.ReferenceHalfLife <= cfg.CurrentHalfLife {
+		cfg.ReferenceHalfLife = max(time.Hour, 12*cfg.CurrentHalfLife)
+	}
+	if cfg.Threshold <= 0 {
+		cfg.Threshold = 0.25
+	}
+	if cfg.MinEvents <= 0 {
+		cfg.MinEvents = 30
+	}
+	return &Stream{
+		cfg:     cfg,
+		curRate: math.Ln2 / cfg.CurrentHalfLife.Seconds(),
+		refRate: math.Ln2 / cfg.ReferenceHalfLife.Seconds(),
+		tokens:  make(map[string]*streamToken),
+	}
+}
+
+// Observe counts one event for token at time at and reports whether the
+// drift state flipped. A zero at counts as the latest time seen.
+func (s *Stream) Observe(token string, at time.Time) bool {
+	if at.IsZero() {
+		at = s.latest
+	}
+	if s.base.IsZero() {
+		s.base = at
+	}
+	if at.After(s.latest) {
+		s.latest = at
+	}
+	if s.curRate*at.Sub(s.base).Seconds() > rescaleExponent {
+		s.rebase(at)
+	}
+
+	elapsed := at.Sub(s.base).Seconds()
+	dc, dr := math.Exp(s.curRate*elapsed), math.Exp(s.refRate*elapsed)
+
+	t := s.tokens[token]
+	if t == nil {
+		t = &streamToken{}
+		s.tokens[token] = t
+	} else {
+		s.removeTerms(t)
+	}
+	t.cur += dc
+	t.ref += dr
+	s.addTerms(t)
+	s.cur += dc
+	s.ref += dr
+
+	return s.updateState()
+}
+
+// PSI returns the population stability index of the current window against
+// the reference window.
+func (s *Stream) PSI() float64 {
+	if s.cur <= 0 || s.ref <= 0 {
+		return 0
+	}
+	// Rounding can leave a stationary stream a hair below zero.
+	return math.Max(0, (s.scc-s.scr)/s.cur+(s.srr-s.src)/s.ref)
+}
+
+// Drifting reports whether the stream is currently alerting.
+func (s *Stream) Drifting() bool {
+	return s.drifting
+}
+
+// Status returns the current PSI, alert state, window sizes and up to limit
+// top contributing tokens. It walks every token, unlike Observe.
+func (s *Stream) Status(limit int) StreamStatus {
+	status := StreamStatus{
+		Result:      Result{PSI: s.PSI(), IsDrift: s.drifting},
+		Current:     s.decayed(s.cur, s.curRate),
+		Reference:   s.decayed(s.ref, s.refRate),
+		Transitions: s.transitions,
+	}
+	if limit <= 0 || s.cur <= 0 || s.ref <= 0 {
+		return status
+	}
+	contributors := make([]Contributor, 0, len(s.tokens))
+	for token, t := range s.tokens {
+		c, r := t.cur/s.cur, t.ref/s.ref
+		contributors = append(contributors, Contributor{
+			Token: token,
+			Value: math.Abs((c - r) * (safeLog(t.cur) - math.Log(s.cur) - safeLog(t.ref) + math.Log(s.ref))),
+		})
+	}
+	sort.Slice(contributors, func(i, j int) bool {
+		if contributors[i].Value == contributors[j].Value {
+			return contributors[i].Token < contributors[j].Token
+		}
+		return contributors[i].Value > contributors[j].Value
+	})
+	if len(contributors) > limit {
+		contributors = contributors[:limit]
+	}
+	status.TopContributors = contributors
+	return status
+}
+
+func (s *Stream) updateState() bool {
+	psi := s.PSI()
+	warm := s.decayed(s.cur, s.curRate) >= s.cfg.MinEvents
+	next := s.drifting
+	switch {
+	case !s.drifting && warm && psi > s.cfg.Threshold:
+		next = true
+	case s.drifting && psi < s.cfg.Threshold*clearFraction:
+		next = false
+	}
+	if next == s.drifting {
+		return false
+	}
+	s.drifting = next
+	s.transitions++
+	return true
+}
+
+// decayed converts a lazily scaled total to an event count as of the latest
+// observation.
+func (s *Stream) decayed(total, rate float64) float64 {
+	return total * math.Exp(-rate*s.latest.Sub(s.base).Seconds())
+}
+
+// rebase moves the decay origin to at, shrinking every weight to its value
+// there, pruning tokens that have all but vanished and recomputing the sums.
+func (s *Stream) rebase(at time.Time) {
+	elapsed := at.Sub(s.base).Seconds()
+	fc, fr := math.Exp(-s.curRate*elapsed), math.Exp(-s.refRate*elapsed)
+	s.base = at
+	s.cur, s.ref = 0, 0
+	s.scc, s.scr, s.src, s.srr = 0, 0, 0, 0
+	for token, t := range s.tokens {
+		t.cur *= fc
+		t.ref *= fr
+		if t.ref < pruneWeight {
+			delete(s.tokens, token)
+			continue
+		}
+		s.cur += t.cur
+		s.ref += t.ref
+		s.addTerms(t)
+	}
+}
+
+func (s *Stream) addTerms(t *streamToken) {
+	lc, lr := safeLog(t.cur), safeLog(t.ref)
+	s.scc += t.cur * lc
+	s.scr += t.cur * lr
+	s.src += t.ref * lc
+	s.srr += t.ref * lr
+}
+
+func (s *Stream) removeTerms(t *streamToken) {
+	lc, lr := safeLog(t.cur), safeLog(t.ref)
+	s.scc -= t.cur * lc
+	s.scr -= t.cur * lr
+	s.src -= t.ref * lc
+	s.srr -= t.ref * lr
+}
+
+// safeLog keeps a current weight that has decayed to nothing from turning
+// into -Inf before the token is pruned.
+func safeLog(x float64) float64 {
+	return math.Log(math.Max(x, math.SmallestNonzeroFloat64))
+}
@@ -0,0 +1,97 @@
+package drift
+
+import (
+	"math"
+	"testing"
+	"time"
+)
+
+type timedToken struct {
+	token string
+	at    time.Time
+}
+
+// decayedPSI recomputes PSI from scratch over exponentially decayed counts as
+// of the last event.
+func decayedPSI(events []timedToken, cfg StreamConfig) float64 {
+	now := events[len(events)-1].at
+	cur, ref := map[string]float64{}, map[string]float64{}
+	var curTotal, refTotal float64
+	for _, e := range events {
+		age := now.Sub(e.at).Seconds()
+		c := math.Exp(-math.Ln2 * age / cfg.CurrentHalfLife.Seconds())
+		r := math.Exp(-math.Ln2 * age / cfg.ReferenceHalfLife.Seconds())
+		cur[e.token] += c
+		ref[e.token] += r
+		curTotal += c
+		refTotal += r
+	}
+	var psi float64
+	for token := range ref {
+		c, r := cur[token]/curTotal, ref[token]/refTotal
+		psi += (c - r) * math.Log(c/r)
+	}
+	return psi
+}
+
+func TestStreamPSIMatchesRecomputation(t *testing.T) {
+	t.Parallel()
+
+	cfg := StreamConfig{CurrentHalfLife: 5 * time.Minute, ReferenceHalfLife: time.Hour}
+	stream := NewStream(cfg)
+	base := time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	tokens := []string{"file:open", "network:connect", "process:exec", "http:request"}
+
+	var events []timedToken
+	// Six hours is long enough for the weights to be rebased several times.
+	for i := 0; i < 2160; i++ {
+		token := tokens[i%3]
+		if i > 1500 {
+			token = tokens[3-i%2]
+		}
+		e := timedToken{token: token, at: base.Add(time.Duration(i) * 10 * time.Second)}
+		events = append(events, e)
+		stream.Observe(e.token, e.at)
+
+		if i%97 == 0 || i == 2159 {
+			want := decayedPSI(events, cfg)
+			if got := stream.PSI(); math.Abs(got-want) > 1e-9*math.Max(1, want) {
+				t.Fatalf("event %d: incremental PSI %.12f, recomputed %.12f", i, got, want)
+			}
+		}
+	}
+}
+
+func TestStreamAlertsOnShiftAndClears(t *testing.T) {
+	t.Parallel()
+
+	stream := NewStream(StreamConfig{CurrentHalfLife: 5 * time.Minute, ReferenceHalfLife: time.Hour, Threshold: 0.25})
+	at := time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	mix := []string{"file:open", "network:connect", "process:exec"}
+	feed := func(d time.Duration, token func(i int) string) (flips int) {
+		for i := 0; i < int(d/time.Second); i++ {
+			at = at.Add(time.Second)
+			if stream.Observe(token(i), at) {
+				flips++
+			}
+		}
+		return flips
+	}
+
+	if flips := feed(time.Hour, func(i int) string { return mix[i%3] }); flips != 0 || stream.Drifting() {
+		t.Fatalf("stationary traffic flagged drift: psi %.3f", stream.PSI())
+	}
+	if flips := feed(20*time.Minute, func(int) string { return "network:connect" }); flips != 1 || !stream.Drifting() {
+		t.Fatalf("expected one alert after the shift, got %d flips, psi %.3f", flips, stream.PSI())
+	}
+	status := stream.Status(2)
+	if !status.IsDrift || status.Transitions != 1 || len(status.TopContributors) != 2 {
+		t.Fatalf("unexpected status: %+v", status)
+	}
+	if math.Abs(status.Current-300/math.Ln2) > 5 {
+		t.Fatalf("current window holds %.1f events, want about %.1f", status.Current, 300/math.Ln2)
+	}
+	if flips := feed(2*time.Hour, func(i int) string { return mix[i%3] }); flips != 1 || stream.Drifting() {
+		t.Fatalf("expected the alert to clear, got %d flips, psi %.3f", flips, stream.PSI())
+	}
+}
@@ -1,10 +1,10 @@
 package encoding
 
 import (
-	"fmt"
-	"math"
+	"runtime"
 	"sort"
 	"strings"
+	"sync"
 
 	"github.com/strongdm/leash/internal/policy/suggest/pattern"
 )
@@ -81,6 +81,11 @@ func ConstraintTensorEncoding(seq pattern.Sequence) FeatureVector {
 // AffinityCluster clusters traces using cosine similarity between feature
 // vectors. threshold controls the minimum similarity required to join an
 // existing cluster.
+//
+// Traces are encoded in parallel and interned to float32 vectors; assignment
+// stays sequential because each trace sees the centroids formed before it.
+// The nearest centroid is found through an exact inverted index, so the
+// result matches comparing every trace against every centroid.
 func AffinityCluster(traces []pattern.Sequence, enc func(pattern.Sequence) FeatureVector, threshold float64) []Cluster {
 	if enc == nil {
 		enc = BagOfNGrams
@@ -88,101 +93,88 @@ func AffinityCluster(traces []pattern.Sequence, enc func(pattern.Sequence) Featu
 	if threshold <= 0 {
 		threshold = 0.65
 	}
-	type centroid struct {
-		vector  FeatureVector
-		count   float64
-		cluster *Cluster
-	}
-	centroids := make([]*centroid, 0)
-
-	for _, trace := range traces {
-		vec := enc(trace)
-		bestIdx := -1
-		bestScore := -1.0
-
-		for idx, c := range centroids {
-			score := cosine(vec, c.vector)
-			if score > bestScore {
-				bestScore = score
-				bestIdx = idx
-			}
-		}
 
-		if bestIdx == -1 || bestScore < threshold {
-			clusterID := fmt.Sprintf("cluster-%d", len(centroids)+1)
+	vocab := NewVocabulary()
+	vectors := internAll(vocab, encodeAll(traces, enc))
+	set := newCentroidSet(threshold, vocab)
+
+	clusters := make([]*Cluster, 0)
+	bySlot := make(map[int32]*Cluster)
+	slots := make([]int32, 0)
+	for i, trace := range traces {
+		slot, created := set.assign(vectors[i])
+		if created {
 			cl := &Cluster{
-				ID:             clusterID,
+				ID:             set.slots[slot].id,
 				Members:        []string{trace.SessionID},
-				Centroid:       copyVector(vec),
 				Explanation:    summarizeCluster(trace),
 				Representative: trace,
 			}
-			centroids = append(centroids, &centroid{
-				vector:  copyVector(vec),
-				count:   1,
-				cluster: cl,
-			})
+			clusters = append(clusters, cl)
+			bySlot[slot] = cl
+			slots = append(slots, slot)
 			continue
 		}
-
-		c := centroids[bestIdx]
-		c.cluster.Members = append(c.cluster.Members, trace.SessionID)
-		c.count++
-		c.vector = incrementalAverage(c.vector, vec, c.count)
-		c.cluster.Centroid = copyVector(c.vector)
+		cl := bySlot[slot]
+		cl.Members = append(cl.Members, trace.SessionID)
 	}
 
-	out := make([]Cluster, len(centroids))
-	for i, c := range centroids {
-		sort.Strings(c.cluster.Members)
-		out[i] = *c.cluster
+	out := make([]Cluster, len(clusters))
+	for i, cl := range clusters {
+		sort.Strings(cl.Members)
+		cl.Centroid = set.mean(slots[i])
+		out[i] = *cl
 	}
 	return out
 }
 
-func canonicalAction(evt pattern.Event) string {
-	return strings.ToLower(evt.ActionFamily + ":" + evt.ActionName + ":" + evt.ResourceClass)
-}
-
-func cosine(a, b FeatureVector) float64 {
-	var dot, magA, magB float64
-	for k, v := range a {
-		if bv, ok := b[k]; ok {
-			dot += v * bv
+// parallelEncodeMin is the number of traces below which encoding stays on
+// the calling goroutine.
+const parallelEncodeMin = 256
+
+// encodeAll runs enc over traces, spreading the work over GOMAXPROCS
+// goroutines for large batches. enc must be safe for concurrent use, as the
+// encoders in this package are.
+func encodeAll(traces []pattern.Sequence, enc func(pattern.Sequence) FeatureVector) []FeatureVector {
+	out := make([]FeatureVector, len(traces))
+	workers := runtime.GOMAXPROCS(0)
+	if len(traces) < parallelEncodeMin || workers <= 1 {
+		for i, trace := range traces {
+			out[i] = enc(trace)
 		}
-		magA += v * v
-	}
-	for _, v := range b {
-		magB += v * v
-	}
-	if magA == 0 || magB == 0 {
-		return 0
+		return out
+	}
+	var wg sync.WaitGroup
+	chunk := (len(traces) + workers - 1) / workers
+	for start := 0; start < len(traces); start += chunk {
+		end := start + chunk
+		if end > len(traces) {
+			end = len(traces)
+		}
+		wg.Add(1)
+		go func(start, end int) {
+			defer wg.Done()
+			for i := start; i < end; i++ {
+				out[i] = enc(traces[i])
+			}
+		}(start, end)
 	}
-	return dot / (math.Sqrt(magA) * math.Sqrt(magB))
+	wg.Wait()
+	return out
 }
 
-func incrementalAverage(current FeatureVector, incoming FeatureVector, count float64) FeatureVector {
-	out := make(FeatureVector)
-	keys := make(map[string]struct{})
-	for k := range current {
-		keys[k] = struct{}{}
-	}
-	for k := range incoming {
-		keys[k] = struct{}{}
-	}
-	den := count
-	prevDen := count - 1
-	if prevDen < 1 {
-		prevDen = 1
-	}
-	for k := range keys {
-		prev := current[k]
-		newVal := incoming[k]
-		out[k] = ((prev * prevDen) + newVal) / den
+func internAll(vocab *Vocabulary, vecs []FeatureVector) []SparseVector {
+	out := make([]SparseVector, len(vecs))
+	for i, vec := range vecs {
+		out[i] = vocab.Intern(vec)
 	}
 	return out
 }
 
+func canonicalAction(evt pattern.Event) string {
+	return strings.ToLower(evt.ActionFamily + ":" + evt.ActionName + ":" + evt.ResourceClass)
+}
+
 func summarizeCluster(seq pattern.Sequence) string {
 	if len(seq.Events) == 0 {
 		return "empty trace"
@@ -194,11 +186,3 @@ func summarizeCluster(seq pattern.Sequence) string {
 		"principal " + first.PrincipalID,
 	}, "; ")
 }
-
-func copyVector(src FeatureVector) FeatureVector {
-	dst := make(FeatureVector, len(src))
-	for k, v := range src {
-		dst[k] = v
-	}
-	return dst
-}
@@ -0,0 +1,312 @@
+package encoding
+
+import (
+	"fmt"
+	"math"
+	"sort"
+)
+
+// exactScanLimit is the number of centroids below which a plain scan beats
+// consulting the index.
+const exactScanLimit = 32
+
+// centroidSet holds dense float32 centroids and finds the most similar one to
+// a trace. Centroids are unnormalised sums: cosine similarity ignores scale,
+// so a sum ranks candidates exactly like a mean, and withdrawing a member is a
+// subtraction.
+//
+// Search uses an inverted index from feature id to the centroids where that
+// feature is non-zero, with prefix filtering: a centroid that shares only
+// features outside the trace's heaviest ones cannot reach the threshold,
+// because its cosine is bounded by the norm of the features it shares. Only
+// centroids posted under those heavy features are scored. The bound is exact,
+// so the result always matches a full scan.
+type centroidSet struct {
+	threshold float64
+	vocab     *Vocabulary
+
+	slots    []*centroid
+	free     []int32
+	live     int
+	byID     map[string]int32
+	postings [][]int32
+	next     int
+	order    int64
+
+	seen  []uint32
+	epoch uint32
+}
+
+type centroid struct {
+	id    string
+	order int64
+	sum   []float32
+	norm2 float64
+	count int
+	// owner is the set allowed to mutate this centroid; a fork shares its
+	// parent's centroids and clones one before the first write.
+	owner *centroidSet
+}
+
+func newCentroidSet(threshold float64, vocab *Vocabulary) *centroidSet {
+	if threshold <= 0 {
+		threshold = 0.65
+	}
+	return &centroidSet{
+		threshold: threshold,
+		vocab:     vocab,
+		byID:      make(map[string]int32),
+	}
+}
+
+// nearest returns the slot of the most similar centroid and its cosine
+// similarity, or -1 when no centroid can reach the threshold. Ties go to the
+// oldest centroid, as in a scan in creation order.
+func (cs *centroidSet) nearest(v SparseVector) (int32, float64) {
+	best, bestScore, bestOrder := int32(-1), -1.0, int64(math.MaxInt64)
+	consider := func(slot int32) {
+		c := cs.slots[slot]
+		score := c.cosine(v)
+		if score > bestScore || (score == bestScore && c.order < bestOrder) {
+			best, bestScore, bestOrder = slot, score, c.order
+		}
+	}
+
+	if cs.live <= exactScanLimit {
+		for slot, c := range cs.slots {
+			if c != nil {
+				consider(int32(slot))
+			}
+		}
+		return best, bestScore
+	}
+
+	cs.epoch++
+	if cs.epoch == 0 {
+		clear(cs.seen)
+		cs.epoch = 1
+	}
+	if len(cs.seen) < len(cs.slots) {
+		cs.seen = append(cs.seen, make([]uint32, len(cs.slots)-len(cs.seen))...)
+	}
+	for _, feature := range prefixFeatures(v, cs.threshold) {
+		if int(feature) >= len(cs.postings) {
+			continue
+		}
+		for _, slot := range cs.postings[feature] {
+			if cs.seen[slot] == cs.epoch {
+				continue
+			}
+			cs.seen[slot] = cs.epoch
+			consider(slot)
+		}
+	}
+	return best, bestScore
+}
+
+// prefixFeatures returns the trace's heaviest features, just enough of them
+// that the norm of the rest falls below threshold times the full norm.
+func prefixFeatures(v SparseVector, threshold float64) []int32 {
+	if v.Norm == 0 {
+		return nil
+	}
+	order := make([]int, len(v.IDs))
+	for i := range order {
+		order[i] = i
+	}
+	sort.Slice(order, func(i, j int) bool {
+		return math.Abs(float64(v.Values[order[i]])) > math.Abs(float64(v.Values[order[j]]))
+	})
+	rest := float64(v.Norm) * float64(v.Norm)
+	// Keep a little slack so float32 rounding never stops the prefix early.
+	bound := threshold * threshold * rest * (1 - 1e-6)
+	out := make([]int32, 0, len(order))
+	for _, i := range order {
+		if rest < bound {
+			break
+		}
+		out = append(out, v.IDs[i])
+		w := float64(v.Values[i])
+		rest -= w * w
+	}
+	return out
+}
+
+// assign adds v to the nearest centroid, or to a new one when none is similar
+// enough, and returns the slot.
+func (cs *centroidSet) assign(v SparseVector) (int32, bool) {
+	slot, score := cs.nearest(v)
+	if slot == -1 || score < cs.threshold {
+		return cs.create(v), true
+	}
+	cs.add(slot, v)
+	return slot, false
+}
+
+func (cs *centroidSet) create(v SparseVector) int32 {
+	cs.next++
+	cs.order++
+	c := &centroid{
+		id:    fmt.Sprintf("cluster-%d", cs.next),
+		order: cs.order,
+		owner: cs,
+	}
+	var slot int32
+	if n := len(cs.free); n > 0 {
+		slot = cs.free[n-1]
+		cs.free = cs.free[:n-1]
+		cs.slots[slot] = c
+	} else {
+		slot = int32(len(cs.slots))
+		cs.slots = append(cs.slots, c)
+	}
+	cs.byID[c.id] = slot
+	cs.live++
+	cs.add(slot, v)
+	return slot
+}
+
+func (cs *centroidSet) add(slot int32, v SparseVector) {
+	c := cs.writable(slot)
+	c.count++
+	if n := len(v.IDs); n > 0 {
+		c.grow(int(v.IDs[n-1]) + 1)
+	}
+	for i, id := range v.IDs {
+		old := c.sum[id]
+		updated := old + v.Values[i]
+		c.sum[id] = updated
+		c.norm2 += float64(updated)*float64(updated) - float64(old)*float64(old)
+		if old == 0 && updated != 0 {
+			cs.post(id, slot)
+		}
+	}
+}
+
+// subtract removes v from the centroid, dropping components that cancel out
+// so rounding residue does not accumulate as a window slides.
+func (cs *centroidSet) subtract(slot int32, v SparseVector) {
+	c := cs.writable(slot)
+	for i, id := range v.IDs {
+		if int(id) >= len(c.sum) || c.sum[id] == 0 {
+			continue
+		}
+		rest := c.sum[id] - v.Values[i]
+		if math.Abs(float64(rest)) < 1e-6 {
+			rest = 0
+			cs.unpost(id, slot)
+		}
+		c.sum[id] = rest
+	}
+	c.norm2 = 0
+	for _, w := range c.sum {
+		c.norm2 += float64(w) * float64(w)
+	}
+}
+
+// remove withdraws v from the centroid in slot, dropping the centroid once it
+// has no members.
+func (cs *centroidSet) remove(slot int32, v SparseVector) {
+	c := cs.slots[slot]
+	if c.count <= 1 {
+		for id, w := range c.sum {
+			if w != 0 {
+				cs.unpost(int32(id), slot)
+			}
+		}
+		delete(cs.byID, c.id)
+		cs.slots[slot] = nil
+		cs.free = append(cs.free, slot)
+		cs.live--
+		return
+	}
+	cs.subtract(slot, v)
+	cs.slots[slot].count--
+}
+
+// writable returns the centroid in slot, cloning it first if it still
+// belongs to the set this one was forked from.
+func (cs *centroidSet) writable(slot int32) *centroid {
+	c := cs.slots[slot]
+	if c.owner == cs {
+		return c
+	}
+	dup := *c
+	dup.sum = append([]float32(nil), c.sum...)
+	dup.owner = cs
+	cs.slots[slot] = &dup
+	return &dup
+}
+
+func (cs *centroidSet) post(feature, slot int32) {
+	for int(feature) >= len(cs.postings) {
+		cs.postings = append(cs.postings, nil)
+	}
+	cs.postings[feature] = append(cs.postings[feature], slot)
+}
+
+func (cs *centroidSet) unpost(feature, slot int32) {
+	list := cs.postings[feature]
+	for i, s := range list {
+		if s == slot {
+			list[i] = list[len(list)-1]
+			cs.postings[feature] = list[:len(list)-1]
+			return
+		}
+	}
+}
+
+// fork returns a copy that shares centroids copy-on-write, for trying
+// assignments that should not stick. Both sets share the vocabulary, and
+// either one clones a shared centroid before changing it.
+func (cs *centroidSet) fork() *centroidSet {
+	for _, c := range cs.slots {
+		if c != nil {
+			c.owner = nil
+		}
+	}
+	out := &centroidSet{
+		threshold: cs.threshold,
+		vocab:     cs.vocab,
+		slots:     append([]*centroid(nil), cs.slots...),
+		free:      append([]int32(nil), cs.free...),
+		live:      cs.live,
+		byID:      make(map[string]int32, len(cs.byID)),
+		postings:  make([][]int32, len(cs.postings)),
+		next:      cs.next,
+		order:     cs.order,
+	}
+	for id, slot := range cs.byID {
+		out.byID[id] = slot
+	}
+	for i, list := range cs.postings {
+		out.postings[i] = append([]int32(nil), list...)
+	}
+	return out
+}
+
+// mean returns the centroid as an average over its members, keyed by
+// feature name.
+func (cs *centroidSet) mean(slot int32) FeatureVector {
+	c := cs.slots[slot]
+	out := make(FeatureVector)
+	for id, w := range c.sum {
+		if w != 0 {
+			out[cs.vocab.Name(int32(id))] = float64(w) / float64(c.count)
+		}
+	}
+	return out
+}
+
+func (c *centroid) grow(dim int) {
+	if len(c.sum) < dim {
+		c.sum = append(c.sum, make([]float32, dim-len(c.sum))...)
+	}
+}
+
+func (c *centroid) cosine(v SparseVector) float64 {
+	if v.Norm == 0 || c.norm2 <= 0 {
+		return 0
+	}
+	return float64(dotDense(v, c.sum)) / (float64(v.Norm) * math.Sqrt(c.norm2))
+}
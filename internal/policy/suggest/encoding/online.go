@@ -0,0 +1,55 @@
+package encoding
+
+// Clusterer is the online form of AffinityCluster for live streams: traces
+// join the most similar centroid as they arrive and can later be withdrawn,
+// so centroids follow a sliding window without reclustering it.
+type Clusterer struct {
+	set *centroidSet
+}
+
+// NewClusterer returns an empty clusterer. threshold has the same meaning and
+// default as in AffinityCluster.
+func NewClusterer(threshold float64) *Clusterer {
+	return &Clusterer{set: newCentroidSet(threshold, NewVocabulary())}
+}
+
+// Len reports the number of non-empty clusters.
+func (c *Clusterer) Len() int {
+	return c.set.live
+}
+
+// Add assigns vec to the nearest cluster, or to a new one when none is
+// similar enough, and returns the cluster ID. IDs follow AffinityCluster's
+// cluster-N scheme and are never reused.
+func (c *Clusterer) Add(vec FeatureVector) string {
+	slot, _ := c.set.assign(c.set.vocab.Intern(vec))
+	return c.set.slots[slot].id
+}
+
+// Remove withdraws a vector previously added to cluster id. A cluster left
+// without members is dropped.
+func (c *Clusterer) Remove(id string, vec FeatureVector) {
+	slot, ok := c.set.byID[id]
+	if !ok {
+		return
+	}
+	c.set.remove(slot, c.set.vocab.Intern(vec))
+}
+
+// Replace swaps a member's vector in place, e.g. after the trace was trimmed,
+// without reconsidering which cluster it belongs to.
+func (c *Clusterer) Replace(id string, old, updated FeatureVector) {
+	slot, ok := c.set.byID[id]
+	if !ok {
+		return
+	}
+	c.set.subtract(slot, c.set.vocab.Intern(old))
+	c.set.add(slot, c.set.vocab.Intern(updated))
+	c.set.slots[slot].count--
+}
+
+// Fork returns an independent copy, for trying assignments that should not
+// stick. Centroids are shared until either side changes them.
+func (c *Clusterer) Fork() *Clusterer {
+	return &Clusterer{set: c.set.fork()}
+}
@@ -0,0 +1,288 @@
+package encoding
+
+import (
+	"fmt"
+	"math"
+	"math/rand"
+	"sort"
+	"strings"
+	"testing"
+
+	"github.com/strongdm/leash/internal/policy/suggest/pattern"
+)
+
+func TestClustererMatchesAffinityCluster(t *testing.T) {
+	traces := []pattern.Sequence{
+		onlineTrace("build-1", "process:exec", "file:write", "network:connect"),
+		onlineTrace("fetch-1", "http:request", "http:request", "file:write"),
+		onlineTrace("build-2", "process:exec", "file:write", "network:connect"),
+		onlineTrace("fetch-2", "http:request", "http:request", "file:write"),
+		onlineTrace("build-3", "process:exec", "file:write", "file:write"),
+	}
+
+	batch := AffinityCluster(traces, BagOfNGrams, 0.7)
+	online := NewClusterer(0.7)
+	assigned := make(map[string][]string)
+	for _, trace := range traces {
+		id := online.Add(BagOfNGrams(trace))
+		assigned[id] = append(assigned[id], trace.SessionID)
+	}
+
+	if online.Len() != len(batch) {
+		t.Fatalf("expected %d clusters, got %d", len(batch), online.Len())
+	}
+	for _, cl := range batch {
+		if got := assigned[cl.ID]; len(got) != len(cl.Members) {
+			t.Fatalf("cluster %s: got members %v, want %v", cl.ID, got, cl.Members)
+		}
+	}
+}
+
+func TestClustererRemoveRestoresCentroid(t *testing.T) {
+	online := NewClusterer(0.4)
+	a := BagOfNGrams(onlineTrace("a", "process:exec", "file:write", "network:connect"))
+	b := BagOfNGrams(onlineTrace("b", "process:exec", "file:write", "file:write"))
+
+	id := online.Add(a)
+	if got := online.Add(b); got != id {
+		t.Fatalf("expected %s to absorb similar trace, got %s", id, got)
+	}
+	online.Remove(id, b)
+
+	fork := online.Fork()
+	fork.Remove(id, a)
+	if fork.Len() != 0 || online.Len() != 1 {
+		t.Fatalf("fork must be independent: fork=%d online=%d", fork.Len(), online.Len())
+	}
+	mean := online.set.mean(online.set.byID[id])
+	for k, v := range mean {
+		if diff := v - a[k]; diff > 1e-6 || diff < -1e-6 {
+			t.Fatalf("centroid component %s = %f, want %f", k, v, a[k])
+		}
+	}
+	if len(mean) != len(a) {
+		t.Fatalf("expected cancelled components dropped, got %v", mean)
+	}
+}
+
+func onlineTrace(id string, actions ...string) pattern.Sequence {
+	evts := make([]pattern.Event, len(actions))
+	for i, act := range actions {
+		parts := strings.SplitN(act, ":", 2)
+		evts[i] = makeEvent(parts[0], parts[1], "resource")
+	}
+	return pattern.Sequence{SessionID: id, Principal: id, Events: evts}
+}
+
+func randomTraces(n int, seed int64) []pattern.Sequence {
+	rng := rand.New(rand.NewSource(seed))
+	actions := []string{"file:open", "file:read", "file:write", "process:exec", "network:connect", "http:request", "dns:lookup"}
+	traces := make([]pattern.Sequence, n)
+	for i := range traces {
+		events := make([]string, 1+rng.Intn(6))
+		for j := range events {
+			events[j] = actions[rng.Intn(len(actions))]
+		}
+		traces[i] = onlineTrace(fmt.Sprintf("t%05d", i), events...)
+	}
+	return traces
+}
+
+func TestAffinityClusterMatchesReference(t *testing.T) {
+	traces := randomTraces(2000, 3)
+	for _, threshold := range []float64{0.55, 0.72, 0.9} {
+		got := AffinityCluster(traces, BagOfNGrams, threshold)
+		want := affinityClusterReference(traces, BagOfNGrams, threshold)
+		if len(got) <= exactScanLimit {
+			t.Fatalf("threshold %.2f: %d clusters do not exercise the index", threshold, len(got))
+		}
+		if len(got) != len(want) {
+			t.Fatalf("threshold %.2f: got %d clusters, want %d", threshold, len(got), len(want))
+		}
+		for i := range want {
+			if got[i].ID != want[i].ID || strings.Join(got[i].Members, ",") != strings.Join(want[i].Members, ",") {
+				t.Fatalf("threshold %.2f: cluster %d differs: %v vs %v", threshold, i, got[i].Members, want[i].Members)
+			}
+			for k, v := range want[i].Centroid {
+				if math.Abs(got[i].Centroid[k]-v) > 1e-5 {
+					t.Fatalf("threshold %.2f: centroid %s[%s] = %f, want %f", threshold, got[i].ID, k, got[i].Centroid[k], v)
+				}
+			}
+		}
+	}
+}
+
+func TestClustererForkIsCopyOnWrite(t *testing.T) {
+	traces := randomTraces(400, 5)
+	online := NewClusterer(0.72)
+	for _, trace := range traces[:300] {
+		online.Add(BagOfNGrams(trace))
+	}
+	before := make(map[string]FeatureVector)
+	for id, slot := range online.set.byID {
+		before[id] = online.set.mean(slot)
+	}
+
+	fork := online.Fork()
+	for _, trace := range traces[300:] {
+		fork.Add(BagOfNGrams(trace))
+	}
+	// The parent keeps clustering after the fork without leaking into it.
+	online.Add(BagOfNGrams(traces[0]))
+	if fork.Len() < online.Len() {
+		t.Fatalf("fork lost clusters: %d < %d", fork.Len(), online.Len())
+	}
+
+	ids := make([]string, 0, len(before))
+	for id := range before {
+		ids = append(ids, id)
+	}
+	sort.Strings(ids)
+	changed := 0
+	for _, id := range ids {
+		got := online.set.mean(online.set.byID[id])
+		for k, v := range before[id] {
+			if math.Abs(got[k]-v) > 1e-6 {
+				changed++
+				break
+			}
+		}
+	}
+	if changed > 1 {
+		t.Fatalf("fork writes leaked into %d parent centroids", changed)
+	}
+}
+
+func BenchmarkAffinityCluster(b *testing.B) {
+	traces := randomTraces(5000, 9)
+	b.Run("indexed", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			AffinityCluster(traces, BagOfNGrams, 0.72)
+		}
+	})
+	b.Run("reference", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			affinityClusterReference(traces, BagOfNGrams, 0.72)
+		}
+	})
+}
+
+// affinityClusterReference is the original map-based AffinityCluster, which
+// compares every trace against every centroid.
+func affinityClusterReference(traces []pattern.Sequence, enc func(pattern.Sequence) FeatureVector, threshold float64) []Cluster {
+	if enc == nil {
+		enc = BagOfNGrams
+	}
+	if threshold <= 0 {
+		threshold = 0.65
+	}
+	type centroid struct {
+		vector  FeatureVector
+		count   float64
+		cluster *Cluster
+	}
+	centroids := make([]*centroid, 0)
+
+	for _, trace := range traces {
+		vec := enc(trace)
+		bestIdx := -1
+		bestScore := -1.0
+
+		for idx, c := range centroids {
+			score := cosineReference(vec, c.vector)
+			if score > bestScore {
+				bestScore = score
+				bestIdx = idx
+			}
+		}
+
+		if bestIdx == -1 || bestScore < threshold {
+			clusterID := fmt.Sprintf("cluster-%d", len(centroids)+1)
+			cl := &Cluster{
+				ID:             clusterID,
+				Members:        []string{trace.SessionID},
+				Centroid:       copyVectorReference(vec),
+				Explanation:    summarizeCluster(trace),
+				Representative: trace,
+			}
+			centroids = append(centroids, &centroid{
+				vector:  copyVectorReference(vec),
+				count:   1,
+				cluster: cl,
+			})
+			continue
+		}
+
+		c := centroids[bestIdx]
+		c.cluster.Members = append(c.cluster.Members, trace.SessionID)
+		c.count++
+		c.vector = incrementalAverageReference(c.vector, vec, c.count)
+		c.cluster.Centroid = copyVectorReference(c.vector)
+	}
+
+	out := make([]Cluster, len(centroids))
+	for i, c := range centroids {
+		sort.Strings(c.cluster.Members)
+		out[i] = *c.cluster
+	}
+	return out
+}
+
+// cosineReference sums in key order so the oracle rounds the same way on
+// every run; map order would let near-ties fall either side.
+func cosineReference(a, b FeatureVector) float64 {
+	var dot, magA, magB float64
+	for _, k := range sortedFeatures(a) {
+		v := a[k]
+		if bv, ok := b[k]; ok {
+			dot += v * bv
+		}
+		magA += v * v
+	}
+	for _, k := range sortedFeatures(b) {
+		magB += b[k] * b[k]
+	}
+	if magA == 0 || magB == 0 {
+		return 0
+	}
+	return dot / (math.Sqrt(magA) * math.Sqrt(magB))
+}
+
+func sortedFeatures(v FeatureVector) []string {
+	keys := make([]string, 0, len(v))
+	for k := range v {
+		keys = append(keys, k)
+	}
+	sort.Strings(keys)
+	return keys
+}
+
+func incrementalAverageReference(current FeatureVector, incoming FeatureVector, count float64) FeatureVector {
+	out := make(FeatureVector)
+	keys := make(map[string]struct{})
+	for k := range current {
+		keys[k] = struct{}{}
+	}
+	for k := range incoming {
+		keys[k] = struct{}{}
+	}
+	den := count
+	prevDen := count - 1
+	if prevDen < 1 {
+		prevDen = 1
+	}
+	for k := range keys {
+		prev := current[k]
+		newVal := incoming[k]
+		out[k] = ((prev * prevDen) + newVal) / den
+	}
+	return out
+}
+
+func copyVectorReference(src FeatureVector) FeatureVector {
+	dst := make(FeatureVector, len(src))
+	for k, v := range src {
+		dst[k] = v
+	}
+	return dst
+}
@@ -0,0 +1,116 @@
+package encoding
+
+import (
+	"math"
+	"sort"
+)
+
+// Vocabulary interns feature names to dense ids so vectors can be stored as
+// id/weight slices instead of string-keyed maps.
+type Vocabulary struct {
+	ids   map[string]int32
+	names []string
+}
+
+// NewVocabulary returns an empty vocabulary.
+func NewVocabulary() *Vocabulary {
+	return &Vocabulary{ids: make(map[string]int32)}
+}
+
+// ID returns the id for name, assigning the next one if it is new.
+func (v *Vocabulary) ID(name string) int32 {
+	if id, ok := v.ids[name]; ok {
+		return id
+	}
+	id := int32(len(v.names))
+	v.ids[name] = id
+	v.names = append(v.names, name)
+	return id
+}
+
+// Len reports the number of interned features.
+func (v *Vocabulary) Len() int {
+	return len(v.names)
+}
+
+// Name returns the feature name for id.
+func (v *Vocabulary) Name(id int32) string {
+	return v.names[id]
+}
+
+// SparseVector is a feature vector over vocabulary ids, sorted by id.
+type SparseVector struct {
+	IDs    []int32
+	Values []float32
+	Norm   float32
+}
+
+// Intern converts fv to a SparseVector, adding unseen features to the
+// vocabulary. Zero weights are dropped. Unseen features get ids in name
+// order rather than map order, so the same input always yields the same ids
+// and float32 sums round the same way from run to run.
+func (v *Vocabulary) Intern(fv FeatureVector) SparseVector {
+	out := SparseVector{
+		IDs:    make([]int32, 0, len(fv)),
+		Values: make([]float32, 0, len(fv)),
+	}
+	var unseen []string
+	for name, w := range fv {
+		if w == 0 {
+			continue
+		}
+		id, ok := v.ids[name]
+		if !ok {
+			unseen = append(unseen, name)
+			continue
+		}
+		out.IDs = append(out.IDs, id)
+		out.Values = append(out.Values, float32(w))
+	}
+	sort.Strings(unseen)
+	for _, name := range unseen {
+		out.IDs = append(out.IDs, v.ID(name))
+		out.Values = append(out.Values, float32(fv[name]))
+	}
+	sort.Sort(byID(out))
+	var norm2 float64
+	for _, w := range out.Values {
+		norm2 += float64(w) * float64(w)
+	}
+	out.Norm = float32(math.Sqrt(norm2))
+	return out
+}
+
+type byID SparseVector
+
+func (s byID) Len() int           { return len(s.IDs) }
+func (s byID) Less(i, j int) bool { return s.IDs[i] < s.IDs[j] }
+func (s byID) Swap(i, j int) {
+	s.IDs[i], s.IDs[j] = s.IDs[j], s.IDs[i]
+	s.Values[i], s.Values[j] = s.Values[j], s.Values[i]
+}
+
+// dotDense returns the dot product of s with a dense vector. Ids past the end
+// of dense (features first seen after it was sized) contribute zero. The loop
+// is unrolled into independent accumulators so it pipelines well.
+func dotDense(s SparseVector, dense []float32) float32 {
+	ids, vals := s.IDs, s.Values
+	n := len(ids)
+	// Ids are sorted, so everything before the first out-of-range id is safe.
+	limit := n
+	if n > 0 && int(ids[n-1]) >= len(dense) {
+		limit = sort.Search(n, func(i int) bool { return int(ids[i]) >= len(dense) })
+	}
+	var s0, s1, s2, s3 float32
+	i := 0
+	for ; i+4 <= limit; i += 4 {
+		s0 += vals[i] * dense[ids[i]]
+		s1 += vals[i+1] * dense[ids[i+1]]
+		s2 += vals[i+2] * dense[ids[i+2]]
+		s3 += vals[i+3] * dense[ids[i+3]]
+	}
+	for ; i < limit; i++ {
+		s0 += vals[i] * dense[ids[i]]
+	}
+	return (s0 + s1) + (s2 + s3)
+}
@@ -3,6 +3,8 @@ package suggest
 import (
 	"sort"
 	"strings"
+	"sync"
+	"sync/atomic"
 	"time"
 
 	"github.com/strongdm/leash/internal/policy/suggest/pattern"
@@ -12,81 +14,179 @@ import (
 // BuildSequencesFromLogs groups recent runtime log entries into per-principal
 // sequences, splitting a principal's stream whenever the time gap between
 // events exceeds the provided window. The logs are expected in chronological
-// order (oldest first); if not, they are ordered before grouping.
+// order (oldest first); if not, they are ordered before grouping, keeping the
+// original order among equal timestamps. Sequences are returned in the order
+// they start.
+//
+// Timestamps are parsed once up front, so sequence building is a single pass
+// when the logs are already ordered, as the hub's ring buffer is.
 func BuildSequencesFromLogs(logs []websocket.LogEntry, window time.Duration) []pattern.Sequence {
 	if window <= 0 {
 		window = 5 * time.Minute
 	}
-	// Defensive copy + sort by time
-	items := make([]websocket.LogEntry, 0, len(logs))
-	items = append(items, logs...)
-	sort.Slice(items, func(i, j int) bool {
-		ti := parseTime(items[i].Time)
-		tj := parseTime(items[j].Time)
-		if ti.Equal(tj) {
-			// stable-ish fallback
-			return i < j
+	ats := make([]int64, len(logs))
+	ordered := true
+	for i := range logs {
+		ats[i] = parseUnixNano(logs[i].Time)
+		if i > 0 && ats[i] < ats[i-1] {
+			ordered = false
 		}
-		return ti.Before(tj)
-	})
-
-	type cursor struct {
-		last time.Time
-		seq  pattern.Sequence
 	}
-	byPrincipal := make(map[string]*cursor)
-	out := make([]pattern.Sequence, 0)
+	var order []int32
+	if !ordered {
+		order = make([]int32, len(logs))
+		for i := range order {
+			order[i] = int32(i)
+		}
+		sort.SliceStable(order, func(i, j int) bool { return ats[order[i]] < ats[order[j]] })
+	}
 
-	for _, e := range items {
-		ts := parseTime(e.Time)
+	gap := int64(window)
+	out := make([]pattern.Sequence, 0)
+	last := make([]int64, 0)
+	open := make(map[string]int)
+	for k := range logs {
+		i := k
+		if order != nil {
+			i = int(order[k])
+		}
+		e := &logs[i]
 		principal := principalOf(e)
 		if principal == "" {
 			// Skip unprincipaled events for suggestions
 			continue
 		}
-		cur := byPrincipal[principal]
-		if cur == nil || (cur.last.Add(window).Before(ts)) {
-			// Flush previous, start new sequence
-			if cur != nil && len(cur.seq.Events) > 0 {
-				out = append(out, cur.seq)
-			}
-			cur = &cursor{
-				last: ts,
-				seq: pattern.Sequence{
-					SessionID: principal + "@" + ts.UTC().Format(time.RFC3339Nano),
-					Principal: principal,
-					Events:    make([]pattern.Event, 0, 8),
-				},
-			}
-			byPrincipal[principal] = cur
-		}
-		cur.last = ts
-		cur.seq.Events = append(cur.seq.Events, toPatternEvent(e, ts))
-	}
-
-	// Drain any active cursors
-	for _, cur := range byPrincipal {
-		if len(cur.seq.Events) > 0 {
-			out = append(out, cur.seq)
+		at := ats[i]
+		s, ok := open[principal]
+		if !ok || last[s]+gap < at {
+			s = len(out)
+			open[principal] = s
+			out = append(out, pattern.Sequence{
+				SessionID: sessionID(principal, at),
+				Principal: principal,
+				Events:    make([]pattern.Event, 0, 8),
+			})
+			last = append(last, at)
 		}
+		last[s] = at
+		out[s].Events = append(out[s].Events, toPatternEvent(e, at))
 	}
 	return out
 }
 
+// sessionID names a sequence after its principal and first event.
+func sessionID(principal string, at int64) string {
+	buf := make([]byte, 0, len(principal)+1+len(time.RFC3339Nano))
+	buf = append(buf, principal...)
+	buf = append(buf, '@')
+	buf = unixNanoTime(at).UTC().AppendFormat(buf, time.RFC3339Nano)
+	return string(buf)
+}
+
 func parseTime(raw string) time.Time {
-	if raw == "" {
+	return unixNanoTime(parseUnixNano(raw))
+}
+
+// unixNanoTime converts an At value back to a time; zero is the zero time.
+func unixNanoTime(at int64) time.Time {
+	if at == 0 {
 		return time.Time{}
 	}
+	return time.Unix(0, at).UTC()
+}
+
+// parseUnixNano parses an RFC 3339 timestamp to Unix nanoseconds, returning
+// zero when raw is empty or malformed. The fixed-width form the hub writes is
+// decoded by hand; anything else goes through time.Parse.
+func parseUnixNano(raw string) int64 {
+	if raw == "" {
+		return 0
+	}
+	if at, ok := parseRFC3339Fast(raw); ok {
+		return at
+	}
 	if t, err := time.Parse(time.RFC3339Nano, raw); err == nil {
-		return t
+		return t.UnixNano()
 	}
 	if t, err := time.Parse(time.RFC3339, raw); err == nil {
-		return t
+		return t.UnixNano()
+	}
+	return 0
+}
+
+// parseRFC3339Fast handles YYYY-MM-DDTHH:MM:SS[.fraction](Z|±HH:MM). It
+// reports false for anything it does not fully validate, leaving the caller
+// to fall back to time.Parse.
+func parseRFC3339Fast(s string) (int64, bool) {
+	if len(s) < len("2006-01-02T15:04:05Z") || s[4] != '-' || s[7] != '-' || s[10] != 'T' || s[13] != ':' || s[16] != ':' {
+		return 0, false
+	}
+	year, ok1 := digits(s[0:4])
+	month, ok2 := digits(s[5:7])
+	day, ok3 := digits(s[8:10])
+	hour, ok4 := digits(s[11:13])
+	minute, ok5 := digits(s[14:16])
+	sec, ok6 := digits(s[17:19])
+	if !(ok1 && ok2 && ok3 && ok4 && ok5 && ok6) || month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 || sec > 59 {
+		return 0, false
+	}
+
+	rest := s[19:]
+	nsec := 0
+	if rest != "" && rest[0] == '.' {
+		n := 1
+		for n < len(rest) && rest[n] >= '0' && rest[n] <= '9' {
+			n++
+		}
+		if n == 1 || n > 10 {
+			return 0, false
+		}
+		frac, _ := digits(rest[1:n])
+		for i := n - 1; i < 9; i++ {
+			frac *= 10
+		}
+		nsec = frac
+		rest = rest[n:]
+	}
+
+	offset := 0
+	switch {
+	case rest == "Z":
+	case len(rest) == 6 && (rest[0] == '+' || rest[0] == '-') && rest[3] == ':':
+		oh, okh := digits(rest[1:3])
+		om, okm := digits(rest[4:6])
+		if !okh || !okm || oh > 23 || om > 59 {
+			return 0, false
+		}
+		offset = (oh*60 + om) * 60
+		if rest[0] == '-' {
+			offset = -offset
+		}
+	default:
+		return 0, false
+	}
+
+	t := time.Date(year, time.Month(month), day, hour, minute, sec, nsec, time.UTC)
+	if t.Day() != day {
+		// time.Date normalized an impossible date such as February 30.
+		return 0, false
+	}
+	return t.UnixNano() - int64(offset)*int64(time.Second), true
+}
+
+func digits(s string) (int, bool) {
+	n := 0
+	for i := 0; i < len(s); i++ {
+		c := s[i]
+		if c < '0' || c > '9' {
+			return 0, false
+		}
+		n = n*10 + int(c-'0')
 	}
-	return time.Time{}
+	return n, true
 }
 
-func principalOf(e websocket.LogEntry) string {
+func principalOf(e *websocket.LogEntry) string {
 	// Prefer explicit tool for HTTP; fall back to exe for system events.
 	p := strings.TrimSpace(e.Tool)
 	if p != "" {
@@ -96,47 +196,136 @@ func principalOf(e websocket.LogEntry) string {
 	return p
 }
 
-func toPatternEvent(e websocket.LogEntry, ts time.Time) pattern.Event {
-	family, action, rclass, rfacet := classify(e)
+func toPatternEvent(e *websocket.LogEntry, at int64) pattern.Event {
+	id, kind := kindOf(e.Event)
+	var facet string
+	switch kind.facet {
+	case facetPath:
+		facet = strings.TrimSpace(e.Path)
+	case facetExe:
+		facet = strings.TrimSpace(e.Exe)
+	case facetHost:
+		facet = strings.TrimSpace(e.Addr)
+		if facet == "" {
+			facet = strings.TrimSpace(e.Server)
+		}
+	}
 	outcome := strings.ToLower(strings.TrimSpace(e.Decision))
 	if outcome == "" {
 		outcome = "unknown"
 	}
 	return pattern.Event{
-		Timestamp:     ts,
+		Timestamp:     unixNanoTime(at),
+		At:            at,
+		Kind:          id,
 		PrincipalID:   principalOf(e),
-		ActionFamily:  family,
-		ActionName:    action,
-		ResourceClass: rclass,
-		ResourceFacet: rfacet,
+		ActionFamily:  kind.family,
+		ActionName:    kind.action,
+		ResourceClass: kind.rclass,
+		ResourceFacet: facet,
 		Outcome:       outcome,
 	}
 }
 
-func classify(e websocket.LogEntry) (family, action, rclass, facet string) {
-	ev := strings.ToLower(strings.TrimSpace(e.Event))
+// facetField says which log field supplies an event kind's resource facet.
+type facetField uint8
+
+const (
+	facetNone facetField = iota
+	facetPath
+	facetExe
+	facetHost
+)
+
+// eventKind is everything about an event's classification that follows from
+// its raw event name alone.
+type eventKind struct {
+	family, action, rclass string
+	facet                  facetField
+	// token is the canonical event token up to the facet.
+	token string
+}
+
+// maxEventKinds bounds the kind table. Event names seen after it fills are
+// classified on every call and get Kind zero.
+const maxEventKinds = 4096
+
+// kindTable maps raw event names to kinds. It is never modified once
+// published; additions copy it, so lookups need no lock.
+type kindTable struct {
+	byName map[string]int32
+	kinds  []eventKind
+}
+
+var (
+	eventKindsMu sync.Mutex
+	eventKinds   atomic.Pointer[kindTable]
+)
+
+func init() {
+	// Kind zero is reserved for unregistered events.
+	eventKinds.Store(&kindTable{byName: map[string]int32{}, kinds: make([]eventKind, 1)})
+}
+
+// kindOf returns the kind id and classification for a raw event name.
+func kindOf(name string) (int32, *eventKind) {
+	table := eventKinds.Load()
+	if id, ok := table.byName[name]; ok {
+		return id, &table.kinds[id]
+	}
+
+	kind := classifyEvent(name)
+	eventKindsMu.Lock()
+	defer eventKindsMu.Unlock()
+	table = eventKinds.Load()
+	if id, ok := table.byName[name]; ok {
+		return id, &table.kinds[id]
+	}
+	if len(table.kinds) >= maxEventKinds {
+		return 0, &kind
+	}
+	next := &kindTable{
+		byName: make(map[string]int32, len(table.byName)+1),
+		kinds:  append(table.kinds[:len(table.kinds):len(table.kinds)], kind),
+	}
+	for k, v := range table.byName {
+		next.byName[k] = v
+	}
+	id := int32(len(next.kinds) - 1)
+	next.byName[name] = id
+	eventKinds.Store(next)
+	return id, &next.kinds[id]
+}
+
+// kindByID returns the classification registered under id.
+func kindByID(id int32) *eventKind {
+	return &eventKinds.Load().kinds[id]
+}
+
+func classifyEvent(name string) eventKind {
+	ev := strings.ToLower(strings.TrimSpace(name))
+	var kind eventKind
 	switch ev {
 	case "file.open":
-		return "file", "open", "unix.file", strings.TrimSpace(e.Path)
+		kind = eventKind{family: "file", action: "open", rclass: "unix.file", facet: facetPath}
 	case "file.open:ro":
-		return "file", "open:ro", "unix.file", strings.TrimSpace(e.Path)
+		kind = eventKind{family: "file", action: "open:ro", rclass: "unix.file", facet: facetPath}
 	case "file.open:rw":
-		return "file", "open:rw", "unix.file", strings.TrimSpace(e.Path)
+		kind = eventKind{family: "file", action: "open:rw", rclass: "unix.file", facet: facetPath}
 	case "proc.exec":
 		// Not currently emitted through this path, but keep for symmetry.
-		return "process", "exec", "unix.process", strings.TrimSpace(e.Exe)
+		kind = eventKind{family: "process", action: "exec", rclass: "unix.process", facet: facetExe}
 	case "http.request":
-		host := strings.TrimSpace(e.Addr)
-		if host == "" {
-			host = strings.TrimSpace(e.Server)
-		}
-		return "http", "request", "http.host", host
+		kind = eventKind{family: "http", action: "request", rclass: "http.host", facet: facetHost}
 	default:
 		// Best-effort mapping
 		parts := strings.SplitN(ev, ".", 2)
 		if len(parts) == 2 {
-			return parts[0], parts[1], "resource", ""
+			kind = eventKind{family: parts[0], action: parts[1], rclass: "resource"}
+		} else {
+			kind = eventKind{family: ev, action: "event", rclass: "resource"}
 		}
-		return ev, "event", "resource", ""
 	}
+	kind.token = canonicalTokenPrefix(kind.family, kind.action, kind.rclass)
+	return kind
 }
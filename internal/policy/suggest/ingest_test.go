@@ -1,6 +1,10 @@
 package suggest
 
 import (
+	"fmt"
+	"math/rand"
+	"sort"
+	"strings"
 	"testing"
 	"time"
 
@@ -40,3 +44,213 @@ func TestBuildSequencesFromLogsGroupsByPrincipal(t *testing.T) {
 		t.Fatalf("expected http host resource, got %s", httpSeq.Events[0].ResourceClass)
 	}
 }
+
+// buildSequencesReference is the previous implementation, which re-parsed
+// timestamps inside the sort comparator. It is the oracle for the linear
+// builder.
+func buildSequencesReference(logs []websocket.LogEntry, window time.Duration) []pattern.Sequence {
+	items := append([]websocket.LogEntry(nil), logs...)
+	sort.SliceStable(items, func(i, j int) bool {
+		return referenceTime(items[i].Time).Before(referenceTime(items[j].Time))
+	})
+	type cursor struct {
+		last time.Time
+		seq  pattern.Sequence
+	}
+	byPrincipal := make(map[string]*cursor)
+	out := make([]pattern.Sequence, 0)
+	for _, e := range items {
+		ts := referenceTime(e.Time)
+		principal := principalOf(&e)
+		if principal == "" {
+			continue
+		}
+		cur := byPrincipal[principal]
+		if cur == nil || cur.last.Add(window).Before(ts) {
+			if cur != nil {
+				out = append(out, cur.seq)
+			}
+			cur = &cursor{seq: pattern.Sequence{
+				SessionID: principal + "@" + ts.UTC().Format(time.RFC3339Nano),
+				Principal: principal,
+			}}
+			byPrincipal[principal] = cur
+		}
+		cur.last = ts
+		family, action, rclass, facet := referenceClassify(e)
+		cur.seq.Events = append(cur.seq.Events, pattern.Event{
+			Timestamp:     ts,
+			PrincipalID:   principal,
+			ActionFamily:  family,
+			ActionName:    action,
+			ResourceClass: rclass,
+			ResourceFacet: facet,
+			Outcome:       strings.ToLower(strings.TrimSpace(e.Decision)),
+		})
+	}
+	for _, cur := range byPrincipal {
+		out = append(out, cur.seq)
+	}
+	return out
+}
+
+func referenceTime(raw string) time.Time {
+	if t, err := time.Parse(time.RFC3339Nano, raw); err == nil {
+		return t
+	}
+	return time.Time{}
+}
+
+func referenceClassify(e websocket.LogEntry) (family, action, rclass, facet string) {
+	ev := strings.ToLower(strings.TrimSpace(e.Event))
+	switch ev {
+	case "file.open", "file.open:ro", "file.open:rw":
+		return "file", strings.TrimPrefix(ev, "file."), "unix.file", strings.TrimSpace(e.Path)
+	case "proc.exec":
+		return "process", "exec", "unix.process", strings.TrimSpace(e.Exe)
+	case "http.request":
+		host := strings.TrimSpace(e.Addr)
+		if host == "" {
+			host = strings.TrimSpace(e.Server)
+		}
+		return "http", "request", "http.host", host
+	}
+	parts := strings.SplitN(ev, ".", 2)
+	if len(parts) == 2 {
+		return parts[0], parts[1], "resource", ""
+	}
+	return ev, "event", "resource", ""
+}
+
+// syntheticLogs returns n hub-ordered entries from a handful of principals,
+// with a pause long enough to split sessions every few hundred events.
+func syntheticLogs(n int) []websocket.LogEntry {
+	principals := []string{"claude", "codex", "/usr/bin/git", "/usr/bin/make", "curl"}
+	events := []websocket.LogEntry{
+		{Event: "file.open:ro", Path: "/home/agent/.netrc", Decision: "allowed"},
+		{Event: "file.open:rw", Path: "/workspace/out.txt", Decision: "allowed"},
+		{Event: "http.request", Addr: "api.github.com", Decision: "allowed"},
+		{Event: "proc.exec", Decision: "allowed"},
+		{Event: "net.send", Addr: "10.0.0.1:443", Decision: "Denied "},
+		{Event: "leash.heartbeat"},
+	}
+	base := time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	at := base
+	logs := make([]websocket.LogEntry, n)
+	for i := range logs {
+		at = at.Add(250 * time.Millisecond)
+		if i%512 == 511 {
+			at = at.Add(20 * time.Minute)
+		}
+		entry := events[i%len(events)]
+		if entry.Event != "leash.heartbeat" {
+			entry.Exe = principals[(i/7)%len(principals)]
+		}
+		entry.Seq = uint64(i + 1)
+		if i%3 == 0 {
+			entry.Time = at.Format(time.RFC3339Nano)
+		} else {
+			entry.Time = at.In(time.FixedZone("", -7*3600)).Format(time.RFC3339Nano)
+		}
+		logs[i] = entry
+	}
+	return logs
+}
+
+func sameSequences(t *testing.T, got, want []pattern.Sequence) {
+	t.Helper()
+	byID := func(seqs []pattern.Sequence) {
+		sort.Slice(seqs, func(i, j int) bool { return seqs[i].SessionID < seqs[j].SessionID })
+	}
+	byID(got)
+	byID(want)
+	if len(got) != len(want) {
+		t.Fatalf("got %d sequences, want %d", len(got), len(want))
+	}
+	for i := range want {
+		g, w := got[i], want[i]
+		if g.SessionID != w.SessionID || g.Principal != w.Principal || len(g.Events) != len(w.Events) {
+			t.Fatalf("sequence %d: got %s/%s with %d events, want %s/%s with %d", i, g.SessionID, g.Principal, len(g.Events), w.SessionID, w.Principal, len(w.Events))
+		}
+		for j := range w.Events {
+			ge, we := g.Events[j], w.Events[j]
+			if !ge.Timestamp.Equal(we.Timestamp) || ge.At != we.Timestamp.UnixNano() {
+				t.Fatalf("%s event %d: time %v (at %d), want %v", w.SessionID, j, ge.Timestamp, ge.At, we.Timestamp)
+			}
+			ge.Timestamp, we.Timestamp = time.Time{}, time.Time{}
+			ge.At, ge.Kind = 0, 0
+			if we.Outcome == "" {
+				we.Outcome = "unknown"
+			}
+			if ge != we {
+				t.Fatalf("%s event %d: got %+v, want %+v", w.SessionID, j, ge, we)
+			}
+			if canonicalEventToken(g.Events[j]) != canonicalEventToken(we) {
+				t.Fatalf("token %q differs from unclassified %q", canonicalEventToken(g.Events[j]), canonicalEventToken(we))
+			}
+		}
+	}
+}
+
+func TestBuildSequencesMatchesReference(t *testing.T) {
+	t.Parallel()
+
+	logs := syntheticLogs(5000)
+	sameSequences(t, BuildSequencesFromLogs(logs, 10*time.Minute), buildSequencesReference(logs, 10*time.Minute))
+
+	// Out-of-order input is sorted first.
+	shuffled := append([]websocket.LogEntry(nil), logs...)
+	rand.New(rand.NewSource(7)).Shuffle(len(shuffled), func(i, j int) { shuffled[i], shuffled[j] = shuffled[j], shuffled[i] })
+	sameSequences(t, BuildSequencesFromLogs(shuffled, 10*time.Minute), buildSequencesReference(shuffled, 10*time.Minute))
+}
+
+func TestParseUnixNanoMatchesTimeParse(t *testing.T) {
+	t.Parallel()
+
+	for _, raw := range []string{
+		"2025-10-11T15:04:05Z",
+		"2025-10-11T15:04:05.5Z",
+		"2025-10-11T15:04:05.123456789Z",
+		"2025-10-11T15:04:05-07:00",
+		"2025-10-11T15:04:05.25+05:30",
+		"2024-02-29T23:59:59Z",
+		"2025-10-11T15:04:05.1234567891Z",
+		"2025-10-11 15:04:05Z",
+	} {
+		want, err := time.Parse(time.RFC3339Nano, raw)
+		if err != nil {
+			if got := parseUnixNano(raw); got != 0 {
+				t.Fatalf("%s: expected 0 for an unparseable timestamp, got %d", raw, got)
+			}
+			continue
+		}
+		if got := parseUnixNano(raw); got != want.UnixNano() {
+			t.Fatalf("%s: got %d, want %d", raw, got, want.UnixNano())
+		}
+	}
+	for _, raw := range []string{"", "2025-02-30T00:00:00Z", "2025-10-11T24:00:00Z", "2025-10-11T15:04:05", "garbage"} {
+		if got := parseUnixNano(raw); got != 0 {
+			t.Fatalf("%q: expected 0, got %d", raw, got)
+		}
+	}
+}
+
+func benchmarkBuildSequences(b *testing.B, n int, build func([]websocket.LogEntry, time.Duration) []pattern.Sequence) {
+	logs := syntheticLogs(n)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		build(logs, 10*time.Minute)
+	}
+}
+
+func BenchmarkBuildSequencesFromLogs(b *testing.B) {
+	for _, n := range []int{10_000, 1_000_000} {
+		b.Run(fmt.Sprintf("events=%d", n), func(b *testing.B) {
+			benchmarkBuildSequences(b, n, BuildSequencesFromLogs)
+		})
+		b.Run(fmt.Sprintf("reference/events=%d", n), func(b *testing.B) {
+			benchmarkBuildSequences(b, n, buildSequencesReference)
+		})
+	}
+}
@@ -1,6 +1,9 @@
 package suggest
 
-import "time"
+import (
+	"runtime"
+	"time"
+)
 
 // Options controls thresholds and knobs for generating mechanical suggestions.
 type Options struct {
@@ -32,9 +35,16 @@ type Options struct {
 	// constructing trace sequences.
 	SessionWindow time.Duration
 
-	// DriftThreshold determines when PSI drift detection should flag a cluster.
+	// DriftThreshold determines when PSI drift detection should flag a cluster,
+	// and when the streaming engine's live drift monitor raises an alert.
 	DriftThreshold float64
 
+	// DriftCurrentHalfLife and DriftReferenceHalfLife set how quickly the
+	// streaming drift monitor's current and reference windows forget. Zero
+	// uses the drift package defaults.
+	DriftCurrentHalfLife   time.Duration
+	DriftReferenceHalfLife time.Duration
+
 	// TailLimit bounds the number of ring buffer events ingested per analysis
 	// run. A value <= 0 means inspect the entire buffer.
 	TailLimit int
@@ -44,6 +54,10 @@ type Options struct {
 
 	// MinClusterSize filters clusters with too few member sessions.
 	MinClusterSize int
+
+	// Workers bounds how many workflow clusters are mined concurrently.
+	// Zero uses GOMAXPROCS.
+	Workers int
 }
 
 // DefaultOptions returns a conservative set of thresholds suitable for initial
@@ -64,3 +78,45 @@ func DefaultOptions() Options {
 		MinClusterSize:     2,
 	}
 }
+
+// withDefaults fills unset thresholds from DefaultOptions.
+func (opts Options) withDefaults() Options {
+	defaults := DefaultOptions()
+	if opts.MinDirectoryGroup <= 0 {
+		opts.MinDirectoryGroup = defaults.MinDirectoryGroup
+	}
+	if opts.MinDomainGroup <= 0 {
+		opts.MinDomainGroup = defaults.MinDomainGroup
+	}
+	if opts.MinHTTPGroup <= 0 {
+		opts.MinHTTPGroup = defaults.MinHTTPGroup
+	}
+	if opts.MinSequenceSupport <= 0 {
+		opts.MinSequenceSupport = defaults.MinSequenceSupport
+	}
+	if opts.MaxSequenceLength <= 0 {
+		opts.MaxSequenceLength = defaults.MaxSequenceLength
+	}
+	if opts.ClusterSimilarity <= 0 {
+		opts.ClusterSimilarity = defaults.ClusterSimilarity
+	}
+	if opts.SessionWindow <= 0 {
+		opts.SessionWindow = defaults.SessionWindow
+	}
+	if opts.DriftThreshold <= 0 {
+		opts.DriftThreshold = defaults.DriftThreshold
+	}
+	if opts.TailLimit == 0 {
+		opts.TailLimit = defaults.TailLimit
+	}
+	if opts.MaxClusters <= 0 {
+		opts.MaxClusters = defaults.MaxClusters
+	}
+	if opts.MinClusterSize <= 0 {
+		opts.MinClusterSize = defaults.MinClusterSize
+	}
+	if opts.Workers <= 0 {
+		opts.Workers = runtime.GOMAXPROCS(0)
+	}
+	return opts
+}
@@ -0,0 +1,98 @@
+package suggest
+
+import (
+	"context"
+	"sort"
+	"time"
+)
+
+// workflowPass produces ranked workflow suggestions. The bool is false when
+// ctx ended before the pass finished.
+type workflowPass func(ctx context.Context) ([]Suggestion, bool)
+
+type analysisPass struct {
+	name string
+	run  func(ctx context.Context) ([]Suggestion, bool)
+}
+
+type passResult struct {
+	index       int
+	suggestions []Suggestion
+	complete    bool
+	duration    time.Duration
+}
+
+// runPasses runs the rule-based passes over inputs and the workflow pass
+// concurrently and merges what they return. observed may be nil. Passes still running when ctx
+// ends are abandoned: their results are dropped and the Result is Partial.
+// Every pass checks ctx, so abandoned passes stop soon after.
+func runPasses(ctx context.Context, inputs Inputs, observed *activity, workflows workflowPass, opts Options) Result {
+	passes := make([]analysisPass, 0, 4)
+	if inputs.LSMPolicies != nil {
+		passes = append(passes,
+			analysisPass{name: "directory", run: func(ctx context.Context) ([]Suggestion, bool) {
+				return directorySuggestions(ctx, inputs.LSMPolicies, observed, opts)
+			}},
+			analysisPass{name: "domain", run: func(ctx context.Context) ([]Suggestion, bool) {
+				return domainSuggestions(ctx, inputs.LSMPolicies, observed, opts)
+			}},
+		)
+	}
+	if len(inputs.HTTPRewrites) > 0 {
+		passes = append(passes, analysisPass{name: "http", run: func(ctx context.Context) ([]Suggestion, bool) {
+			return httpSuggestions(ctx, inputs.HTTPRewrites, opts)
+		}})
+	}
+	if workflows != nil {
+		passes = append(passes, analysisPass{name: "workflow", run: workflows})
+	}
+
+	started := time.Now()
+	results := make(chan passResult, len(passes))
+	for i, pass := range passes {
+		go func(i int, pass analysisPass) {
+			begin := time.Now()
+			suggestions, complete := pass.run(ctx)
+			results <- passResult{index: i, suggestions: suggestions, complete: complete, duration: time.Since(begin)}
+		}(i, pass)
+	}
+
+	byPass := make([]*passResult, len(passes))
+	expired := false
+	for received := 0; received < len(passes) && !expired; {
+		select {
+		case r := <-results:
+			byPass[r.index] = &r
+			received++
+		case <-ctx.Done():
+			expired = true
+		}
+	}
+
+	result := Result{
+		Suggestions: make([]Suggestion, 0),
+		Timings:     make([]PassTiming, len(passes)),
+	}
+	for i, pass := range passes {
+		r := byPass[i]
+		if r == nil {
+			result.Partial = true
+			result.Timings[i] = PassTiming{Pass: pass.name, Duration: time.Since(started)}
+			continue
+		}
+		if !r.complete {
+			result.Partial = true
+		}
+		result.Timings[i] = PassTiming{Pass: pass.name, Duration: r.duration, Completed: r.complete}
+		result.Suggestions = append(result.Suggestions, r.suggestions...)
+	}
+
+	suggestions := result.Suggestions
+	sort.SliceStable(suggestions, func(i, j int) bool {
+		if suggestions[i].Kind == suggestions[j].Kind {
+			return suggestions[i].PolicyCount > suggestions[j].PolicyCount
+		}
+		return suggestions[i].Kind < suggestions[j].Kind
+	})
+	return result
+}
@@ -1,15 +1,29 @@
 package pattern
 
 import (
+	"log"
+	"math/bits"
+	"runtime"
 	"sort"
 	"strings"
+	"sync"
 	"time"
 )
 
+// maxSpanLimit caps MaxSpan so every event a pattern may start at fits in one
+// 64-bit mask per target occurrence.
+const maxSpanLimit = 63
+
 // Event represents a single action within an agent session after feature
 // enrichment. Only the fields required for prototype mining are included.
 type Event struct {
-	Timestamp     time.Time
+	Timestamp time.Time
+	// At is Timestamp in Unix nanoseconds, zero when unknown, so ordering and
+	// gap checks compare integers.
+	At int64
+	// Kind identifies the (ActionFamily, ActionName, ResourceClass) triple as
+	// classified at ingestion; zero when the event was not classified there.
+	Kind          int32
 	PrincipalID   string
 	ActionFamily  string
 	ActionName    string
@@ -30,9 +44,10 @@ type Sequence struct {
 type MinerConfig struct {
 	TargetActions []string
 	MinSupport    int
-	MaxSpan       int // maximum number of preceding events considered
+	MaxSpan       int // maximum number of preceding events considered (at most 63)
 	MaxGap        int // maximum index gap between consecutive tokens
 	MaxLength     int // maximum length of mined pattern (including target)
+	Workers       int // goroutines mining in parallel; zero uses GOMAXPROCS
 }
 
 // Pattern captures a mined workflow motif.
@@ -55,7 +70,16 @@ func DefaultConfig() MinerConfig {
 }
 
 // Mine discovers frequent sequences that terminate in any target action.
+// Support counts distinct session IDs, so sequences sharing an ID count once.
 // Sequences are returned sorted by descending support.
+//
+// Patterns are grown backwards from each target, PrefixSpan style, over
+// sequences of interned token ids. Each pattern keeps a projected database:
+// for every target occurrence that ends it, a bitmask of the positions the
+// pattern can start at. Prepending a token only inspects the events reachable
+// from those positions, and support only shrinks as a pattern grows, so
+// infrequent branches are cut without enumerating their extensions. Branches
+// under different targets are mined in parallel.
 func Mine(seqs []Sequence, cfg MinerConfig) []Pattern {
 	if cfg.MinSupport <= 0 {
 		cfg.MinSupport = 2
@@ -63,6 +87,10 @@ func Mine(seqs []Sequence, cfg MinerConfig) []Pattern {
 	if cfg.MaxSpan <= 0 {
 		cfg.MaxSpan = 5
 	}
+	if cfg.MaxSpan > maxSpanLimit {
+		log.Printf("pattern: MaxSpan %d exceeds the supported %d; mining with %d", cfg.MaxSpan, maxSpanLimit, maxSpanLimit)
+		cfg.MaxSpan = maxSpanLimit
+	}
 	if cfg.MaxGap <= 0 {
 		cfg.MaxGap = cfg.MaxSpan
 	}
@@ -72,166 +100,365 @@ func Mine(seqs []Sequence, cfg MinerConfig) []Pattern {
 	if len(cfg.TargetActions) == 0 {
 		cfg.TargetActions = []string{"connect"}
 	}
+	if cfg.Workers <= 0 {
+		cfg.Workers = runtime.GOMAXPROCS(0)
+	}
 
 	targetSet := make(map[string]struct{}, len(cfg.TargetActions))
 	for _, t := range cfg.TargetActions {
 		targetSet[strings.ToLower(strings.TrimSpace(t))] = struct{}{}
 	}
 
-	type stats struct {
-		count    int
-		sessions map[string]struct{}
-		target   string
+	db := newTokenDB(seqs, targetSet)
+	roots := db.roots(cfg.MinSupport)
+	if len(roots) == 0 {
+		return []Pattern{}
 	}
-	patterns := make(map[string]*stats)
+	// Bigger branches first so one large target does not finish last.
+	sort.Slice(roots, func(i, j int) bool {
+		return len(roots[i].entries) > len(roots[j].entries)
+	})
 
-	for _, seq := range seqs {
-		if len(seq.Events) == 0 {
-			continue
-		}
-		tokens := canonicalTokens(seq.Events)
-		indexedTargets := targetIndexes(seq.Events, targetSet)
-		if len(indexedTargets) == 0 {
-			continue
+	workers := cfg.Workers
+	if workers > len(roots) {
+		workers = len(roots)
+	}
+	results := make([][]minedPattern, workers)
+	if workers <= 1 {
+		m := newMiner(db, cfg)
+		for _, root := range roots {
+			m.mine(root)
 		}
-		seenInSession := make(map[string]struct{})
-
-		for _, ti := range indexedTargets {
-			targetToken := tokens[ti]
-			candidates := candidateIndexes(ti, len(tokens), cfg)
-			path := make([]int, 0, cfg.MaxLength-1)
-			emit := func(idxs []int) {
-				full := append([]int{}, idxs...)
-				full = append(full, ti)
-				if len(full) == 0 || len(full) > cfg.MaxLength {
-					return
+		results[0] = m.out
+	} else {
+		work := make(chan projectedGroup)
+		var wg sync.WaitGroup
+		for w := 0; w < workers; w++ {
+			wg.Add(1)
+			go func(w int) {
+				defer wg.Done()
+				m := newMiner(db, cfg)
+				for root := range work {
+					m.mine(root)
 				}
-				if ti-full[0] > cfg.MaxSpan {
-					return
-				}
-				for i := 1; i < len(full); i++ {
-					if full[i]-full[i-1] > cfg.MaxGap {
-						return
-					}
-				}
-				patternTokens := make([]string, len(full))
-				for i, idx := range full {
-					patternTokens[i] = tokens[idx]
-				}
-				key := strings.Join(patternTokens, " -> ")
-				if _, exists := seenInSession[key]; exists {
-					return
-				}
-				seenInSession[key] = struct{}{}
-				rec := patterns[key]
-				if rec == nil {
-					rec = &stats{
-						sessions: make(map[string]struct{}),
-						target:   targetToken,
-					}
-					patterns[key] = rec
-				}
-				rec.count++
-				rec.sessions[seq.SessionID] = struct{}{}
-			}
-
-			emit(nil) // bare target
-			backtrack(candidates, path, emit, cfg.MaxLength-1)
+				results[w] = m.out
+			}(w)
+		}
+		for _, root := range roots {
+			work <- root
 		}
+		close(work)
+		wg.Wait()
 	}
 
-	out := make([]Pattern, 0, len(patterns))
-	for key, stat := range patterns {
-		if stat.count < cfg.MinSupport {
-			continue
-		}
-		sessionIDs := make([]string, 0, len(stat.sessions))
-		for id := range stat.sessions {
-			sessionIDs = append(sessionIDs, id)
+	total := 0
+	for _, r := range results {
+		total += len(r)
+	}
+	out := make([]Pattern, 0, total)
+	keys := make([]string, 0, total)
+	for _, r := range results {
+		for _, mp := range r {
+			p := db.pattern(mp)
+			out = append(out, p)
+			keys = append(keys, strings.Join(p.Tokens, " -> "))
 		}
-		sort.Strings(sessionIDs)
-		tokens := strings.Split(key, " -> ")
-		out = append(out, Pattern{
-			Tokens:       tokens,
-			Support:      stat.count,
-			Sessions:     sessionIDs,
-			TargetAction: stat.target,
-		})
 	}
 
-	sort.SliceStable(out, func(i, j int) bool {
-		if out[i].Support == out[j].Support {
-			return strings.Join(out[i].Tokens, " -> ") < strings.Join(out[j].Tokens, " -> ")
+	order := make([]int, len(out))
+	for i := range order {
+		order[i] = i
+	}
+	sort.Slice(order, func(i, j int) bool {
+		a, b := order[i], order[j]
+		if out[a].Support == out[b].Support {
+			return keys[a] < keys[b]
 		}
-		return out[i].Support > out[j].Support
+		return out[a].Support > out[b].Support
 	})
+	sorted := make([]Pattern, len(out))
+	for i, idx := range order {
+		sorted[i] = out[idx]
+	}
+	return sorted
+}
 
-	return out
+// tokenDB holds the sequences as interned canonical tokens. Sequences that
+// share a session ID are stored next to each other, and sessions[i] numbers
+// the session of seqs[i].
+type tokenDB struct {
+	vocab    []string
+	isTarget []bool
+	seqs     [][]int32
+	ids      []string
+	sessions []int32
 }
 
-func canonicalTokens(events []Event) []string {
-	out := make([]string, len(events))
-	for i, evt := range events {
-		family := strings.ToLower(evt.ActionFamily)
-		if family == "" {
-			family = "unknown"
+type eventKey struct {
+	family, action, resource, facet string
+}
+
+func newTokenDB(seqs []Sequence, targets map[string]struct{}) *tokenDB {
+	db := &tokenDB{
+		seqs:     make([][]int32, 0, len(seqs)),
+		ids:      make([]string, 0, len(seqs)),
+		sessions: make([]int32, 0, len(seqs)),
+	}
+	// Group sequences by session, in order of first appearance, so projected
+	// databases see each session's sequences contiguously.
+	sessionIndex := make(map[string]int, len(seqs))
+	var bySession [][]int
+	for i, seq := range seqs {
+		if len(seq.Events) == 0 {
+			continue
 		}
-		action := strings.ToLower(evt.ActionName)
-		if action == "" {
-			action = "unknown"
+		idx, ok := sessionIndex[seq.SessionID]
+		if !ok {
+			idx = len(bySession)
+			sessionIndex[seq.SessionID] = idx
+			bySession = append(bySession, nil)
 		}
-		resource := strings.ToLower(evt.ResourceClass)
-		if resource == "" {
-			resource = "resource"
+		bySession[idx] = append(bySession[idx], i)
+	}
+
+	// Raw field tuples repeat heavily; only the first sighting pays for
+	// lowercasing and joining.
+	byKey := make(map[eventKey]int32)
+	byToken := make(map[string]int32)
+	for session, members := range bySession {
+		for _, i := range members {
+			seq := seqs[i]
+			toks := make([]int32, len(seq.Events))
+			for j, evt := range seq.Events {
+				key := eventKey{evt.ActionFamily, evt.ActionName, evt.ResourceClass, evt.ResourceFacet}
+				id, ok := byKey[key]
+				if !ok {
+					token := canonicalToken(evt)
+					id, ok = byToken[token]
+					if !ok {
+						id = int32(len(db.vocab))
+						byToken[token] = id
+						db.vocab = append(db.vocab, token)
+						_, target := targets[strings.ToLower(evt.ActionName)]
+						db.isTarget = append(db.isTarget, target)
+					}
+					byKey[key] = id
+				}
+				toks[j] = id
+			}
+			db.seqs = append(db.seqs, toks)
+			db.ids = append(db.ids, seq.SessionID)
+			db.sessions = append(db.sessions, int32(session))
 		}
-		facet := strings.ToLower(evt.ResourceFacet)
-		if facet == "" {
-			facet = "*"
+	}
+	return db
+}
+
+// projection is one target occurrence supporting a pattern. Bit d of firsts
+// is set when the pattern can start d events before the target.
+type projection struct {
+	seq    int32
+	target int32
+	firsts uint64
+}
+
+// projectedGroup is a pattern's projected database. Entries are ordered by
+// sequence, and a session's sequences are contiguous, so support is counted
+// without a per-pattern session set.
+type projectedGroup struct {
+	token       int32
+	entries     []projection
+	support     int
+	lastSession int32 // session+1 of the newest entry, zero when empty
+}
+
+func (g *projectedGroup) add(seq, session, target int32, bit uint64) {
+	if n := len(g.entries); n > 0 && g.entries[n-1].seq == seq && g.entries[n-1].target == target {
+		g.entries[n-1].firsts |= bit
+		return
+	}
+	g.entries = append(g.entries, projection{seq: seq, target: target, firsts: bit})
+	if g.lastSession != session+1 {
+		g.lastSession = session + 1
+		g.support++
+	}
+}
+
+// roots returns the single-token patterns, one per frequent target token.
+func (db *tokenDB) roots(minSupport int) []projectedGroup {
+	index := make(map[int32]int)
+	groups := make([]projectedGroup, 0)
+	for s, toks := range db.seqs {
+		for i, tok := range toks {
+			if !db.isTarget[tok] {
+				continue
+			}
+			idx, ok := index[tok]
+			if !ok {
+				idx = len(groups)
+				index[tok] = idx
+				groups = append(groups, projectedGroup{token: tok})
+			}
+			groups[idx].add(int32(s), db.sessions[s], int32(i), 1)
+		}
+	}
+	out := groups[:0]
+	for _, g := range groups {
+		if g.support >= minSupport {
+			out = append(out, g)
 		}
-		out[i] = strings.Join([]string{family, action, resource, facet}, ":")
 	}
 	return out
 }
 
-func targetIndexes(events []Event, targets map[string]struct{}) []int {
-	indexes := make([]int, 0)
-	for i, evt := range events {
-		if _, ok := targets[strings.ToLower(evt.ActionName)]; ok {
-			indexes = append(indexes, i)
+type minedPattern struct {
+	tokens  []int32
+	support int
+	seqs    []int32
+}
+
+func (db *tokenDB) pattern(mp minedPattern) Pattern {
+	tokens := make([]string, len(mp.tokens))
+	for i, tok := range mp.tokens {
+		tokens[i] = db.vocab[tok]
+	}
+	sessions := make([]string, 0, len(mp.seqs))
+	for _, s := range mp.seqs {
+		sessions = append(sessions, db.ids[s])
+	}
+	sort.Strings(sessions)
+	uniq := sessions[:0]
+	for i, id := range sessions {
+		if i > 0 && id == sessions[i-1] {
+			continue
 		}
+		uniq = append(uniq, id)
+	}
+	return Pattern{
+		Tokens:       tokens,
+		Support:      mp.support,
+		Sessions:     uniq,
+		TargetAction: tokens[len(tokens)-1],
 	}
-	return indexes
 }
 
-func candidateIndexes(targetIdx int, total int, cfg MinerConfig) []int {
-	minIdx := targetIdx - cfg.MaxSpan
-	if minIdx < 0 {
-		minIdx = 0
+// miner grows patterns depth first. Each depth owns scratch space that is
+// reused across siblings, so a branch allocates only for what it emits.
+type miner struct {
+	db       *tokenDB
+	cfg      MinerConfig
+	spanMask uint64
+	levels   []minerLevel
+	suffix   []int32
+	out      []minedPattern
+}
+
+type minerLevel struct {
+	slot   map[int32]int
+	groups []projectedGroup
+}
+
+func newMiner(db *tokenDB, cfg MinerConfig) *miner {
+	m := &miner{
+		db:       db,
+		cfg:      cfg,
+		spanMask: uint64(1)<<(cfg.MaxSpan+1) - 1,
+		levels:   make([]minerLevel, cfg.MaxLength),
+		suffix:   make([]int32, 0, cfg.MaxLength),
 	}
-	candidates := make([]int, 0, cfg.MaxSpan)
-	for i := minIdx; i < targetIdx; i++ {
-		candidates = append(candidates, i)
+	for i := range m.levels {
+		m.levels[i].slot = make(map[int32]int)
 	}
-	return candidates
+	return m
 }
 
-func backtrack(candidates []int, path []int, emit func([]int), depth int) {
-	if depth == 0 {
+func (m *miner) mine(root projectedGroup) {
+	m.suffix = append(m.suffix[:0], root.token)
+	m.grow(root.entries, root.support, 0)
+}
+
+// grow emits the pattern in m.suffix (stored target first) and recurses into
+// every frequent one-token extension to its left.
+func (m *miner) grow(entries []projection, support int, depth int) {
+	m.emit(entries, support)
+	if len(m.suffix) >= m.cfg.MaxLength {
 		return
 	}
-	start := 0
-	if len(path) > 0 {
-		last := path[len(path)-1]
-		for start < len(candidates) && candidates[start] <= last {
-			start++
+
+	lv := &m.levels[depth]
+	for _, p := range entries {
+		reach := uint64(0)
+		for g := 1; g <= m.cfg.MaxGap; g++ {
+			reach |= p.firsts << g
+		}
+		reach &= m.spanMask
+		if p.target < maxSpanLimit {
+			reach &= uint64(1)<<(p.target+1) - 1
+		}
+		toks := m.db.seqs[p.seq]
+		for reach != 0 {
+			d := bits.TrailingZeros64(reach)
+			reach &= reach - 1
+			tok := toks[int(p.target)-d]
+			idx, ok := lv.slot[tok]
+			if !ok {
+				idx = len(lv.groups)
+				lv.slot[tok] = idx
+				if idx < cap(lv.groups) {
+					lv.groups = lv.groups[:idx+1]
+					g := &lv.groups[idx]
+					*g = projectedGroup{token: tok, entries: g.entries[:0]}
+				} else {
+					lv.groups = append(lv.groups, projectedGroup{token: tok})
+				}
+			}
+			lv.groups[idx].add(p.seq, m.db.sessions[p.seq], p.target, uint64(1)<<d)
+		}
+	}
+
+	for i := range lv.groups {
+		g := &lv.groups[i]
+		if g.support < m.cfg.MinSupport {
+			continue
+		}
+		m.suffix = append(m.suffix, g.token)
+		m.grow(g.entries, g.support, depth+1)
+		m.suffix = m.suffix[:len(m.suffix)-1]
+	}
+	clear(lv.slot)
+	lv.groups = lv.groups[:0]
+}
+
+func (m *miner) emit(entries []projection, support int) {
+	tokens := make([]int32, len(m.suffix))
+	for i, tok := range m.suffix {
+		tokens[len(tokens)-1-i] = tok
+	}
+	seqs := make([]int32, 0, support)
+	for _, p := range entries {
+		if n := len(seqs); n == 0 || seqs[n-1] != p.seq {
+			seqs = append(seqs, p.seq)
 		}
 	}
-	for i := start; i < len(candidates); i++ {
-		path = append(path, candidates[i])
-		tmp := make([]int, len(path))
-		copy(tmp, path)
-		emit(tmp)
-		backtrack(candidates, path, emit, depth-1)
-		path = path[:len(path)-1]
+	m.out = append(m.out, minedPattern{tokens: tokens, support: support, seqs: seqs})
+}
+
+func canonicalToken(evt Event) string {
+	family := strings.ToLower(evt.ActionFamily)
+	if family == "" {
+		family = "unknown"
+	}
+	action := strings.ToLower(evt.ActionName)
+	if action == "" {
+		action = "unknown"
+	}
+	resource := strings.ToLower(evt.ResourceClass)
+	if resource == "" {
+		resource = "resource"
+	}
+	facet := strings.ToLower(evt.ResourceFacet)
+	if facet == "" {
+		facet = "*"
 	}
+	return strings.Join([]string{family, action, resource, facet}, ":")
 }
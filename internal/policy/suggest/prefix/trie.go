@@ -0,0 +1,266 @@
+// Package prefix indexes paths and host names in compressed tries so callers
+// can find the tightest prefix covering a group of them and count what falls
+// under any prefix.
+package prefix
+
+import (
+	"sort"
+	"strings"
+)
+
+// Trie is a compressed trie over label sequences: path components for file
+// paths, reversed labels for host names. Chains of nodes with one child and
+// no key of their own are merged into a single edge, so the depth of a walk
+// is bounded by the branching in the data rather than by key length.
+//
+// Every key carries a weight, such as the number of rules or events that
+// named it, and every node keeps the key count and total weight beneath it,
+// so Stats is a single walk. Weights can be lowered again, which lets a
+// sliding window retire old events.
+//
+// A Trie is not safe for concurrent use.
+type Trie struct {
+	split func(string) []string
+	join  func([]string) string
+	root  *node
+}
+
+type node struct {
+	// edge is the run of labels leading to this node from its parent.
+	edge     []string
+	children map[string]*node
+	// weight is the node's own weight; a node with positive weight is a key.
+	weight int
+
+	keys  int
+	total int
+}
+
+// Stats counts the keys under a prefix and their total weight.
+type Stats struct {
+	Keys   int
+	Weight int
+}
+
+// Cover is a prefix proposed to stand in for a group of keys.
+type Cover struct {
+	Prefix string
+	// Depth is the number of labels in Prefix.
+	Depth int
+	// Keys are the keys this cover claims, in order, and Weight is their
+	// total weight. Keys already claimed by a tighter cover are excluded.
+	Keys   []string
+	Weight int
+	// All counts every key under Prefix, claimed by this cover or not.
+	All Stats
+}
+
+// NewPathTrie returns a trie over slash-separated paths. Empty components are
+// ignored, so "/etc//ssh/" and "/etc/ssh" are the same key.
+func NewPathTrie() *Trie {
+	return &Trie{
+		split: func(s string) []string {
+			return strings.FieldsFunc(s, func(r rune) bool { return r == '/' })
+		},
+		join: func(labels []string) string {
+			return "/" + strings.Join(labels, "/")
+		},
+		root: &node{},
+	}
+}
+
+// NewDomainTrie returns a trie over host names, indexed from the top-level
+// label down so that subdomains share a prefix. Names are matched case
+// insensitively and a leading "*." is ignored.
+func NewDomainTrie() *Trie {
+	return &Trie{
+		split: func(s string) []string {
+			s = strings.TrimPrefix(strings.ToLower(strings.TrimSpace(s)), "*.")
+			labels := strings.FieldsFunc(s, func(r rune) bool { return r == '.' })
+			for i, j := 0, len(labels)-1; i < j; i, j = i+1, j-1 {
+				labels[i], labels[j] = labels[j], labels[i]
+			}
+			return labels
+		},
+		join: func(labels []string) string {
+			out := make([]string, len(labels))
+			for i, l := range labels {
+				out[len(labels)-1-i] = l
+			}
+			return strings.Join(out, ".")
+		},
+		root: &node{},
+	}
+}
+
+// Canonical returns key in the form Covers reports keys in.
+func (t *Trie) Canonical(key string) string {
+	return t.join(t.split(key))
+}
+
+// Len reports the number of keys.
+func (t *Trie) Len() int {
+	return t.root.keys
+}
+
+// Add changes the weight of key by delta, inserting it when it is new and
+// removing it once its weight drops to zero or below. Keys with no labels are
+// ignored.
+func (t *Trie) Add(key string, delta int) {
+	labels := t.split(key)
+	if len(labels) == 0 || delta == 0 {
+		return
+	}
+	path := []*node{t.root}
+	n := t.root
+	for len(labels) > 0 {
+		child := n.children[labels[0]]
+		if child == nil {
+			if delta < 0 {
+				return
+			}
+			child = &node{edge: append([]string(nil), labels...)}
+			if n.children == nil {
+				n.children = make(map[string]*node)
+			}
+			n.children[labels[0]] = child
+			path = append(path, child)
+			n, labels = child, nil
+			break
+		}
+		common := commonPrefix(child.edge, labels)
+		if common < len(child.edge) {
+			if delta < 0 {
+				return
+			}
+			child = n.split(child, common)
+		}
+		path = append(path, child)
+		n, labels = child, labels[common:]
+	}
+
+	before := n.weight
+	after := before + delta
+	if after < 0 {
+		after = 0
+	}
+	n.weight = after
+	keyDelta := 0
+	switch {
+	case before == 0 && after > 0:
+		keyDelta = 1
+	case before > 0 && after == 0:
+		keyDelta = -1
+	}
+	for _, p := range path {
+		p.keys += keyDelta
+		p.total += after - before
+	}
+	if after == 0 {
+		t.prune(path)
+	}
+}
+
+// split breaks child's edge after common labels, inserting and returning the
+// node for the shared part.
+func (n *node) split(child *node, common int) *node {
+	mid := &node{
+		edge:     child.edge[:common:common],
+		children: map[string]*node{child.edge[common]: child},
+		keys:     child.keys,
+		total:    child.total,
+	}
+	child.edge = child.edge[common:]
+	n.children[mid.edge[0]] = mid
+	return mid
+}
+
+// prune removes nodes left without keys along path and re-merges a node left
+// with a single child and no weight of its own.
+func (t *Trie) prune(path []*node) {
+	for i := len(path) - 1; i > 0; i-- {
+		n, parent := path[i], path[i-1]
+		switch {
+		case n.weight == 0 && len(n.children) == 0:
+			delete(parent.children, n.edge[0])
+		case n.weight == 0 && len(n.children) == 1:
+			for _, only := range n.children {
+				only.edge = append(append([]string(nil), n.edge...), only.edge...)
+				parent.children[n.edge[0]] = only
+			}
+		}
+	}
+}
+
+// Stats counts the keys equal to or under prefix.
+func (t *Trie) Stats(prefix string) Stats {
+	labels := t.split(prefix)
+	n := t.root
+	for len(labels) > 0 {
+		child := n.children[labels[0]]
+		if child == nil {
+			return Stats{}
+		}
+		common := commonPrefix(child.edge, labels)
+		if common < len(labels) && common < len(child.edge) {
+			return Stats{}
+		}
+		n, labels = child, labels[common:]
+	}
+	return Stats{Keys: n.keys, Weight: n.total}
+}
+
+// Covers proposes the tightest prefixes that each stand in for at least
+// minKeys keys with a combined weight of at least minWeight. The trie is
+// walked bottom-up: a node becomes a cover as soon as the keys beneath it not
+// yet claimed by a deeper cover meet both minimums, and it claims them. Only
+// prefixes with at least minDepth labels are proposed. Covers come out in
+// key order of their prefixes, deepest first within a subtree.
+func (t *Trie) Covers(minKeys, minWeight, minDepth int) []Cover {
+	var out []Cover
+	var labels []string
+	var walk func(n *node) ([]string, int)
+	walk = func(n *node) ([]string, int) {
+		labels = append(labels, n.edge...)
+		defer func() { labels = labels[:len(labels)-len(n.edge)] }()
+
+		var keys []string
+		weight := 0
+		if n.weight > 0 {
+			keys = append(keys, t.join(labels))
+			weight = n.weight
+		}
+		firsts := make([]string, 0, len(n.children))
+		for first := range n.children {
+			firsts = append(firsts, first)
+		}
+		sort.Strings(firsts)
+		for _, first := range firsts {
+			childKeys, childWeight := walk(n.children[first])
+			keys = append(keys, childKeys...)
+			weight += childWeight
+		}
+
+		if len(labels) >= minDepth && len(keys) >= minKeys && weight >= minWeight {
+			out = append(out, Cover{
+				Prefix: t.join(labels),
+				Depth:  len(labels),
+				Keys:   keys,
+				Weight: weight,
+				All:    Stats{Keys: n.keys, Weight: n.total},
+			})
+			return nil, 0
+		}
+		return keys, weight
+	}
+	walk(t.root)
+	return out
+}
+
+func commonPrefix(a, b []string) int {
+	i := 0
+	for i < len(a) && i < len(b) && a[i] == b[i] {
+		i++
+	}
+	return i
+}
@@ -0,0 +1,125 @@
+package prefix
+
+import (
+	"fmt"
+	"math/rand"
+	"strings"
+	"testing"
+)
+
+func TestCoversPicksTightestPrefixes(t *testing.T) {
+	t.Parallel()
+
+	trie := NewPathTrie()
+	for _, p := range []string{
+		"/etc/ssh/sshd_config",
+		"/etc/ssh/ssh_config",
+		"/etc/ssh/ssh_known_hosts",
+		"/etc/hosts",
+		"/home/agent/src/a/main.go",
+		"/home/agent/src/b/util.go",
+		"/home/agent/.netrc",
+	} {
+		trie.Add(p, 1)
+	}
+
+	covers := trie.Covers(2, 2, 1)
+	got := make([]string, 0, len(covers))
+	for _, c := range covers {
+		got = append(got, fmt.Sprintf("%s=%d/%d", c.Prefix, len(c.Keys), c.All.Keys))
+	}
+	// /etc/ssh claims its three files, which leaves /etc/hosts alone under
+	// /etc. /home/agent/src claims two, and /home/agent gathers .netrc with
+	// nothing else, so it is not proposed.
+	want := []string{"/etc/ssh=3/3", "/home/agent/src=2/2"}
+	if fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Fatalf("got %v, want %v", got, want)
+	}
+
+	domains := NewDomainTrie()
+	for _, h := range []string{"api.openai.com", "files.openai.com", "cdn.OpenAI.com", "github.com", "api.github.com"} {
+		domains.Add(h, 1)
+	}
+	covers = domains.Covers(2, 2, 2)
+	if len(covers) != 2 || covers[0].Prefix != "github.com" || covers[1].Prefix != "openai.com" || len(covers[1].Keys) != 3 {
+		t.Fatalf("unexpected domain covers: %+v", covers)
+	}
+	if s := domains.Stats("*.openai.com"); s.Keys != 3 || s.Weight != 3 {
+		t.Fatalf("unexpected stats: %+v", s)
+	}
+}
+
+// TestTrieMatchesFlatIndex checks inserts, removals and prefix counts against
+// a plain map under a random workload, including re-merging after removals.
+func TestTrieMatchesFlatIndex(t *testing.T) {
+	t.Parallel()
+
+	rng := rand.New(rand.NewSource(3))
+	parts := []string{"a", "b", "c", "usr", "lib"}
+	randomPath := func() string {
+		n := 1 + rng.Intn(4)
+		labels := make([]string, n)
+		for i := range labels {
+			labels[i] = parts[rng.Intn(len(parts))]
+		}
+		return "/" + strings.Join(labels, "/")
+	}
+
+	trie := NewPathTrie()
+	flat := make(map[string]int)
+	for i := 0; i < 5000; i++ {
+		p := randomPath()
+		delta := 1 + rng.Intn(3)
+		if rng.Intn(3) == 0 {
+			delta = -delta
+		}
+		trie.Add(p, delta)
+		if w := flat[p] + delta; w > 0 {
+			flat[p] = w
+		} else {
+			delete(flat, p)
+		}
+
+		if i%50 != 0 {
+			continue
+		}
+		if trie.Len() != len(flat) {
+			t.Fatalf("step %d: %d keys, want %d", i, trie.Len(), len(flat))
+		}
+		prefix := randomPath()
+		var want Stats
+		for key, w := range flat {
+			if key == prefix || strings.HasPrefix(key, prefix+"/") {
+				want.Keys++
+				want.Weight += w
+			}
+		}
+		if got := trie.Stats(prefix); got != want {
+			t.Fatalf("step %d: stats(%s) = %+v, want %+v", i, prefix, got, want)
+		}
+		checkCompressed(t, trie.root, true)
+	}
+}
+
+func checkCompressed(t *testing.T, n *node, root bool) {
+	t.Helper()
+	if !root && n.weight == 0 && len(n.children) < 2 {
+		t.Fatalf("node %v should have been merged or pruned", n.edge)
+	}
+	for _, child := range n.children {
+		checkCompressed(t, child, false)
+	}
+}
+
+func BenchmarkPathTrieAdd(b *testing.B) {
+	paths := make([]string, 4096)
+	for i := range paths {
+		paths[i] = fmt.Sprintf("/home/agent/src/pkg%d/sub%d/file%d.go", i%64, i%7, i)
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	trie := NewPathTrie()
+	for i := 0; i < b.N; i++ {
+		trie.Add(paths[i%len(paths)], 1)
+	}
+}
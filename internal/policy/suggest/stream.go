@@ -0,0 +1,478 @@
+package suggest
+
+import (
+	"context"
+	"slices"
+	"sort"
+	"sync"
+	"time"
+
+	"github.com/strongdm/leash/internal/lsm"
+	"github.com/strongdm/leash/internal/policy/suggest/drift"
+	"github.com/strongdm/leash/internal/policy/suggest/encoding"
+	"github.com/strongdm/leash/internal/policy/suggest/pattern"
+	"github.com/strongdm/leash/internal/proxy"
+	"github.com/strongdm/leash/internal/websocket"
+)
+
+// engineSubscribeBuffer is how far the engine may fall behind the hub before
+// entries are dropped.
+const engineSubscribeBuffer = 4096
+
+// Engine maintains workflow suggestion state incrementally from the live
+// event stream instead of rebuilding it from the hub tail on every request.
+//
+// Events are grouped into per-principal sequences as they arrive. When a
+// sequence closes it joins an online cluster centroid, and each cluster's
+// mined profile is cached until its membership changes. The window slides
+// like TailLimit: the oldest events are trimmed from their sequences and the
+// affected centroids and counts are updated in place. Analyze only profiles
+// clusters that changed since the previous call.
+type Engine struct {
+	opts Options
+
+	mu       sync.Mutex
+	version  uint64
+	lastSeq  uint64
+	observed int64
+	latest   time.Time
+
+	// window holds principal events still inside the tail in arrival order;
+	// entries before head have been evicted.
+	window []windowEvent
+	head   int
+
+	open     map[string]*streamSequence
+	clusters *encoding.Clusterer
+	members  map[string]*streamCluster
+
+	tokens     map[string]int
+	principals map[string]int
+	events     int
+
+	// drift follows the token mix of every principal event, independent of
+	// the window.
+	drift *drift.Stream
+	// activity indexes the paths and hosts of events inside the window.
+	activity *activity
+}
+
+// EngineStats describes the state an Engine answer was computed from.
+type EngineStats struct {
+	// Seq is the hub sequence number of the newest observed entry.
+	Seq uint64
+	// Version increases whenever observed events change the engine state.
+	Version   uint64
+	Events    int
+	Sequences int
+}
+
+type windowEvent struct {
+	index int64
+	seq   *streamSequence
+}
+
+type streamSequence struct {
+	principal string
+	events    []pattern.Event
+	// arrivals holds the window index each event arrived at, aligned with
+	// events, so eviction removes the event that actually left the tail.
+	arrivals []int64
+	last     time.Time
+	// cluster and vector are set once the sequence has closed.
+	cluster string
+	vector  encoding.FeatureVector
+}
+
+type streamCluster struct {
+	members map[*streamSequence]struct{}
+	gen     uint64
+	profile *clusterProfile
+}
+
+// NewEngine returns an empty engine. The engine needs a bounded window, so a
+// TailLimit <= 0 falls back to the default.
+func NewEngine(opts Options) *Engine {
+	opts = opts.withDefaults()
+	if opts.TailLimit <= 0 {
+		opts.TailLimit = DefaultOptions().TailLimit
+	}
+	e := &Engine{
+		opts:       opts,
+		open:       make(map[string]*streamSequence),
+		clusters:   encoding.NewClusterer(opts.ClusterSimilarity),
+		members:    make(map[string]*streamCluster),
+		tokens:     make(map[string]int),
+		principals: make(map[string]int),
+		drift: drift.NewStream(drift.StreamConfig{
+			CurrentHalfLife:   opts.DriftCurrentHalfLife,
+			ReferenceHalfLife: opts.DriftReferenceHalfLife,
+			Threshold:         opts.DriftThreshold,
+		}),
+	}
+	e.activity = newActivity(&e.mu)
+	return e
+}
+
+// Options returns the effective options, including defaults.
+func (e *Engine) Options() Options {
+	return e.opts
+}
+
+// Run feeds the engine from hub until ctx is done. It subscribes before
+// reading the buffered history so nothing falls between the two; entries seen
+// twice are dropped by sequence number.
+func (e *Engine) Run(ctx context.Context, hub *websocket.WebSocketHub) {
+	entries, cancel := hub.Subscribe(engineSubscribeBuffer)
+	defer cancel()
+
+	for _, entry := range hub.RecentEvents(e.opts.TailLimit) {
+		e.Observe(entry)
+	}
+	for {
+		select {
+		case <-ctx.Done():
+			return
+		case entry, ok := <-entries:
+			if !ok {
+				return
+			}
+			e.Observe(entry)
+		}
+	}
+}
+
+// Observe folds one hub entry into the engine. Entries must arrive in hub
+// order; an entry whose sequence number was already seen is ignored.
+func (e *Engine) Observe(entry websocket.LogEntry) {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if entry.Seq != 0 {
+		if entry.Seq <= e.lastSeq {
+			return
+		}
+		e.lastSeq = entry.Seq
+	}
+	// Every entry counts toward the tail, as in RecentEvents(TailLimit), but
+	// only principal events can join a sequence.
+	e.observed++
+	changed := false
+
+	if principal := principalOf(&entry); principal != "" {
+		at := parseUnixNano(entry.Time)
+		ts := unixNanoTime(at)
+		seq := e.open[principal]
+		if seq != nil && seq.last.Add(e.opts.SessionWindow).Before(ts) {
+			e.closeLocked(seq)
+			seq = nil
+		}
+		if seq == nil {
+			seq = &streamSequence{principal: principal, events: make([]pattern.Event, 0, 8)}
+			e.open[principal] = seq
+		}
+		evt := toPatternEvent(&entry, at)
+		seq.add(evt, e.observed)
+		if ts.After(e.latest) {
+			e.latest = ts
+		}
+		e.window = append(e.window, windowEvent{index: e.observed, seq: seq})
+		e.countLocked(evt, 1)
+		e.drift.Observe(canonicalEventToken(evt), ts)
+		changed = true
+	}
+
+	if e.evictLocked() {
+		changed = true
+	}
+	if changed {
+		e.version++
+	}
+}
+
+// Version increases whenever observed events change the engine state.
+func (e *Engine) Version() uint64 {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	return e.version
+}
+
+// Drift returns the live drift monitor's state with up to limit top
+// contributing tokens.
+func (e *Engine) Drift(limit int) drift.StreamStatus {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	return e.drift.Status(limit)
+}
+
+// Analyze runs the rule-based passes over the supplied policies and merges
+// them with workflow suggestions from the engine's current state, bounded by
+// ctx as in AnalyzeContext.
+func (e *Engine) Analyze(ctx context.Context, policies *lsm.PolicySet, rewrites []proxy.HeaderRewriteRule) (Result, EngineStats) {
+	snap := e.snapshot()
+	var workflows workflowPass
+	if len(snap.candidates) > 0 {
+		workflows = func(ctx context.Context) ([]Suggestion, bool) {
+			suggestions, complete := rankWorkflows(ctx, snap.candidates, snap.principals, snap.dist, e.opts)
+			e.keepProfiles(snap)
+			return suggestions, complete
+		}
+	}
+	inputs := Inputs{LSMPolicies: policies, HTTPRewrites: rewrites}
+	return runPasses(ctx, inputs, e.activity, workflows, e.opts), snap.stats
+}
+
+// engineSnapshot is the clustering state one Analyze call ranks. gens holds
+// the generation each cached-eligible cluster had when it was taken.
+type engineSnapshot struct {
+	stats      EngineStats
+	candidates []workflowCluster
+	gens       map[string]uint64
+	principals int
+	dist       map[string]float64
+}
+
+// snapshot captures the current clusters for ranking. Open sequences are
+// assigned to a fork of the clusterer so they count toward this answer
+// without committing to a centroid; clusters they join are profiled afresh,
+// everything else reuses the cached profile. Mining happens after the lock
+// is released.
+func (e *Engine) snapshot() engineSnapshot {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	e.closeIdleLocked()
+
+	stats := EngineStats{Seq: e.lastSeq, Version: e.version, Events: e.events, Sequences: len(e.open)}
+	candidates := make([]workflowCluster, 0, len(e.members))
+	gens := make(map[string]uint64, len(e.members))
+	index := make(map[string]int, len(e.members))
+	for id, cl := range e.members {
+		stats.Sequences += len(cl.members)
+		wc := workflowCluster{id: id, size: len(cl.members), profile: cl.profile}
+		if wc.profile == nil {
+			wc.seqs = memberSequences(cl.members)
+		}
+		index[id] = len(candidates)
+		gens[id] = cl.gen
+		candidates = append(candidates, wc)
+	}
+
+	if len(e.open) > 0 {
+		fork := e.clusters.Fork()
+		open := make([]*streamSequence, 0, len(e.open))
+		for _, seq := range e.open {
+			open = append(open, seq)
+		}
+		sort.Slice(open, func(i, j int) bool { return open[i].principal < open[j].principal })
+		for _, seq := range open {
+			ps := seq.sequence()
+			id := fork.Add(encoding.BagOfNGrams(ps))
+			i, ok := index[id]
+			if !ok {
+				index[id] = len(candidates)
+				candidates = append(candidates, workflowCluster{id: id})
+				i = len(candidates) - 1
+			} else if candidates[i].profile != nil {
+				candidates[i].seqs = memberSequences(e.members[id].members)
+				candidates[i].profile = nil
+			}
+			delete(gens, id)
+			candidates[i].seqs = append(candidates[i].seqs, ps)
+			candidates[i].size++
+		}
+	}
+
+	overallDist := make(map[string]float64, len(e.tokens))
+	for token, n := range e.tokens {
+		overallDist[token] = float64(n) / float64(e.events)
+	}
+	return engineSnapshot{
+		stats:      stats,
+		candidates: candidates,
+		gens:       gens,
+		principals: len(e.principals),
+		dist:       overallDist,
+	}
+}
+
+// keepProfiles caches profiles computed for snap on clusters that have not
+// changed since it was taken.
+func (e *Engine) keepProfiles(snap engineSnapshot) {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	for _, wc := range snap.candidates {
+		gen, ok := snap.gens[wc.id]
+		if !ok || wc.profile == nil {
+			continue
+		}
+		if cl := e.members[wc.id]; cl != nil && cl.gen == gen {
+			cl.profile = wc.profile
+		}
+	}
+}
+
+// closeLocked moves seq from the open set into its nearest cluster.
+func (e *Engine) closeLocked(seq *streamSequence) {
+	if e.open[seq.principal] == seq {
+		delete(e.open, seq.principal)
+	}
+	seq.vector = encoding.BagOfNGrams(seq.sequence())
+	seq.cluster = e.clusters.Add(seq.vector)
+	cl := e.members[seq.cluster]
+	if cl == nil {
+		cl = &streamCluster{members: make(map[*streamSequence]struct{})}
+		e.members[seq.cluster] = cl
+	}
+	cl.members[seq] = struct{}{}
+	cl.touch()
+}
+
+// closeIdleLocked closes open sequences that no later event can extend: the
+// newest event is already past their session window.
+func (e *Engine) closeIdleLocked() {
+	idle := make([]*streamSequence, 0)
+	for _, seq := range e.open {
+		if seq.last.Add(e.opts.SessionWindow).Before(e.latest) {
+			idle = append(idle, seq)
+		}
+	}
+	sort.Slice(idle, func(i, j int) bool {
+		if idle[i].last.Equal(idle[j].last) {
+			return idle[i].principal < idle[j].principal
+		}
+		return idle[i].last.Before(idle[j].last)
+	})
+	for _, seq := range idle {
+		e.closeLocked(seq)
+	}
+}
+
+// evictLocked drops events that have left the tail, in arrival order. The
+// evicted event is usually the front of its sequence; a late event that was
+// inserted further back is removed from where it sits.
+func (e *Engine) evictLocked() bool {
+	evicted := false
+	cutoff := e.observed - int64(e.opts.TailLimit)
+	for e.head < len(e.window) && e.window[e.head].index <= cutoff {
+		ev := e.window[e.head]
+		e.window[e.head] = windowEvent{}
+		e.head++
+		e.trimLocked(ev.seq, ev.index)
+		evicted = true
+	}
+	if e.head > 1024 && e.head*2 > len(e.window) {
+		n := copy(e.window, e.window[e.head:])
+		clear(e.window[n:])
+		e.window = e.window[:n]
+		e.head = 0
+	}
+	return evicted
+}
+
+// trimLocked removes the event that arrived at index from seq.
+func (e *Engine) trimLocked(seq *streamSequence, index int64) {
+	pos := slices.Index(seq.arrivals, index)
+	if pos < 0 {
+		return
+	}
+	e.countLocked(seq.events[pos], -1)
+	if pos == 0 {
+		seq.events = seq.events[1:]
+		seq.arrivals = seq.arrivals[1:]
+	} else {
+		// Copy rather than shift so snapshots keep their events.
+		events := make([]pattern.Event, 0, len(seq.events)-1)
+		events = append(events, seq.events[:pos]...)
+		seq.events = append(events, seq.events[pos+1:]...)
+		seq.arrivals = slices.Delete(seq.arrivals, pos, pos+1)
+	}
+
+	if seq.cluster == "" {
+		if len(seq.events) == 0 && e.open[seq.principal] == seq {
+			delete(e.open, seq.principal)
+		}
+		return
+	}
+	cl := e.members[seq.cluster]
+	if len(seq.events) == 0 {
+		e.clusters.Remove(seq.cluster, seq.vector)
+		delete(cl.members, seq)
+		if len(cl.members) == 0 {
+			delete(e.members, seq.cluster)
+		} else {
+			cl.touch()
+		}
+		return
+	}
+	vec := encoding.BagOfNGrams(seq.sequence())
+	e.clusters.Replace(seq.cluster, seq.vector, vec)
+	seq.vector = vec
+	cl.touch()
+}
+
+func (e *Engine) countLocked(evt pattern.Event, delta int) {
+	token := canonicalEventToken(evt)
+	if n := e.tokens[token] + delta; n > 0 {
+		e.tokens[token] = n
+	} else {
+		delete(e.tokens, token)
+	}
+	if n := e.principals[evt.PrincipalID] + delta; n > 0 {
+		e.principals[evt.PrincipalID] = n
+	} else {
+		delete(e.principals, evt.PrincipalID)
+	}
+	e.events += delta
+	e.activity.observe(evt, delta)
+}
+
+// add appends evt, which arrived at window index, keeping events in timestamp
+// order. Late events are rare; they copy the slice so snapshots handed to
+// Analyze are never mutated.
+func (s *streamSequence) add(evt pattern.Event, index int64) {
+	n := len(s.events)
+	if n == 0 || evt.At >= s.events[n-1].At {
+		s.events = append(s.events, evt)
+		s.arrivals = append(s.arrivals, index)
+	} else {
+		pos := sort.Search(n, func(i int) bool { return evt.At < s.events[i].At })
+		events := make([]pattern.Event, 0, n+1)
+		events = append(events, s.events[:pos]...)
+		events = append(events, evt)
+		s.events = append(events, s.events[pos:]...)
+		s.arrivals = slices.Insert(s.arrivals, pos, index)
+	}
+	if evt.Timestamp.After(s.last) {
+		s.last = evt.Timestamp
+	}
+}
+
+// sequence returns a view of s named like BuildSequencesFromLogs names it.
+// Events are shared: appends and trims never modify the visible elements.
+func (s *streamSequence) sequence() pattern.Sequence {
+	id := s.principal
+	if len(s.events) > 0 {
+		id = sessionID(s.principal, s.events[0].At)
+	}
+	return pattern.Sequence{
+		SessionID: id,
+		Principal: s.principal,
+		Events:    s.events[:len(s.events):len(s.events)],
+	}
+}
+
+func (c *streamCluster) touch() {
+	c.gen++
+	c.profile = nil
+}
+
+// memberSequences returns the cluster's sequences ordered by session ID, the
+// order AffinityCluster reports members in.
+func memberSequences(members map[*streamSequence]struct{}) []pattern.Sequence {
+	out := make([]pattern.Sequence, 0, len(members)+1)
+	for seq := range members {
+		out = append(out, seq.sequence())
+	}
+	sort.Slice(out, func(i, j int) bool { return out[i].SessionID < out[j].SessionID })
+	return out
+}
@@ -0,0 +1,159 @@
+package suggest
+
+import (
+	"context"
+	"fmt"
+	"sort"
+	"testing"
+	"time"
+
+	"github.com/strongdm/leash/internal/websocket"
+)
+
+// streamLogs returns hub-ordered entries for repeated sessions of two
+// workflows, with heartbeats between sessions and a gap larger than the
+// session window after each one.
+func streamLogs(sessions int, window time.Duration) []websocket.LogEntry {
+	base := time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	var logs []websocket.LogEntry
+	var seq uint64
+	add := func(ts time.Time, entry websocket.LogEntry) {
+		seq++
+		entry.Seq = seq
+		entry.Time = ts.Format(time.RFC3339)
+		logs = append(logs, entry)
+	}
+	for s := 0; s < sessions; s++ {
+		start := base.Add(time.Duration(s) * 2 * window)
+		for _, principal := range []string{"agent-a", "agent-b"} {
+			add(start, websocket.LogEntry{Event: "file.open:ro", Exe: principal, Path: "/home/agent/.netrc", Decision: "allowed"})
+			add(start.Add(time.Second), websocket.LogEntry{Event: "http.request", Exe: principal, Addr: "api.github.com", Decision: "allowed"})
+			add(start.Add(2*time.Second), websocket.LogEntry{Event: "file.open:rw", Exe: principal, Path: fmt.Sprintf("/tmp/out-%d", s), Decision: "allowed"})
+		}
+		add(start.Add(3*time.Second), websocket.LogEntry{Event: "proc.exec", Exe: "make", Path: "/usr/bin/make", Decision: "allowed"})
+		add(start.Add(4*time.Second), websocket.LogEntry{Event: "proc.exec", Exe: "make", Path: "/usr/bin/cc", Decision: "allowed"})
+		add(start.Add(5*time.Second), websocket.LogEntry{Event: "leash.heartbeat"})
+	}
+	return logs
+}
+
+func workflowKeys(result Result) []string {
+	keys := make([]string, 0)
+	for _, s := range result.Suggestions {
+		if s.Kind != SuggestWorkflow {
+			continue
+		}
+		keys = append(keys, fmt.Sprintf("%d %s %s", s.PolicyCount, s.Metadata["top_pattern"], s.Metadata["top_support"]))
+	}
+	sort.Strings(keys)
+	return keys
+}
+
+func TestEngineMatchesBatchAnalysis(t *testing.T) {
+	t.Parallel()
+
+	opts := DefaultOptions()
+	logs := streamLogs(6, opts.SessionWindow)
+
+	engine := NewEngine(opts)
+	for _, entry := range logs {
+		engine.Observe(entry)
+	}
+	streamed, stats := engine.Analyze(context.Background(), nil, nil)
+
+	seqs := BuildSequencesFromLogs(logs, opts.SessionWindow)
+	batch := Analyze(Inputs{EventSequences: seqs}, opts)
+
+	got, want := workflowKeys(streamed), workflowKeys(batch)
+	if len(want) == 0 {
+		t.Fatalf("expected batch workflow suggestions")
+	}
+	if fmt.Sprint(got) != fmt.Sprint(want) {
+		t.Fatalf("engine diverged from batch:\n got %v\nwant %v", got, want)
+	}
+	if stats.Sequences != len(seqs) || stats.Events != 6*8 || stats.Seq != logs[len(logs)-1].Seq {
+		t.Fatalf("unexpected stats: %+v", stats)
+	}
+
+	if d := engine.Drift(3); d.Reference <= 0 || len(d.TopContributors) == 0 {
+		t.Fatalf("drift monitor saw no events: %+v", d)
+	}
+
+	// A second answer reuses cached profiles and must not change.
+	again, _ := engine.Analyze(context.Background(), nil, nil)
+	if fmt.Sprint(workflowKeys(again)) != fmt.Sprint(got) {
+		t.Fatalf("cached answer differs: %v vs %v", workflowKeys(again), got)
+	}
+}
+
+func TestEngineSlidesWindowLikeTailLimit(t *testing.T) {
+	t.Parallel()
+
+	opts := DefaultOptions()
+	opts.TailLimit = 20
+	logs := streamLogs(6, opts.SessionWindow)
+
+	engine := NewEngine(opts)
+	for _, entry := range logs {
+		engine.Observe(entry)
+		// Replays of already seen entries are ignored.
+		engine.Observe(entry)
+	}
+	_, stats := engine.Analyze(context.Background(), nil, nil)
+
+	tail := logs[len(logs)-opts.TailLimit:]
+	wantEvents := 0
+	for _, entry := range tail {
+		if principalOf(&entry) != "" {
+			wantEvents++
+		}
+	}
+	seqs := BuildSequencesFromLogs(tail, opts.SessionWindow)
+	if stats.Events != wantEvents || stats.Sequences != len(seqs) {
+		t.Fatalf("got %d events in %d sequences, want %d in %d", stats.Events, stats.Sequences, wantEvents, len(seqs))
+	}
+	if len(engine.tokens) == 0 || engine.clusters.Len() != len(engine.members) {
+		t.Fatalf("cluster state out of sync: %d centroids, %d member sets", engine.clusters.Len(), len(engine.members))
+	}
+}
+
+func TestEngineEvictsLateEventsInArrivalOrder(t *testing.T) {
+	t.Parallel()
+
+	opts := DefaultOptions()
+	opts.TailLimit = 3
+	engine := NewEngine(opts)
+
+	base := time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	for i, ev := range []struct {
+		offset time.Duration
+		path   string
+	}{
+		{0, "/a"},
+		{2 * time.Second, "/b"},
+		{time.Second, "/late"}, // arrives after /b but sorts before it
+		{3 * time.Second, "/d"},
+		{4 * time.Second, "/e"},
+	} {
+		engine.Observe(websocket.LogEntry{
+			Seq:      uint64(i + 1),
+			Time:     base.Add(ev.offset).Format(time.RFC3339),
+			Event:    "file.open:ro",
+			Exe:      "agent",
+			Path:     ev.path,
+			Decision: "allowed",
+		})
+	}
+
+	seq := engine.open["agent"]
+	if seq == nil {
+		t.Fatal("expected an open sequence")
+	}
+	var paths []string
+	for _, evt := range seq.events {
+		paths = append(paths, evt.ResourceFacet)
+	}
+	if fmt.Sprint(paths) != "[/late /d /e]" {
+		t.Fatalf("window should hold the last three arrivals, got %v", paths)
+	}
+}
@@ -0,0 +1,294 @@
+// Package synth generates synthetic runtime event streams for exercising the
+// suggestion pipeline at scale. The streams model coding-agent sessions:
+// package installs, git operations, LLM API calls and MCP tool use, with
+// several agents interleaved and the occasional heartbeat, in the shape the
+// websocket hub buffers them.
+package synth
+
+import (
+	"fmt"
+	"math/rand"
+	"time"
+
+	"github.com/strongdm/leash/internal/websocket"
+)
+
+// Config controls the generated stream. Zero values fall back to the defaults
+// noted on each field.
+type Config struct {
+	// Events is the number of entries to generate (10000).
+	Events int
+	// Agents is how many agent processes run sessions concurrently (4).
+	Agents int
+	// Seed makes the stream reproducible (1).
+	Seed int64
+	// Start is the timestamp of the first entry (2025-10-11T15:00:00Z).
+	Start time.Time
+	// Step is the mean time between entries (250ms).
+	Step time.Duration
+	// Idle is the pause an agent takes between sessions, which should exceed
+	// the session window used to split them (15m).
+	Idle time.Duration
+	// Repos and Packages bound how many distinct repositories and packages
+	// appear in paths and hosts (32 and 256), which sets the vocabulary size.
+	Repos    int
+	Packages int
+}
+
+func (c Config) withDefaults() Config {
+	if c.Events <= 0 {
+		c.Events = 10000
+	}
+	if c.Agents <= 0 {
+		c.Agents = 4
+	}
+	if c.Seed == 0 {
+		c.Seed = 1
+	}
+	if c.Start.IsZero() {
+		c.Start = time.Date(2025, 10, 11, 15, 0, 0, 0, time.UTC)
+	}
+	if c.Step <= 0 {
+		c.Step = 250 * time.Millisecond
+	}
+	if c.Idle <= 0 {
+		c.Idle = 15 * time.Minute
+	}
+	if c.Repos <= 0 {
+		c.Repos = 32
+	}
+	if c.Packages <= 0 {
+		c.Packages = 256
+	}
+	return c
+}
+
+// agentNames are the executables sessions are attributed to.
+var agentNames = []string{"claude", "codex", "gemini", "opencode", "qwen", "amp", "cursor-agent", "aider"}
+
+// scenario expands into the steps of one session.
+type scenario func(g *generator, agent string) []websocket.LogEntry
+
+var scenarios = []struct {
+	weight int
+	build  scenario
+}{
+	{4, npmInstall},
+	{3, pipInstall},
+	{5, gitWork},
+	{6, llmTurn},
+	{3, mcpTools},
+}
+
+// Generate returns cfg.Events entries in hub order, with sequence numbers
+// assigned from 1.
+func Generate(cfg Config) []websocket.LogEntry {
+	cfg = cfg.withDefaults()
+	g := &generator{
+		cfg: cfg,
+		rng: rand.New(rand.NewSource(cfg.Seed)),
+	}
+	for i := 0; i < cfg.Agents; i++ {
+		g.agents = append(g.agents, &agentState{name: agentNames[i%len(agentNames)] + agentSuffix(i)})
+	}
+	for _, s := range scenarios {
+		g.totalWeight += s.weight
+	}
+
+	out := make([]websocket.LogEntry, 0, cfg.Events)
+	now := cfg.Start
+	heartbeatEvery := max(64, cfg.Events/100)
+	for len(out) < cfg.Events {
+		now = now.Add(g.jitter(cfg.Step))
+		if len(out)%heartbeatEvery == heartbeatEvery-1 {
+			out = append(out, g.stamp(websocket.LogEntry{Event: "leash.heartbeat"}, now, len(out)))
+			continue
+		}
+		a := g.agents[g.rng.Intn(len(g.agents))]
+		if now.Before(a.resume) {
+			// The agent is idle between sessions; let another one act.
+			a = g.earliest()
+			if now.Before(a.resume) {
+				now = a.resume
+			}
+		}
+		if len(a.pending) == 0 {
+			a.pending = g.session(a.name)
+		}
+		entry := a.pending[0]
+		a.pending = a.pending[1:]
+		if len(a.pending) == 0 {
+			a.resume = now.Add(cfg.Idle + g.jitter(cfg.Idle/4))
+		}
+		out = append(out, g.stamp(entry, now, len(out)))
+	}
+	return out
+}
+
+func agentSuffix(i int) string {
+	if i < len(agentNames) {
+		return ""
+	}
+	return fmt.Sprintf("-%d", i/len(agentNames))
+}
+
+type generator struct {
+	cfg         Config
+	rng         *rand.Rand
+	agents      []*agentState
+	totalWeight int
+}
+
+type agentState struct {
+	name    string
+	pending []websocket.LogEntry
+	resume  time.Time
+}
+
+func (g *generator) earliest() *agentState {
+	best := g.agents[0]
+	for _, a := range g.agents[1:] {
+		if a.resume.Before(best.resume) {
+			best = a
+		}
+	}
+	return best
+}
+
+func (g *generator) session(agent string) []websocket.LogEntry {
+	pick := g.rng.Intn(g.totalWeight)
+	for _, s := range scenarios {
+		if pick < s.weight {
+			return s.build(g, agent)
+		}
+		pick -= s.weight
+	}
+	return scenarios[0].build(g, agent)
+}
+
+func (g *generator) stamp(entry websocket.LogEntry, at time.Time, index int) websocket.LogEntry {
+	entry.Seq = uint64(index + 1)
+	entry.Time = at.Format(time.RFC3339Nano)
+	if entry.Decision == "" && entry.Event != "leash.heartbeat" {
+		entry.Decision = "allowed"
+		if g.rng.Intn(50) == 0 {
+			entry.Decision = "denied"
+		}
+	}
+	return entry
+}
+
+// jitter returns a duration uniformly spread around d.
+func (g *generator) jitter(d time.Duration) time.Duration {
+	if d <= 0 {
+		return 0
+	}
+	return d/2 + time.Duration(g.rng.Int63n(int64(d)))
+}
+
+func (g *generator) repo() string {
+	return fmt.Sprintf("/workspace/repo-%02d", g.rng.Intn(g.cfg.Repos))
+}
+
+func (g *generator) pkg() string {
+	// Package popularity is skewed, as in real dependency trees.
+	n := g.cfg.Packages
+	i := int(float64(n) * g.rng.Float64() * g.rng.Float64())
+	return fmt.Sprintf("pkg-%03d", i%n)
+}
+
+func fileRO(agent, path string) websocket.LogEntry {
+	return websocket.LogEntry{Event: "file.open:ro", Exe: agent, Path: path}
+}
+
+func fileRW(agent, path string) websocket.LogEntry {
+	return websocket.LogEntry{Event: "file.open:rw", Exe: agent, Path: path}
+}
+
+func exec(agent, path string) websocket.LogEntry {
+	return websocket.LogEntry{Event: "proc.exec", Exe: agent, Path: path}
+}
+
+func request(agent, host string) websocket.LogEntry {
+	return websocket.LogEntry{Event: "http.request", Exe: agent, Addr: host}
+}
+
+func npmInstall(g *generator, agent string) []websocket.LogEntry {
+	repo := g.repo()
+	steps := []websocket.LogEntry{
+		fileRO(agent, repo+"/package.json"),
+		fileRO(agent, "/home/agent/.npmrc"),
+		exec(agent, "/usr/bin/npm"),
+	}
+	for i := 1 + g.rng.Intn(8); i > 0; i-- {
+		p := g.pkg()
+		steps = append(steps,
+			request(agent, "registry.npmjs.org"),
+			fileRW(agent, repo+"/node_modules/"+p+"/package.json"),
+		)
+	}
+	return append(steps, fileRW(agent, repo+"/package-lock.json"))
+}
+
+func pipInstall(g *generator, agent string) []websocket.LogEntry {
+	repo := g.repo()
+	steps := []websocket.LogEntry{
+		fileRO(agent, repo+"/requirements.txt"),
+		exec(agent, "/usr/bin/python3"),
+	}
+	for i := 1 + g.rng.Intn(6); i > 0; i-- {
+		p := g.pkg()
+		steps = append(steps,
+			request(agent, "pypi.org"),
+			request(agent, "files.pythonhosted.org"),
+			fileRW(agent, repo+"/.venv/lib/python3.12/site-packages/"+p+"/__init__.py"),
+		)
+	}
+	return steps
+}
+
+func gitWork(g *generator, agent string) []websocket.LogEntry {
+	repo := g.repo()
+	steps := []websocket.LogEntry{
+		exec(agent, "/usr/bin/git"),
+		fileRO(agent, "/home/agent/.gitconfig"),
+		fileRO(agent, repo+"/.git/HEAD"),
+	}
+	if g.rng.Intn(2) == 0 {
+		steps = append(steps, fileRO(agent, "/home/agent/.ssh/id_ed25519"), request(agent, "github.com"))
+	}
+	for i := 1 + g.rng.Intn(5); i > 0; i-- {
+		steps = append(steps, fileRW(agent, fmt.Sprintf("%s/src/file%02d.go", repo, g.rng.Intn(40))))
+	}
+	return append(steps, fileRW(agent, repo+"/.git/index"))
+}
+
+func llmTurn(g *generator, agent string) []websocket.LogEntry {
+	hosts := []string{"api.anthropic.com", "api.openai.com", "generativelanguage.googleapis.com"}
+	host := hosts[g.rng.Intn(len(hosts))]
+	steps := []websocket.LogEntry{fileRO(agent, "/home/agent/.config/"+agent+"/config.json")}
+	for i := 1 + g.rng.Intn(4); i > 0; i-- {
+		steps = append(steps, request(agent, host))
+		if g.rng.Intn(3) == 0 {
+			steps = append(steps, fileRO(agent, fmt.Sprintf("%s/src/file%02d.go", g.repo(), g.rng.Intn(40))))
+		}
+	}
+	return steps
+}
+
+func mcpTools(g *generator, agent string) []websocket.LogEntry {
+	servers := []string{"mcp.github.com", "mcp.linear.app", "localhost:3845"}
+	tools := []string{"search_issues", "create_pull_request", "read_file", "list_projects"}
+	server := servers[g.rng.Intn(len(servers))]
+	steps := []websocket.LogEntry{request(agent, server)}
+	for i := 1 + g.rng.Intn(4); i > 0; i-- {
+		steps = append(steps, websocket.LogEntry{
+			Event:  "mcp.call",
+			Exe:    agent,
+			Server: server,
+			Method: "tools/call",
+			Tool:   tools[g.rng.Intn(len(tools))],
+		})
+	}
+	return steps
+}
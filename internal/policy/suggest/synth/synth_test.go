@@ -0,0 +1,57 @@
+package synth
+
+import (
+	"reflect"
+	"testing"
+	"time"
+)
+
+func TestGenerateIsDeterministic(t *testing.T) {
+	t.Parallel()
+
+	cfg := Config{Events: 2000, Agents: 3, Seed: 7}
+	a, b := Generate(cfg), Generate(cfg)
+	if !reflect.DeepEqual(a, b) {
+		t.Fatalf("same config produced different streams")
+	}
+	if c := Generate(Config{Events: 2000, Agents: 3, Seed: 8}); reflect.DeepEqual(a, c) {
+		t.Fatalf("different seeds produced the same stream")
+	}
+}
+
+func TestGenerateShapesAgentSessions(t *testing.T) {
+	t.Parallel()
+
+	logs := Generate(Config{Events: 5000, Agents: 4})
+	if len(logs) != 5000 {
+		t.Fatalf("got %d entries, want 5000", len(logs))
+	}
+	events := make(map[string]int)
+	agents := make(map[string]struct{})
+	var prev time.Time
+	for i, e := range logs {
+		if e.Seq != uint64(i+1) {
+			t.Fatalf("entry %d has seq %d", i, e.Seq)
+		}
+		at, err := time.Parse(time.RFC3339Nano, e.Time)
+		if err != nil {
+			t.Fatalf("entry %d: %v", i, err)
+		}
+		if at.Before(prev) {
+			t.Fatalf("entry %d is out of order: %s before %s", i, at, prev)
+		}
+		prev = at
+		events[e.Event]++
+		if e.Exe != "" {
+			agents[e.Exe] = struct{}{}
+		}
+	}
+	for _, name := range []string{"file.open:ro", "file.open:rw", "proc.exec", "http.request", "mcp.call", "leash.heartbeat"} {
+		if events[name] == 0 {
+			t.Fatalf("no %s events in %v", name, events)
+		}
+	}
+	if len(agents) != 4 {
+		t.Fatalf("got agents %v, want 4", agents)
+	}
+}
@@ -1,5 +1,7 @@
 package suggest
 
+import "time"
+
 // SuggestionKind enumerates mechanical compression opportunities.
 type SuggestionKind string
 
@@ -50,4 +52,17 @@ type Suggestion struct {
 // Result bundles all suggestions generated from a control-plane snapshot.
 type Result struct {
 	Suggestions []Suggestion
+	// Partial is set when the analysis deadline expired before every pass
+	// finished; Suggestions then holds only what completed.
+	Partial bool
+	// Timings reports each pass that ran, in pass order.
+	Timings []PassTiming
+}
+
+// PassTiming records how long one suggestion pass ran and whether it
+// finished within the deadline.
+type PassTiming struct {
+	Pass      string
+	Duration  time.Duration
+	Completed bool
 }
@@ -0,0 +1,31 @@
+package proxy
+
+import (
+	"fmt"
+	"net/http/httptest"
+	"testing"
+)
+
+func BenchmarkApplyRules(b *testing.B) {
+	for _, n := range []int{1, 16, 128} {
+		b.Run(fmt.Sprintf("rules=%d", n), func(b *testing.B) {
+			rules := make([]HeaderRewriteRule, n)
+			for i := range rules {
+				rules[i] = HeaderRewriteRule{
+					Host:   fmt.Sprintf("api%d.example.com", i),
+					Header: "Authorization",
+					Value:  fmt.Sprintf("Bearer token-%d", i),
+				}
+			}
+			hr := NewHeaderRewriter()
+			hr.SetRules(rules)
+			req := httptest.NewRequest("GET", fmt.Sprintf("https://api%d.example.com:443/v1/models", n-1), nil)
+			req.Header.Set("User-Agent", "claude-cli")
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				hr.ApplyRules(req)
+			}
+		})
+	}
+}
@@ -0,0 +1,41 @@
+package proxy
+
+import (
+	"net/http/httptrace"
+
+	"github.com/strongdm/leash/internal/telemetry/metrics"
+)
+
+const phaseHelp = "Time spent in each phase of a proxied request."
+
+var (
+	connectionsAccepted = metrics.Default.Counter("leash_proxy_connections_total", "Connections accepted by the proxy listeners.")
+	connectionsActive   = metrics.Default.Gauge("leash_proxy_connections_active", "Connections the proxy is handling.")
+
+	handshakesOK    = metrics.Default.Counter("leash_proxy_tls_handshakes_total", "TLS handshakes with intercepted clients.", "result", "ok")
+	handshakesError = metrics.Default.Counter("leash_proxy_tls_handshakes_total", "TLS handshakes with intercepted clients.", "result", "error")
+
+	certCacheHits   = metrics.Default.Counter("leash_proxy_cert_cache_total", "Leaf certificate lookups.", "result", "hit")
+	certCacheMisses = metrics.Default.Counter("leash_proxy_cert_cache_total", "Leaf certificate lookups.", "result", "miss")
+
+	upstreamReused = metrics.Default.Counter("leash_proxy_upstream_conns_total", "Upstream connections used for requests, by whether they came from the idle pool.", "reused", "true")
+	upstreamNew    = metrics.Default.Counter("leash_proxy_upstream_conns_total", "Upstream connections used for requests, by whether they came from the idle pool.", "reused", "false")
+
+	requestsDenied = metrics.Default.Counter("leash_proxy_requests_denied_total", "Requests the proxy blocked by connect or MCP policy.")
+
+	phaseHandshake = metrics.Default.Histogram("leash_proxy_phase_seconds", phaseHelp, metrics.DefBuckets, "phase", "handshake")
+	phaseDial      = metrics.Default.Histogram("leash_proxy_phase_seconds", phaseHelp, metrics.DefBuckets, "phase", "upstream_dial")
+	phaseUpstream  = metrics.Default.Histogram("leash_proxy_phase_seconds", phaseHelp, metrics.DefBuckets, "phase", "upstream_response")
+	phaseResponse  = metrics.Default.Histogram("leash_proxy_phase_seconds", phaseHelp, metrics.DefBuckets, "phase", "response")
+)
+
+// upstreamTrace counts whether the HTTP client reused a pooled connection.
+var upstreamTrace = &httptrace.ClientTrace{
+	GotConn: func(info httptrace.GotConnInfo) {
+		if info.Reused {
+			upstreamReused.Inc()
+		} else {
+			upstreamNew.Inc()
+		}
+	},
+}
@@ -4,11 +4,13 @@ import (
 	"bufio"
 	"context"
 	"crypto/tls"
+	"errors"
 	"fmt"
 	"io"
 	"log"
 	"net"
 	"net/http"
+	"net/http/httptrace"
 	"strconv"
 	"strings"
 	"sync"
@@ -46,6 +48,10 @@ type MITMProxy struct {
 	httpClient     *http.Client      // Custom HTTP client with marked connections
 	tlsDialer      func(string) (*tls.Conn, error)
 	mcpObserver    *mcpObserver
+
+	// tenantsMu guards tenants, keyed by listen port, and policyChecker.
+	tenantsMu sync.RWMutex
+	tenants   map[int]*proxyTenant
 }
 
 // sockaddr_in structure for SO_ORIGINAL_DST
@@ -222,28 +228,39 @@ func (p *MITMProxy) Run() error {
 	defer listener.Close()
 
 	log.Printf("Starting transparent MITM proxy on port %s", p.port)
+	p.serve(listener)
+	return nil
+}
 
+// serve accepts connections until the listener is closed.
+func (p *MITMProxy) serve(listener net.Listener) {
 	for {
 		conn, err := listener.Accept()
 		if err != nil {
+			if errors.Is(err, net.ErrClosed) {
+				return
+			}
 			log.Printf("Error accepting connection: %v", err)
 			continue
 		}
 
+		connectionsAccepted.Inc()
 		go p.handleTransparentConnection(conn)
 	}
 }
 
 // SetPolicyChecker updates the policy checker used for connect enforcement.
 func (p *MITMProxy) SetPolicyChecker(pc PolicyChecker) {
+	p.tenantsMu.Lock()
 	p.policyChecker = pc
-	if p.mcpObserver != nil {
-		p.mcpObserver.setForceParse(pc != nil && pc.HasMCPPolicies())
-	}
+	p.tenantsMu.Unlock()
+	p.refreshMCPParse()
 }
 
 func (p *MITMProxy) handleTransparentConnection(clientConn net.Conn) {
 	defer clientConn.Close()
+	connectionsActive.Inc()
+	defer connectionsActive.Dec()
 
 	// Get the original destination
 	originalDest, err := getOriginalDest(clientConn)
@@ -270,12 +287,13 @@ func (p *MITMProxy) handleTransparentConnection(clientConn net.Conn) {
 }
 
 // checkConnectPolicy validates if a connection should be allowed based on hostname/IP policy
-func (p *MITMProxy) checkConnectPolicy(hostname, destIP string, port uint16) bool {
-	if p.policyChecker == nil {
+func (p *MITMProxy) checkConnectPolicy(conn net.Conn, hostname, destIP string, port uint16) bool {
+	checker := p.policyFor(conn).checker
+	if checker == nil {
 		return true // No policy checker, allow all
 	}
 
-	return p.policyChecker.CheckConnect(hostname, destIP, port)
+	return checker.CheckConnect(hostname, destIP, port)
 }
 
 // blockConnection sends a policy violation response and closes the connection
@@ -289,9 +307,10 @@ func (p *MITMProxy) blockConnection(clientConn net.Conn, isHTTPS bool, hostname,
 
 	// Create policy denial error for logging
 	policyErr := fmt.Errorf("connection denied by security policy")
+	requestsDenied.Inc()
 
 	// Log the denied request to shared logger
-	p.logRequest(protocol, hostname, portStr, path, query, authHeader, 403, policyErr)
+	p.logRequest(clientConn, protocol, hostname, portStr, path, query, authHeader, 403, policyErr)
 
 	body := "Connection denied by security policy: " + hostname
 	response := fmt.Sprintf("HTTP/1.1 403 Forbidden\r\n"+
@@ -315,7 +334,8 @@ func (p *MITMProxy) blockConnection(clientConn net.Conn, isHTTPS bool, hostname,
 }
 
 func (p *MITMProxy) enforceMCPCall(conn net.Conn, ctx *mcpRequestContext, serverHost string, logHost string, logPort string, path string, query string, authHeader string, scheme string) bool {
-	if p.policyChecker == nil || ctx == nil {
+	checker := p.policyFor(conn).checker
+	if checker == nil || ctx == nil {
 		return false
 	}
 	if !strings.EqualFold(ctx.method, "tools/call") {
@@ -324,7 +344,8 @@ func (p *MITMProxy) enforceMCPCall(conn net.Conn, ctx *mcpRequestContext, server
 	if serverHost == "" {
 		serverHost = logHost
 	}
-	if !p.policyChecker.CheckMCPCall(serverHost, ctx.tool) {
+	if !checker.CheckMCPCall(serverHost, ctx.tool) {
+		requestsDenied.Inc()
 		status := http.StatusForbidden
 		ctx.server = serverHost
 		ctx.responseOutcome = "denied"
@@ -354,7 +375,7 @@ func (p *MITMProxy) enforceMCPCall(conn net.Conn, ctx *mcpRequestContext, server
 		if p.mcpObserver != nil {
 			p.mcpObserver.logHTTPRequest(ctx, status, "denied", "", nil)
 		}
-		p.logRequest(scheme, logHost, logPort, path, query, authHeader, status, fmt.Errorf("mcp tools/call denied by policy"))
+		p.logRequest(conn, scheme, logHost, logPort, path, query, authHeader, status, fmt.Errorf("mcp tools/call denied by policy"))
 		return true
 	}
 	return false
@@ -385,7 +406,7 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 		if port == "" {
 			port = "80"
 		}
-		p.logRequest("http", host, port, "", "", "", 0, err)
+		p.logRequest(clientConn, "http", host, port, "", "", "", 0, err)
 		return
 	}
 
@@ -415,7 +436,7 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 	query := req.URL.RawQuery
 	authHeader := req.Header.Get("Authorization")
 
-	if !p.checkConnectPolicy(hostname, host, uint16(portNum)) {
+	if !p.checkConnectPolicy(clientConn, hostname, host, uint16(portNum)) {
 		p.blockConnection(clientConn, false, hostname, host, uint16(portNum), path, query, authHeader)
 		return
 	}
@@ -423,7 +444,7 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 	// Unique request logging removed
 
 	// Apply header rewriting rules
-	p.headerRewriter.ApplyRules(req)
+	p.policyFor(clientConn).headerRewriter.ApplyRules(req)
 
 	var mcpCtx *mcpRequestContext
 	if p.mcpObserver != nil {
@@ -444,10 +465,12 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 		return
 	}
 
-	resp, err := p.httpClient.Do(req)
+	upstreamStart := time.Now()
+	resp, err := p.httpClient.Do(req.WithContext(httptrace.WithClientTrace(req.Context(), upstreamTrace)))
+	phaseUpstream.Since(upstreamStart)
 	if err != nil {
 		log.Printf("Error forwarding request: %v", err)
-		p.logRequest("http", host, port, path, query, authHeader, 0, err)
+		p.logRequest(clientConn, "http", host, port, path, query, authHeader, 0, err)
 		if mcpCtx != nil {
 			p.mcpObserver.logHTTPRequest(mcpCtx, 0, "error", "", err)
 		}
@@ -479,7 +502,9 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 		resp.Body = p.mcpObserver.wrapSessionSSE(sessionHeader, serverHost, protoHeader, resp.Body)
 	}
 
+	responseStart := time.Now()
 	writeErr := resp.Write(clientConn)
+	phaseResponse.Since(responseStart)
 	if writeErr != nil {
 		log.Printf("Error writing response: %v", writeErr)
 	}
@@ -489,7 +514,7 @@ func (p *MITMProxy) handleTransparentHTTP(clientConn net.Conn, originalDest stri
 		p.mcpObserver.logHTTPRequest(mcpCtx, resp.StatusCode, outcome, sessionHeader, writeErr)
 	}
 
-	p.logRequest("http", host, port, path, query, authHeader, resp.StatusCode, writeErr)
+	p.logRequest(clientConn, "http", host, port, path, query, authHeader, resp.StatusCode, writeErr)
 }
 
 // connWrapper wraps a net.Conn with additional reader for prepending data
@@ -535,10 +560,14 @@ func (p *MITMProxy) handleTransparentHTTPS(clientConn net.Conn, originalDest str
 	defer tlsConn.Close()
 
 	// Handle the TLS connection
+	handshakeStart := time.Now()
 	if err := tlsConn.Handshake(); err != nil {
+		handshakesError.Inc()
 		log.Printf("TLS handshake error for %s: %v", originalDest, err)
 		return
 	}
+	handshakesOK.Inc()
+	phaseHandshake.Since(handshakeStart)
 
 	// Use the hostname from SNI if available, otherwise fall back to originalDest
 	targetHost := actualHostname
@@ -566,7 +595,7 @@ func (p *MITMProxy) handleTransparentHTTPS(clientConn net.Conn, originalDest str
 		hostname = destHost
 	}
 
-	if !p.checkConnectPolicy(hostname, destHost, uint16(portNum)) {
+	if !p.checkConnectPolicy(clientConn, hostname, destHost, uint16(portNum)) {
 		// For HTTPS connection denials, we don't have specific path/query/auth info yet
 		p.blockConnection(tlsConn, true, hostname, destHost, uint16(portNum), "/", "", "")
 		return
@@ -621,7 +650,7 @@ func (p *MITMProxy) handleTransparentHTTPS(clientConn net.Conn, originalDest str
 		}
 
 		// Apply header rewriting rules
-		p.headerRewriter.ApplyRules(req)
+		p.policyFor(clientConn).headerRewriter.ApplyRules(req)
 
 		responseCode, _, sessionHeader, forwardErr := p.forwardTransparentHTTPS(tlsConn, req, targetHost, mcpCtx)
 
@@ -631,7 +660,7 @@ func (p *MITMProxy) handleTransparentHTTPS(clientConn net.Conn, originalDest str
 		}
 
 		// Log request to logfmt
-		p.logRequest("https", host, port, path, query, authHeader, responseCode, forwardErr)
+		p.logRequest(clientConn, "https", host, port, path, query, authHeader, responseCode, forwardErr)
 	}
 }
 
@@ -641,14 +670,18 @@ func (p *MITMProxy) forwardTransparentHTTPS(clientConn net.Conn, req *http.Reque
 	if dialer == nil {
 		dialer = p.createMarkedTLSConnection
 	}
+	dialStart := time.Now()
 	targetConn, err := dialer(targetHost)
+	phaseDial.Since(dialStart)
 	if err != nil {
 		log.Printf("Error connecting to target %s: %v", targetHost, err)
 		return 0, "", "", err
 	}
+	upstreamNew.Inc()
 	defer targetConn.Close()
 
 	// Forward the request
+	upstreamStart := time.Now()
 	if err := req.Write(targetConn); err != nil {
 		log.Printf("Error writing request to target: %v", err)
 		return 0, "", "", err
@@ -657,6 +690,7 @@ func (p *MITMProxy) forwardTransparentHTTPS(clientConn net.Conn, req *http.Reque
 	// Read the response
 	targetReader := bufio.NewReader(targetConn)
 	resp, err := http.ReadResponse(targetReader, req)
+	phaseUpstream.Since(upstreamStart)
 	if err != nil {
 		log.Printf("Error reading response: %v", err)
 		return 0, "", "", err
@@ -688,7 +722,9 @@ func (p *MITMProxy) forwardTransparentHTTPS(clientConn net.Conn, req *http.Reque
 	}
 
 	// Forward the response to client
+	responseStart := time.Now()
 	writeErr := resp.Write(clientConn)
+	phaseResponse.Since(responseStart)
 	if writeErr != nil {
 		log.Printf("Error writing response to client: %v", writeErr)
 		return resp.StatusCode, contentType, sessionHeader, writeErr
@@ -701,6 +737,7 @@ func (p *MITMProxy) getCertificate(host string) (*tls.Certificate, error) {
 	p.certCacheMux.RLock()
 	if cert, ok := p.certCache[host]; ok {
 		p.certCacheMux.RUnlock()
+		certCacheHits.Inc()
 		return cert, nil
 	}
 	p.certCacheMux.RUnlock()
@@ -710,10 +747,12 @@ func (p *MITMProxy) getCertificate(host string) (*tls.Certificate, error) {
 
 	// Double-check after acquiring write lock
 	if cert, ok := p.certCache[host]; ok {
+		certCacheHits.Inc()
 		return cert, nil
 	}
 
 	// Generate new certificate
+	certCacheMisses.Inc()
 	cert, err := p.ca.GenerateCertificate(host)
 	if err != nil {
 		return nil, err
@@ -723,8 +762,9 @@ func (p *MITMProxy) getCertificate(host string) (*tls.Certificate, error) {
 	return cert, nil
 }
 
-// logRequest logs a request in logfmt format to the shared event log
-func (p *MITMProxy) logRequest(reqType, host, port, path, query, authHeader string, responseCode int, err error) {
+// logRequest logs a request in logfmt format to the shared event log.
+// Requests on a tenant listener carry the tenant's cgroup.
+func (p *MITMProxy) logRequest(conn net.Conn, reqType, host, port, path, query, authHeader string, responseCode int, err error) {
 	// Log to shared logger
 	if p.sharedLogger != nil {
 		timestamp := time.Now().Format(time.RFC3339) // ISO 8601 format
@@ -762,6 +802,7 @@ func (p *MITMProxy) logRequest(reqType, host, port, path, query, authHeader stri
 		if err != nil {
 			logEntry += fmt.Sprintf(" error=\"%s\"", err.Error())
 		}
+		logEntry += tenantField(p.policyFor(conn).tenant)
 
 		_ = p.sharedLogger.Write(logEntry)
 	}
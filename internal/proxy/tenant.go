@@ -0,0 +1,145 @@
+package proxy
+
+import (
+	"errors"
+	"fmt"
+	"log"
+	"net"
+	"strconv"
+)
+
+// proxyTenant is a cgroup subtree served on its own listener. The network
+// rules redirect each tenant's traffic to the tenant's port, so the port a
+// connection arrives on identifies the cgroup it came from.
+type proxyTenant struct {
+	id             uint64
+	port           int
+	listener       net.Listener
+	policyChecker  PolicyChecker
+	headerRewriter *HeaderRewriter
+}
+
+// connPolicy is the policy a connection is checked against: its tenant's,
+// or the proxy's own for connections outside tenant listeners.
+type connPolicy struct {
+	tenant         uint64
+	checker        PolicyChecker
+	headerRewriter *HeaderRewriter
+}
+
+// AddTenant starts a listener on port whose connections are checked against
+// the tenant's policy checker and header rules. Port "0" picks a free port.
+// It returns the port the listener is bound to.
+func (p *MITMProxy) AddTenant(id uint64, port string, policyChecker PolicyChecker, headerRewriter *HeaderRewriter) (int, error) {
+	p.tenantsMu.Lock()
+	for _, t := range p.tenants {
+		if t.id == id {
+			p.tenantsMu.Unlock()
+			return 0, fmt.Errorf("tenant %d already has a listener on port %d", id, t.port)
+		}
+	}
+	p.tenantsMu.Unlock()
+
+	listener, err := net.Listen("tcp", ":"+port)
+	if err != nil {
+		return 0, fmt.Errorf("failed to listen for tenant %d: %w", id, err)
+	}
+	t := &proxyTenant{
+		id:             id,
+		port:           listener.Addr().(*net.TCPAddr).Port,
+		listener:       listener,
+		policyChecker:  policyChecker,
+		headerRewriter: headerRewriter,
+	}
+
+	p.tenantsMu.Lock()
+	if p.tenants == nil {
+		p.tenants = make(map[int]*proxyTenant)
+	}
+	p.tenants[t.port] = t
+	p.tenantsMu.Unlock()
+	p.refreshMCPParse()
+
+	log.Printf("Starting MITM proxy listener for tenant %d on port %d", id, t.port)
+	go p.serve(listener)
+	return t.port, nil
+}
+
+// SetTenantPolicyChecker updates the connect policy of a tenant.
+func (p *MITMProxy) SetTenantPolicyChecker(id uint64, pc PolicyChecker) error {
+	p.tenantsMu.Lock()
+	t := p.tenantByIDLocked(id)
+	if t != nil {
+		t.policyChecker = pc
+	}
+	p.tenantsMu.Unlock()
+	if t == nil {
+		return fmt.Errorf("unknown tenant %d", id)
+	}
+	p.refreshMCPParse()
+	return nil
+}
+
+// RemoveTenant closes the tenant's listener. Connections already accepted
+// finish under the policy they started with.
+func (p *MITMProxy) RemoveTenant(id uint64) error {
+	p.tenantsMu.Lock()
+	t := p.tenantByIDLocked(id)
+	if t != nil {
+		delete(p.tenants, t.port)
+	}
+	p.tenantsMu.Unlock()
+	if t == nil {
+		return fmt.Errorf("unknown tenant %d", id)
+	}
+	p.refreshMCPParse()
+	if err := t.listener.Close(); err != nil && !errors.Is(err, net.ErrClosed) {
+		return err
+	}
+	return nil
+}
+
+func (p *MITMProxy) tenantByIDLocked(id uint64) *proxyTenant {
+	for _, t := range p.tenants {
+		if t.id == id {
+			return t
+		}
+	}
+	return nil
+}
+
+// policyFor returns the policy for a connection accepted by the proxy.
+func (p *MITMProxy) policyFor(conn net.Conn) connPolicy {
+	p.tenantsMu.RLock()
+	defer p.tenantsMu.RUnlock()
+	if len(p.tenants) > 0 && conn != nil {
+		if addr, ok := conn.LocalAddr().(*net.TCPAddr); ok {
+			if t := p.tenants[addr.Port]; t != nil {
+				return connPolicy{tenant: t.id, checker: t.policyChecker, headerRewriter: t.headerRewriter}
+			}
+		}
+	}
+	return connPolicy{checker: p.policyChecker, headerRewriter: p.headerRewriter}
+}
+
+// refreshMCPParse makes the MCP observer parse every request when any
+// policy in use has MCP rules.
+func (p *MITMProxy) refreshMCPParse() {
+	if p.mcpObserver == nil {
+		return
+	}
+	p.tenantsMu.RLock()
+	force := p.policyChecker != nil && p.policyChecker.HasMCPPolicies()
+	for _, t := range p.tenants {
+		force = force || (t.policyChecker != nil && t.policyChecker.HasMCPPolicies())
+	}
+	p.tenantsMu.RUnlock()
+	p.mcpObserver.setForceParse(force)
+}
+
+func tenantField(tenant uint64) string {
+	if tenant == 0 {
+		return ""
+	}
+	return " cgroup=" + strconv.FormatUint(tenant, 10)
+}
@@ -0,0 +1,75 @@
+package proxy
+
+import (
+	"net"
+	"strings"
+	"testing"
+)
+
+// localAddrConn reports a fixed local address, as an accepted connection on
+// a tenant listener would.
+type localAddrConn struct {
+	net.Conn
+	local net.Addr
+}
+
+func (c localAddrConn) LocalAddr() net.Addr { return c.local }
+
+func TestTenantListenerSelectsPolicy(t *testing.T) {
+	t.Parallel()
+
+	defaultRewriter := NewHeaderRewriter()
+	p := &MITMProxy{
+		policyChecker:  stubPolicyChecker{allowConnect: true},
+		headerRewriter: defaultRewriter,
+	}
+	tenantRewriter := NewHeaderRewriter()
+	port, err := p.AddTenant(42, "0", stubPolicyChecker{allowConnect: false}, tenantRewriter)
+	if err != nil {
+		t.Fatalf("AddTenant: %v", err)
+	}
+	if _, err := p.AddTenant(42, "0", stubPolicyChecker{}, NewHeaderRewriter()); err == nil {
+		t.Fatal("expected a second listener for the same tenant to be refused")
+	}
+
+	tenantConn := localAddrConn{local: &net.TCPAddr{IP: net.IPv4(127, 0, 0, 1), Port: port}}
+	policy := p.policyFor(tenantConn)
+	if policy.tenant != 42 || policy.headerRewriter != tenantRewriter {
+		t.Fatalf("expected tenant policy, got %+v", policy)
+	}
+	if p.checkConnectPolicy(tenantConn, "example.com", "93.184.216.34", 443) {
+		t.Fatal("expected tenant policy to deny the connection")
+	}
+	if got := tenantField(policy.tenant); !strings.Contains(got, "cgroup=42") {
+		t.Fatalf("unexpected tenant field %q", got)
+	}
+
+	// Connections on other listeners, and pipes in tests, use the default.
+	otherConn := localAddrConn{local: &net.TCPAddr{IP: net.IPv4(127, 0, 0, 1), Port: port + 1}}
+	if policy := p.policyFor(otherConn); policy.tenant != 0 || policy.headerRewriter != defaultRewriter {
+		t.Fatalf("expected default policy, got %+v", policy)
+	}
+	client, server := net.Pipe()
+	defer client.Close()
+	defer server.Close()
+	if !p.checkConnectPolicy(server, "example.com", "93.184.216.34", 443) {
+		t.Fatal("expected default policy to allow the connection")
+	}
+
+	if err := p.SetTenantPolicyChecker(42, stubPolicyChecker{allowConnect: true}); err != nil {
+		t.Fatalf("SetTenantPolicyChecker: %v", err)
+	}
+	if !p.checkConnectPolicy(tenantConn, "example.com", "93.184.216.34", 443) {
+		t.Fatal("expected updated tenant policy to allow the connection")
+	}
+
+	if err := p.RemoveTenant(42); err != nil {
+		t.Fatalf("RemoveTenant: %v", err)
+	}
+	if policy := p.policyFor(tenantConn); policy.tenant != 0 {
+		t.Fatalf("expected removed tenant to fall back to the default, got %+v", policy)
+	}
+	if err := p.RemoveTenant(42); err == nil {
+		t.Fatal("expected removing an unknown tenant to fail")
+	}
+}
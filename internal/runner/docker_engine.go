@@ -0,0 +1,380 @@
+package runner
+
+import (
+	"context"
+	"crypto/sha256"
+	"encoding/hex"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+	"io/fs"
+	"net"
+	"net/http"
+	"net/url"
+	"os"
+	"path/filepath"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// dockerEngine is a minimal Docker Engine API client for the read-only
+// queries startup makes: container and image inspects and the published port
+// list. Each `docker` CLI invocation costs a fork and exec plus the CLI's own
+// start-up, so these go straight to the daemon socket over one keep-alive
+// connection instead. Anything that mutates state (run, pull, rm, exec) still
+// goes through the CLI so its output and flags stay exactly as before.
+type dockerEngine struct {
+	client *http.Client
+	socket string
+	down   atomic.Bool
+}
+
+// errEngineUnavailable reports that the daemon socket could not be reached;
+// callers fall back to the CLI.
+var errEngineUnavailable = errors.New("docker engine unavailable")
+
+// newDockerEngine returns a client for the daemon socket the CLI would use,
+// or nil when the CLI would talk to something else, such as a TCP host, or
+// when its endpoint cannot be resolved.
+func newDockerEngine() *dockerEngine {
+	socket := dockerSocket()
+	if socket == "" {
+		return nil
+	}
+	if info, err := os.Stat(socket); err != nil || info.Mode()&os.ModeSocket == 0 {
+		return nil
+	}
+	return newDockerEngineAt(socket)
+}
+
+const defaultDockerSocket = "/var/run/docker.sock"
+
+// dockerSocket resolves the daemon endpoint the way the docker CLI does:
+// DOCKER_CONTEXT, then DOCKER_HOST, then the currentContext set by `docker
+// context use`, then the default socket. It returns "" when that endpoint is
+// not a unix socket or cannot be resolved.
+func dockerSocket() string {
+	name := strings.TrimSpace(os.Getenv("DOCKER_CONTEXT"))
+	host := strings.TrimSpace(os.Getenv("DOCKER_HOST"))
+	if name == "" && host == "" {
+		current, ok := currentDockerContext()
+		if !ok {
+			return ""
+		}
+		name = current
+	}
+	if name != "" && name != "default" {
+		return contextSocket(name)
+	}
+	if host != "" {
+		return unixSocket(host)
+	}
+	return defaultDockerSocket
+}
+
+// dockerConfigDir is the CLI's configuration directory.
+func dockerConfigDir() string {
+	if dir := strings.TrimSpace(os.Getenv("DOCKER_CONFIG")); dir != "" {
+		return dir
+	}
+	home, err := os.UserHomeDir()
+	if err != nil {
+		return ""
+	}
+	return filepath.Join(home, ".docker")
+}
+
+// currentDockerContext reads the context selected in the CLI config. A
+// missing config selects the default context; an unreadable one is not ok.
+func currentDockerContext() (string, bool) {
+	dir := dockerConfigDir()
+	if dir == "" {
+		return "", false
+	}
+	data, err := os.ReadFile(filepath.Join(dir, "config.json"))
+	if errors.Is(err, fs.ErrNotExist) {
+		return "", true
+	}
+	if err != nil {
+		return "", false
+	}
+	var cfg struct {
+		CurrentContext string `json:"currentContext"`
+	}
+	if err := json.Unmarshal(data, &cfg); err != nil {
+		return "", false
+	}
+	return strings.TrimSpace(cfg.CurrentContext), true
+}
+
+// contextSocket returns the unix socket of the named context's docker
+// endpoint. The CLI stores a context's metadata under the SHA-256 of its name.
+func contextSocket(name string) string {
+	dir := dockerConfigDir()
+	if dir == "" {
+		return ""
+	}
+	sum := sha256.Sum256([]byte(name))
+	data, err := os.ReadFile(filepath.Join(dir, "contexts", "meta", hex.EncodeToString(sum[:]), "meta.json"))
+	if err != nil {
+		return ""
+	}
+	var meta struct {
+		Endpoints map[string]struct {
+			Host string `json:"Host"`
+		} `json:"Endpoints"`
+	}
+	if err := json.Unmarshal(data, &meta); err != nil {
+		return ""
+	}
+	return unixSocket(meta.Endpoints["docker"].Host)
+}
+
+// unixSocket returns the path of a unix:// host, or "" for any other host.
+func unixSocket(host string) string {
+	path, ok := strings.CutPrefix(strings.TrimSpace(host), "unix://")
+	if !ok {
+		return ""
+	}
+	return path
+}
+
+func newDockerEngineAt(socket string) *dockerEngine {
+	dialer := &net.Dialer{Timeout: 2 * time.Second}
+	return &dockerEngine{
+		socket: socket,
+		client: &http.Client{
+			Transport: &http.Transport{
+				DialContext: func(ctx context.Context, _, _ string) (net.Conn, error) {
+					return dialer.DialContext(ctx, "unix", socket)
+				},
+				MaxIdleConnsPerHost: 4,
+				IdleConnTimeout:     30 * time.Second,
+			},
+		},
+	}
+}
+
+// usable reports whether the engine should be tried. A nil engine, or one
+// whose socket stopped answering, is not.
+func (d *dockerEngine) usable() bool {
+	return d != nil && !d.down.Load()
+}
+
+// get decodes the JSON response for path into out. A daemon error status is
+// returned with the daemon's message, which carries the same "No such ..."
+// wording the CLI prints.
+func (d *dockerEngine) get(ctx context.Context, path string, query url.Values, out any) error {
+	u := url.URL{Scheme: "http", Host: "docker", Path: path, RawQuery: query.Encode()}
+	req, err := http.NewRequestWithContext(ctx, http.MethodGet, u.String(), nil)
+	if err != nil {
+		return err
+	}
+	resp, err := d.client.Do(req)
+	if err != nil {
+		if ctx.Err() != nil {
+			return ctx.Err()
+		}
+		d.down.Store(true)
+		return fmt.Errorf("%w: %s: %v", errEngineUnavailable, d.socket, err)
+	}
+	defer resp.Body.Close()
+	if resp.StatusCode != http.StatusOK {
+		var body struct {
+			Message string `json:"message"`
+		}
+		raw, _ := io.ReadAll(io.LimitReader(resp.Body, 64<<10))
+		if json.Unmarshal(raw, &body) != nil || body.Message == "" {
+			body.Message = strings.TrimSpace(string(raw))
+		}
+		return fmt.Errorf("docker engine GET %s: %s (status %d)", path, body.Message, resp.StatusCode)
+	}
+	return json.NewDecoder(resp.Body).Decode(out)
+}
+
+// engineContainer is the subset of a container inspect startup reads.
+type engineContainer struct {
+	Name  string `json:"Name"`
+	State struct {
+		Running bool `json:"Running"`
+	} `json:"State"`
+}
+
+func (d *dockerEngine) inspectContainer(ctx context.Context, name string) (engineContainer, error) {
+	var out engineContainer
+	err := d.get(ctx, "/containers/"+name+"/json", nil, &out)
+	return out, err
+}
+
+// engineImage is the subset of an image inspect startup reads.
+type engineImage struct {
+	ID           string `json:"Id"`
+	Architecture string `json:"Architecture"`
+	Config       struct {
+		Entrypoint   []string       `json:"Entrypoint"`
+		Cmd          []string       `json:"Cmd"`
+		StopSignal   string         `json:"StopSignal"`
+		ExposedPorts map[string]any `json:"ExposedPorts"`
+	} `json:"Config"`
+}
+
+func (d *dockerEngine) inspectImage(ctx context.Context, image string) (engineImage, error) {
+	var out engineImage
+	err := d.get(ctx, "/images/"+image+"/json", nil, &out)
+	return out, err
+}
+
+// publishedPorts returns the host ports published by running containers.
+func (d *dockerEngine) publishedPorts(ctx context.Context) (map[string]bool, error) {
+	var containers []struct {
+		Ports []struct {
+			PublicPort int `json:"PublicPort"`
+		} `json:"Ports"`
+	}
+	if err := d.get(ctx, "/containers/json", nil, &containers); err != nil {
+		return nil, err
+	}
+	used := make(map[string]bool)
+	for _, c := range containers {
+		for _, p := range c.Ports {
+			if p.PublicPort != 0 {
+				used[strconv.Itoa(p.PublicPort)] = true
+			}
+		}
+	}
+	return used, nil
+}
+
+// engineFallback reports whether err means the CLI should be used instead.
+func engineFallback(err error) bool {
+	return errors.Is(err, errEngineUnavailable)
+}
+
+// engineImage returns the cached inspect of image from the Engine API. ok is
+// false when the API is not in use and the caller should ask the CLI.
+func (r *runner) engineImage(ctx context.Context, image string) (img engineImage, ok bool, err error) {
+	if !r.engine.usable() {
+		return engineImage{}, false, nil
+	}
+	r.imagesMu.Lock()
+	cached, hit := r.images[image]
+	r.imagesMu.Unlock()
+	if hit {
+		return cached, true, nil
+	}
+	img, err = r.engine.inspectImage(ctx, image)
+	if engineFallback(err) {
+		r.debugf("falling back to docker CLI: %v", err)
+		return engineImage{}, false, nil
+	}
+	if err != nil {
+		return engineImage{}, true, err
+	}
+	r.imagesMu.Lock()
+	if r.images == nil {
+		r.images = make(map[string]engineImage)
+	}
+	r.images[image] = img
+	r.imagesMu.Unlock()
+	return img, true, nil
+}
+
+// forgetImage drops a cached inspect, such as after pulling a newer image.
+func (r *runner) forgetImage(image string) {
+	r.imagesMu.Lock()
+	delete(r.images, image)
+	r.imagesMu.Unlock()
+}
+
+// containerState reports whether a container named name exists and whether
+// it is running, with a single inspect.
+func (r *runner) containerState(ctx context.Context, name string) (exists, running bool, err error) {
+	if r.engine.usable() {
+		c, err := r.engine.inspectContainer(ctx, name)
+		switch {
+		case err == nil:
+			return true, c.State.Running, nil
+		case isNoSuchObjectError(err):
+			return false, false, nil
+		case !engineFallback(err):
+			return false, false, err
+		}
+		r.debugf("falling back to docker CLI: %v", err)
+	}
+	out, err := commandOutput(ctx, "docker", "inspect", "-f", "{{.State.Running}}", name)
+	if err != nil {
+		if isNoSuchObjectError(err) {
+			return false, false, nil
+		}
+		return false, false, err
+	}
+	return true, strings.TrimSpace(out) == "true", nil
+}
+
+// usedHostPorts lists the host ports Docker currently publishes.
+func (r *runner) usedHostPorts(ctx context.Context) (map[string]bool, error) {
+	if r.engine.usable() {
+		used, err := r.engine.publishedPorts(ctx)
+		if err == nil {
+			return used, nil
+		}
+		if !engineFallback(err) {
+			return nil, fmt.Errorf("list docker ports: %w", err)
+		}
+		r.debugf("falling back to docker CLI: %v", err)
+	}
+	out, err := commandOutput(ctx, "docker", "ps", "--format", "{{.Names}} {{.Ports}}")
+	if err != nil {
+		return nil, fmt.Errorf("list docker ports: %w", err)
+	}
+	return parsePublishedPorts(out), nil
+}
+
+// parsePublishedPorts extracts host ports from `docker ps` port columns such
+// as "0.0.0.0:18080->18080/tcp, :::18080->18080/tcp".
+func parsePublishedPorts(out string) map[string]bool {
+	used := make(map[string]bool)
+	for {
+		arrow := strings.Index(out, "->")
+		if arrow < 0 {
+			return used
+		}
+		if colon := strings.LastIndexByte(out[:arrow], ':'); colon >= 0 {
+			if port := out[colon+1 : arrow]; port != "" && strings.Trim(port, "0123456789") == "" {
+				used[port] = true
+			}
+		}
+		out = out[arrow+2:]
+	}
+}
+
+// runConcurrently runs fns in parallel and waits for all of them. The first
+// error returned is reported, and the context passed to the others is
+// cancelled so they can stop early.
+func runConcurrently(ctx context.Context, fns ...func(context.Context) error) error {
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+	var (
+		wg       sync.WaitGroup
+		once     sync.Once
+		firstErr error
+	)
+	for _, fn := range fns {
+		wg.Add(1)
+		go func(fn func(context.Context) error) {
+			defer wg.Done()
+			if err := fn(ctx); err != nil {
+				once.Do(func() {
+					firstErr = err
+					cancel()
+				})
+			}
+		}(fn)
+	}
+	wg.Wait()
+	return firstErr
+}
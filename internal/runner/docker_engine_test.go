@@ -0,0 +1,330 @@
+package runner
+
+import (
+	"context"
+	"crypto/sha256"
+	"encoding/hex"
+	"encoding/json"
+	"fmt"
+	"io"
+	"log"
+	"net"
+	"net/http"
+	"net/http/httptest"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"testing"
+
+	"github.com/strongdm/leash/internal/leashd/listen"
+)
+
+// fakeEngine serves the Engine API endpoints startup queries over a unix
+// socket and counts the requests it sees.
+type fakeEngine struct {
+	mu       sync.Mutex
+	requests map[string]int
+	socket   string
+}
+
+func newFakeEngine(tb testing.TB) *fakeEngine {
+	tb.Helper()
+	// Unix socket paths are limited to about 100 bytes, which t.TempDir can
+	// exceed.
+	dir, err := os.MkdirTemp("", "leash-engine")
+	if err != nil {
+		tb.Fatal(err)
+	}
+	tb.Cleanup(func() { _ = os.RemoveAll(dir) })
+	socket := filepath.Join(dir, "docker.sock")
+	ln, err := net.Listen("unix", socket)
+	if err != nil {
+		tb.Skipf("unix sockets unavailable: %v", err)
+	}
+
+	f := &fakeEngine{requests: make(map[string]int), socket: socket}
+	srv := httptest.NewUnstartedServer(http.HandlerFunc(f.serve))
+	srv.Listener = ln
+	srv.Start()
+	tb.Cleanup(srv.Close)
+	return f
+}
+
+func (f *fakeEngine) serve(w http.ResponseWriter, req *http.Request) {
+	f.mu.Lock()
+	f.requests[req.URL.Path]++
+	f.mu.Unlock()
+
+	path := req.URL.Path
+	switch {
+	case path == "/containers/json":
+		_ = json.NewEncoder(w).Encode([]map[string]any{
+			{"Names": []string{"/other"}, "Ports": []map[string]any{{"PrivatePort": 18080, "PublicPort": 18080, "Type": "tcp"}}},
+		})
+	case strings.HasPrefix(path, "/containers/"):
+		name := strings.TrimSuffix(strings.TrimPrefix(path, "/containers/"), "/json")
+		w.WriteHeader(http.StatusNotFound)
+		fmt.Fprintf(w, `{"message":"No such container: %s"}`, name)
+	case strings.HasPrefix(path, "/images/"):
+		_ = json.NewEncoder(w).Encode(map[string]any{
+			"Id":           "sha256:1234",
+			"Architecture": "arm64",
+			"Config": map[string]any{
+				"Cmd":          []string{"/bin/bash"},
+				"StopSignal":   "SIGINT",
+				"ExposedPorts": map[string]any{"8080/tcp": map[string]any{}},
+			},
+		})
+	default:
+		http.NotFound(w, req)
+	}
+}
+
+func (f *fakeEngine) count(path string) int {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	return f.requests[path]
+}
+
+func newPreflightRunner(engine *dockerEngine) *runner {
+	return &runner{
+		cfg: config{
+			targetContainer:     "target",
+			leashContainer:      "target-leash",
+			targetContainerBase: "target",
+			leashContainerBase:  "target-leash",
+			targetImage:         "example/target:latest",
+			leashImage:          "example/leash:latest",
+			listenCfg:           listen.Config{Port: "18080"},
+		},
+		opts:   options{publishAll: true},
+		logger: log.New(io.Discard, "", 0),
+		engine: engine,
+	}
+}
+
+func TestPreflightDockerUsesEngineAPI(t *testing.T) {
+	t.Parallel()
+
+	fake := newFakeEngine(t)
+
+	commandOverrideMu.Lock()
+	restoreOutput := commandOutput
+	commandOutput = func(ctx context.Context, name string, args ...string) (string, error) {
+		t.Helper()
+		return "", fmt.Errorf("unexpected command: %s %v", name, args)
+	}
+	t.Cleanup(func() {
+		commandOutput = restoreOutput
+		commandOverrideMu.Unlock()
+	})
+
+	r := newPreflightRunner(newDockerEngineAt(fake.socket))
+	ctx := context.Background()
+	if err := r.preflightDocker(ctx); err != nil {
+		t.Fatalf("preflightDocker returned error: %v", err)
+	}
+
+	if got, want := r.cfg.listenCfg.Port, "18081"; got != want {
+		t.Fatalf("listen port mismatch: got %q want %q", got, want)
+	}
+	if len(r.opts.publishes) != 1 || r.opts.publishes[0].ContainerPort != "8080" || r.opts.publishes[0].HostPort != "8080" {
+		t.Fatalf("unexpected publishes: %+v", r.opts.publishes)
+	}
+	sig, err := r.getImageStopSignal(ctx)
+	if err != nil {
+		t.Fatalf("getImageStopSignal returned error: %v", err)
+	}
+	if sig != "SIGINT" {
+		t.Fatalf("stop signal mismatch: got %q", sig)
+	}
+	arch, err := r.detectImageArch(ctx)
+	if err != nil {
+		t.Fatalf("detectImageArch returned error: %v", err)
+	}
+	if arch != "arm64" {
+		t.Fatalf("arch mismatch: got %q", arch)
+	}
+
+	// Every later read of the target image is served from the first inspect.
+	for _, image := range []string{r.cfg.targetImage, r.cfg.leashImage} {
+		if got := fake.count("/images/" + image + "/json"); got != 1 {
+			t.Fatalf("expected one inspect of %s, got %d", image, got)
+		}
+	}
+	if got := fake.count("/containers/target/json"); got != 1 {
+		t.Fatalf("expected one inspect of target, got %d", got)
+	}
+}
+
+func TestContainerStateFallsBackToCLI(t *testing.T) {
+	t.Parallel()
+
+	commandOverrideMu.Lock()
+	restoreOutput := commandOutput
+	var calls int
+	commandOutput = func(ctx context.Context, name string, args ...string) (string, error) {
+		t.Helper()
+		if name == "docker" && len(args) > 0 && args[0] == "inspect" {
+			calls++
+			return "true\n", nil
+		}
+		return "", fmt.Errorf("unexpected command: %s %v", name, args)
+	}
+	t.Cleanup(func() {
+		commandOutput = restoreOutput
+		commandOverrideMu.Unlock()
+	})
+
+	dir, err := os.MkdirTemp("", "leash-engine")
+	if err != nil {
+		t.Fatal(err)
+	}
+	t.Cleanup(func() { _ = os.RemoveAll(dir) })
+	r := newPreflightRunner(newDockerEngineAt(filepath.Join(dir, "missing.sock")))
+
+	for i := 0; i < 2; i++ {
+		exists, running, err := r.containerState(context.Background(), "target")
+		if err != nil {
+			t.Fatalf("containerState returned error: %v", err)
+		}
+		if !exists || !running {
+			t.Fatalf("expected running container, got exists=%v running=%v", exists, running)
+		}
+	}
+	if r.engine.usable() {
+		t.Fatal("expected engine to be marked unavailable after a dial failure")
+	}
+	if calls != 2 {
+		t.Fatalf("expected two CLI inspects, got %d", calls)
+	}
+}
+
+func TestParsePublishedPorts(t *testing.T) {
+	t.Parallel()
+
+	out := "web 0.0.0.0:8080->80/tcp, :::8080->80/tcp\ndb 5432/tcp\napi 127.0.0.1:19000->19000/tcp\n"
+	got := parsePublishedPorts(out)
+	for _, port := range []string{"8080", "19000"} {
+		if !got[port] {
+			t.Fatalf("expected %s in %v", port, got)
+		}
+	}
+	if len(got) != 2 {
+		t.Fatalf("unexpected ports: %v", got)
+	}
+}
+
+func TestDockerSocketFollowsCLIContext(t *testing.T) {
+	dir := t.TempDir()
+	t.Setenv("DOCKER_CONFIG", dir)
+	t.Setenv("DOCKER_CONTEXT", "")
+	t.Setenv("DOCKER_HOST", "")
+
+	writeContext := func(name, host string) {
+		t.Helper()
+		sum := sha256.Sum256([]byte(name))
+		meta := filepath.Join(dir, "contexts", "meta", hex.EncodeToString(sum[:]))
+		if err := os.MkdirAll(meta, 0o755); err != nil {
+			t.Fatal(err)
+		}
+		data := fmt.Sprintf(`{"Name":%q,"Endpoints":{"docker":{"Host":%q,"SkipTLSVerify":false}}}`, name, host)
+		if err := os.WriteFile(filepath.Join(meta, "meta.json"), []byte(data), 0o644); err != nil {
+			t.Fatal(err)
+		}
+	}
+	writeContext("rootless", "unix:///run/user/1000/docker.sock")
+	writeContext("remote", "tcp://10.0.0.1:2376")
+
+	if got := dockerSocket(); got != defaultDockerSocket {
+		t.Fatalf("expected the default socket without a config, got %q", got)
+	}
+	if err := os.WriteFile(filepath.Join(dir, "config.json"), []byte(`{"currentContext":"rootless"}`), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if got := dockerSocket(); got != "/run/user/1000/docker.sock" {
+		t.Fatalf("expected the current context's socket, got %q", got)
+	}
+
+	t.Setenv("DOCKER_HOST", "unix:///tmp/host.sock")
+	if got := dockerSocket(); got != "/tmp/host.sock" {
+		t.Fatalf("expected DOCKER_HOST to override the current context, got %q", got)
+	}
+	t.Setenv("DOCKER_CONTEXT", "remote")
+	if got := dockerSocket(); got != "" {
+		t.Fatalf("expected a TCP context to fall back to the CLI, got %q", got)
+	}
+	t.Setenv("DOCKER_CONTEXT", "missing")
+	if got := dockerSocket(); got != "" {
+		t.Fatalf("expected an unknown context to fall back to the CLI, got %q", got)
+	}
+	t.Setenv("DOCKER_CONTEXT", "default")
+	if got := dockerSocket(); got != "/tmp/host.sock" {
+		t.Fatalf("expected the default context to use DOCKER_HOST, got %q", got)
+	}
+
+	t.Setenv("DOCKER_CONTEXT", "")
+	t.Setenv("DOCKER_HOST", "")
+	if err := os.WriteFile(filepath.Join(dir, "config.json"), []byte(`{`), 0o644); err != nil {
+		t.Fatal(err)
+	}
+	if got := dockerSocket(); got != "" {
+		t.Fatalf("expected an unreadable config to fall back to the CLI, got %q", got)
+	}
+}
+
+// BenchmarkStartupPreflight compares the Docker checks startup makes before
+// the first container launches when they go through the Engine API against
+// the CLI. The CLI variant execs a stub `docker` script, so it measures the
+// per-command process cost without the real CLI's own start-up on top.
+func BenchmarkStartupPreflight(b *testing.B) {
+	b.Run("engine", func(b *testing.B) {
+		fake := newFakeEngine(b)
+		engine := newDockerEngineAt(fake.socket)
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if err := newPreflightRunner(engine).preflightDocker(context.Background()); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("cli", func(b *testing.B) {
+		dir := b.TempDir()
+		script := `#!/bin/sh
+case "$1" in
+image) echo '[{"Id":"sha256:1234"}]' ;;
+inspect)
+	case "$*" in
+	*Architecture*) echo arm64 ;;
+	*ExposedPorts*) echo '{"8080/tcp":{}}' ;;
+	*) echo "Error: No such object: $4" >&2; exit 1 ;;
+	esac ;;
+ps) echo "other 0.0.0.0:18080->18080/tcp" ;;
+*) exit 1 ;;
+esac
+`
+		if err := os.WriteFile(filepath.Join(dir, "docker"), []byte(script), 0o755); err != nil {
+			b.Fatal(err)
+		}
+		b.Setenv("PATH", dir+string(os.PathListSeparator)+os.Getenv("PATH"))
+
+		commandOverrideMu.Lock()
+		restoreOutput := commandOutput
+		commandOutput = commandOutputImpl
+		b.Cleanup(func() {
+			commandOutput = restoreOutput
+			commandOverrideMu.Unlock()
+		})
+
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if err := newPreflightRunner(nil).preflightDocker(context.Background()); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,452 @@
+package runner
+
+import (
+	"context"
+	"crypto/rand"
+	"encoding/hex"
+	"errors"
+	"flag"
+	"fmt"
+	"log"
+	"os"
+	"os/signal"
+	"path/filepath"
+	"strings"
+	"syscall"
+	"time"
+
+	"github.com/strongdm/leash/internal/entrypoint"
+	"github.com/strongdm/leash/internal/leashd/listen"
+)
+
+// The warm pool keeps standby leash containers running so a session can
+// claim one instead of starting its own. A standby container owns the
+// network namespace, which the target joins, and its leashd has done
+// everything that does not depend on the target: CA, policy compile and
+// BPF load and verify. Claiming renames the container to the session's leash
+// container name; the session then writes the target cgroup into the
+// container's share dir (entrypoint.PoolClaim), and leashd attaches and
+// continues with the usual bootstrap handshake.
+const (
+	poolEnv         = "LEASH_POOL"
+	poolDirEnv      = "LEASH_POOL_DIR"
+	poolNamePrefix  = "leash-pool-"
+	poolLabel       = "leash.pool"
+	poolImageLabel  = "leash.pool.image"
+	poolDirLabel    = "leash.pool.dir"
+	poolListenLabel = "leash.pool.listen"
+	defaultPoolSize = 2
+	poolInterval    = 2 * time.Second
+)
+
+// pooledLeash is a standby leash container, either idle in the pool or
+// claimed by this session.
+type pooledLeash struct {
+	name   string
+	dir    string
+	listen listen.Config
+}
+
+// poolDirs returns the share, private, log and cfg dirs of the pooled
+// container rooted at dir.
+func poolDirs(dir string) (share, private, logDir, cfgDir string) {
+	return filepath.Join(dir, "share"), filepath.Join(dir, "private"), filepath.Join(dir, "log"), filepath.Join(dir, "cfg")
+}
+
+func poolRoot() (string, error) {
+	if dir := strings.TrimSpace(os.Getenv(poolDirEnv)); dir != "" {
+		return dir, nil
+	}
+	base, err := os.UserCacheDir()
+	if err != nil {
+		return "", fmt.Errorf("locate warm pool dir (set %s): %w", poolDirEnv, err)
+	}
+	return filepath.Join(base, "leash", "pool"), nil
+}
+
+// poolIneligible explains why this session cannot use a standby container,
+// or returns "" when it can. Standby containers are started before any
+// session exists, so nothing session-specific can be baked into them.
+func (r *runner) poolIneligible() string {
+	switch {
+	case len(r.opts.publishes) > 0:
+		// Ports of a shared network namespace are published by its owner.
+		return "ports are published"
+	case r.cfg.listenExplicit:
+		return "the listen address is set"
+	case !r.cfg.workDirIsTemp || r.cfg.shareDirFromEnv:
+		return "the work or share dir is set"
+	case r.cfg.cgroupPathOverride != "":
+		return "the cgroup path is set"
+	case strings.TrimSpace(r.cfg.extraArgs) != "":
+		return "LEASH_EXTRA_ARGS is set"
+	}
+	for _, env := range r.opts.envVars {
+		if strings.HasPrefix(env, "LEASH_") {
+			return fmt.Sprintf("%s is passed to leashd", envSpecKey(env))
+		}
+	}
+	return ""
+}
+
+// claimPooledLeash takes over an idle standby container matching the leash
+// image when LEASH_POOL=1. Any failure leaves the session on the regular
+// launch path, so it only reports whether a container was claimed.
+func (r *runner) claimPooledLeash(ctx context.Context) bool {
+	if !r.cfg.usePool {
+		return false
+	}
+	if reason := r.poolIneligible(); reason != "" {
+		r.debugf("Warm pool skipped: %s.", reason)
+		return false
+	}
+
+	idle, err := listPooledLeash(ctx, r.cfg.leashImage)
+	if err != nil {
+		r.debugf("Warm pool unavailable: %v", err)
+		return false
+	}
+	for _, candidate := range idle {
+		// Renaming fails once another session has renamed the container, so
+		// racing sessions never claim the same one.
+		if _, err := commandOutput(ctx, "docker", "rename", candidate.name, r.cfg.leashContainer); err != nil {
+			r.debugf("Warm pool container %s was not claimed: %v", candidate.name, err)
+			continue
+		}
+		claimed := candidate
+		r.pool = &claimed
+		r.debugf("Claimed warm pool container %s as %s.", candidate.name, r.cfg.leashContainer)
+		return true
+	}
+	r.debugf("Warm pool has no idle container for %s.", r.cfg.leashImage)
+	return false
+}
+
+// adoptPooledLeash points the session at the claimed container's dirs and
+// listen address and carries over the policy prepareHostDirs synced.
+func (r *runner) adoptPooledLeash() error {
+	share, private, logDir, cfgDir := poolDirs(r.pool.dir)
+
+	policy, err := os.ReadFile(filepath.Join(r.cfg.cfgDir, "leash.cedar"))
+	if err != nil && !os.IsNotExist(err) {
+		return fmt.Errorf("read Cedar policy: %w", err)
+	}
+	if err == nil {
+		if err := os.WriteFile(filepath.Join(cfgDir, "leash.cedar"), policy, 0o644); err != nil {
+			return fmt.Errorf("copy Cedar policy: %w", err)
+		}
+	}
+
+	if r.shareDirCreated {
+		_ = os.RemoveAll(r.cfg.shareDir)
+	}
+	if r.cfg.privateDirCreated {
+		_ = os.RemoveAll(r.cfg.privateDir)
+	}
+	r.cfg.shareDir, r.shareDirCreated = share, false
+	r.cfg.privateDir, r.cfg.privateDirCreated = private, false
+	r.cfg.logDir, r.cfg.cfgDir = logDir, cfgDir
+	r.cfg.listenCfg = r.pool.listen
+	return nil
+}
+
+// bindPooledLeash hands the target cgroup and session details to the
+// claimed container's standby leashd.
+func (r *runner) bindPooledLeash(cgroupPath string) error {
+	claim := entrypoint.PoolClaim{
+		CgroupPath:    cgroupPath,
+		SessionID:     r.sessionID,
+		WorkspaceHash: r.workspaceHash,
+		Project:       workspaceNameFrom(r.cfg.callerDir),
+		Command:       strings.Join(r.opts.command, " "),
+	}
+	return entrypoint.WritePoolClaim(r.cfg.shareDir, claim)
+}
+
+// listPooledLeash returns the running, unclaimed standby containers for
+// image.
+func listPooledLeash(ctx context.Context, image string) ([]pooledLeash, error) {
+	out, err := commandOutput(ctx, "docker", "ps",
+		"--filter", "label="+poolImageLabel+"="+image,
+		"--filter", "status=running",
+		"--format", poolFormat,
+	)
+	if err != nil {
+		return nil, err
+	}
+	var idle []pooledLeash
+	for _, c := range parsePoolContainers(out) {
+		if c.state == "running" && strings.HasPrefix(c.name, poolNamePrefix) {
+			idle = append(idle, c.pooledLeash)
+		}
+	}
+	return idle, nil
+}
+
+const poolFormat = `{{.Names}}\t{{.State}}\t{{.Label "` + poolDirLabel + `"}}\t{{.Label "` + poolListenLabel + `"}}`
+
+type poolContainer struct {
+	pooledLeash
+	state string
+}
+
+// parsePoolContainers parses `docker ps --format poolFormat` output. Lines
+// without a pool dir or a valid listen address are skipped.
+func parsePoolContainers(out string) []poolContainer {
+	var containers []poolContainer
+	for _, line := range strings.Split(out, "\n") {
+		fields := strings.Split(strings.TrimSpace(line), "\t")
+		if len(fields) != 4 || fields[0] == "" || fields[2] == "" {
+			continue
+		}
+		cfg, err := listen.Parse(fields[3])
+		if err != nil || cfg.Disable {
+			continue
+		}
+		containers = append(containers, poolContainer{
+			pooledLeash: pooledLeash{name: fields[0], dir: fields[2], listen: cfg},
+			state:       fields[1],
+		})
+	}
+	return containers
+}
+
+// warmPool keeps size standby containers of one leash image running.
+type warmPool struct {
+	root  string
+	size  int
+	image string
+	// r provides the docker helpers; its cfg carries the leash settings the
+	// standby containers start with.
+	r *runner
+}
+
+// PoolMain runs the warm pool until interrupted, then removes the containers
+// that were never claimed. Sessions opt in with LEASH_POOL=1.
+func PoolMain(args []string) error {
+	fs := flag.NewFlagSet("leash --pool", flag.ContinueOnError)
+	size := fs.Int("size", defaultPoolSize, "Number of idle leash containers to keep running")
+	image := fs.String("leash-image", envOrDefault("LEASH_IMAGE", defaultLeashImage), "Leash manager image")
+	verbose := fs.Bool("verbose", false, "Enable verbose logging")
+	if err := fs.Parse(args); err != nil {
+		return err
+	}
+	if *size < 1 {
+		return fmt.Errorf("--size must be at least 1")
+	}
+	if err := ensureCommand("docker"); err != nil {
+		return err
+	}
+	root, err := poolRoot()
+	if err != nil {
+		return err
+	}
+	timeout := defaultBootstrapTimeout
+	if raw := strings.TrimSpace(os.Getenv("LEASH_BOOTSTRAP_TIMEOUT")); raw != "" {
+		if timeout, err = parseTimeout(raw); err != nil {
+			return fmt.Errorf("parse LEASH_BOOTSTRAP_TIMEOUT: %w", err)
+		}
+		if timeout <= 0 {
+			return fmt.Errorf("LEASH_BOOTSTRAP_TIMEOUT must be positive")
+		}
+	}
+
+	p := &warmPool{
+		root:  root,
+		size:  *size,
+		image: strings.TrimSpace(*image),
+		r: &runner{
+			cfg: config{
+				leashImage:       strings.TrimSpace(*image),
+				proxyPort:        envOrDefault("LEASH_PROXY_PORT", defaultProxyPort),
+				bootstrapTimeout: timeout,
+			},
+			verbose: *verbose,
+			logger:  log.New(os.Stderr, "", 0),
+			engine:  newDockerEngine(),
+		},
+	}
+
+	ctx, stop := signal.NotifyContext(context.Background(), os.Interrupt, syscall.SIGTERM)
+	defer stop()
+	if err := p.r.ensureLocalImage(ctx, p.image); err != nil {
+		return err
+	}
+
+	p.r.logger.Printf("Keeping %d standby leash containers of %s in %s.", p.size, p.image, p.root)
+	ticker := time.NewTicker(poolInterval)
+	defer ticker.Stop()
+	for {
+		if err := p.fill(ctx); err != nil && ctx.Err() == nil {
+			p.r.logger.Printf("Warning: warm pool refill failed: %v", err)
+		}
+		select {
+		case <-ctx.Done():
+			return p.drain(context.Background())
+		case <-ticker.C:
+		}
+	}
+}
+
+// containers lists every container the pool started, claimed or not.
+func (p *warmPool) containers(ctx context.Context) ([]poolContainer, error) {
+	out, err := commandOutput(ctx, "docker", "ps", "-a",
+		"--filter", "label="+poolLabel,
+		"--format", poolFormat,
+	)
+	if err != nil {
+		return nil, err
+	}
+	return parsePoolContainers(out), nil
+}
+
+// fill removes standby containers that exited, deletes dirs no container
+// references any more, and starts containers until size are idle.
+func (p *warmPool) fill(ctx context.Context) error {
+	containers, err := p.containers(ctx)
+	if err != nil {
+		return err
+	}
+	referenced := make(map[string]bool)
+	idle := 0
+	for _, c := range containers {
+		if !strings.HasPrefix(c.name, poolNamePrefix) {
+			// Claimed; the session removes it and its dir.
+			referenced[c.dir] = true
+			continue
+		}
+		if c.state != "running" {
+			p.r.debugf("Removing standby container %s (%s).", c.name, c.state)
+			_ = runCommand(ctx, "docker", "rm", "-f", c.name)
+			continue
+		}
+		referenced[c.dir] = true
+		idle++
+	}
+	p.prune(referenced)
+
+	for ; idle < p.size; idle++ {
+		if err := p.start(ctx); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// prune deletes pool dirs that no container references.
+func (p *warmPool) prune(referenced map[string]bool) {
+	entries, err := os.ReadDir(p.root)
+	if err != nil {
+		return
+	}
+	for _, entry := range entries {
+		dir := filepath.Join(p.root, entry.Name())
+		if entry.IsDir() && strings.HasPrefix(entry.Name(), poolNamePrefix) && !referenced[dir] {
+			p.r.debugf("Removing unused pool dir %s.", dir)
+			_ = os.RemoveAll(dir)
+		}
+	}
+}
+
+// start launches one standby container with its own dirs and listen port.
+func (p *warmPool) start(ctx context.Context) (err error) {
+	var suffix [6]byte
+	if _, err := rand.Read(suffix[:]); err != nil {
+		return err
+	}
+	name := poolNamePrefix + hex.EncodeToString(suffix[:])
+	dir := filepath.Join(p.root, name)
+	defer func() {
+		if err != nil {
+			_ = os.RemoveAll(dir)
+		}
+	}()
+
+	share, private, logDir, cfgDir := poolDirs(dir)
+	for _, d := range []string{share, logDir, cfgDir} {
+		if err := os.MkdirAll(d, 0o755); err != nil {
+			return fmt.Errorf("create pool dir: %w", err)
+		}
+	}
+	if err := os.MkdirAll(private, 0o700); err != nil {
+		return fmt.Errorf("create pool dir: %w", err)
+	}
+	if err := os.Chmod(private, 0o700); err != nil {
+		return fmt.Errorf("set private dir permissions: %w", err)
+	}
+	if err := entrypoint.InflateBinaries(share); err != nil {
+		return fmt.Errorf("prepare leash-entry binaries: %w", err)
+	}
+
+	used, err := p.r.usedHostPorts(ctx)
+	if err != nil {
+		return err
+	}
+	p.r.cfg.listenCfg = listen.Default()
+	if err := p.r.allocateListenPortFrom(used); err != nil {
+		return err
+	}
+
+	if err := p.r.runDocker(ctx, p.runArgs(name, dir)...); err != nil {
+		return fmt.Errorf("start standby container %s: %w", name, err)
+	}
+	p.r.debugf("Started standby container %s listening on %s.", name, p.r.cfg.listenCfg.Address())
+	return nil
+}
+
+// runArgs mirrors launchLeashContainer, except that the standby container
+// owns the network namespace and publishes the Control UI port, and leashd
+// starts without a cgroup.
+func (p *warmPool) runArgs(name, dir string) []string {
+	cfg := p.r.cfg
+	share, private, logDir, cfgDir := poolDirs(dir)
+	return []string{
+		"run", "--pull=missing", "-d",
+		"--name", name,
+		"--label", poolLabel + "=1",
+		"--label", poolImageLabel + "=" + p.image,
+		"--label", poolDirLabel + "=" + dir,
+		"--label", poolListenLabel + "=" + cfg.listenCfg.Address(),
+		"--privileged",
+		"--cap-add", "NET_ADMIN",
+		"--cgroupns=host",
+		"-p", cfg.listenCfg.DockerPublish(),
+		"-v", "/sys/fs/cgroup:/sys/fs/cgroup:ro",
+		"-v", fmt.Sprintf("%s:/log", logDir),
+		"-v", fmt.Sprintf("%s:/cfg", cfgDir),
+		"-v", fmt.Sprintf("%s:%s", share, leashPublicMount),
+		"-v", fmt.Sprintf("%s:%s", private, leashPrivateMount),
+		"-e", fmt.Sprintf("LEASH_PROXY_PORT=%s", cfg.proxyPort),
+		"-e", fmt.Sprintf("LEASH_LISTEN=%s", cfg.listenCfg.Address()),
+		"-e", "LEASH_LOG=/log/events.log",
+		"-e", "LEASH_POLICY=/cfg/leash.cedar",
+		"-e", "LEASH_STANDBY=1",
+		"-e", fmt.Sprintf("LEASH_BOOTSTRAP_TIMEOUT=%s", cfg.bootstrapTimeout.String()),
+		"-e", fmt.Sprintf("LEASH_DIR=%s", leashPublicMount),
+		"-e", fmt.Sprintf("LEASH_PRIVATE_DIR=%s", leashPrivateMount),
+		p.image,
+	}
+}
+
+// drain removes the standby containers that were never claimed.
+func (p *warmPool) drain(ctx context.Context) error {
+	containers, err := p.containers(ctx)
+	if err != nil {
+		return err
+	}
+	var errs []error
+	removed := 0
+	for _, c := range containers {
+		if !strings.HasPrefix(c.name, poolNamePrefix) {
+			continue
+		}
+		if err := runCommand(ctx, "docker", "rm", "-f", c.name); err != nil {
+			errs = append(errs, fmt.Errorf("remove %s: %w", c.name, err))
+			continue
+		}
+		_ = os.RemoveAll(c.dir)
+		removed++
+	}
+	p.r.logger.Printf("Removed %d standby leash containers.", removed)
+	return errors.Join(errs...)
+}
@@ -0,0 +1,139 @@
+package runner
+
+import (
+	"context"
+	"fmt"
+	"io"
+	"log"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func TestParsePoolContainers(t *testing.T) {
+	t.Parallel()
+
+	out := strings.Join([]string{
+		"leash-pool-aaa\trunning\t/pool/leash-pool-aaa\t:18081",
+		"demo-leash\trunning\t/pool/leash-pool-bbb\t127.0.0.1:18082",
+		"leash-pool-ccc\texited\t/pool/leash-pool-ccc\t:18083",
+		"leash-pool-ddd\trunning\t\t:18084",
+		"leash-pool-eee\trunning\t/pool/leash-pool-eee\t",
+	}, "\n")
+	got := parsePoolContainers(out)
+	if len(got) != 3 {
+		t.Fatalf("expected 3 containers, got %+v", got)
+	}
+	if got[0].name != "leash-pool-aaa" || got[0].listen.Port != "18081" || got[0].state != "running" {
+		t.Fatalf("unexpected first container: %+v", got[0])
+	}
+	if got[1].listen.Host != "127.0.0.1" || got[1].dir != "/pool/leash-pool-bbb" {
+		t.Fatalf("unexpected claimed container: %+v", got[1])
+	}
+	if got[2].state != "exited" {
+		t.Fatalf("unexpected exited container: %+v", got[2])
+	}
+}
+
+func TestClaimPooledLeashSkipsContainersClaimedElsewhere(t *testing.T) {
+	t.Parallel()
+
+	commandOverrideMu.Lock()
+	restoreOutput := commandOutput
+	var renamed []string
+	commandOutput = func(ctx context.Context, name string, args ...string) (string, error) {
+		t.Helper()
+		switch {
+		case name == "docker" && args[0] == "ps":
+			return "leash-pool-aaa\trunning\t/pool/leash-pool-aaa\t:18081\nleash-pool-bbb\trunning\t/pool/leash-pool-bbb\t:18082\n", nil
+		case name == "docker" && args[0] == "rename":
+			renamed = append(renamed, args[1])
+			if args[1] == "leash-pool-aaa" {
+				return "", fmt.Errorf("Error: No such container: %s", args[1])
+			}
+			return "", nil
+		}
+		return "", fmt.Errorf("unexpected command: %s %v", name, args)
+	}
+	t.Cleanup(func() {
+		commandOutput = restoreOutput
+		commandOverrideMu.Unlock()
+	})
+
+	r := &runner{
+		cfg: config{
+			leashContainer: "demo-leash",
+			leashImage:     "example/leash:latest",
+			workDirIsTemp:  true,
+			usePool:        true,
+		},
+		logger: log.New(io.Discard, "", 0),
+	}
+	if !r.claimPooledLeash(context.Background()) {
+		t.Fatal("expected a container to be claimed")
+	}
+	if r.pool == nil || r.pool.name != "leash-pool-bbb" || r.pool.listen.Port != "18082" {
+		t.Fatalf("unexpected claim: %+v", r.pool)
+	}
+	if len(renamed) != 2 {
+		t.Fatalf("expected two rename attempts, got %v", renamed)
+	}
+}
+
+func TestPoolIneligible(t *testing.T) {
+	t.Parallel()
+
+	base := func() *runner {
+		return &runner{cfg: config{workDirIsTemp: true}}
+	}
+	if reason := base().poolIneligible(); reason != "" {
+		t.Fatalf("expected eligible session, got %q", reason)
+	}
+
+	cases := map[string]func(r *runner){
+		"publish":   func(r *runner) { r.opts.publishes = []publishSpec{{HostPort: "3000", ContainerPort: "3000"}} },
+		"listen":    func(r *runner) { r.cfg.listenExplicit = true },
+		"work dir":  func(r *runner) { r.cfg.workDirIsTemp = false },
+		"leash env": func(r *runner) { r.opts.envVars = []string{"LEASH_MCP_OBS=off"} },
+	}
+	for name, mutate := range cases {
+		r := base()
+		mutate(r)
+		if r.poolIneligible() == "" {
+			t.Fatalf("%s: expected session to be ineligible", name)
+		}
+	}
+}
+
+func TestAdoptPooledLeashCarriesPolicy(t *testing.T) {
+	t.Parallel()
+
+	workDir := t.TempDir()
+	poolDir := filepath.Join(t.TempDir(), "leash-pool-aaa")
+	_, _, _, poolCfg := poolDirs(poolDir)
+	if err := os.MkdirAll(poolCfg, 0o755); err != nil {
+		t.Fatal(err)
+	}
+	sessionCfg := filepath.Join(workDir, "cfg")
+	if err := os.MkdirAll(sessionCfg, 0o755); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.WriteFile(filepath.Join(sessionCfg, "leash.cedar"), []byte("permit (principal, action, resource);\n"), 0o644); err != nil {
+		t.Fatal(err)
+	}
+
+	r := &runner{
+		cfg:  config{cfgDir: sessionCfg, shareDir: filepath.Join(workDir, "share")},
+		pool: &pooledLeash{name: "leash-pool-aaa", dir: poolDir},
+	}
+	if err := r.adoptPooledLeash(); err != nil {
+		t.Fatalf("adoptPooledLeash returned error: %v", err)
+	}
+	if r.cfg.cfgDir != poolCfg {
+		t.Fatalf("cfg dir not switched: %s", r.cfg.cfgDir)
+	}
+	if data, err := os.ReadFile(filepath.Join(poolCfg, "leash.cedar")); err != nil || !strings.Contains(string(data), "permit") {
+		t.Fatalf("policy not carried over: %q %v", data, err)
+	}
+}
@@ -16,6 +16,7 @@ import (
 	"sort"
 	"strconv"
 	"strings"
+	"sync"
 	"sync/atomic"
 	"time"
 
@@ -24,6 +25,7 @@ import (
 	"github.com/strongdm/leash/internal/entrypoint"
 	"github.com/strongdm/leash/internal/leashd/listen"
 	"github.com/strongdm/leash/internal/openflag"
+	"github.com/strongdm/leash/internal/telemetry/startup"
 	"github.com/strongdm/leash/internal/telemetry/statsig"
 )
 
@@ -136,6 +138,7 @@ type config struct {
 	leashImageDevFile   string
 	listenCfg           listen.Config
 	listenExplicit      bool
+	usePool             bool
 }
 
 type runner struct {
@@ -150,6 +153,18 @@ type runner struct {
 	mountState    *mountState
 	sessionID     string
 	workspaceHash string
+
+	// engine, when set, answers startup's read-only docker queries over the
+	// Engine API; images caches its image inspects.
+	engine   *dockerEngine
+	imagesMu sync.Mutex
+	images   map[string]engineImage
+
+	// timeline times each startup phase; nil disables it.
+	timeline *startup.Timeline
+
+	// pool is the warm pool container this session claimed, if any.
+	pool *pooledLeash
 }
 
 // ExitCodeError propagates the exact exit status produced by the leashed command
@@ -240,6 +255,8 @@ func execute(cmdName string, args []string) error {
 		logger:        log.New(os.Stderr, "", 0),
 		sessionID:     sessionID,
 		workspaceHash: workspaceHash,
+		engine:        newDockerEngine(),
+		timeline:      startup.New("runner"),
 	}
 
 	if err := r.initMountState(context.Background(), callerDir); err != nil {
@@ -330,6 +347,8 @@ Environment variables:
   LEASH_EXTRA_ARGS             Additional arguments passed into leash-entry.
   LEASH_CGROUP_PATH            Override cgroup path for the leash container.
   LEASH_HOME                   Base directory for persisted leash state.
+  LEASH_POOL                   Set to 1 to claim a standby leash container from a running 'leash --pool'.
+  LEASH_POOL_DIR               Warm pool state directory (defaults to the user cache dir).
 
 	Persisted mount decisions live at $XDG_CONFIG_HOME/leash/config.toml (or ~/.config/leash/config.toml). Set LEASH_HOME to override this base directory.
 	Global and per-project sections in that file control whether ~/.codex, ~/.claude, and other tool directories
@@ -860,6 +879,7 @@ func loadConfig(callerDir string, opts options) (config, map[string]configstore.
 		proxyPort:           envOrDefault("LEASH_PROXY_PORT", defaultProxyPort),
 		extraArgs:           os.Getenv("LEASH_EXTRA_ARGS"),
 		cgroupPathOverride:  strings.TrimSpace(os.Getenv("LEASH_CGROUP_PATH")),
+		usePool:             strings.TrimSpace(os.Getenv(poolEnv)) == "1",
 	}
 
 	if envLeash := strings.TrimSpace(os.Getenv("LEASH_IMAGE")); envLeash != "" {
@@ -1117,70 +1137,17 @@ func (r *runner) runDocker(ctx context.Context, args ...string) error {
 func (r *runner) startContainers(ctx context.Context) error {
 	r.logDevImageSelections()
 
-	if err := r.assignContainerNames(ctx); err != nil {
-		return err
-	}
-
-	if err := r.ensureNotRunning(ctx); err != nil {
-		return err
-	}
-
-	if err := r.allocateListenPort(ctx); err != nil {
-		return err
-	}
-
-	if err := r.expandPublishAll(ctx); err != nil {
-		return err
-	}
-	if err := r.allocatePublishPorts(ctx); err != nil {
-		return err
-	}
-
-	if err := r.ensureLocalImage(ctx, r.cfg.targetImage); err != nil {
-		return err
-	}
-	if err := r.ensureLocalImage(ctx, r.cfg.leashImage); err != nil {
-		return err
-	}
-
-	if err := os.MkdirAll(r.cfg.workDir, 0o755); err != nil {
-		return fmt.Errorf("create work dir: %w", err)
-	}
-	if err := r.ensureShareDir(); err != nil {
-		return err
-	}
-	if err := r.ensurePrivateDir(); err != nil {
-		return err
-	}
-	bootstrapMarker := filepath.Join(r.cfg.shareDir, entrypoint.BootstrapReadyFileName)
-	if err := os.Remove(bootstrapMarker); err == nil {
-		r.debugf("removed stale bootstrap marker at %s", bootstrapMarker)
-	}
-	if err := os.MkdirAll(r.cfg.logDir, 0o755); err != nil {
-		return fmt.Errorf("create log dir: %w", err)
-	}
-	if err := os.MkdirAll(r.cfg.cfgDir, 0o755); err != nil {
-		return fmt.Errorf("create cfg dir: %w", err)
-	}
-	if err := os.MkdirAll(r.cfg.workspaceDir, 0o755); err != nil {
-		return fmt.Errorf("create workspace dir: %w", err)
-	}
-
-	if err := r.syncPolicyFile(); err != nil {
-		return err
-	}
-
-	if err := entrypoint.InflateBinaries(r.cfg.shareDir); err != nil {
-		return fmt.Errorf("prepare leash-entry binaries: %w", err)
-	}
-
-	stopSignal, err := r.getImageStopSignal(ctx)
+	stopSignal, err := r.prepareLaunch(ctx)
 	if err != nil {
 		return err
 	}
 
+	launched := time.Now()
 	for {
-		if err := r.launchTargetContainer(ctx, stopSignal); err != nil {
+		end := r.timeline.Begin("container.start.target")
+		err := r.launchTargetContainer(ctx, stopSignal)
+		end(err)
+		if err != nil {
 			retry, retryErr := r.handleListenPortRetry(ctx, err)
 			if retryErr != nil {
 				return r.finishLifecycle(ctx, 0, retryErr)
@@ -1193,31 +1160,52 @@ func (r *runner) startContainers(ctx context.Context) error {
 		break
 	}
 
+	end := r.timeline.Begin("cgroup.discover")
 	cgroupPath, err := r.resolveCgroupPath()
+	end(err)
 	if err != nil {
 		return r.finishLifecycle(ctx, 0, err)
 	}
 
-	if err := r.launchLeashContainer(ctx, cgroupPath); err != nil {
+	if r.pool != nil {
+		end = r.timeline.Begin("pool.bind")
+		err = r.bindPooledLeash(cgroupPath)
+	} else {
+		end = r.timeline.Begin("container.start.leash")
+		err = r.launchLeashContainer(ctx, cgroupPath)
+	}
+	end(err)
+	if err != nil {
 		return r.finishLifecycle(ctx, 0, err)
 	}
 
-	if err := r.waitForFile(filepath.Join(r.cfg.shareDir, "ca-cert.pem"), 50, 200*time.Millisecond); err != nil {
+	end = r.timeline.Begin("ca.wait")
+	err = r.waitForFile(filepath.Join(r.cfg.shareDir, "ca-cert.pem"), 50, 200*time.Millisecond)
+	end(err)
+	if err != nil {
 		r.logger.Println("Warning: Leash CA certificate was not detected after waiting.")
 	} else if r.verbose {
 		r.logger.Printf("Leash CA certificate is available at %s\n", filepath.Join(r.cfg.shareDir, "ca-cert.pem"))
 	}
 
-	if err := r.waitForBootstrap(ctx); err != nil {
+	end = r.timeline.Begin("bootstrap.wait")
+	err = r.waitForBootstrap(ctx)
+	end(err)
+	if err != nil {
 		return r.finishLifecycle(ctx, 0, err)
 	}
 
-	if err := r.installPromptAssets(ctx); err != nil {
+	end = r.timeline.Begin("prompt.install")
+	err = r.installPromptAssets(ctx)
+	end(err)
+	if err != nil {
 		fmt.Printf("Warning: failed to install leash prompt: %v\n", err)
 		if r.logger != nil {
 			r.logger.Printf("Warning: failed to install leash prompt: %v", err)
 		}
 	}
+	r.debugf("Session ready %s after container launch.", time.Since(launched).Round(time.Millisecond))
+	r.emitStartupTimeline()
 
 	if r.cfg.listenCfg.Disable {
 		fmt.Println()
@@ -1267,6 +1255,112 @@ func (r *runner) startContainers(ctx context.Context) error {
 	return r.finishLifecycle(ctx, exitCode, nil)
 }
 
+// prepareLaunch runs everything that precedes launching the target
+// container: the docker checks and the host directory setup, which are
+// independent, run concurrently, and then a warm pool claim when enabled.
+// It returns the target image's stop signal.
+func (r *runner) prepareLaunch(ctx context.Context) (string, error) {
+	if err := runConcurrently(ctx, r.preflightDocker, r.prepareHostDirs); err != nil {
+		return "", err
+	}
+	end := r.timeline.Begin("pool.claim")
+	var err error
+	if r.claimPooledLeash(ctx) {
+		err = r.adoptPooledLeash()
+	}
+	end(err)
+	if err != nil {
+		return "", err
+	}
+	end = r.timeline.Begin("image.stop_signal")
+	sig, err := r.getImageStopSignal(ctx)
+	end(err)
+	return sig, err
+}
+
+// preflightDocker picks container names, makes sure no earlier session is
+// still running, and then checks both images and allocates host ports
+// concurrently.
+func (r *runner) preflightDocker(ctx context.Context) (err error) {
+	end := r.timeline.Begin("container.check")
+	err = r.assignContainerNames(ctx)
+	if err == nil {
+		err = r.ensureNotRunning(ctx)
+	}
+	end(err)
+	if err != nil {
+		return err
+	}
+	return runConcurrently(ctx,
+		func(ctx context.Context) (err error) {
+			end := r.timeline.Begin("image.check.target")
+			err = r.ensureLocalImage(ctx, r.cfg.targetImage)
+			end(err)
+			if err != nil {
+				return err
+			}
+			end = r.timeline.Begin("ports.allocate")
+			defer func() { end(err) }()
+			// Publishing every exposed port needs the target image's config.
+			if err := r.expandPublishAll(ctx); err != nil {
+				return err
+			}
+			used, err := r.usedHostPorts(ctx)
+			if err != nil {
+				return err
+			}
+			if err := r.allocateListenPortFrom(used); err != nil {
+				return err
+			}
+			return r.allocatePublishPortsFrom(used)
+		},
+		func(ctx context.Context) (err error) {
+			end := r.timeline.Begin("image.check.leash")
+			defer func() { end(err) }()
+			return r.ensureLocalImage(ctx, r.cfg.leashImage)
+		},
+	)
+}
+
+// prepareHostDirs creates the host directories the containers mount and
+// inflates the leash-entry binaries into the share dir.
+func (r *runner) prepareHostDirs(context.Context) error {
+	if err := os.MkdirAll(r.cfg.workDir, 0o755); err != nil {
+		return fmt.Errorf("create work dir: %w", err)
+	}
+	if err := r.ensureShareDir(); err != nil {
+		return err
+	}
+	if err := r.ensurePrivateDir(); err != nil {
+		return err
+	}
+	bootstrapMarker := filepath.Join(r.cfg.shareDir, entrypoint.BootstrapReadyFileName)
+	if err := os.Remove(bootstrapMarker); err == nil {
+		r.debugf("removed stale bootstrap marker at %s", bootstrapMarker)
+	}
+	if err := os.MkdirAll(r.cfg.logDir, 0o755); err != nil {
+		return fmt.Errorf("create log dir: %w", err)
+	}
+	if err := os.MkdirAll(r.cfg.cfgDir, 0o755); err != nil {
+		return fmt.Errorf("create cfg dir: %w", err)
+	}
+	if err := os.MkdirAll(r.cfg.workspaceDir, 0o755); err != nil {
+		return fmt.Errorf("create workspace dir: %w", err)
+	}
+
+	if err := r.syncPolicyFile(); err != nil {
+		return err
+	}
+
+	end := r.timeline.Begin("inflate_binaries")
+	err := entrypoint.InflateBinaries(r.cfg.shareDir)
+	end(err)
+	if err != nil {
+		return fmt.Errorf("prepare leash-entry binaries: %w", err)
+	}
+	return nil
+}
+
 func (r *runner) assignContainerNames(ctx context.Context) error {
 	baseTarget := r.cfg.targetContainerBase
 	if strings.TrimSpace(baseTarget) == "" {
@@ -1282,11 +1376,17 @@ func (r *runner) assignContainerNames(ctx context.Context) error {
 		targetCandidate := containerNameWithSuffix(baseTarget, attempt)
 		leashCandidate := containerNameWithSuffix(baseLeash, attempt)
 
-		targetExists, err := r.containerExists(ctx, targetCandidate)
-		if err != nil {
-			return err
-		}
-		leashExists, err := r.containerExists(ctx, leashCandidate)
+		var targetExists, leashExists bool
+		err := runConcurrently(ctx,
+			func(ctx context.Context) (err error) {
+				targetExists, err = r.containerExists(ctx, targetCandidate)
+				return err
+			},
+			func(ctx context.Context) (err error) {
+				leashExists, err = r.containerExists(ctx, leashCandidate)
+				return err
+			},
+		)
 		if err != nil {
 			return err
 		}
@@ -1323,32 +1423,37 @@ func (r *runner) allocateListenPort(ctx context.Context) error {
 	if r.cfg.listenCfg.Disable {
 		return nil
 	}
+	used, err := r.usedHostPorts(ctx)
+	if err != nil {
+		return err
+	}
+	return r.allocateListenPortFrom(used)
+}
+
+// allocateListenPortFrom picks the listen port against a snapshot of the
+// host ports Docker already publishes.
+func (r *runner) allocateListenPortFrom(used map[string]bool) error {
+	if r.cfg.listenCfg.Disable {
+		return nil
+	}
 
 	if r.cfg.listenExplicit {
-		if err := r.ensurePortFree(ctx, r.cfg.listenCfg.Port); err != nil {
-			var inUse *portInUseError
-			if errors.As(err, &inUse) {
-				return fmt.Errorf("listen port %s is already in use; specify a different value with --listen", inUse.port)
-			}
-			return err
+		if used[r.cfg.listenCfg.Port] {
+			return fmt.Errorf("listen port %s is already in use; specify a different value with --listen", r.cfg.listenCfg.Port)
 		}
 		return nil
 	}
 
 	port := r.cfg.listenCfg.Port
 	for attempts := 0; attempts < 1000; attempts++ {
-		if err := r.ensurePortFree(ctx, port); err != nil {
-			var inUse *portInUseError
-			if errors.As(err, &inUse) {
-				next, err := incrementPort(port)
-				if err != nil {
-					return err
-				}
-				r.debugf("Port %s is unavailable; retrying with %s.", port, next)
-				port = next
-				continue
+		if used[port] {
+			next, err := incrementPort(port)
+			if err != nil {
+				return err
 			}
-			return err
+			r.debugf("Port %s is unavailable; retrying with %s.", port, next)
+			port = next
+			continue
 		}
 
 		r.cfg.listenCfg.Port = port
@@ -1440,26 +1545,29 @@ func isPortConflictError(err error) bool {
 // Additional helper methods will be defined below.
 
 func (r *runner) ensureNotRunning(ctx context.Context) error {
-	running, err := r.containerRunning(ctx, r.cfg.targetContainer)
-	if err != nil {
-		return err
-	}
-	if running {
-		return fmt.Errorf("error: containers already running (target='%s', leash='%s').\nRun: docker rm -f %s %s   to stop them, then try again.", r.cfg.targetContainer, r.cfg.leashContainer, r.cfg.targetContainer, r.cfg.leashContainer)
-	}
-	running, err = r.containerRunning(ctx, r.cfg.leashContainer)
+	names := []string{r.cfg.targetContainer, r.cfg.leashContainer}
+	var exists, running [2]bool
+	err := runConcurrently(ctx,
+		func(ctx context.Context) (err error) {
+			exists[0], running[0], err = r.containerState(ctx, names[0])
+			return err
+		},
+		func(ctx context.Context) (err error) {
+			exists[1], running[1], err = r.containerState(ctx, names[1])
+			return err
+		},
+	)
 	if err != nil {
 		return err
 	}
-	if running {
+	if running[0] || running[1] {
 		return fmt.Errorf("error: containers already running (target='%s', leash='%s').\nRun: docker rm -f %s %s   to stop them, then try again.", r.cfg.targetContainer, r.cfg.leashContainer, r.cfg.targetContainer, r.cfg.leashContainer)
 	}
 
-	if exists, _ := r.containerExists(ctx, r.cfg.targetContainer); exists {
-		_ = runCommand(ctx, "docker", "rm", "-f", r.cfg.targetContainer)
-	}
-	if exists, _ := r.containerExists(ctx, r.cfg.leashContainer); exists {
-		_ = runCommand(ctx, "docker", "rm", "-f", r.cfg.leashContainer)
+	for i, name := range names {
+		if exists[i] {
+			_ = runCommand(ctx, "docker", "rm", "-f", name)
+		}
 	}
 	return nil
 }
@@ -1584,6 +1692,12 @@ func (r *runner) syncPolicyFile() error {
 }
 
 func (r *runner) imageDefaultCommand(ctx context.Context) ([]string, error) {
+	if img, ok, err := r.engineImage(ctx, r.cfg.targetImage); ok {
+		if err != nil {
+			return nil, err
+		}
+		return append(append([]string(nil), img.Config.Entrypoint...), img.Config.Cmd...), nil
+	}
 	entryJSON, err := commandOutput(ctx, "docker", "inspect", "--format", "{{json .Config.Entrypoint}}", r.cfg.targetImage)
 	if err != nil {
 		return nil, err
@@ -1612,9 +1726,17 @@ func (r *runner) imageDefaultCommand(ctx context.Context) ([]string, error) {
 }
 
 func (r *runner) getImageStopSignal(ctx context.Context) (string, error) {
-	out, err := commandOutput(ctx, "docker", "inspect", "--format", "{{.Config.StopSignal}}", r.cfg.targetImage)
-	if err != nil {
-		return "", fmt.Errorf("query stop signal: %w", err)
+	var out string
+	if img, ok, err := r.engineImage(ctx, r.cfg.targetImage); ok {
+		if err != nil {
+			return "", fmt.Errorf("query stop signal: %w", err)
+		}
+		out = img.Config.StopSignal
+	} else {
+		out, err = commandOutput(ctx, "docker", "inspect", "--format", "{{.Config.StopSignal}}", r.cfg.targetImage)
+		if err != nil {
+			return "", fmt.Errorf("query stop signal: %w", err)
+		}
 	}
 	sig := strings.TrimSpace(out)
 	if sig == "" || sig == "<no value>" {
@@ -1624,15 +1746,12 @@ func (r *runner) getImageStopSignal(ctx context.Context) (string, error) {
 }
 
 func (r *runner) ensurePortFree(ctx context.Context, port string) error {
-	out, err := commandOutput(ctx, "docker", "ps", "--format", "{{.Names}} {{.Ports}}")
+	used, err := r.usedHostPorts(ctx)
 	if err != nil {
-		return fmt.Errorf("list docker ports: %w", err)
+		return err
 	}
-	needle := fmt.Sprintf(":%s->", port)
-	for _, line := range strings.Split(out, "\n") {
-		if strings.Contains(line, needle) {
-			return &portInUseError{port: port}
-		}
+	if used[port] {
+		return &portInUseError{port: port}
 	}
 	return nil
 }
@@ -1730,6 +1849,20 @@ func (ps publishSpec) toDockerArg() string {
 }
 
 func (r *runner) allocatePublishPorts(ctx context.Context) error {
+	if len(r.opts.publishes) == 0 {
+		return nil
+	}
+	used, err := r.usedHostPorts(ctx)
+	if err != nil {
+		return err
+	}
+	return r.allocatePublishPortsFrom(used)
+}
+
+// allocatePublishPortsFrom resolves publish host ports against a snapshot of
+// the host ports Docker already publishes. Ports it assigns are added to
+// used so later specs do not pick them again.
+func (r *runner) allocatePublishPortsFrom(used map[string]bool) error {
 	for i := range r.opts.publishes {
 		ps := &r.opts.publishes[i]
 		// If host port is unspecified or auto, try container port first, then bump
@@ -1737,19 +1870,16 @@ func (r *runner) allocatePublishPorts(ctx context.Context) error {
 			candidate := ps.ContainerPort
 			var busyPorts []string
 			for attempts := 0; attempts < 1000; attempts++ {
-				if err := r.ensurePortFree(ctx, candidate); err != nil {
-					var inUse *portInUseError
-					if errors.As(err, &inUse) {
-						busyPorts = append(busyPorts, candidate)
-						next, err := incrementPort(candidate)
-						if err != nil {
-							return err
-						}
-						candidate = next
-						continue
+				if used[candidate] {
+					busyPorts = append(busyPorts, candidate)
+					next, err := incrementPort(candidate)
+					if err != nil {
+						return err
 					}
-					return err
+					candidate = next
+					continue
 				}
+				used[candidate] = true
 				ps.HostPort = candidate
 				ps.AutoHostPort = false
 				break
@@ -1761,12 +1891,8 @@ func (r *runner) allocatePublishPorts(ctx context.Context) error {
 				r.logger.Printf("%d ports were in-use; using %s for container:%s.", len(busyPorts), ps.HostPort, ps.ContainerPort)
 			}
 		} else {
-			if err := r.ensurePortFree(ctx, ps.HostPort); err != nil {
-				var inUse *portInUseError
-				if errors.As(err, &inUse) {
-					return fmt.Errorf("host port %s is already in use; choose a different host port or omit it to auto-pick", inUse.port)
-				}
-				return err
+			if used[ps.HostPort] {
+				return fmt.Errorf("host port %s is already in use; choose a different host port or omit it to auto-pick", ps.HostPort)
 			}
 		}
 	}
@@ -1777,17 +1903,24 @@ func (r *runner) expandPublishAll(ctx context.Context) error {
 	if !r.opts.publishAll {
 		return nil
 	}
-	out, err := commandOutput(ctx, "docker", "inspect", "--format", "{{json .Config.ExposedPorts}}", r.cfg.targetImage)
-	if err != nil {
-		return fmt.Errorf("inspect exposed ports: %w", err)
-	}
-	raw := strings.TrimSpace(out)
-	if raw == "" || raw == "null" || raw == "{}" {
-		return nil
-	}
 	var exposed map[string]any
-	if err := json.Unmarshal([]byte(raw), &exposed); err != nil {
-		return fmt.Errorf("parse exposed ports: %w", err)
+	if img, ok, err := r.engineImage(ctx, r.cfg.targetImage); ok {
+		if err != nil {
+			return fmt.Errorf("inspect exposed ports: %w", err)
+		}
+		exposed = img.Config.ExposedPorts
+	} else {
+		out, err := commandOutput(ctx, "docker", "inspect", "--format", "{{json .Config.ExposedPorts}}", r.cfg.targetImage)
+		if err != nil {
+			return fmt.Errorf("inspect exposed ports: %w", err)
+		}
+		raw := strings.TrimSpace(out)
+		if raw == "" || raw == "null" || raw == "{}" {
+			return nil
+		}
+		if err := json.Unmarshal([]byte(raw), &exposed); err != nil {
+			return fmt.Errorf("parse exposed ports: %w", err)
+		}
 	}
 	for key := range exposed {
 		// key is like "3000/tcp" or "53/udp"
@@ -1825,7 +1958,11 @@ func (r *runner) launchTargetContainer(ctx context.Context, stopSignal string) e
 		"--entrypoint", filepath.Join(leashPublicMount, entryName),
 		"--cgroupns", "host",
 	}
-	if !r.cfg.listenCfg.Disable {
+	if r.pool != nil {
+		// The claimed container owns the network namespace and publishes
+		// the Control UI port.
+		args = append(args, "--network", fmt.Sprintf("container:%s", r.cfg.leashContainer))
+	} else if !r.cfg.listenCfg.Disable {
 		if publish := r.cfg.listenCfg.DockerPublish(); publish != "" {
 			args = append(args, "-p", publish)
 		}
@@ -1852,6 +1989,22 @@ func (r *runner) launchTargetContainer(ctx context.Context, stopSignal string) e
 		"-e", "LEASH_ENTRY_KILL_SIGNAL=SIGKILL",
 		"-e", "NODE_OPTIONS=--use-openssl-ca",
 	)
+	// leash-entry publishes the system roots plus the leash CA here; pointing
+	// the common TLS stacks at it covers runtimes that ship their own roots.
+	// Values from -e flags below take precedence.
+	bundle := filepath.Join(leashPublicMount, entrypoint.CABundleFileName)
+	for _, name := range []string{"SSL_CERT_FILE", "NODE_EXTRA_CA_CERTS", "REQUESTS_CA_BUNDLE"} {
+		value := fmt.Sprintf("%s=%s", name, bundle)
+		args = append(args, "-e", value)
+		targetEnv = append(targetEnv, value)
+	}
+	// The image ID lets leash-entry reuse a merged bundle built for the same
+	// image.
+	if img, ok, err := r.engineImage(ctx, r.cfg.targetImage); ok && err == nil && img.ID != "" {
+		value := fmt.Sprintf("LEASH_IMAGE_ID=%s", img.ID)
+		args = append(args, "-e", value)
+		targetEnv = append(targetEnv, value)
+	}
 	for _, env := range r.opts.envVars {
 		args = append(args, "-e", env)
 		targetEnv = append(targetEnv, env)
@@ -1966,6 +2119,12 @@ func (r *runner) launchTargetContainer(ctx context.Context, stopSignal string) e
 }
 
 func (r *runner) detectImageArch(ctx context.Context) (string, error) {
+	if img, ok, err := r.engineImage(ctx, r.cfg.targetImage); ok {
+		if err != nil {
+			return "", fmt.Errorf("detect architecture: %w", err)
+		}
+		return normalizeArch(img.Architecture)
+	}
 	out, err := commandOutput(ctx, "docker", "inspect", "--format", "{{.Architecture}}", r.cfg.targetImage)
 	if err != nil {
 		return "", fmt.Errorf("detect architecture: %w", err)
@@ -2078,6 +2237,12 @@ func (r *runner) launchLeashContainer(ctx context.Context, cgroupPath string) er
 		args = append(args, "-e", value)
 		leashEnv = append(leashEnv, value)
 	}
+	if startup.TracePath("runner") != "" {
+		// leashd's trace lands in the share dir next to the markers.
+		value := fmt.Sprintf("%s=%s", startup.TraceEnv, leashPublicMount)
+		args = append(args, "-e", value)
+		leashEnv = append(leashEnv, value)
+	}
 	for _, env := range r.opts.envVars {
 		args = append(args, "-e", env)
 		leashEnv = append(leashEnv, env)
@@ -2194,24 +2359,38 @@ func formatList(items []string) string {
 	return "[" + strings.Join(encoded, ", ") + "]"
 }
 
+// waitForFile waits up to attempts*delay for path to appear. On Linux hosts
+// the share dir is watched so the file is seen as soon as it is written; delay
+// is the polling interval otherwise.
 func (r *runner) waitForFile(path string, attempts int, delay time.Duration) error {
-	for i := 0; i < attempts; i++ {
-		if _, err := os.Stat(path); err == nil {
-			return nil
-		}
-		time.Sleep(delay)
+	ctx, cancel := context.WithTimeout(context.Background(), time.Duration(attempts)*delay)
+	defer cancel()
+	if err := entrypoint.WaitForFile(ctx, path, delay); err != nil {
+		return fmt.Errorf("file %s not found after waiting", path)
 	}
-	return fmt.Errorf("file %s not found after waiting", path)
+	return nil
 }
 
 func (r *runner) waitForBootstrap(ctx context.Context) error {
 	marker := filepath.Join(r.cfg.shareDir, entrypoint.BootstrapReadyFileName)
 	deadline := time.Now().Add(r.cfg.bootstrapTimeout)
+	// The marker is noticed as soon as it is written; the ticker only paces
+	// the container health checks below.
 	ticker := time.NewTicker(500 * time.Millisecond)
 	defer ticker.Stop()
+	waitCtx, cancel := context.WithCancel(ctx)
+	defer cancel()
+	ready := make(chan error, 1)
+	go func() { ready <- entrypoint.WaitForFile(waitCtx, marker, 500*time.Millisecond) }()
 
 	for {
-		if _, err := os.Stat(marker); err == nil {
+		select {
+		case <-ctx.Done():
+			return ctx.Err()
+		case err := <-ready:
+			if err != nil {
+				return fmt.Errorf("wait for bootstrap marker: %w", err)
+			}
 			if r.verbose {
 				if info := describeBootstrapMarker(marker); info != "" {
 					fmt.Printf("Bootstrap complete (%s)\n", info)
@@ -2220,6 +2399,7 @@ func (r *runner) waitForBootstrap(ctx context.Context) error {
 				}
 			}
 			return nil
+		case <-ticker.C:
 		}
 
 		if time.Now().After(deadline) {
@@ -2243,12 +2423,6 @@ func (r *runner) waitForBootstrap(ctx context.Context) error {
 			}
 			return fmt.Errorf("leash container terminated before bootstrap completed (state=%s). Inspect docker logs %s", state, r.cfg.leashContainer)
 		}
-
-		select {
-		case <-ctx.Done():
-			return ctx.Err()
-		case <-ticker.C:
-		}
 	}
 }
 
@@ -2341,6 +2515,7 @@ func describeBootstrapMarker(path string) string {
 		PID       int    `json:"pid"`
 		Hostname  string `json:"hostname"`
 		Timestamp string `json:"timestamp"`
+		ElapsedMS int64  `json:"elapsed_ms"`
 	}
 	if err := json.Unmarshal(data, &payload); err != nil {
 		return ""
@@ -2355,9 +2530,53 @@ func describeBootstrapMarker(path string) string {
 	if payload.Timestamp != "" {
 		parts = append(parts, "ts="+payload.Timestamp)
 	}
+	if payload.ElapsedMS > 0 {
+		parts = append(parts, fmt.Sprintf("entry=%dms", payload.ElapsedMS))
+	}
 	return strings.Join(parts, " ")
 }
 
+// emitStartupTimeline reports where startup time went. It folds in the
+// phases leash-entry recorded in the bootstrap marker, logs one
+// event=startup.timeline line under verbose mode, and writes a trace file
+// when LEASH_STARTUP_TRACE names a directory.
+func (r *runner) emitStartupTimeline() {
+	if r.timeline == nil {
+		return
+	}
+	if entry, ok := readEntryTimeline(filepath.Join(r.cfg.shareDir, entrypoint.BootstrapReadyFileName)); ok {
+		r.timeline.Merge(entry)
+	}
+	s, path, err := r.timeline.Flush()
+	if err != nil && r.logger != nil {
+		r.logger.Printf("Warning: %v", err)
+	}
+	fields := make(map[string]string)
+	for k, v := range s.Fields() {
+		fields[k] = fmt.Sprint(v)
+	}
+	if path != "" {
+		fields["trace"] = path
+	}
+	r.logPrivateDirEvent("startup.timeline", fields)
+}
+
+// readEntryTimeline extracts the timeline leash-entry embeds in the
+// bootstrap marker.
+func readEntryTimeline(path string) (startup.Snapshot, bool) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return startup.Snapshot{}, false
+	}
+	var payload struct {
+		Timeline *startup.Snapshot `json:"timeline"`
+	}
+	if err := json.Unmarshal(bytes.TrimSpace(data), &payload); err != nil || payload.Timeline == nil {
+		return startup.Snapshot{}, false
+	}
+	return *payload.Timeline, true
+}
+
 func (r *runner) detectShell(ctx context.Context) (string, error) {
 	if err := runCommand(ctx, "docker", "exec", "-w", r.cfg.callerDir, r.cfg.targetContainer, "bash", "-lc", "true"); err == nil {
 		return "bash", nil
@@ -2519,6 +2738,9 @@ func (r *runner) stopContainers(ctx context.Context) error {
 			_ = os.RemoveAll(r.cfg.privateDir)
 		}
 	}
+	if r.pool != nil {
+		_ = os.RemoveAll(r.pool.dir)
+	}
 	if r.cfg.workDirIsTemp && r.cfg.workDir != "" {
 		if err := os.RemoveAll(r.cfg.workDir); err != nil {
 			r.debugf("failed to remove work dir %s: %v", r.cfg.workDir, err)
@@ -2546,25 +2768,9 @@ func (r *runner) showStatus(ctx context.Context) error {
 	return nil
 }
 
-func (r *runner) containerRunning(ctx context.Context, name string) (bool, error) {
-	out, err := commandOutput(ctx, "docker", "inspect", "-f", "{{.State.Running}}", name)
-	if err != nil {
-		if isNoSuchObjectError(err) {
-			return false, nil
-		}
-		return false, err
-	}
-	return strings.TrimSpace(out) == "true", nil
-}
-
 func (r *runner) containerExists(ctx context.Context, name string) (bool, error) {
-	if _, err := commandOutput(ctx, "docker", "inspect", "-f", "{{.Name}}", name); err != nil {
-		if isNoSuchObjectError(err) {
-			return false, nil
-		}
-		return false, err
-	}
-	return true, nil
+	exists, _, err := r.containerState(ctx, name)
+	return exists, err
 }
 
 func (r *runner) discoverShareDir(ctx context.Context) string {
@@ -2683,12 +2889,17 @@ func isNoSuchImageError(err error) bool {
 }
 
 func (r *runner) ensureLocalImage(ctx context.Context, image string) error {
-	if _, err := commandOutput(ctx, "docker", "image", "inspect", image); err != nil {
+	_, ok, err := r.engineImage(ctx, image)
+	if !ok {
+		_, err = commandOutput(ctx, "docker", "image", "inspect", image)
+	}
+	if err != nil {
 		if isNoSuchObjectError(err) || isNoSuchImageError(err) {
 			fmt.Printf("Pulling container image %s...\n", image)
 			if pullErr := runCommand(ctx, "docker", "pull", image); pullErr != nil {
 				return fmt.Errorf("pull image %s: %w", image, pullErr)
 			}
+			r.forgetImage(image)
 			return nil
 		}
 		return err
@@ -0,0 +1,314 @@
+// Package metrics keeps leashd's operational counters, gauges and histograms
+// and serves them in the Prometheus text exposition format. Metrics are
+// registered once, typically into package-level variables, and updated with
+// atomics only, so hot paths such as the LSM event loop and the proxy never
+// take a lock to record a sample.
+package metrics
+
+import (
+	"bufio"
+	"fmt"
+	"math"
+	"net/http"
+	"slices"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// Default is the process-wide registry served on /metrics.
+var Default = NewRegistry()
+
+// DefBuckets are latency buckets in seconds, from 100µs to 10s.
+var DefBuckets = []float64{.0001, .00025, .0005, .001, .0025, .005, .01, .025, .05, .1, .25, .5, 1, 2.5, 5, 10}
+
+type kind int
+
+const (
+	kindCounter kind = iota
+	kindGauge
+	kindHistogram
+)
+
+func (k kind) String() string {
+	switch k {
+	case kindCounter:
+		return "counter"
+	case kindGauge:
+		return "gauge"
+	default:
+		return "histogram"
+	}
+}
+
+// Registry holds metric families by name. Registration takes a lock;
+// updating a registered metric does not.
+type Registry struct {
+	mu       sync.Mutex
+	families map[string]*family
+}
+
+type family struct {
+	name   string
+	help   string
+	kind   kind
+	series map[string]*series // keyed by rendered labels
+}
+
+type series struct {
+	labels string
+	// One of the following is set.
+	counter   *Counter
+	gauge     *Gauge
+	histogram *Histogram
+	fn        func() float64
+}
+
+// NewRegistry returns an empty registry.
+func NewRegistry() *Registry {
+	return &Registry{families: make(map[string]*family)}
+}
+
+// Counter returns the counter with name and label pairs (key, value, ...),
+// registering it on first use. Registering the same series again returns
+// the existing counter.
+func (r *Registry) Counter(name, help string, labels ...string) *Counter {
+	s := r.series(name, help, kindCounter, labels, func(s *series) { s.counter = &Counter{} })
+	return s.counter
+}
+
+// Gauge returns the gauge with name and label pairs, registering it on first
+// use.
+func (r *Registry) Gauge(name, help string, labels ...string) *Gauge {
+	s := r.series(name, help, kindGauge, labels, func(s *series) { s.gauge = &Gauge{} })
+	return s.gauge
+}
+
+// Histogram returns the histogram with name and label pairs, registering it
+// with buckets (upper bounds, ascending) on first use.
+func (r *Registry) Histogram(name, help string, buckets []float64, labels ...string) *Histogram {
+	s := r.series(name, help, kindHistogram, labels, func(s *series) { s.histogram = newHistogram(buckets) })
+	return s.histogram
+}
+
+// CounterFunc registers a counter whose value is read from fn at scrape
+// time, such as a count kept by the kernel. Registering the series again
+// replaces fn.
+func (r *Registry) CounterFunc(name, help string, fn func() float64, labels ...string) {
+	r.setFunc(name, help, kindCounter, fn, labels)
+}
+
+// GaugeFunc registers a gauge whose value is read from fn at scrape time.
+// Registering the series again replaces fn.
+func (r *Registry) GaugeFunc(name, help string, fn func() float64, labels ...string) {
+	r.setFunc(name, help, kindGauge, fn, labels)
+}
+
+func (r *Registry) setFunc(name, help string, k kind, fn func() float64, labels []string) {
+	s := r.series(name, help, k, labels, func(*series) {})
+	r.mu.Lock()
+	s.fn = fn
+	r.mu.Unlock()
+}
+
+func (r *Registry) series(name, help string, k kind, labels []string, init func(*series)) *series {
+	if len(labels)%2 != 0 {
+		panic(fmt.Sprintf("metrics: %s: labels must be key/value pairs", name))
+	}
+	key := renderLabels(labels)
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	f, ok := r.families[name]
+	if !ok {
+		f = &family{name: name, help: help, kind: k, series: make(map[string]*series)}
+		r.families[name] = f
+	} else if f.kind != k {
+		panic(fmt.Sprintf("metrics: %s registered as %s and %s", name, f.kind, k))
+	}
+	s, ok := f.series[key]
+	if !ok {
+		s = &series{labels: key}
+		init(s)
+		f.series[key] = s
+	}
+	return s
+}
+
+// renderLabels formats label pairs as `{k="v",...}`, sorted by key.
+func renderLabels(labels []string) string {
+	if len(labels) == 0 {
+		return ""
+	}
+	pairs := make([]string, 0, len(labels)/2)
+	for i := 0; i < len(labels); i += 2 {
+		pairs = append(pairs, labels[i]+`="`+escapeLabel(labels[i+1])+`"`)
+	}
+	slices.Sort(pairs)
+	return "{" + strings.Join(pairs, ",") + "}"
+}
+
+var labelEscaper = strings.NewReplacer(`\`, `\\`, `"`, `\"`, "\n", `\n`)
+
+func escapeLabel(v string) string { return labelEscaper.Replace(v) }
+
+// Counter is a monotonically increasing count.
+type Counter struct{ v atomic.Uint64 }
+
+// Inc adds one.
+func (c *Counter) Inc() { c.v.Add(1) }
+
+// Add adds n.
+func (c *Counter) Add(n uint64) { c.v.Add(n) }
+
+// Value returns the current count.
+func (c *Counter) Value() uint64 { return c.v.Load() }
+
+// Gauge is a value that goes up and down.
+type Gauge struct{ v atomic.Int64 }
+
+// Set replaces the value.
+func (g *Gauge) Set(v int64) { g.v.Store(v) }
+
+// Add adds delta, which may be negative.
+func (g *Gauge) Add(delta int64) { g.v.Add(delta) }
+
+// Inc adds one.
+func (g *Gauge) Inc() { g.v.Add(1) }
+
+// Dec subtracts one.
+func (g *Gauge) Dec() { g.v.Add(-1) }
+
+// Value returns the current value.
+func (g *Gauge) Value() int64 { return g.v.Load() }
+
+// Histogram counts observations into cumulative buckets.
+type Histogram struct {
+	upper  []float64
+	counts []atomic.Uint64 // per bucket, not cumulative; the last is +Inf
+	count  atomic.Uint64
+	sum    atomic.Uint64 // float64 bits
+}
+
+func newHistogram(buckets []float64) *Histogram {
+	upper := slices.Clone(buckets)
+	slices.Sort(upper)
+	return &Histogram{upper: upper, counts: make([]atomic.Uint64, len(upper)+1)}
+}
+
+// Observe records v.
+func (h *Histogram) Observe(v float64) {
+	i, _ := slices.BinarySearch(h.upper, v)
+	h.counts[i].Add(1)
+	for {
+		old := h.sum.Load()
+		if h.sum.CompareAndSwap(old, math.Float64bits(math.Float64frombits(old)+v)) {
+			break
+		}
+	}
+	h.count.Add(1)
+}
+
+// ObserveDuration records d in seconds.
+func (h *Histogram) ObserveDuration(d time.Duration) { h.Observe(d.Seconds()) }
+
+// Since records the time elapsed since start, in seconds.
+func (h *Histogram) Since(start time.Time) { h.Observe(time.Since(start).Seconds()) }
+
+// Count returns the number of observations.
+func (h *Histogram) Count() uint64 { return h.count.Load() }
+
+// Handler serves the registry in the Prometheus text format.
+func (r *Registry) Handler() http.Handler {
+	return http.HandlerFunc(func(w http.ResponseWriter, req *http.Request) {
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		bw := bufio.NewWriter(w)
+		r.WriteText(bw)
+		_ = bw.Flush()
+	})
+}
+
+// WriteText writes every family, sorted by name, in the Prometheus text
+// format.
+func (r *Registry) WriteText(w *bufio.Writer) {
+	r.mu.Lock()
+	families := make([]*family, 0, len(r.families))
+	for _, f := range r.families {
+		families = append(families, f)
+	}
+	// Snapshot the series and value funcs under the lock; values are read
+	// after it is released.
+	type entry struct {
+		f      *family
+		series []series
+	}
+	entries := make([]entry, 0, len(families))
+	slices.SortFunc(families, func(a, b *family) int { return strings.Compare(a.name, b.name) })
+	for _, f := range families {
+		e := entry{f: f, series: make([]series, 0, len(f.series))}
+		for _, s := range f.series {
+			e.series = append(e.series, *s)
+		}
+		slices.SortFunc(e.series, func(a, b series) int { return strings.Compare(a.labels, b.labels) })
+		entries = append(entries, e)
+	}
+	r.mu.Unlock()
+
+	for _, e := range entries {
+		fmt.Fprintf(w, "# HELP %s %s\n# TYPE %s %s\n", e.f.name, e.f.help, e.f.name, e.f.kind)
+		for _, s := range e.series {
+			switch {
+			case s.fn != nil:
+				writeSample(w, e.f.name, s.labels, s.fn())
+			case s.counter != nil:
+				writeSample(w, e.f.name, s.labels, float64(s.counter.Value()))
+			case s.gauge != nil:
+				writeSample(w, e.f.name, s.labels, float64(s.gauge.Value()))
+			case s.histogram != nil:
+				writeHistogram(w, e.f.name, s.labels, s.histogram)
+			}
+		}
+	}
+}
+
+func writeHistogram(w *bufio.Writer, name, labels string, h *Histogram) {
+	var cumulative uint64
+	for i, upper := range h.upper {
+		cumulative += h.counts[i].Load()
+		writeSample(w, name+"_bucket", withLabel(labels, "le", formatFloat(upper)), float64(cumulative))
+	}
+	cumulative += h.counts[len(h.upper)].Load()
+	writeSample(w, name+"_bucket", withLabel(labels, "le", "+Inf"), float64(cumulative))
+	writeSample(w, name+"_sum", labels, math.Float64frombits(h.sum.Load()))
+	// Observations racing with the scrape may be in a bucket but not yet in
+	// the count; report the bucket total so the two agree.
+	writeSample(w, name+"_count", labels, float64(cumulative))
+}
+
+func withLabel(labels, key, value string) string {
+	pair := key + `="` + value + `"`
+	if labels == "" {
+		return "{" + pair + "}"
+	}
+	return labels[:len(labels)-1] + "," + pair + "}"
+}
+
+func writeSample(w *bufio.Writer, name, labels string, v float64) {
+	w.WriteString(name)
+	w.WriteString(labels)
+	w.WriteByte(' ')
+	w.WriteString(formatFloat(v))
+	w.WriteByte('\n')
+}
+
+func formatFloat(v float64) string {
+	switch {
+	case math.IsInf(v, 1):
+		return "+Inf"
+	case math.IsInf(v, -1):
+		return "-Inf"
+	}
+	return strconv.FormatFloat(v, 'g', -1, 64)
+}
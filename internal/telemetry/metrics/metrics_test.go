@@ -0,0 +1,111 @@
+package metrics
+
+import (
+	"net/http/httptest"
+	"strings"
+	"sync"
+	"testing"
+	"time"
+)
+
+func scrape(t *testing.T, r *Registry) string {
+	t.Helper()
+	rec := httptest.NewRecorder()
+	r.Handler().ServeHTTP(rec, httptest.NewRequest("GET", "/metrics", nil))
+	if ct := rec.Header().Get("Content-Type"); !strings.HasPrefix(ct, "text/plain; version=0.0.4") {
+		t.Fatalf("unexpected content type %q", ct)
+	}
+	return rec.Body.String()
+}
+
+func TestRegistryWritesTextFormat(t *testing.T) {
+	t.Parallel()
+
+	r := NewRegistry()
+	r.Counter("leash_events_total", "Events.", "program", "open").Add(3)
+	r.Counter("leash_events_total", "Events.", "program", "exec").Inc()
+	// Registering a series again returns the same counter.
+	r.Counter("leash_events_total", "Events.", "program", "open").Inc()
+	r.Gauge("leash_clients", "Clients.").Set(2)
+	r.GaugeFunc("leash_lag_bytes", "Lag.", func() float64 { return 7 }, "program", `a"b`)
+	h := r.Histogram("leash_latency_seconds", "Latency.", []float64{0.1, 1})
+	h.Observe(0.05)
+	h.Observe(0.1)
+	h.ObserveDuration(2 * time.Second)
+
+	got := scrape(t, r)
+	for _, want := range []string{
+		"# TYPE leash_clients gauge\nleash_clients 2\n",
+		"# HELP leash_events_total Events.\n# TYPE leash_events_total counter\n" +
+			"leash_events_total{program=\"exec\"} 1\nleash_events_total{program=\"open\"} 4\n",
+		`leash_lag_bytes{program="a\"b"} 7`,
+		"leash_latency_seconds_bucket{le=\"0.1\"} 2\n" +
+			"leash_latency_seconds_bucket{le=\"1\"} 2\n" +
+			"leash_latency_seconds_bucket{le=\"+Inf\"} 3\n" +
+			"leash_latency_seconds_sum 2.15\n" +
+			"leash_latency_seconds_count 3\n",
+	} {
+		if !strings.Contains(got, want) {
+			t.Fatalf("missing %q in:\n%s", want, got)
+		}
+	}
+	if strings.Index(got, "leash_clients") > strings.Index(got, "leash_events_total") {
+		t.Fatalf("families not sorted by name:\n%s", got)
+	}
+}
+
+func TestRegistryRejectsKindMismatch(t *testing.T) {
+	t.Parallel()
+
+	r := NewRegistry()
+	r.Counter("leash_x", "X.")
+	defer func() {
+		if recover() == nil {
+			t.Fatal("expected a panic for a gauge registered over a counter")
+		}
+	}()
+	r.Gauge("leash_x", "X.")
+}
+
+func TestConcurrentUpdates(t *testing.T) {
+	t.Parallel()
+
+	r := NewRegistry()
+	c := r.Counter("leash_c_total", "C.")
+	h := r.Histogram("leash_h_seconds", "H.", DefBuckets)
+	var wg sync.WaitGroup
+	for i := 0; i < 8; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < 1000; j++ {
+				c.Inc()
+				h.Observe(0.001)
+			}
+		}()
+	}
+	// Scrapes run alongside updates.
+	_ = scrape(t, r)
+	wg.Wait()
+	if c.Value() != 8000 || h.Count() != 8000 {
+		t.Fatalf("lost updates: counter=%d histogram=%d", c.Value(), h.Count())
+	}
+}
+
+func BenchmarkCounterInc(b *testing.B) {
+	c := NewRegistry().Counter("leash_c_total", "C.")
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			c.Inc()
+		}
+	})
+}
+
+func BenchmarkHistogramObserve(b *testing.B) {
+	h := NewRegistry().Histogram("leash_h_seconds", "H.", DefBuckets)
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			h.Observe(0.003)
+		}
+	})
+}
@@ -0,0 +1,249 @@
+package otel
+
+import (
+	"context"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"go.opentelemetry.io/otel/attribute"
+	"go.opentelemetry.io/otel/codes"
+	"go.opentelemetry.io/otel/metric"
+	"go.opentelemetry.io/otel/trace"
+)
+
+// LSMOperation identifies the LSM program that made a decision.
+type LSMOperation int
+
+const (
+	LSMFileOpen LSMOperation = iota
+	LSMProcExec
+	LSMNetConnect
+	lsmOperationCount
+)
+
+var lsmOperationNames = [lsmOperationCount]string{"file.open", "proc.exec", "net.connect"}
+
+func (op LSMOperation) String() string {
+	if op < 0 || op >= lsmOperationCount {
+		return "unknown"
+	}
+	return lsmOperationNames[op]
+}
+
+// eventSeqKey carries the event hub sequence number of a sampled denial. The
+// decisions view drops it from the aggregated series, so it only survives on
+// exemplars.
+const eventSeqKey = attribute.Key("leash.event.seq")
+
+const lsmDecisionsName = "leash.lsm.decisions"
+
+// denialQueueSize bounds the sampled denials waiting for a span. Denials that
+// do not fit are counted without one.
+const denialQueueSize = 256
+
+// LSMDecision is one decision reported by an LSM program. Seq is the event's
+// sequence number in the event hub.
+type LSMDecision struct {
+	Operation LSMOperation
+	Denied    bool
+	Seq       uint64
+	PID       int
+	Exe       string
+	Target    string // file path, executable or destination address
+}
+
+// LSMInstruments publishes LSM decisions, ring buffer lag and policy reloads.
+// A nil *LSMInstruments records nothing, so callers need no guard when
+// telemetry is off.
+type LSMInstruments struct {
+	meter  metric.Meter
+	tracer trace.Tracer
+
+	decisions      metric.Int64Counter
+	ringbufPending metric.Int64ObservableGauge
+	reloadDuration metric.Float64Histogram
+
+	// Attribute options are built once so recording a decision allocates
+	// nothing. decisionAttrs is indexed by operation, then by denied.
+	decisionAttrs [lsmOperationCount][2]metric.AddOption
+	reloadOK      metric.RecordOption
+	reloadError   metric.RecordOption
+
+	// One denial in every sampleEvery gets a span. Spans are started by
+	// traceDenials, never by RecordDecision, which runs inside the hub's
+	// emit.
+	sampleEvery uint64
+	denials     atomic.Uint64
+	sampled     chan LSMDecision
+	stopOnce    sync.Once
+	stopped     chan struct{}
+	done        chan struct{}
+}
+
+func newLSMInstruments(p *Provider, sampleEvery int) *LSMInstruments {
+	if p == nil || (p.meterProvider == nil && p.tracerProvider == nil) {
+		return nil
+	}
+	if sampleEvery < 1 {
+		sampleEvery = 1
+	}
+
+	inst := &LSMInstruments{sampleEvery: uint64(sampleEvery)}
+	if p.meterProvider != nil {
+		inst.meter = p.meterProvider.Meter("github.com/strongdm/leash/lsm")
+		inst.decisions, _ = inst.meter.Int64Counter(
+			lsmDecisionsName,
+			metric.WithDescription("Decisions reported by the LSM programs"),
+		)
+		inst.ringbufPending, _ = inst.meter.Int64ObservableGauge(
+			"leash.lsm.ringbuf.pending",
+			metric.WithDescription("Bytes in an LSM ring buffer not yet read by leashd"),
+			metric.WithUnit("By"),
+		)
+		inst.reloadDuration, _ = inst.meter.Float64Histogram(
+			"leash.policy.reload.duration",
+			metric.WithDescription("Time to push the merged policy to the LSM programs and proxy"),
+			metric.WithUnit("s"),
+		)
+	}
+	if p.tracerProvider != nil {
+		inst.tracer = p.tracerProvider.Tracer("github.com/strongdm/leash/lsm")
+		inst.sampled = make(chan LSMDecision, denialQueueSize)
+		inst.stopped = make(chan struct{})
+		inst.done = make(chan struct{})
+		go inst.traceDenials()
+	}
+
+	for op := LSMOperation(0); op < lsmOperationCount; op++ {
+		operation := attribute.String("operation", op.String())
+		inst.decisionAttrs[op][0] = metric.WithAttributeSet(attribute.NewSet(operation, attribute.String("result", "allow")))
+		inst.decisionAttrs[op][1] = metric.WithAttributeSet(attribute.NewSet(operation, attribute.String("result", "deny")))
+	}
+	inst.reloadOK = metric.WithAttributeSet(attribute.NewSet(attribute.String("result", "ok")))
+	inst.reloadError = metric.WithAttributeSet(attribute.NewSet(attribute.String("result", "error")))
+	return inst
+}
+
+// RecordDecision counts d. Sampled denials are handed to traceDenials, which
+// gives them a span and records their count inside it so the exemplar links
+// the series to the span and to the event's sequence number. RecordDecision
+// only increments counters and never blocks.
+func (i *LSMInstruments) RecordDecision(d LSMDecision) {
+	if i == nil || d.Operation < 0 || d.Operation >= lsmOperationCount {
+		return
+	}
+	if d.Denied && i.sampled != nil && (i.denials.Add(1)-1)%i.sampleEvery == 0 {
+		select {
+		case i.sampled <- d:
+			return
+		default:
+		}
+	}
+	if i.decisions != nil {
+		denied := 0
+		if d.Denied {
+			denied = 1
+		}
+		i.decisions.Add(context.Background(), 1, i.decisionAttrs[d.Operation][denied])
+	}
+}
+
+// traceDenials starts the spans of sampled denials until stop is called,
+// then finishes those already queued.
+func (i *LSMInstruments) traceDenials() {
+	defer close(i.done)
+	for {
+		select {
+		case d := <-i.sampled:
+			i.traceDenial(d)
+		case <-i.stopped:
+			for {
+				select {
+				case d := <-i.sampled:
+					i.traceDenial(d)
+				default:
+					return
+				}
+			}
+		}
+	}
+}
+
+func (i *LSMInstruments) traceDenial(d LSMDecision) {
+	operation := d.Operation.String()
+	seq := attribute.Int64(string(eventSeqKey), int64(d.Seq))
+	ctx, span := i.tracer.Start(context.Background(), "lsm.deny "+operation,
+		trace.WithSpanKind(trace.SpanKindInternal),
+		trace.WithAttributes(
+			seq,
+			attribute.String("operation", operation),
+			attribute.Int("process.pid", d.PID),
+			attribute.String("process.executable.name", d.Exe),
+			attribute.String("leash.target", d.Target),
+		),
+	)
+	if i.decisions != nil {
+		i.decisions.Add(ctx, 1, metric.WithAttributes(
+			attribute.String("operation", operation),
+			attribute.String("result", "deny"),
+			seq,
+		))
+	}
+	span.SetStatus(codes.Error, "denied")
+	span.End()
+}
+
+// stop waits for the queued denials to be traced. It runs before the
+// providers shut down, so nothing recorded after it is exported.
+func (i *LSMInstruments) stop(ctx context.Context) error {
+	if i == nil || i.sampled == nil {
+		return nil
+	}
+	i.stopOnce.Do(func() { close(i.stopped) })
+	select {
+	case <-i.done:
+		return nil
+	case <-ctx.Done():
+		return ctx.Err()
+	}
+}
+
+// ObserveRingBufferLag reports pending for program on every collection of
+// the ring buffer lag gauge.
+func (i *LSMInstruments) ObserveRingBufferLag(program string, pending func() int64) error {
+	if i == nil || i.meter == nil {
+		return nil
+	}
+	attrs := metric.WithAttributeSet(attribute.NewSet(attribute.String("program", program)))
+	_, err := i.meter.RegisterCallback(func(_ context.Context, o metric.Observer) error {
+		o.ObserveInt64(i.ringbufPending, pending(), attrs)
+		return nil
+	}, i.ringbufPending)
+	return err
+}
+
+// RecordPolicyReload records one push of the merged policy that took
+// elapsed. It is traced as a policy.reload span.
+func (i *LSMInstruments) RecordPolicyReload(elapsed time.Duration, err error) {
+	if i == nil {
+		return
+	}
+	ctx := context.Background()
+	if i.tracer != nil {
+		end := time.Now()
+		var span trace.Span
+		ctx, span = i.tracer.Start(ctx, "policy.reload", trace.WithTimestamp(end.Add(-elapsed)))
+		if err != nil {
+			span.SetStatus(codes.Error, err.Error())
+		}
+		defer span.End(trace.WithTimestamp(end))
+	}
+	if i.reloadDuration != nil {
+		opt := i.reloadOK
+		if err != nil {
+			opt = i.reloadError
+		}
+		i.reloadDuration.Record(ctx, elapsed.Seconds(), opt)
+	}
+}
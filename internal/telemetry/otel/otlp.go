@@ -0,0 +1,447 @@
+package otel
+
+import (
+	"bytes"
+	"context"
+	"encoding/hex"
+	"encoding/json"
+	"fmt"
+	"io"
+	"net/http"
+	"strconv"
+	"strings"
+	"time"
+
+	"go.opentelemetry.io/otel/attribute"
+	"go.opentelemetry.io/otel/codes"
+	sdkmetric "go.opentelemetry.io/otel/sdk/metric"
+	"go.opentelemetry.io/otel/sdk/metric/metricdata"
+	"go.opentelemetry.io/otel/sdk/resource"
+	sdktrace "go.opentelemetry.io/otel/sdk/trace"
+)
+
+// The OTLP exporters speak OTLP/HTTP with JSON bodies, which any collector
+// accepts on :4318, so exporting needs no generated protobuf code.
+
+// A change to the SDK's exporter interfaces fails here rather than where
+// Setup hands the exporters to the providers.
+var (
+	_ sdkmetric.Exporter    = (*otlpMetricExporter)(nil)
+	_ sdktrace.SpanExporter = (*otlpTraceExporter)(nil)
+)
+
+// otlpClient posts OTLP/HTTP JSON payloads to a collector.
+type otlpClient struct {
+	endpoint string
+	headers  map[string]string
+	client   *http.Client
+}
+
+func newOTLPClient(endpoint string, headers map[string]string) *otlpClient {
+	endpoint = strings.TrimRight(strings.TrimSpace(endpoint), "/")
+	if !strings.Contains(endpoint, "://") {
+		endpoint = "http://" + endpoint
+	}
+	return &otlpClient{
+		endpoint: endpoint,
+		headers:  headers,
+		client:   &http.Client{Timeout: 10 * time.Second},
+	}
+}
+
+func (c *otlpClient) post(ctx context.Context, path string, payload any) error {
+	body, err := json.Marshal(payload)
+	if err != nil {
+		return err
+	}
+	req, err := http.NewRequestWithContext(ctx, http.MethodPost, c.endpoint+path, bytes.NewReader(body))
+	if err != nil {
+		return err
+	}
+	req.Header.Set("Content-Type", "application/json")
+	MergeHeaders(req, c.headers)
+	resp, err := c.client.Do(req)
+	if err != nil {
+		return err
+	}
+	defer resp.Body.Close()
+	_, _ = io.Copy(io.Discard, io.LimitReader(resp.Body, 64<<10))
+	if resp.StatusCode/100 != 2 {
+		return fmt.Errorf("otlp export to %s: %s", path, resp.Status)
+	}
+	return nil
+}
+
+type otlpKeyValue struct {
+	Key   string       `json:"key"`
+	Value otlpAnyValue `json:"value"`
+}
+
+type otlpAnyValue struct {
+	StringValue *string  `json:"stringValue,omitempty"`
+	BoolValue   *bool    `json:"boolValue,omitempty"`
+	IntValue    string   `json:"intValue,omitempty"` // int64 is a string in OTLP JSON
+	DoubleValue *float64 `json:"doubleValue,omitempty"`
+}
+
+type otlpResource struct {
+	Attributes []otlpKeyValue `json:"attributes,omitempty"`
+}
+
+type otlpScope struct {
+	Name    string `json:"name"`
+	Version string `json:"version,omitempty"`
+}
+
+func otlpAttributes(kvs []attribute.KeyValue) []otlpKeyValue {
+	if len(kvs) == 0 {
+		return nil
+	}
+	out := make([]otlpKeyValue, 0, len(kvs))
+	for _, kv := range kvs {
+		var v otlpAnyValue
+		switch kv.Value.Type() {
+		case attribute.BOOL:
+			b := kv.Value.AsBool()
+			v.BoolValue = &b
+		case attribute.INT64:
+			v.IntValue = strconv.FormatInt(kv.Value.AsInt64(), 10)
+		case attribute.FLOAT64:
+			f := kv.Value.AsFloat64()
+			v.DoubleValue = &f
+		default:
+			s := kv.Value.Emit()
+			v.StringValue = &s
+		}
+		out = append(out, otlpKeyValue{Key: string(kv.Key), Value: v})
+	}
+	return out
+}
+
+func otlpResourceOf(res *resource.Resource) otlpResource {
+	if res == nil {
+		return otlpResource{}
+	}
+	return otlpResource{Attributes: otlpAttributes(res.Attributes())}
+}
+
+func unixNano(t time.Time) string {
+	if t.IsZero() {
+		return ""
+	}
+	return strconv.FormatInt(t.UnixNano(), 10)
+}
+
+// otlpTraceExporter sends spans to <endpoint>/v1/traces.
+type otlpTraceExporter struct {
+	client *otlpClient
+}
+
+type otlpTracesPayload struct {
+	ResourceSpans []otlpResourceSpans `json:"resourceSpans"`
+}
+
+type otlpResourceSpans struct {
+	Resource   otlpResource     `json:"resource"`
+	ScopeSpans []otlpScopeSpans `json:"scopeSpans"`
+}
+
+type otlpScopeSpans struct {
+	Scope otlpScope  `json:"scope"`
+	Spans []otlpSpan `json:"spans"`
+}
+
+type otlpSpan struct {
+	TraceID           string          `json:"traceId"`
+	SpanID            string          `json:"spanId"`
+	ParentSpanID      string          `json:"parentSpanId,omitempty"`
+	Name              string          `json:"name"`
+	Kind              int             `json:"kind"`
+	StartTimeUnixNano string          `json:"startTimeUnixNano"`
+	EndTimeUnixNano   string          `json:"endTimeUnixNano"`
+	Attributes        []otlpKeyValue  `json:"attributes,omitempty"`
+	Events            []otlpSpanEvent `json:"events,omitempty"`
+	Status            otlpStatus      `json:"status"`
+}
+
+type otlpSpanEvent struct {
+	Name         string         `json:"name"`
+	TimeUnixNano string         `json:"timeUnixNano"`
+	Attributes   []otlpKeyValue `json:"attributes,omitempty"`
+}
+
+type otlpStatus struct {
+	Code    int    `json:"code,omitempty"`
+	Message string `json:"message,omitempty"`
+}
+
+// ExportSpans implements sdktrace.SpanExporter.
+func (e *otlpTraceExporter) ExportSpans(ctx context.Context, spans []sdktrace.ReadOnlySpan) error {
+	if len(spans) == 0 {
+		return nil
+	}
+	rs := otlpResourceSpans{Resource: otlpResourceOf(spans[0].Resource())}
+	scopes := map[otlpScope]int{}
+	for _, s := range spans {
+		scope := otlpScope{Name: s.InstrumentationScope().Name, Version: s.InstrumentationScope().Version}
+		idx, ok := scopes[scope]
+		if !ok {
+			idx = len(rs.ScopeSpans)
+			scopes[scope] = idx
+			rs.ScopeSpans = append(rs.ScopeSpans, otlpScopeSpans{Scope: scope})
+		}
+		rs.ScopeSpans[idx].Spans = append(rs.ScopeSpans[idx].Spans, otlpSpanOf(s))
+	}
+	return e.client.post(ctx, "/v1/traces", otlpTracesPayload{ResourceSpans: []otlpResourceSpans{rs}})
+}
+
+// Shutdown implements sdktrace.SpanExporter.
+func (e *otlpTraceExporter) Shutdown(context.Context) error { return nil }
+
+func otlpSpanOf(s sdktrace.ReadOnlySpan) otlpSpan {
+	sc := s.SpanContext()
+	span := otlpSpan{
+		TraceID:           sc.TraceID().String(),
+		SpanID:            sc.SpanID().String(),
+		Name:              s.Name(),
+		Kind:              int(s.SpanKind()), // the SDK and OTLP number kinds alike
+		StartTimeUnixNano: unixNano(s.StartTime()),
+		EndTimeUnixNano:   unixNano(s.EndTime()),
+		Attributes:        otlpAttributes(s.Attributes()),
+	}
+	if parent := s.Parent(); parent.IsValid() {
+		span.ParentSpanID = parent.SpanID().String()
+	}
+	for _, ev := range s.Events() {
+		span.Events = append(span.Events, otlpSpanEvent{
+			Name:         ev.Name,
+			TimeUnixNano: unixNano(ev.Time),
+			Attributes:   otlpAttributes(ev.Attributes),
+		})
+	}
+	// OTLP numbers status codes Unset=0, Ok=1, Error=2.
+	switch st := s.Status(); st.Code {
+	case codes.Ok:
+		span.Status = otlpStatus{Code: 1}
+	case codes.Error:
+		span.Status = otlpStatus{Code: 2, Message: st.Description}
+	}
+	return span
+}
+
+// otlpMetricExporter sends collected metrics to <endpoint>/v1/metrics.
+type otlpMetricExporter struct {
+	client *otlpClient
+}
+
+type otlpMetricsPayload struct {
+	ResourceMetrics []otlpResourceMetrics `json:"resourceMetrics"`
+}
+
+type otlpResourceMetrics struct {
+	Resource     otlpResource       `json:"resource"`
+	ScopeMetrics []otlpScopeMetrics `json:"scopeMetrics"`
+}
+
+type otlpScopeMetrics struct {
+	Scope   otlpScope    `json:"scope"`
+	Metrics []otlpMetric `json:"metrics"`
+}
+
+type otlpMetric struct {
+	Name        string         `json:"name"`
+	Description string         `json:"description,omitempty"`
+	Unit        string         `json:"unit,omitempty"`
+	Sum         *otlpSum       `json:"sum,omitempty"`
+	Gauge       *otlpGauge     `json:"gauge,omitempty"`
+	Histogram   *otlpHistogram `json:"histogram,omitempty"`
+}
+
+type otlpSum struct {
+	DataPoints             []otlpNumberPoint `json:"dataPoints"`
+	AggregationTemporality int               `json:"aggregationTemporality"`
+	IsMonotonic            bool              `json:"isMonotonic"`
+}
+
+type otlpGauge struct {
+	DataPoints []otlpNumberPoint `json:"dataPoints"`
+}
+
+type otlpHistogram struct {
+	DataPoints             []otlpHistogramPoint `json:"dataPoints"`
+	AggregationTemporality int                  `json:"aggregationTemporality"`
+}
+
+type otlpNumberPoint struct {
+	Attributes        []otlpKeyValue `json:"attributes,omitempty"`
+	StartTimeUnixNano string         `json:"startTimeUnixNano,omitempty"`
+	TimeUnixNano      string         `json:"timeUnixNano"`
+	AsInt             string         `json:"asInt,omitempty"`
+	AsDouble          *float64       `json:"asDouble,omitempty"`
+	Exemplars         []otlpExemplar `json:"exemplars,omitempty"`
+}
+
+type otlpHistogramPoint struct {
+	Attributes        []otlpKeyValue `json:"attributes,omitempty"`
+	StartTimeUnixNano string         `json:"startTimeUnixNano,omitempty"`
+	TimeUnixNano      string         `json:"timeUnixNano"`
+	Count             string         `json:"count"`
+	Sum               *float64       `json:"sum,omitempty"`
+	BucketCounts      []string       `json:"bucketCounts"`
+	ExplicitBounds    []float64      `json:"explicitBounds"`
+	Min               *float64       `json:"min,omitempty"`
+	Max               *float64       `json:"max,omitempty"`
+	Exemplars         []otlpExemplar `json:"exemplars,omitempty"`
+}
+
+type otlpExemplar struct {
+	FilteredAttributes []otlpKeyValue `json:"filteredAttributes,omitempty"`
+	TimeUnixNano       string         `json:"timeUnixNano"`
+	AsInt              string         `json:"asInt,omitempty"`
+	AsDouble           *float64       `json:"asDouble,omitempty"`
+	SpanID             string         `json:"spanId,omitempty"`
+	TraceID            string         `json:"traceId,omitempty"`
+}
+
+// Temporality implements sdkmetric.Exporter.
+func (e *otlpMetricExporter) Temporality(k sdkmetric.InstrumentKind) metricdata.Temporality {
+	return sdkmetric.DefaultTemporalitySelector(k)
+}
+
+// Aggregation implements sdkmetric.Exporter.
+func (e *otlpMetricExporter) Aggregation(k sdkmetric.InstrumentKind) sdkmetric.Aggregation {
+	return sdkmetric.DefaultAggregationSelector(k)
+}
+
+// Export implements sdkmetric.Exporter.
+func (e *otlpMetricExporter) Export(ctx context.Context, rm *metricdata.ResourceMetrics) error {
+	out := otlpResourceMetrics{Resource: otlpResourceOf(rm.Resource)}
+	for _, sm := range rm.ScopeMetrics {
+		scope := otlpScopeMetrics{Scope: otlpScope{Name: sm.Scope.Name, Version: sm.Scope.Version}}
+		for _, m := range sm.Metrics {
+			if om, ok := otlpMetricOf(m); ok {
+				scope.Metrics = append(scope.Metrics, om)
+			}
+		}
+		if len(scope.Metrics) > 0 {
+			out.ScopeMetrics = append(out.ScopeMetrics, scope)
+		}
+	}
+	if len(out.ScopeMetrics) == 0 {
+		return nil
+	}
+	return e.client.post(ctx, "/v1/metrics", otlpMetricsPayload{ResourceMetrics: []otlpResourceMetrics{out}})
+}
+
+// ForceFlush implements sdkmetric.Exporter; nothing is buffered.
+func (e *otlpMetricExporter) ForceFlush(context.Context) error { return nil }
+
+// Shutdown implements sdkmetric.Exporter.
+func (e *otlpMetricExporter) Shutdown(context.Context) error { return nil }
+
+func otlpMetricOf(m metricdata.Metrics) (otlpMetric, bool) {
+	out := otlpMetric{Name: m.Name, Description: m.Description, Unit: m.Unit}
+	switch data := m.Data.(type) {
+	case metricdata.Sum[int64]:
+		out.Sum = &otlpSum{DataPoints: otlpNumberPoints(data.DataPoints), AggregationTemporality: otlpTemporality(data.Temporality), IsMonotonic: data.IsMonotonic}
+	case metricdata.Sum[float64]:
+		out.Sum = &otlpSum{DataPoints: otlpNumberPoints(data.DataPoints), AggregationTemporality: otlpTemporality(data.Temporality), IsMonotonic: data.IsMonotonic}
+	case metricdata.Gauge[int64]:
+		out.Gauge = &otlpGauge{DataPoints: otlpNumberPoints(data.DataPoints)}
+	case metricdata.Gauge[float64]:
+		out.Gauge = &otlpGauge{DataPoints: otlpNumberPoints(data.DataPoints)}
+	case metricdata.Histogram[int64]:
+		out.Histogram = &otlpHistogram{DataPoints: otlpHistogramPoints(data.DataPoints), AggregationTemporality: otlpTemporality(data.Temporality)}
+	case metricdata.Histogram[float64]:
+		out.Histogram = &otlpHistogram{DataPoints: otlpHistogramPoints(data.DataPoints), AggregationTemporality: otlpTemporality(data.Temporality)}
+	default:
+		return out, false
+	}
+	return out, true
+}
+
+// otlpTemporality maps SDK temporality onto OTLP's numbering (Delta=1,
+// Cumulative=2), which differs from the SDK's.
+func otlpTemporality(t metricdata.Temporality) int {
+	switch t {
+	case metricdata.DeltaTemporality:
+		return 1
+	case metricdata.CumulativeTemporality:
+		return 2
+	}
+	return 0
+}
+
+func otlpNumber[N int64 | float64](v N) (asInt string, asDouble *float64) {
+	switch x := any(v).(type) {
+	case int64:
+		return strconv.FormatInt(x, 10), nil
+	case float64:
+		return "", &x
+	}
+	return "", nil
+}
+
+func otlpNumberPoints[N int64 | float64](points []metricdata.DataPoint[N]) []otlpNumberPoint {
+	out := make([]otlpNumberPoint, 0, len(points))
+	for _, p := range points {
+		asInt, asDouble := otlpNumber(p.Value)
+		out = append(out, otlpNumberPoint{
+			Attributes:        otlpAttributes(p.Attributes.ToSlice()),
+			StartTimeUnixNano: unixNano(p.StartTime),
+			TimeUnixNano:      unixNano(p.Time),
+			AsInt:             asInt,
+			AsDouble:          asDouble,
+			Exemplars:         otlpExemplars(p.Exemplars),
+		})
+	}
+	return out
+}
+
+func otlpHistogramPoints[N int64 | float64](points []metricdata.HistogramDataPoint[N]) []otlpHistogramPoint {
+	out := make([]otlpHistogramPoint, 0, len(points))
+	for _, p := range points {
+		sum := float64(p.Sum)
+		hp := otlpHistogramPoint{
+			Attributes:        otlpAttributes(p.Attributes.ToSlice()),
+			StartTimeUnixNano: unixNano(p.StartTime),
+			TimeUnixNano:      unixNano(p.Time),
+			Count:             strconv.FormatUint(p.Count, 10),
+			Sum:               &sum,
+			ExplicitBounds:    p.Bounds,
+			Exemplars:         otlpExemplars(p.Exemplars),
+		}
+		for _, c := range p.BucketCounts {
+			hp.BucketCounts = append(hp.BucketCounts, strconv.FormatUint(c, 10))
+		}
+		if v, ok := p.Min.Value(); ok {
+			f := float64(v)
+			hp.Min = &f
+		}
+		if v, ok := p.Max.Value(); ok {
+			f := float64(v)
+			hp.Max = &f
+		}
+		out = append(out, hp)
+	}
+	return out
+}
+
+func otlpExemplars[N int64 | float64](exemplars []metricdata.Exemplar[N]) []otlpExemplar {
+	if len(exemplars) == 0 {
+		return nil
+	}
+	out := make([]otlpExemplar, 0, len(exemplars))
+	for _, ex := range exemplars {
+		asInt, asDouble := otlpNumber(ex.Value)
+		out = append(out, otlpExemplar{
+			FilteredAttributes: otlpAttributes(ex.FilteredAttributes),
+			TimeUnixNano:       unixNano(ex.Time),
+			AsInt:              asInt,
+			AsDouble:           asDouble,
+			SpanID:             hex.EncodeToString(ex.SpanID),
+			TraceID:            hex.EncodeToString(ex.TraceID),
+		})
+	}
+	return out
+}
@@ -0,0 +1,176 @@
+package otel
+
+import (
+	"context"
+	"encoding/json"
+	"errors"
+	"io"
+	"net/http"
+	"net/http/httptest"
+	"sync"
+	"testing"
+	"time"
+)
+
+// collector is a stand-in OTLP/HTTP collector that keeps what it receives.
+type collector struct {
+	mu      sync.Mutex
+	traces  []otlpTracesPayload
+	metrics []otlpMetricsPayload
+}
+
+func newCollector(t *testing.T) (*collector, string) {
+	t.Helper()
+	c := &collector{}
+	srv := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		body, _ := io.ReadAll(r.Body)
+		c.mu.Lock()
+		defer c.mu.Unlock()
+		var err error
+		switch r.URL.Path {
+		case "/v1/traces":
+			var p otlpTracesPayload
+			err = json.Unmarshal(body, &p)
+			c.traces = append(c.traces, p)
+		case "/v1/metrics":
+			var p otlpMetricsPayload
+			err = json.Unmarshal(body, &p)
+			c.metrics = append(c.metrics, p)
+		default:
+			err = errors.New("unexpected path")
+		}
+		if err != nil {
+			http.Error(w, err.Error(), http.StatusBadRequest)
+		}
+	}))
+	t.Cleanup(srv.Close)
+	return c, srv.URL
+}
+
+func attrValue(kvs []otlpKeyValue, key string) (otlpAnyValue, bool) {
+	for _, kv := range kvs {
+		if kv.Key == key {
+			return kv.Value, true
+		}
+	}
+	return otlpAnyValue{}, false
+}
+
+func TestLSMInstrumentsExportToCollector(t *testing.T) {
+	c, endpoint := newCollector(t)
+	p, err := Setup(context.Background(), Config{
+		EnableMetrics:     true,
+		EnableTraces:      true,
+		Endpoint:          endpoint,
+		DenialSampleEvery: 2,
+	})
+	if err != nil {
+		t.Fatalf("setup: %v", err)
+	}
+	inst := p.LSM()
+	inst.RecordDecision(LSMDecision{Operation: LSMFileOpen, Seq: 1})
+	inst.RecordDecision(LSMDecision{Operation: LSMNetConnect, Denied: true, Seq: 42, PID: 7, Exe: "curl", Target: "10.0.0.1:443"})
+	inst.RecordDecision(LSMDecision{Operation: LSMNetConnect, Denied: true, Seq: 43})
+	inst.RecordPolicyReload(3*time.Millisecond, nil)
+	if err := inst.ObserveRingBufferLag("connect", func() int64 { return 128 }); err != nil {
+		t.Fatalf("observe lag: %v", err)
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	if err := p.Shutdown(ctx); err != nil {
+		t.Fatalf("shutdown: %v", err)
+	}
+
+	c.mu.Lock()
+	defer c.mu.Unlock()
+
+	// Only the first of the two denials is sampled.
+	var denyTraceID string
+	var spans []string
+	for _, payload := range c.traces {
+		for _, rs := range payload.ResourceSpans {
+			for _, ss := range rs.ScopeSpans {
+				for _, span := range ss.Spans {
+					spans = append(spans, span.Name)
+					if span.Name == "lsm.deny net.connect" {
+						if v, _ := attrValue(span.Attributes, "leash.event.seq"); v.IntValue != "42" {
+							t.Fatalf("expected the sampled denial to carry seq 42, got %+v", span.Attributes)
+						}
+						denyTraceID = span.TraceID
+					}
+				}
+			}
+		}
+	}
+	if len(spans) != 2 || denyTraceID == "" {
+		t.Fatalf("expected one denial span and one policy.reload span, got %v", spans)
+	}
+
+	found := map[string]bool{}
+	for _, payload := range c.metrics {
+		for _, rm := range payload.ResourceMetrics {
+			for _, sm := range rm.ScopeMetrics {
+				for _, m := range sm.Metrics {
+					found[m.Name] = true
+					if m.Name != lsmDecisionsName || m.Sum == nil {
+						continue
+					}
+					for _, dp := range m.Sum.DataPoints {
+						if _, ok := attrValue(dp.Attributes, "leash.event.seq"); ok {
+							t.Fatalf("event seq leaked into the decision series: %+v", dp.Attributes)
+						}
+						result, _ := attrValue(dp.Attributes, "result")
+						if result.StringValue == nil || *result.StringValue != "deny" {
+							continue
+						}
+						if dp.AsInt != "2" {
+							t.Fatalf("expected 2 denials, got %s", dp.AsInt)
+						}
+						if len(dp.Exemplars) != 1 || dp.Exemplars[0].TraceID != denyTraceID {
+							t.Fatalf("expected an exemplar linking to the denial span, got %+v", dp.Exemplars)
+						}
+						if v, _ := attrValue(dp.Exemplars[0].FilteredAttributes, "leash.event.seq"); v.IntValue != "42" {
+							t.Fatalf("expected the exemplar to carry seq 42, got %+v", dp.Exemplars[0].FilteredAttributes)
+						}
+					}
+				}
+			}
+		}
+	}
+	for _, name := range []string{lsmDecisionsName, "leash.lsm.ringbuf.pending", "leash.policy.reload.duration"} {
+		if !found[name] {
+			t.Fatalf("collector did not receive %s: %v", name, found)
+		}
+	}
+}
+
+func TestLSMInstrumentsOffAllocateNothing(t *testing.T) {
+	p, err := Setup(context.Background(), Config{})
+	if err != nil {
+		t.Fatalf("setup: %v", err)
+	}
+	inst := p.LSM()
+	d := LSMDecision{Operation: LSMFileOpen, Denied: true, Seq: 1, Exe: "cat", Target: "/etc/shadow"}
+	if allocs := testing.AllocsPerRun(100, func() { inst.RecordDecision(d) }); allocs != 0 {
+		t.Fatalf("expected no allocations with telemetry off, got %v", allocs)
+	}
+}
+
+func TestLSMInstrumentsNeverBlockOnSampledDenials(t *testing.T) {
+	inst := &LSMInstruments{sampleEvery: 1, sampled: make(chan LSMDecision, 1)}
+	done := make(chan struct{})
+	go func() {
+		defer close(done)
+		inst.RecordDecision(LSMDecision{Operation: LSMProcExec, Denied: true, Seq: 1})
+		inst.RecordDecision(LSMDecision{Operation: LSMProcExec, Denied: true, Seq: 2})
+	}()
+	select {
+	case <-done:
+	case <-time.After(5 * time.Second):
+		t.Fatal("RecordDecision blocked on a full denial queue")
+	}
+	if d := <-inst.sampled; d.Seq != 1 {
+		t.Fatalf("expected the first denial to be queued, got seq %d", d.Seq)
+	}
+}
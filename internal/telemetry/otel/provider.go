@@ -4,11 +4,12 @@ import (
 	"context"
 	"errors"
 	"fmt"
-	"log"
 	"net/http"
 	"os"
+	"strconv"
 	"strings"
 	"sync"
+	"time"
 
 	"go.opentelemetry.io/otel"
 	"go.opentelemetry.io/otel/attribute"
@@ -28,9 +29,17 @@ type Config struct {
 	Endpoint      string
 	Headers       map[string]string
 	PropagateHTTP bool
+	// DenialSampleEvery traces one LSM denial in every DenialSampleEvery.
+	DenialSampleEvery int
 }
 
-// Provider owns OTEL meter/tracer providers and derived MCP instruments.
+// defaultDenialSampleEvery is used when DenialSampleEvery is unset.
+const defaultDenialSampleEvery = 10
+
+// otlpExportInterval is how often metrics are pushed to an OTLP endpoint.
+const otlpExportInterval = 15 * time.Second
+
+// Provider owns OTEL meter/tracer providers and derived MCP and LSM instruments.
 type Provider struct {
 	cfg            Config
 	meterProvider  *sdkmetric.MeterProvider
@@ -39,6 +48,7 @@ type Provider struct {
 	tracer         trace.Tracer
 
 	mcpInstruments *MCPInstruments
+	lsmInstruments *LSMInstruments
 	shutdownOnce   sync.Once
 }
 
@@ -85,29 +95,46 @@ func Setup(ctx context.Context, cfg Config) (*Provider, error) {
 	}
 
 	p.mcpInstruments = newMCPInstruments(p, cfg.PropagateHTTP)
+	sampleEvery := cfg.DenialSampleEvery
+	if sampleEvery <= 0 {
+		sampleEvery = defaultDenialSampleEvery
+	}
+	p.lsmInstruments = newLSMInstruments(p, sampleEvery)
 	return p, nil
 }
 
 func createMeterProvider(ctx context.Context, cfg Config, res *resource.Resource) (*sdkmetric.MeterProvider, error) {
+	var reader sdkmetric.Reader
 	if strings.TrimSpace(cfg.Endpoint) != "" {
-		log.Printf("LEASH_OTEL_ENDPOINT=%s ignored: remote OTLP metric export not implemented", cfg.Endpoint)
+		exp := &otlpMetricExporter{client: newOTLPClient(cfg.Endpoint, cfg.Headers)}
+		reader = sdkmetric.NewPeriodicReader(exp, sdkmetric.WithInterval(otlpExportInterval))
+	} else {
+		reader = sdkmetric.NewManualReader()
 	}
 
-	reader := sdkmetric.NewManualReader()
+	// A sampled denial carries its event sequence number; keep it on the
+	// exemplar but out of the decision series.
+	decisionsView := sdkmetric.NewView(
+		sdkmetric.Instrument{Name: lsmDecisionsName},
+		sdkmetric.Stream{AttributeFilter: attribute.NewDenyKeysFilter(eventSeqKey)},
+	)
 	return sdkmetric.NewMeterProvider(
 		sdkmetric.WithReader(reader),
 		sdkmetric.WithResource(res),
+		sdkmetric.WithView(decisionsView),
 	), nil
 }
 
 func createTracerProvider(ctx context.Context, cfg Config, res *resource.Resource) (*sdktrace.TracerProvider, error) {
+	var exp sdktrace.SpanExporter
 	if strings.TrimSpace(cfg.Endpoint) != "" {
-		log.Printf("LEASH_OTEL_ENDPOINT=%s ignored: OTLP trace export unsupported; using stdout exporter", cfg.Endpoint)
-	}
-
-	exp, err := stdouttrace.New(stdouttrace.WithPrettyPrint())
-	if err != nil {
-		return nil, fmt.Errorf("init stdout trace exporter: %w", err)
+		exp = &otlpTraceExporter{client: newOTLPClient(cfg.Endpoint, cfg.Headers)}
+	} else {
+		stdout, err := stdouttrace.New(stdouttrace.WithPrettyPrint())
+		if err != nil {
+			return nil, fmt.Errorf("init stdout trace exporter: %w", err)
+		}
+		exp = stdout
 	}
 
 	tp := sdktrace.NewTracerProvider(
@@ -122,6 +149,10 @@ func (p *Provider) Shutdown(ctx context.Context) error {
 	var err error
 	p.shutdownOnce.Do(func() {
 		var errs []error
+		// Sampled denials still queued need the tracer and meter.
+		if stopErr := p.lsmInstruments.stop(ctx); stopErr != nil {
+			errs = append(errs, stopErr)
+		}
 		if p.meterProvider != nil {
 			if shutdownErr := p.meterProvider.Shutdown(ctx); shutdownErr != nil {
 				errs = append(errs, shutdownErr)
@@ -147,6 +178,14 @@ func (p *Provider) MCP() *MCPInstruments {
 	return p.mcpInstruments
 }
 
+// LSM returns instruments for LSM decisions and policy reloads.
+func (p *Provider) LSM() *LSMInstruments {
+	if p == nil {
+		return nil
+	}
+	return p.lsmInstruments
+}
+
 // ParseHeadersEnv converts LEASH_OTEL_HEADERS into a header map (comma/whitespace separated).
 func ParseHeadersEnv(raw string) map[string]string {
 	raw = strings.TrimSpace(raw)
@@ -199,11 +238,20 @@ func EnvBool(value string, defaultOn bool) bool {
 // LoadConfigFromEnv reads OTEL config from environment (used by runtime).
 func LoadConfigFromEnv() Config {
 	return Config{
-		ServiceName:   "leash",
-		EnableMetrics: EnvBool(os.Getenv("LEASH_OTEL_METRICS"), false),
-		EnableTraces:  EnvBool(os.Getenv("LEASH_OTEL_TRACES"), false),
-		Endpoint:      strings.TrimSpace(os.Getenv("LEASH_OTEL_ENDPOINT")),
-		Headers:       ParseHeadersEnv(os.Getenv("LEASH_OTEL_HEADERS")),
-		PropagateHTTP: EnvBool(os.Getenv("LEASH_OTEL_PROPAGATE_HTTP_HEADERS"), false),
+		ServiceName:       "leash",
+		EnableMetrics:     EnvBool(os.Getenv("LEASH_OTEL_METRICS"), false),
+		EnableTraces:      EnvBool(os.Getenv("LEASH_OTEL_TRACES"), false),
+		Endpoint:          strings.TrimSpace(os.Getenv("LEASH_OTEL_ENDPOINT")),
+		Headers:           ParseHeadersEnv(os.Getenv("LEASH_OTEL_HEADERS")),
+		PropagateHTTP:     EnvBool(os.Getenv("LEASH_OTEL_PROPAGATE_HTTP_HEADERS"), false),
+		DenialSampleEvery: envInt(os.Getenv("LEASH_OTEL_DENIAL_SAMPLE_EVERY")),
+	}
+}
+
+func envInt(value string) int {
+	n, err := strconv.Atoi(strings.TrimSpace(value))
+	if err != nil {
+		return 0
 	}
+	return n
 }
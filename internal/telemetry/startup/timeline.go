@@ -0,0 +1,275 @@
+// Package startup records how long each phase of bringing up a leash session
+// takes. Every component (the runner on the host, leash-entry in the target
+// container and leashd in the leash container) keeps a Timeline, reports it
+// as one startup.timeline event, and optionally writes it as a Chrome trace
+// file that chrome://tracing or Perfetto can open.
+package startup
+
+import (
+	"context"
+	"encoding/json"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+	"sync"
+	"time"
+)
+
+// TraceEnv names the directory trace files are written to. Tracing is off
+// when it is unset.
+const TraceEnv = "LEASH_STARTUP_TRACE"
+
+// Phase is one timed step. Offsets are relative to the timeline start.
+type Phase struct {
+	Name       string `json:"name"`
+	Component  string `json:"component,omitempty"`
+	OffsetUS   int64  `json:"offset_us"`
+	DurationUS int64  `json:"dur_us"`
+	Error      string `json:"error,omitempty"`
+}
+
+// Snapshot is a point-in-time copy of a Timeline.
+type Snapshot struct {
+	Component string    `json:"component"`
+	Start     time.Time `json:"start"`
+	TotalUS   int64     `json:"total_us"`
+	Phases    []Phase   `json:"phases"`
+}
+
+// Timeline collects phases for one component. It is safe for concurrent use,
+// and a nil *Timeline records nothing.
+type Timeline struct {
+	mu        sync.Mutex
+	component string
+	start     time.Time
+	phases    []Phase
+	open      int
+	idle      chan struct{}
+}
+
+// New starts a timeline for component now.
+func New(component string) *Timeline {
+	return &Timeline{component: component, start: time.Now()}
+}
+
+// Default is the process-wide timeline used by packages that record phases
+// without being handed one, such as the LSM loaders inside leashd.
+var Default = New(defaultComponent())
+
+func defaultComponent() string {
+	if len(os.Args) == 0 {
+		return "leash"
+	}
+	return filepath.Base(os.Args[0])
+}
+
+// SetComponent renames the component the timeline reports as.
+func (t *Timeline) SetComponent(component string) {
+	if t == nil {
+		return
+	}
+	t.mu.Lock()
+	t.component = component
+	t.mu.Unlock()
+}
+
+// Begin starts the named phase and returns the function that ends it. The end
+// function records err, if any, as the phase's outcome.
+func (t *Timeline) Begin(name string) func(err error) {
+	if t == nil {
+		return func(error) {}
+	}
+	start := time.Now()
+	t.mu.Lock()
+	t.open++
+	t.mu.Unlock()
+	var once sync.Once
+	return func(err error) {
+		once.Do(func() {
+			t.mu.Lock()
+			defer t.mu.Unlock()
+			t.appendLocked(name, start, time.Now(), err)
+			t.open--
+			if t.open == 0 && t.idle != nil {
+				close(t.idle)
+				t.idle = nil
+			}
+		})
+	}
+}
+
+// Record adds a phase that ran from start until now.
+func (t *Timeline) Record(name string, start time.Time, err error) {
+	if t == nil {
+		return
+	}
+	end := time.Now()
+	t.mu.Lock()
+	t.appendLocked(name, start, end, err)
+	t.mu.Unlock()
+}
+
+func (t *Timeline) appendLocked(name string, start, end time.Time, err error) {
+	p := Phase{
+		Name:       name,
+		OffsetUS:   start.Sub(t.start).Microseconds(),
+		DurationUS: end.Sub(start).Microseconds(),
+	}
+	if err != nil {
+		p.Error = err.Error()
+	}
+	t.phases = append(t.phases, p)
+}
+
+// Merge folds another component's snapshot into t, shifting its phases onto
+// t's clock and tagging them with that component.
+func (t *Timeline) Merge(s Snapshot) {
+	if t == nil || s.Start.IsZero() {
+		return
+	}
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	shift := s.Start.Sub(t.start).Microseconds()
+	for _, p := range s.Phases {
+		p.OffsetUS += shift
+		if p.Component == "" {
+			p.Component = s.Component
+		}
+		t.phases = append(t.phases, p)
+	}
+}
+
+// Wait blocks until every phase started with Begin has ended, or ctx is done.
+func (t *Timeline) Wait(ctx context.Context) error {
+	if t == nil {
+		return nil
+	}
+	t.mu.Lock()
+	if t.open == 0 {
+		t.mu.Unlock()
+		return nil
+	}
+	if t.idle == nil {
+		t.idle = make(chan struct{})
+	}
+	idle := t.idle
+	t.mu.Unlock()
+	select {
+	case <-idle:
+		return nil
+	case <-ctx.Done():
+		return ctx.Err()
+	}
+}
+
+// Snapshot returns the phases recorded so far ordered by start offset. The
+// total spans from the timeline start to the latest phase end.
+func (t *Timeline) Snapshot() Snapshot {
+	if t == nil {
+		return Snapshot{}
+	}
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	s := Snapshot{
+		Component: t.component,
+		Start:     t.start,
+		Phases:    append([]Phase(nil), t.phases...),
+	}
+	sort.SliceStable(s.Phases, func(i, j int) bool { return s.Phases[i].OffsetUS < s.Phases[j].OffsetUS })
+	for _, p := range s.Phases {
+		s.TotalUS = max(s.TotalUS, p.OffsetUS+p.DurationUS)
+	}
+	return s
+}
+
+// Fields renders the snapshot for a compact event=startup.timeline log line:
+// the total plus one name=milliseconds summary per phase in start order.
+func (s Snapshot) Fields() map[string]any {
+	parts := make([]string, 0, len(s.Phases))
+	for _, p := range s.Phases {
+		name := p.Name
+		if p.Component != "" && p.Component != s.Component {
+			name = p.Component + "." + name
+		}
+		entry := fmt.Sprintf("%s=%.1f", name, float64(p.DurationUS)/1000)
+		if p.Error != "" {
+			entry += "!"
+		}
+		parts = append(parts, entry)
+	}
+	return map[string]any{
+		"component": s.Component,
+		"total_ms":  fmt.Sprintf("%.1f", float64(s.TotalUS)/1000),
+		"phases":    strings.Join(parts, ","),
+	}
+}
+
+// WriteTrace writes the snapshot in the Chrome trace event format, with one
+// track per component.
+func (s Snapshot) WriteTrace(path string) error {
+	type traceEvent struct {
+		Name string         `json:"name"`
+		Ph   string         `json:"ph"`
+		TS   int64          `json:"ts"`
+		Dur  int64          `json:"dur,omitempty"`
+		PID  int            `json:"pid"`
+		TID  int            `json:"tid"`
+		Args map[string]any `json:"args,omitempty"`
+	}
+	tracks := map[string]int{}
+	var events []traceEvent
+	track := func(component string) int {
+		if component == "" {
+			component = s.Component
+		}
+		id, ok := tracks[component]
+		if !ok {
+			id = len(tracks) + 1
+			tracks[component] = id
+			events = append(events, traceEvent{Name: "thread_name", Ph: "M", PID: 1, TID: id, Args: map[string]any{"name": component}})
+		}
+		return id
+	}
+	track(s.Component)
+	base := s.Start.UnixMicro()
+	for _, p := range s.Phases {
+		ev := traceEvent{Name: p.Name, Ph: "X", TS: base + p.OffsetUS, Dur: p.DurationUS, PID: 1, TID: track(p.Component)}
+		if p.Error != "" {
+			ev.Args = map[string]any{"error": p.Error}
+		}
+		events = append(events, ev)
+	}
+	data, err := json.Marshal(map[string]any{"traceEvents": events, "displayTimeUnit": "ms"})
+	if err != nil {
+		return err
+	}
+	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+		return err
+	}
+	return os.WriteFile(path, data, 0o644)
+}
+
+// TracePath returns where component's trace file goes, or "" when TraceEnv
+// is unset.
+func TracePath(component string) string {
+	dir := strings.TrimSpace(os.Getenv(TraceEnv))
+	if dir == "" {
+		return ""
+	}
+	return filepath.Join(dir, "startup-"+component+".json")
+}
+
+// Flush snapshots t and, when TraceEnv is set, writes the snapshot to the
+// component's trace file. path is empty when no trace was written.
+func (t *Timeline) Flush() (s Snapshot, path string, err error) {
+	s = t.Snapshot()
+	if path = TracePath(s.Component); path == "" {
+		return s, "", nil
+	}
+	if err := s.WriteTrace(path); err != nil {
+		return s, "", fmt.Errorf("write startup trace: %w", err)
+	}
+	return s, path, nil
+}
@@ -0,0 +1,134 @@
+package startup
+
+import (
+	"context"
+	"encoding/json"
+	"errors"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestTimelineRecordsPhasesInStartOrder(t *testing.T) {
+	t.Parallel()
+
+	tl := New("runner")
+	endOuter := tl.Begin("preflight")
+	endInner := tl.Begin("image.check")
+	endInner(nil)
+	endOuter(errors.New("boom"))
+	endOuter(nil) // ending twice keeps the first outcome
+
+	s := tl.Snapshot()
+	if len(s.Phases) != 2 {
+		t.Fatalf("expected 2 phases, got %+v", s.Phases)
+	}
+	if s.Phases[0].Name != "preflight" || s.Phases[1].Name != "image.check" {
+		t.Fatalf("phases not ordered by start: %+v", s.Phases)
+	}
+	if s.Phases[0].Error != "boom" {
+		t.Fatalf("expected error on preflight, got %+v", s.Phases[0])
+	}
+	if s.TotalUS < s.Phases[1].OffsetUS+s.Phases[1].DurationUS {
+		t.Fatalf("total %d does not cover phases %+v", s.TotalUS, s.Phases)
+	}
+
+	fields := s.Fields()
+	if fields["component"] != "runner" {
+		t.Fatalf("unexpected fields: %v", fields)
+	}
+	if phases, _ := fields["phases"].(string); !strings.HasPrefix(phases, "preflight=") || !strings.Contains(phases, "!,image.check=") {
+		t.Fatalf("unexpected phases field: %q", phases)
+	}
+}
+
+func TestTimelineMergeShiftsOntoOwnClock(t *testing.T) {
+	t.Parallel()
+
+	tl := New("runner")
+	other := Snapshot{
+		Component: "entry",
+		Start:     tl.Snapshot().Start.Add(2 * time.Second),
+		Phases:    []Phase{{Name: "ca.trust", OffsetUS: 500, DurationUS: 100}},
+	}
+	tl.Merge(other)
+
+	s := tl.Snapshot()
+	if len(s.Phases) != 1 {
+		t.Fatalf("expected merged phase, got %+v", s.Phases)
+	}
+	p := s.Phases[0]
+	if p.Component != "entry" || p.OffsetUS != 2_000_500 {
+		t.Fatalf("unexpected merged phase: %+v", p)
+	}
+	if got := s.Fields()["phases"]; got != "entry.ca.trust=0.1" {
+		t.Fatalf("unexpected phases field: %v", got)
+	}
+}
+
+func TestTimelineWaitForOpenPhases(t *testing.T) {
+	t.Parallel()
+
+	tl := New("leashd")
+	end := tl.Begin("bpf.attach")
+	go func() {
+		time.Sleep(10 * time.Millisecond)
+		end(nil)
+	}()
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	if err := tl.Wait(ctx); err != nil {
+		t.Fatalf("Wait returned error: %v", err)
+	}
+
+	tl.Begin("never.ends")
+	short, cancelShort := context.WithTimeout(context.Background(), 10*time.Millisecond)
+	defer cancelShort()
+	if err := tl.Wait(short); !errors.Is(err, context.DeadlineExceeded) {
+		t.Fatalf("expected deadline exceeded, got %v", err)
+	}
+}
+
+func TestNilTimelineIsNoop(t *testing.T) {
+	t.Parallel()
+
+	var tl *Timeline
+	tl.Begin("x")(nil)
+	tl.Record("y", time.Now(), nil)
+	if s := tl.Snapshot(); len(s.Phases) != 0 {
+		t.Fatalf("expected empty snapshot, got %+v", s)
+	}
+}
+
+func TestFlushWritesChromeTrace(t *testing.T) {
+	dir := t.TempDir()
+	t.Setenv(TraceEnv, dir)
+
+	tl := New("leashd")
+	tl.Begin("policy.compile")(nil)
+	_, path, err := tl.Flush()
+	if err != nil {
+		t.Fatalf("Flush returned error: %v", err)
+	}
+	if want := filepath.Join(dir, "startup-leashd.json"); path != want {
+		t.Fatalf("trace path mismatch: got %q want %q", path, want)
+	}
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	var trace struct {
+		TraceEvents []struct {
+			Name string `json:"name"`
+			Ph   string `json:"ph"`
+		} `json:"traceEvents"`
+	}
+	if err := json.Unmarshal(data, &trace); err != nil {
+		t.Fatalf("trace is not valid JSON: %v", err)
+	}
+	if len(trace.TraceEvents) != 2 || trace.TraceEvents[1].Name != "policy.compile" || trace.TraceEvents[1].Ph != "X" {
+		t.Fatalf("unexpected trace events: %+v", trace.TraceEvents)
+	}
+}
@@ -0,0 +1,59 @@
+package transpiler
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+)
+
+// benchCedar returns n policies cycling through the file, exec, network and
+// header rewrite shapes the transpiler handles.
+func benchCedar(n int) string {
+	var sb strings.Builder
+	for i := 0; i < n; i++ {
+		switch i % 4 {
+		case 0:
+			fmt.Fprintf(&sb, "permit (principal, action == Action::\"FileOpenReadOnly\", resource)\nwhen { resource in [ Dir::\"/workspace/repo-%d/\", File::\"/etc/app%d.conf\" ] };\n", i, i)
+		case 1:
+			fmt.Fprintf(&sb, "forbid (principal, action == Action::\"ProcessExec\", resource)\nwhen { resource in [ File::\"/usr/bin/tool%d\" ] };\n", i)
+		case 2:
+			fmt.Fprintf(&sb, "permit (principal, action == Action::\"NetworkConnect\", resource)\nwhen { resource in [ Host::\"api%d.example.com:443\", Host::\"*.cdn%d.example.net\" ] };\n", i, i)
+		case 3:
+			fmt.Fprintf(&sb, "permit (principal, action == Action::\"HttpRewrite\", resource == Host::\"api%d.example.com\")\nwhen { context.header == \"Authorization\" && context.value == \"Bearer token-%d\" };\n", i, i)
+		}
+	}
+	return sb.String()
+}
+
+func BenchmarkTranspileFromString(b *testing.B) {
+	for _, n := range []int{10, 100, 1000} {
+		b.Run(fmt.Sprintf("policies=%d", n), func(b *testing.B) {
+			src := benchCedar(n)
+			t := NewCedarToLeashTranspiler()
+			b.SetBytes(int64(len(src)))
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				if _, _, err := t.TranspileFromString(src); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkLintFromString(b *testing.B) {
+	for _, n := range []int{10, 100, 1000} {
+		b.Run(fmt.Sprintf("policies=%d", n), func(b *testing.B) {
+			src := benchCedar(n)
+			b.SetBytes(int64(len(src)))
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				if _, err := LintFromString(src); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
@@ -0,0 +1,87 @@
+package websocket
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+)
+
+func benchLogLine(pathLen int) string {
+	path := "/home/agent/src/" + strings.Repeat("d/", pathLen/2)
+	return fmt.Sprintf(`time=2025-10-11T15:04:05Z event=file.open:ro pid=4242 cgroup=7 exe="claude" path="%s" decision=allowed`, path[:pathLen])
+}
+
+func benchEntries(n int) []LogEntry {
+	entries := make([]LogEntry, n)
+	for i := range entries {
+		entries[i] = parseLogfmtToJSON(benchLogLine(64 + i%192))
+		entries[i].Seq = uint64(i + 1)
+	}
+	return entries
+}
+
+func BenchmarkParseLogfmtToJSON(b *testing.B) {
+	lines := map[string]string{
+		"exec":    `time=2025-10-11T15:04:05Z event=proc.exec pid=4242 cgroup=7 exe="bash" path="/usr/bin/git" argc=3 argv="git commit -m \"wip\"" decision=allowed`,
+		"connect": `time=2025-10-11T15:04:05Z event=net.send pid=4242 cgroup=7 exe="curl" protocol=tcp addr="93.184.216.34:443" hostname="api.example.com" decision=denied`,
+	}
+	for _, size := range []int{32, 256, 1024} {
+		lines[fmt.Sprintf("path=%d", size)] = benchLogLine(size)
+	}
+	for _, name := range []string{"exec", "connect", "path=32", "path=256", "path=1024"} {
+		line := lines[name]
+		b.Run(name, func(b *testing.B) {
+			b.SetBytes(int64(len(line)))
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				parseLogfmtToJSON(line)
+			}
+		})
+	}
+}
+
+func BenchmarkEventRingBufferAdd(b *testing.B) {
+	entries := benchEntries(1024)
+	for _, size := range []int{1000, 25000} {
+		b.Run(fmt.Sprintf("size=%d", size), func(b *testing.B) {
+			rb := NewEventRingBuffer(size)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				rb.Add(entries[i%len(entries)])
+			}
+		})
+	}
+}
+
+func BenchmarkEventRingBufferGetTail(b *testing.B) {
+	rb := NewEventRingBuffer(25000)
+	// Overfill so the buffer has wrapped, as it has in a long session.
+	for _, e := range benchEntries(30000) {
+		rb.Add(e)
+	}
+	for _, n := range []int{100, 1000, 25000} {
+		b.Run(fmt.Sprintf("tail=%d", n), func(b *testing.B) {
+			b.ReportAllocs()
+			for i := 0; i < b.N; i++ {
+				if got := rb.GetTail(n); len(got) != n {
+					b.Fatalf("got %d events, want %d", len(got), n)
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkEncodeNDJSONLimited(b *testing.B) {
+	for _, n := range []int{100, 1000, 10000} {
+		events := benchEntries(n)
+		for _, limit := range []int{0, 256 << 10} {
+			b.Run(fmt.Sprintf("events=%d/maxBytes=%d", n, limit), func(b *testing.B) {
+				b.ReportAllocs()
+				for i := 0; i < b.N; i++ {
+					encodeNDJSONLimited(events, limit)
+				}
+			})
+		}
+	}
+}
@@ -170,6 +170,31 @@ func (rb *EventRingBuffer) GetTail(n int) []LogEntry {
 	return out
 }
 
+// Since returns the buffered events with a sequence number above seq, oldest
+// first. ok is false when events after seq have already been overwritten, so
+// the result would have a gap.
+func (rb *EventRingBuffer) Since(seq uint64) (events []LogEntry, ok bool) {
+	rb.mutex.RLock()
+	defer rb.mutex.RUnlock()
+
+	n := 0
+	for n < rb.count {
+		idx := (rb.head - 1 - n + rb.size) % rb.size
+		if rb.events[idx].Seq <= seq {
+			break
+		}
+		n++
+	}
+	if n == rb.count && n > 0 && rb.events[rb.tail].Seq > seq+1 {
+		return nil, false
+	}
+	out := make([]LogEntry, n)
+	for i := 0; i < n; i++ {
+		out[i] = rb.events[(rb.head-n+i+rb.size)%rb.size]
+	}
+	return out, true
+}
+
 // GetBulkNDJSON returns all events formatted as NDJSON for bulk transmission
 func (rb *EventRingBuffer) GetBulkNDJSON() []byte {
 	events := rb.GetAll()
@@ -265,11 +290,19 @@ type WebSocketHub struct {
 	logger      *lsm.SharedLogger
 	eventBuffer *EventRingBuffer
 	instanceID  string
+	emitMu      sync.Mutex // orders emits; see emit
 	seq         uint64
 	startTime   time.Time
 	// limits for the initial bulk send on new connections
 	bulkMaxEvents int
 	bulkMaxBytes  int
+
+	subMu       sync.RWMutex
+	subscribers map[int]chan LogEntry
+	nextSub     int
+
+	// observer, when set, sees every entry synchronously as it is emitted.
+	observer atomic.Pointer[func(LogEntry)]
 }
 
 const (
@@ -331,6 +364,7 @@ func NewWebSocketHub(logger *lsm.SharedLogger, bufferSize int, bulkMaxEvents int
 		startTime:     time.Now(),
 		bulkMaxEvents: bulkMaxEvents,
 		bulkMaxBytes:  bulkMaxBytes,
+		subscribers:   make(map[int]chan LogEntry),
 	}
 
 	hub.emitHello()
@@ -348,6 +382,7 @@ func (h *WebSocketHub) Run() {
 		case client := <-h.register:
 			h.mutex.Lock()
 			h.clients[client.id] = client
+			clientsConnected.Set(int64(len(h.clients)))
 			h.mutex.Unlock()
 			log.Printf("WebSocket client connected. Total clients: %d", len(h.clients))
 
@@ -404,14 +439,17 @@ func (h *WebSocketHub) enqueue(client *client, payload []byte) {
 	default:
 	}
 
+	// Make room by dropping the oldest queued message.
 	select {
 	case <-client.send:
+		droppedClient.Inc()
 	default:
 	}
 
 	select {
 	case client.send <- payload:
 	default:
+		droppedClient.Inc()
 		log.Printf("websocket: dropping message for client %s (send buffer full)", client.id)
 	}
 }
@@ -422,6 +460,7 @@ func (h *WebSocketHub) removeClient(id string) {
 	if ok {
 		delete(h.clients, id)
 	}
+	clientsConnected.Set(int64(len(h.clients)))
 	h.mutex.Unlock()
 
 	if ok && client != nil {
@@ -526,16 +565,83 @@ func (h *WebSocketHub) emit(entry LogEntry) {
 		entry.Time = time.Now().Format(time.RFC3339)
 	}
 	entry.InstanceID = h.instanceID
-	seq := atomic.AddUint64(&h.seq, 1)
-	entry.Seq = seq
+
+	// Sequencing, buffering and delivery happen under one lock so every
+	// consumer sees entries in seq order with no gaps.
+	h.emitMu.Lock()
+	defer h.emitMu.Unlock()
+	entry.Seq = atomic.LoadUint64(&h.seq) + 1
+	eventsEmitted.Inc()
 
 	h.eventBuffer.Add(entry)
+	// Publish the seq only once the entry is buffered, so EventsSince never
+	// misses an entry at or below LastSeq.
+	atomic.StoreUint64(&h.seq, entry.Seq)
+	if observe := h.observer.Load(); observe != nil {
+		(*observe)(entry)
+	}
+	h.notifySubscribers(entry)
 
 	if jsonData, err := json.Marshal(entry); err == nil {
 		select {
 		case h.broadcast <- jsonData:
 		default:
 			// Channel is full, drop the message
+			droppedBroadcast.Inc()
+		}
+	}
+}
+
+// SetObserver installs fn to be called with every entry after it has been
+// sequenced, on the emitting goroutine while the hub holds its emit lock.
+// Unlike Subscribe it never drops entries, so fn must be cheap and must not
+// emit. A nil fn removes the observer.
+func (h *WebSocketHub) SetObserver(fn func(LogEntry)) {
+	if fn == nil {
+		h.observer.Store(nil)
+		return
+	}
+	h.observer.Store(&fn)
+}
+
+// Subscribe returns a channel that receives every entry the hub emits, after
+// it has been sequenced and buffered. Delivery is best effort like the
+// websocket broadcast: when the subscriber falls more than buffer entries
+// behind, newer entries are dropped. cancel stops delivery and closes the
+// channel.
+func (h *WebSocketHub) Subscribe(buffer int) (<-chan LogEntry, func()) {
+	if buffer <= 0 {
+		buffer = 256
+	}
+	ch := make(chan LogEntry, buffer)
+
+	h.subMu.Lock()
+	id := h.nextSub
+	h.nextSub++
+	h.subscribers[id] = ch
+	h.subMu.Unlock()
+
+	var once sync.Once
+	cancel := func() {
+		once.Do(func() {
+			h.subMu.Lock()
+			delete(h.subscribers, id)
+			h.subMu.Unlock()
+			close(ch)
+		})
+	}
+	return ch, cancel
+}
+
+func (h *WebSocketHub) notifySubscribers(entry LogEntry) {
+	h.subMu.RLock()
+	defer h.subMu.RUnlock()
+	for _, ch := range h.subscribers {
+		select {
+		case ch <- entry:
+		default:
+			// Subscriber is behind, drop the entry
+			droppedSubscriber.Inc()
 		}
 	}
 }
@@ -549,6 +655,22 @@ func (h *WebSocketHub) RecentEvents(limit int) []LogEntry {
 	return h.eventBuffer.GetTail(limit)
 }
 
+// EventsSince returns buffered events newer than seq. ok is false when some of
+// them have already left the buffer.
+func (h *WebSocketHub) EventsSince(seq uint64) ([]LogEntry, bool) {
+	return h.eventBuffer.Since(seq)
+}
+
+// LastSeq returns the sequence number of the newest emitted entry.
+func (h *WebSocketHub) LastSeq() uint64 {
+	return atomic.LoadUint64(&h.seq)
+}
+
+// BufferSize returns how many events the history buffer holds.
+func (h *WebSocketHub) BufferSize() int {
+	return h.eventBuffer.size
+}
+
 // SnapshotHints extracts recent hostnames and header names from the ring buffer.
 func (h *WebSocketHub) SnapshotHints(limit int) (hosts []string, headers []string) {
 	if h == nil || h.eventBuffer == nil {
@@ -6,7 +6,11 @@ package websocket
 // panic and verifies the revised drop-oldest ring-buffer behavior which provides the
 // resilience fix.
 
-import "testing"
+import (
+	"sync"
+	"sync/atomic"
+	"testing"
+)
 
 func TestHubEnqueueAfterClientClosureDoesNotPanic(t *testing.T) {
 	t.Parallel()
@@ -60,3 +64,150 @@ func TestHubEnqueueDropsOldestMessageWhenFull(t *testing.T) {
 		t.Fatalf("expected 'latest' to be enqueued, got %q", string(second))
 	}
 }
+
+func TestHubSubscribeReceivesSequencedEntries(t *testing.T) {
+	t.Parallel()
+
+	hub := NewWebSocketHub(nil, 8, 0, 0)
+	entries, cancel := hub.Subscribe(1)
+
+	hub.EmitJSON("first", nil)
+	hub.EmitJSON("dropped", nil)
+
+	got := <-entries
+	if got.Event != "first" || got.Seq == 0 {
+		t.Fatalf("unexpected entry: %+v", got)
+	}
+	select {
+	case extra := <-entries:
+		t.Fatalf("expected full subscriber to drop, got %+v", extra)
+	default:
+	}
+
+	cancel()
+	cancel()
+	if _, ok := <-entries; ok {
+		t.Fatalf("expected channel closed after cancel")
+	}
+	hub.EmitJSON("after-cancel", nil)
+}
+
+func TestHubConcurrentEmitsDeliverSeqInOrder(t *testing.T) {
+	t.Parallel()
+
+	const emitters, perEmitter = 8, 200
+	hub := NewWebSocketHub(nil, 8, 0, 0)
+	entries, cancel := hub.Subscribe(emitters * perEmitter)
+	defer cancel()
+
+	var wg sync.WaitGroup
+	for i := 0; i < emitters; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < perEmitter; j++ {
+				hub.EmitJSON("concurrent", nil)
+			}
+		}()
+	}
+	wg.Wait()
+
+	last := hub.LastSeq() - emitters*perEmitter
+	for i := 0; i < emitters*perEmitter; i++ {
+		got := <-entries
+		if got.Seq != last+1 {
+			t.Fatalf("subscriber saw seq %d after %d", got.Seq, last)
+		}
+		last = got.Seq
+	}
+}
+
+func TestHubObserverSeesEveryEntry(t *testing.T) {
+	t.Parallel()
+
+	hub := NewWebSocketHub(nil, 8, 0, 0)
+	var seen []LogEntry
+	hub.SetObserver(func(e LogEntry) { seen = append(seen, e) })
+
+	hub.EmitJSON("first", nil)
+	hub.EmitJSON("second", nil)
+	hub.SetObserver(nil)
+	hub.EmitJSON("third", nil)
+
+	if len(seen) != 2 || seen[0].Event != "first" || seen[1].Event != "second" || seen[1].Seq != seen[0].Seq+1 {
+		t.Fatalf("unexpected observed entries: %+v", seen)
+	}
+}
+
+func TestHubEventsSinceDetectsGaps(t *testing.T) {
+	t.Parallel()
+
+	hub := NewWebSocketHub(nil, 4, 0, 0) // emits leash.hello as seq 1
+	hub.EmitJSON("two", nil)
+
+	events, ok := hub.EventsSince(0)
+	if !ok || len(events) != 2 || events[1].Event != "two" {
+		t.Fatalf("unexpected history: ok=%v %+v", ok, events)
+	}
+	if events, ok := hub.EventsSince(hub.LastSeq()); !ok || len(events) != 0 {
+		t.Fatalf("expected nothing newer than the last seq, got ok=%v %+v", ok, events)
+	}
+
+	for _, name := range []string{"three", "four", "five", "six"} {
+		hub.EmitJSON(name, nil)
+	}
+	events, ok = hub.EventsSince(3)
+	if !ok || len(events) != 3 || events[0].Seq != 4 || events[2].Event != "six" {
+		t.Fatalf("unexpected delta: ok=%v %+v", ok, events)
+	}
+	if _, ok := hub.EventsSince(1); ok {
+		t.Fatalf("expected a gap once seq 2 left the buffer")
+	}
+}
+
+// TestHubEventsSinceUnderConcurrentEmits follows the hub the way the suggest
+// cache catches up: EventsSince from the last seq it saw. An entry buffered
+// behind a newer one would be skipped for good.
+func TestHubEventsSinceUnderConcurrentEmits(t *testing.T) {
+	t.Parallel()
+
+	const emitters, perEmitter = 4, 500
+	hub := NewWebSocketHub(nil, 2*emitters*perEmitter, 0, 0)
+
+	var done atomic.Bool
+	var wg sync.WaitGroup
+	for i := 0; i < emitters; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for j := 0; j < perEmitter; j++ {
+				hub.EmitJSON("concurrent", nil)
+			}
+		}()
+	}
+	go func() {
+		wg.Wait()
+		done.Store(true)
+	}()
+
+	var last uint64
+	for {
+		finished := done.Load()
+		events, ok := hub.EventsSince(last)
+		if !ok {
+			t.Fatalf("unexpected gap after seq %d", last)
+		}
+		for _, e := range events {
+			if e.Seq != last+1 {
+				t.Fatalf("caught up to seq %d after %d", e.Seq, last)
+			}
+			last = e.Seq
+		}
+		if finished {
+			break
+		}
+	}
+	if last != hub.LastSeq() {
+		t.Fatalf("caught up to %d, hub is at %d", last, hub.LastSeq())
+	}
+}
@@ -0,0 +1,13 @@
+package websocket
+
+import "github.com/strongdm/leash/internal/telemetry/metrics"
+
+const dropHelp = "Messages dropped because a queue was full, by queue."
+
+var (
+	eventsEmitted     = metrics.Default.Counter("leash_ws_events_total", "Events sequenced into the history buffer.")
+	clientsConnected  = metrics.Default.Gauge("leash_ws_clients", "Connected websocket clients.")
+	droppedBroadcast  = metrics.Default.Counter("leash_ws_dropped_total", dropHelp, "queue", "broadcast")
+	droppedClient     = metrics.Default.Counter("leash_ws_dropped_total", dropHelp, "queue", "client")
+	droppedSubscriber = metrics.Default.Counter("leash_ws_dropped_total", dropHelp, "queue", "subscriber")
+)